@@ -0,0 +1,295 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_bandwidth.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * The suite brings up two CRTCs with a primary plane each, without
+ * any hardware behind them, and runs via_bandwidth_check() on atomic
+ * states built by hand. The memory is SDR133, whose 80% budget
+ * (851 MB/s) takes one 1920x1080@60Hz XRGB8888 head (594 MB/s) but
+ * not two.
+ */
+
+#include <kunit/test.h>
+
+#include <drm/drm_fourcc.h>
+#include <drm/drm_kunit_helpers.h>
+#include <drm/drm_mode_config.h>
+
+#define VIA_BANDWIDTH_TEST_LOAD		594
+
+static const struct drm_display_mode via_bandwidth_test_mode = {
+	/* 1920x1080@60Hz, CEA VIC 16 */
+	DRM_MODE("1920x1080", DRM_MODE_TYPE_DRIVER, 148500, 1920, 2008,
+		 2052, 2200, 0, 1080, 1084, 1089, 1125, 0,
+		 DRM_MODE_FLAG_PHSYNC | DRM_MODE_FLAG_PVSYNC)
+};
+
+static const u32 via_bandwidth_test_formats[] = {
+	DRM_FORMAT_XRGB8888,
+};
+
+struct via_bandwidth_test_plane {
+	struct drm_plane base;
+};
+
+struct via_bandwidth_test {
+	struct via_drm_priv *dev_priv;
+	struct drm_modeset_acquire_ctx *ctx;
+	struct drm_plane *planes[VIA_MAX_CRTC];
+	struct via_crtc *igas[VIA_MAX_CRTC];
+	struct drm_framebuffer *fb;
+};
+
+static const struct drm_mode_config_funcs via_bandwidth_test_mode_funcs = {
+};
+
+static const struct drm_plane_funcs via_bandwidth_test_plane_funcs = {
+	.reset = drm_atomic_helper_plane_reset,
+	.atomic_duplicate_state = drm_atomic_helper_plane_duplicate_state,
+	.atomic_destroy_state = drm_atomic_helper_plane_destroy_state,
+};
+
+static const struct drm_crtc_funcs via_bandwidth_test_crtc_funcs = {
+	.reset = drm_atomic_helper_crtc_reset,
+	.atomic_duplicate_state = drm_atomic_helper_crtc_duplicate_state,
+	.atomic_destroy_state = drm_atomic_helper_crtc_destroy_state,
+};
+
+static void via_bandwidth_test_fb_destroy(struct drm_framebuffer *fb)
+{
+	drm_framebuffer_cleanup(fb);
+}
+
+static const struct drm_framebuffer_funcs via_bandwidth_test_fb_funcs = {
+	.destroy = via_bandwidth_test_fb_destroy,
+};
+
+static void via_bandwidth_test_fb_put(void *fb)
+{
+	drm_framebuffer_put(fb);
+}
+
+static int via_bandwidth_test_init(struct kunit *test)
+{
+	struct via_bandwidth_test *priv;
+	struct via_bandwidth_test_plane *plane;
+	struct via_drm_priv *dev_priv;
+	struct drm_device *dev;
+	struct device *parent;
+	unsigned int i;
+	int ret;
+
+	priv = kunit_kzalloc(test, sizeof(*priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv);
+
+	parent = drm_kunit_helper_alloc_device(test);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, parent);
+
+	dev_priv = drm_kunit_helper_alloc_drm_device(test, parent,
+						struct via_drm_priv, dev,
+						DRIVER_MODESET |
+						DRIVER_ATOMIC);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, dev_priv);
+	dev = &dev_priv->dev;
+	dev_priv->vram_type = VIA_MEM_SDR133;
+
+	ret = drmm_mode_config_init(dev);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	dev->mode_config.funcs = &via_bandwidth_test_mode_funcs;
+
+	for (i = 0; i < VIA_MAX_CRTC; i++) {
+		plane = drmm_universal_plane_alloc(dev,
+					struct via_bandwidth_test_plane, base,
+					BIT(i),
+					&via_bandwidth_test_plane_funcs,
+					via_bandwidth_test_formats,
+					ARRAY_SIZE(via_bandwidth_test_formats),
+					NULL, DRM_PLANE_TYPE_PRIMARY, NULL);
+		KUNIT_ASSERT_NOT_ERR_OR_NULL(test, plane);
+		priv->planes[i] = &plane->base;
+
+		priv->igas[i] = drmm_crtc_alloc_with_planes(dev,
+					struct via_crtc, base,
+					&plane->base, NULL,
+					&via_bandwidth_test_crtc_funcs, NULL);
+		KUNIT_ASSERT_NOT_ERR_OR_NULL(test, priv->igas[i]);
+		priv->igas[i]->index = i;
+	}
+
+	ret = via_bandwidth_init(dev);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	drm_mode_config_reset(dev);
+
+	priv->fb = kunit_kzalloc(test, sizeof(*priv->fb), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv->fb);
+	priv->fb->dev = dev;
+	priv->fb->format = drm_format_info(DRM_FORMAT_XRGB8888);
+	priv->fb->width = via_bandwidth_test_mode.hdisplay;
+	priv->fb->height = via_bandwidth_test_mode.vdisplay;
+	ret = drm_framebuffer_init(dev, priv->fb,
+					&via_bandwidth_test_fb_funcs);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	ret = kunit_add_action_or_reset(test, via_bandwidth_test_fb_put,
+					priv->fb);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	priv->ctx = drm_kunit_helper_acquire_ctx_alloc(test);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, priv->ctx);
+
+	priv->dev_priv = dev_priv;
+	test->priv = priv;
+	return 0;
+}
+
+static struct drm_atomic_state *
+via_bandwidth_test_state(struct kunit *test)
+{
+	struct via_bandwidth_test *priv = test->priv;
+	struct drm_atomic_state *state;
+
+	state = drm_kunit_helper_atomic_state_alloc(test,
+						&priv->dev_priv->dev,
+						priv->ctx);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, state);
+	return state;
+}
+
+/*
+ * Scans the framebuffer out on an IGA, width pixels of each line of
+ * it, either as a mode set or as a page flip.
+ */
+static void via_bandwidth_test_scanout(struct kunit *test,
+					struct drm_atomic_state *state,
+					unsigned int index,
+					unsigned int width, bool modeset)
+{
+	struct via_bandwidth_test *priv = test->priv;
+	struct drm_crtc *crtc = &priv->igas[index]->base;
+	struct drm_crtc_state *crtc_state;
+	struct drm_plane_state *plane_state;
+	int ret;
+
+	crtc_state = drm_atomic_get_crtc_state(state, crtc);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, crtc_state);
+	crtc_state->enable = true;
+	crtc_state->active = true;
+	crtc_state->mode_changed = modeset;
+	drm_mode_copy(&crtc_state->adjusted_mode, &via_bandwidth_test_mode);
+
+	plane_state = drm_atomic_get_plane_state(state, priv->planes[index]);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, plane_state);
+	ret = drm_atomic_set_crtc_for_plane(plane_state, crtc);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	drm_atomic_set_fb_for_plane_state(plane_state, priv->fb);
+	plane_state->visible = true;
+	plane_state->src = DRM_RECT_INIT(0, 0, width << 16,
+				via_bandwidth_test_mode.vdisplay << 16);
+}
+
+static struct via_bandwidth_state *
+via_bandwidth_test_new_state(struct kunit *test,
+				struct drm_atomic_state *state)
+{
+	struct via_bandwidth_test *priv = test->priv;
+	struct drm_private_state *priv_state;
+
+	priv_state = drm_atomic_get_new_private_obj_state(state,
+					&priv->dev_priv->bandwidth_obj);
+	return priv_state ? to_via_bandwidth_state(priv_state) : NULL;
+}
+
+static void via_bandwidth_test_single_head(struct kunit *test)
+{
+	struct drm_atomic_state *state = via_bandwidth_test_state(test);
+	struct via_bandwidth_state *bw_state;
+
+	via_bandwidth_test_scanout(test, state, 0,
+				via_bandwidth_test_mode.hdisplay, true);
+	KUNIT_EXPECT_EQ(test, via_bandwidth_check(state), 0);
+
+	bw_state = via_bandwidth_test_new_state(test, state);
+	KUNIT_ASSERT_NOT_NULL(test, bw_state);
+	KUNIT_EXPECT_EQ(test, bw_state->load[0], VIA_BANDWIDTH_TEST_LOAD);
+	KUNIT_EXPECT_EQ(test, bw_state->load[1], 0);
+}
+
+static void via_bandwidth_test_dual_head(struct kunit *test)
+{
+	struct drm_atomic_state *state = via_bandwidth_test_state(test);
+
+	via_bandwidth_test_scanout(test, state, 0,
+				via_bandwidth_test_mode.hdisplay, true);
+	via_bandwidth_test_scanout(test, state, 1,
+				via_bandwidth_test_mode.hdisplay, true);
+	KUNIT_EXPECT_EQ(test, via_bandwidth_check(state), -ENOSPC);
+}
+
+/*
+ * With IGA1 already scanning out, a page flip of the same size must
+ * not take the global state, one of half the width must.
+ */
+static void via_bandwidth_test_flip(struct kunit *test)
+{
+	struct via_bandwidth_test *priv = test->priv;
+	struct via_bandwidth_state *cur_bw_state =
+		to_via_bandwidth_state(priv->dev_priv->bandwidth_obj.state);
+	struct drm_atomic_state *state;
+	struct via_bandwidth_state *bw_state;
+
+	cur_bw_state->load[0] = VIA_BANDWIDTH_TEST_LOAD;
+
+	state = via_bandwidth_test_state(test);
+	via_bandwidth_test_scanout(test, state, 0,
+				via_bandwidth_test_mode.hdisplay, false);
+	KUNIT_EXPECT_EQ(test, via_bandwidth_check(state), 0);
+	KUNIT_EXPECT_NULL(test, via_bandwidth_test_new_state(test, state));
+
+	state = via_bandwidth_test_state(test);
+	via_bandwidth_test_scanout(test, state, 0,
+				via_bandwidth_test_mode.hdisplay / 2, false);
+	KUNIT_EXPECT_EQ(test, via_bandwidth_check(state), 0);
+	bw_state = via_bandwidth_test_new_state(test, state);
+	KUNIT_ASSERT_NOT_NULL(test, bw_state);
+	KUNIT_EXPECT_EQ(test, bw_state->load[0],
+				VIA_BANDWIDTH_TEST_LOAD / 2);
+}
+
+static struct kunit_case via_bandwidth_test_cases[] = {
+	KUNIT_CASE(via_bandwidth_test_single_head),
+	KUNIT_CASE(via_bandwidth_test_dual_head),
+	KUNIT_CASE(via_bandwidth_test_flip),
+	{}
+};
+
+static struct kunit_suite via_bandwidth_test_suite = {
+	.name = "via_bandwidth",
+	.init = via_bandwidth_test_init,
+	.test_cases = via_bandwidth_test_cases,
+};
+
+kunit_test_suite(via_bandwidth_test_suite);
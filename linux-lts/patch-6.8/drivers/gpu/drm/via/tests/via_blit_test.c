@@ -0,0 +1,368 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_blit.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * The command lists built by via_blit_encode() and
+ * via_blit_encode_clear() are run through a software model of the 2D
+ * engine, for both register layouts, against a small VRAM held in
+ * memory. The model starts from garbage in every register, and only
+ * supports what the encoders are meant to use, so a missing or stray
+ * register write makes the blit fail or land in the wrong place.
+ */
+
+#include <kunit/test.h>
+
+#define VIA_BLIT_TEST_VRAM_SIZE	(32 * VIA_BLIT_PITCH)
+#define VIA_BLIT_MODEL_REGS	(0x60 / 4)
+
+struct via_blit_model {
+	bool	m1;
+	u32	regs[VIA_BLIT_MODEL_REGS];
+	u8	*vram;
+	u32	vram_size;
+};
+
+struct via_blit_model_layout {
+	u32	pitch;
+	u32	dimension;
+	u32	srcpos;
+	u32	dstpos;
+	u32	srcbase;
+	u32	dstbase;
+	u32	keycontrol;
+	u32	fgcolor;
+};
+
+static const struct via_blit_model_layout via_blit_model_layouts[] = {
+	{
+		.pitch = VIA_REG_PITCH,
+		.dimension = VIA_REG_DIMENSION,
+		.srcpos = VIA_REG_SRCPOS,
+		.dstpos = VIA_REG_DSTPOS,
+		.srcbase = VIA_REG_SRCBASE,
+		.dstbase = VIA_REG_DSTBASE,
+		.keycontrol = VIA_REG_KEYCONTROL,
+		.fgcolor = VIA_REG_FGCOLOR,
+	},
+	{
+		.pitch = VIA_REG_PITCH_M1,
+		.dimension = VIA_REG_DIMENSION_M1,
+		.srcpos = VIA_REG_SRCPOS_M1,
+		.dstpos = VIA_REG_DSTPOS_M1,
+		.srcbase = VIA_REG_SRCBASE_M1,
+		.dstbase = VIA_REG_DSTBASE_M1,
+		.keycontrol = VIA_REG_KEYCONTROL_M1,
+		.fgcolor = VIA_REG_MONOPATFGC_M1,
+	},
+};
+
+static u32 via_blit_model_reg(struct via_blit_model *model, u32 reg)
+{
+	return model->regs[reg / 4];
+}
+
+static void via_blit_model_reset(struct via_blit_model *model, bool m1)
+{
+	unsigned int i;
+
+	model->m1 = m1;
+	for (i = 0; i < VIA_BLIT_MODEL_REGS; i++) {
+		model->regs[i] = 0xDEADBEEF * (i + 1);
+	}
+}
+
+/* Address of pixel (x, y) of a surface, or -1 if it is outside VRAM. */
+static s64 via_blit_model_addr(struct via_blit_model *model, u32 base,
+				u32 pos, u32 pitch, u32 x, u32 y)
+{
+	u64 addr = ((u64)base << 3) +
+			(u64)(((pos >> 16) & 0xFFF) + y) * pitch +
+			(u64)((pos & 0xFFF) + x) * 4;
+
+	if (addr + 4 > model->vram_size) {
+		return -1;
+	}
+
+	return addr;
+}
+
+/*
+ * Carries out the command written to GECMD with the other registers
+ * as they are. Only forward 32 bpp screen to screen copies and solid
+ * fills without color keys are modeled.
+ */
+static int via_blit_model_run(struct via_blit_model *model, u32 gecmd)
+{
+	const struct via_blit_model_layout *layout =
+				&via_blit_model_layouts[model->m1];
+	u32 mode = via_blit_model_reg(model, VIA_REG_GEMODE);
+	u32 pitch = via_blit_model_reg(model, layout->pitch);
+	u32 dimension = via_blit_model_reg(model, layout->dimension);
+	u32 srcpos = via_blit_model_reg(model, layout->srcpos);
+	u32 dstpos = via_blit_model_reg(model, layout->dstpos);
+	u32 srcbase = via_blit_model_reg(model, layout->srcbase);
+	u32 dstbase = via_blit_model_reg(model, layout->dstbase);
+	u32 color = via_blit_model_reg(model, layout->fgcolor);
+	u32 width = (dimension & 0xFFF) + 1;
+	u32 height = ((dimension >> 16) & 0xFFF) + 1;
+	u32 src_pitch = (pitch & 0x3FFF) << 3;
+	u32 dst_pitch = ((pitch >> 16) & 0x3FFF) << 3;
+	u32 rop = gecmd >> 24;
+	bool fill;
+	s64 src, dst;
+	u32 x, y;
+
+	if (((mode & VIA_GEM_32bpp) != VIA_GEM_32bpp) ||
+		((!model->m1) && (!(pitch & VIA_PITCH_ENABLE))) ||
+		(via_blit_model_reg(model, layout->keycontrol))) {
+		return -EINVAL;
+	}
+
+	if (((gecmd & 0x0F) != VIA_GEC_BLT) ||
+		(gecmd & (VIA_GEC_SRC_LINEAR | VIA_GEC_DST_LINRAT |
+			VIA_GEC_SRC_SYS | VIA_GEC_DST_SYS |
+			VIA_GEC_SRC_MONO | VIA_GEC_PAT_MONO |
+			VIA_GEC_CLIP_ENABLE | VIA_GEC_DECX | VIA_GEC_DECY))) {
+		return -EINVAL;
+	}
+
+	if ((rop == VIA_BLIT_ROP_SRCCOPY) &&
+		(!(gecmd & VIA_GEC_FIXCOLOR_PAT))) {
+		fill = false;
+	} else if ((rop == VIA_BLIT_ROP_PATCOPY) &&
+		(gecmd & VIA_GEC_FIXCOLOR_PAT)) {
+		fill = true;
+	} else {
+		return -EINVAL;
+	}
+
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < width; x++) {
+			dst = via_blit_model_addr(model, dstbase, dstpos,
+							dst_pitch, x, y);
+			if (dst < 0) {
+				return -EFAULT;
+			}
+
+			if (fill) {
+				memcpy(&model->vram[dst], &color, 4);
+				continue;
+			}
+
+			src = via_blit_model_addr(model, srcbase, srcpos,
+							src_pitch, x, y);
+			if (src < 0) {
+				return -EFAULT;
+			}
+
+			memmove(&model->vram[dst], &model->vram[src], 4);
+		}
+	}
+
+	return 0;
+}
+
+static int via_blit_model_write(struct via_blit_model *model,
+				const struct via_blit_cmd *cmd)
+{
+	unsigned int i;
+	int ret = -ENOENT;
+
+	for (i = 0; i < cmd->count; i++) {
+		if (cmd->reg[i] >= VIA_BLIT_MODEL_REGS * 4) {
+			return -EINVAL;
+		}
+
+		if (cmd->reg[i] == VIA_REG_GECMD) {
+			ret = via_blit_model_run(model, cmd->val[i]);
+		} else {
+			model->regs[cmd->reg[i] / 4] = cmd->val[i];
+		}
+	}
+
+	return ret;
+}
+
+static int via_blit_test_init(struct kunit *test)
+{
+	struct via_blit_model *model;
+
+	model = kunit_kzalloc(test, sizeof(*model), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, model);
+
+	model->vram_size = VIA_BLIT_TEST_VRAM_SIZE;
+	model->vram = kunit_kzalloc(test, model->vram_size, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, model->vram);
+
+	test->priv = model;
+	return 0;
+}
+
+static void via_blit_test_pattern(u8 *buf, u32 size, u32 seed)
+{
+	u32 i;
+
+	for (i = 0; i < size; i++) {
+		buf[i] = (i * 0x9E3779B1 + seed) >> 24;
+	}
+}
+
+static void via_blit_test_copy_layout(struct kunit *test, bool m1)
+{
+	struct via_blit_model *model = test->priv;
+	u32 size = VIA_BLIT_TEST_VRAM_SIZE;
+	u32 src = 2 * VIA_BLIT_PITCH, dst = 17 * VIA_BLIT_PITCH, lines = 9;
+	struct via_blit_cmd cmd;
+	u8 *expected;
+
+	expected = kunit_kzalloc(test, size, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, expected);
+
+	via_blit_test_pattern(model->vram, size, m1);
+	memcpy(expected, model->vram, size);
+	memcpy(expected + dst, expected + src, lines * VIA_BLIT_PITCH);
+
+	KUNIT_ASSERT_EQ(test, via_blit_encode(m1, src, dst, lines, &cmd), 0);
+	KUNIT_EXPECT_LE(test, cmd.count, VIA_BLIT_CMD_REGS);
+
+	via_blit_model_reset(model, m1);
+	KUNIT_ASSERT_EQ(test, via_blit_model_write(model, &cmd), 0);
+	KUNIT_EXPECT_MEMEQ(test, model->vram, expected, size);
+}
+
+static void via_blit_test_copy(struct kunit *test)
+{
+	via_blit_test_copy_layout(test, false);
+}
+
+static void via_blit_test_copy_m1(struct kunit *test)
+{
+	via_blit_test_copy_layout(test, true);
+}
+
+static void via_blit_test_clear_layout(struct kunit *test, bool m1)
+{
+	struct via_blit_model *model = test->priv;
+	u32 size = VIA_BLIT_TEST_VRAM_SIZE;
+	u32 dst = 5 * VIA_BLIT_PITCH, lines = 3;
+	struct via_blit_cmd cmd;
+	u8 *expected;
+
+	expected = kunit_kzalloc(test, size, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, expected);
+
+	via_blit_test_pattern(model->vram, size, 0x55);
+	memcpy(expected, model->vram, size);
+	memset(expected + dst, 0, lines * VIA_BLIT_PITCH);
+
+	KUNIT_ASSERT_EQ(test, via_blit_encode_clear(m1, dst, lines, &cmd), 0);
+	KUNIT_EXPECT_LE(test, cmd.count, VIA_BLIT_CMD_REGS);
+
+	via_blit_model_reset(model, m1);
+	KUNIT_ASSERT_EQ(test, via_blit_model_write(model, &cmd), 0);
+	KUNIT_EXPECT_MEMEQ(test, model->vram, expected, size);
+}
+
+static void via_blit_test_clear(struct kunit *test)
+{
+	via_blit_test_clear_layout(test, false);
+}
+
+static void via_blit_test_clear_m1(struct kunit *test)
+{
+	via_blit_test_clear_layout(test, true);
+}
+
+/* The largest copy must still fit the 12-bit dimension fields. */
+static void via_blit_test_max_lines(struct kunit *test)
+{
+	struct via_blit_model *model = test->priv;
+	const struct via_blit_model_layout *layout;
+	struct via_blit_cmd cmd;
+	unsigned int i, m1;
+	u32 dimension;
+
+	for (m1 = 0; m1 < ARRAY_SIZE(via_blit_model_layouts); m1++) {
+		layout = &via_blit_model_layouts[m1];
+		KUNIT_ASSERT_EQ(test, via_blit_encode(m1, 0, 0,
+					VIA_BLIT_MAX_LINES, &cmd), 0);
+		KUNIT_EXPECT_LE(test, cmd.count, VIA_BLIT_CMD_REGS);
+
+		via_blit_model_reset(model, m1);
+		for (i = 0; i < cmd.count; i++) {
+			if (cmd.reg[i] != VIA_REG_GECMD) {
+				model->regs[cmd.reg[i] / 4] = cmd.val[i];
+			}
+		}
+
+		dimension = via_blit_model_reg(model, layout->dimension);
+		KUNIT_EXPECT_EQ(test, (dimension >> 16) & 0xFFF,
+					VIA_BLIT_MAX_LINES - 1);
+		KUNIT_EXPECT_EQ(test, ((dimension & 0xFFF) + 1) * 4,
+					VIA_BLIT_PITCH);
+	}
+}
+
+static void via_blit_test_invalid(struct kunit *test)
+{
+	struct via_blit_cmd cmd;
+
+	KUNIT_EXPECT_EQ(test, via_blit_encode(false, 0, 0, 0, &cmd),
+				-EINVAL);
+	KUNIT_EXPECT_EQ(test, via_blit_encode(false, 0, 0,
+					VIA_BLIT_MAX_LINES + 1, &cmd),
+				-EINVAL);
+	KUNIT_EXPECT_EQ(test, via_blit_encode(true, 4, 0, 1, &cmd), -EINVAL);
+	KUNIT_EXPECT_EQ(test, via_blit_encode(true, 0, 0x20000000, 1, &cmd),
+				-EINVAL);
+	KUNIT_EXPECT_EQ(test, cmd.count, 0);
+
+	KUNIT_EXPECT_EQ(test, via_blit_encode_clear(false, 0, 0, &cmd),
+				-EINVAL);
+	KUNIT_EXPECT_EQ(test, via_blit_encode_clear(true, 6, 1, &cmd),
+				-EINVAL);
+	KUNIT_EXPECT_EQ(test, cmd.count, 0);
+}
+
+static struct kunit_case via_blit_test_cases[] = {
+	KUNIT_CASE(via_blit_test_copy),
+	KUNIT_CASE(via_blit_test_copy_m1),
+	KUNIT_CASE(via_blit_test_clear),
+	KUNIT_CASE(via_blit_test_clear_m1),
+	KUNIT_CASE(via_blit_test_max_lines),
+	KUNIT_CASE(via_blit_test_invalid),
+	{}
+};
+
+static struct kunit_suite via_blit_test_suite = {
+	.name = "via_blit",
+	.init = via_blit_test_init,
+	.test_cases = via_blit_test_cases,
+};
+
+kunit_test_suite(via_blit_test_suite);
@@ -0,0 +1,157 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Golden PLL register values, shared by the via_clock KUnit suite and
+ * the userspace harness in tools/testing/via.
+ *
+ * One row per pixel clock of the DMT and CEA-861 modes up to 297 MHz.
+ * The values are the ones the exhaustive M/R/N search (every M of
+ * every N and R pair) picked before via_pll_solve() was introduced.
+ * The solver only depends on which of three families a chipset is in,
+ * so each row holds the value for each family.
+ */
+
+#ifndef _VIA_CLOCK_GOLDEN_H
+#define _VIA_CLOCK_GOLDEN_H
+
+struct via_pll_golden {
+	u32 clock;		/* kHz */
+	u32 unichrome;		/* CLE266 and KM400 */
+	u32 vx855;		/* VX855 and VX900 */
+	u32 chrome9;		/* Everything else */
+};
+
+static const struct via_pll_golden via_pll_golden_table[] = {
+	{  25175, 0x00000407, 0x008d9085, 0x008b9083 },
+	{  25200, 0x0000c763, 0x008d9085, 0x008b9083 },
+	{  27000, 0x00008735, 0x00979085, 0x00959083 },
+	{  27027, 0x00008735, 0x00979085, 0x00959083 },
+	{  31500, 0x0000050b, 0x00b09085, 0x00ae9083 },
+	{  33750, 0x00004721, 0x00979084, 0x00959082 },
+	{  35500, 0x0000c677, 0x00779083, 0x00759081 },
+	{  36000, 0x0000c679, 0x00a19084, 0x009f9082 },
+	{  40000, 0x00008643, 0x00438c83, 0x00418c81 },
+	{  44900, 0x00000716, 0x00328c82, 0x00308c80 },
+	{  49500, 0x00008653, 0x00538c83, 0x00518c81 },
+	{  50000, 0x00000207, 0x00548c83, 0x00528c81 },
+	{  54000, 0x0000c479, 0x00978c85, 0x00958c83 },
+	{  54054, 0x0000c479, 0x00978c85, 0x00958c83 },
+	{  56250, 0x00004737, 0x009d8c85, 0x009b8c83 },
+	{  65000, 0x0000866d, 0x006d8c83, 0x006b8c81 },
+	{  68250, 0x00000413, 0x00bf8c85, 0x00bd8c83 },
+	{  71000, 0x00008677, 0x00778c83, 0x00758c81 },
+	{  72000, 0x00008679, 0x00a18c84, 0x009f8c82 },
+	{  73250, 0x00004429, 0x007b8c83, 0x00798c81 },
+	{  74176, 0x00008453, 0x00cf8c85, 0x00cd8c83 },
+	{  74250, 0x00008453, 0x00538c82, 0x00518c80 },
+	{  75000, 0x00000415, 0x003f8883, 0x003d8881 },
+	{  78750, 0x0000020b, 0x002c8882, 0x002a8880 },
+	{  79500, 0x0000856f, 0x006f8885, 0x006d8883 },
+	{  83500, 0x00000623, 0x00468883, 0x00448881 },
+	{  85500, 0x00008577, 0x00778885, 0x00758883 },
+	{  88750, 0x0000051f, 0x007c8885, 0x007a8883 },
+	{  94500, 0x00000521, 0x00848885, 0x00828883 },
+	{ 101000, 0x00008471, 0x008d8885, 0x008b8883 },
+	{ 102250, 0x00000732, 0x008f8885, 0x008d8883 },
+	{ 106500, 0x00008477, 0x00778884, 0x00758882 },
+	{ 108000, 0x00008479, 0x00978885, 0x00958883 },
+	{ 108108, 0x00008479, 0x00978885, 0x00958883 },
+	{ 115500, 0x00004771, 0x00818884, 0x007f8882 },
+	{ 117500, 0x00000529, 0x00a48885, 0x00a28883 },
+	{ 119000, 0x00004553, 0x00858884, 0x00838882 },
+	{ 121750, 0x00000211, 0x00448882, 0x00428880 },
+	{ 122500, 0x0000073c, 0x00ab8885, 0x00a98883 },
+	{ 135000, 0x00000742, 0x00978884, 0x00958882 },
+	{ 136750, 0x00000743, 0x00bf8885, 0x00bd8883 },
+	{ 140250, 0x00000531, 0x00c48885, 0x00c28883 },
+	{ 146250, 0x00000533, 0x00cc8885, 0x00ca8883 },
+	{ 148250, 0x0000031f, 0x00cf8885, 0x00cd8883 },
+	{ 148352, 0x00004453, 0x00cf8885, 0x00cd8883 },
+	{ 148500, 0x00004453, 0x00538882, 0x00518880 },
+	{ 154000, 0x0000042b, 0x00568484, 0x00548482 },
+	{ 156000, 0x0000456d, 0x006d8485, 0x006b8483 },
+	{ 157000, 0x00000216, 0x00428483, 0x00408481 },
+	{ 157500, 0x00000216, 0x006e8485, 0x006c8483 },
+	{ 162000, 0x00004571, 0x00718485, 0x006f8483 },
+	{ 175500, 0x00000431, 0x00628484, 0x00608482 },
+	{ 179500, 0x00000758, 0x007d8485, 0x007b8483 },
+	{ 182750, 0x00000433, 0x00668484, 0x00648482 },
+	{ 187000, 0x0000021a, 0x00838485, 0x00818483 },
+	{ 187250, 0x00004469, 0x00838485, 0x00818483 },
+	{ 189000, 0x00000542, 0x00848485, 0x00828483 },
+	{ 193250, 0x0000021b, 0x00518483, 0x004f8481 },
+	{ 202500, 0x00000763, 0x00718484, 0x006f8482 },
+	{ 204750, 0x00000764, 0x008f8485, 0x008d8483 },
+	{ 208000, 0x0000021d, 0x00918485, 0x008f8483 },
+	{ 214750, 0x0000021e, 0x005a8483, 0x00588481 },
+	{ 216000, 0x00004479, 0x00978485, 0x00958483 },
+	{ 216216, 0x00004479, 0x00978485, 0x00958483 },
+	{ 218250, 0x0000043d, 0x007a8484, 0x00788482 },
+	{ 229500, 0x00000220, 0x00a08485, 0x009e8483 },
+	{ 234000, 0x00000331, 0x00628483, 0x00608481 },
+	{ 245250, 0x00000778, 0x00898484, 0x00878482 },
+	{ 245500, 0x00000778, 0x00678483, 0x00658481 },
+	{ 261000, 0x00000449, 0x00928484, 0x00908482 },
+	{ 268250, 0x0000044b, 0x00968484, 0x00948482 },
+	{ 268500, 0x0000044b, 0x00968484, 0x00948482 },
+	{ 281250, 0x0000033b, 0x009d8484, 0x009b8482 },
+	{ 288000, 0x00000679, 0x00a18484, 0x009f8482 },
+	{ 296703, 0x00000453, 0x00cf8485, 0x00cd8483 },
+	{ 297000, 0x00000453, 0x00a68484, 0x00a48482 },
+};
+
+static const u16 via_pll_golden_devices[] = {
+	PCI_DEVICE_ID_VIA_CLE266_GFX,
+	PCI_DEVICE_ID_VIA_KM400_GFX,
+	PCI_DEVICE_ID_VIA_K8M800_GFX,
+	PCI_DEVICE_ID_VIA_PM800_GFX,
+	PCI_DEVICE_ID_VIA_P4M800_PRO_GFX,
+	PCI_DEVICE_ID_VIA_UNICHROME_PRO_II,
+	PCI_DEVICE_ID_VIA_CHROME9,
+	PCI_DEVICE_ID_VIA_P4M890_GFX,
+	PCI_DEVICE_ID_VIA_CHROME9_HC,
+	PCI_DEVICE_ID_VIA_CHROME9_HC3,
+	PCI_DEVICE_ID_VIA_CHROME9_HCM,
+	PCI_DEVICE_ID_VIA_CHROME9_HD,
+};
+
+static inline u32 via_pll_golden_value(const struct via_pll_golden *golden,
+					u16 device)
+{
+	switch (device) {
+	case PCI_DEVICE_ID_VIA_CLE266_GFX:
+	case PCI_DEVICE_ID_VIA_KM400_GFX:
+		return golden->unichrome;
+	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
+	case PCI_DEVICE_ID_VIA_CHROME9_HD:
+		return golden->vx855;
+	default:
+		return golden->chrome9;
+	}
+}
+
+#endif /* _VIA_CLOCK_GOLDEN_H */
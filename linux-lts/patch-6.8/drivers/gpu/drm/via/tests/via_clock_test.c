@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_clock.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * via_pll_solve() only evaluates the two M values next to the target
+ * of each (N, R) pair. It is checked against the golden values of the
+ * DMT and CEA-861 pixel clocks on every chipset, and against a full
+ * search over M across the whole pixel clock range.
+ */
+
+#include <kunit/test.h>
+
+#include "via_clock_golden.h"
+
+#define VIA_CLOCK_TEST_SWEEP_MIN	20000000
+#define VIA_CLOCK_TEST_SWEEP_MAX	400000000
+#define VIA_CLOCK_TEST_SWEEP_STEP	250000
+
+/* The search via_pll_solve() replaced, visiting every M. */
+static u32 via_pll_solve_exhaustive(u16 device, u32 freq)
+{
+	u32 best_pll_n = 2, best_pll_r = 0, best_pll_m = 2, best_clk_diff = freq;
+	u32 last_pll_n = 0, last_pll_r = 0, last_pll_m = 0;
+	u32 last_clk_diff = 0;
+	bool last_valid = false;
+	u32 pll_n, pll_r, pll_m, pll_fvco, pll_fout, clk_diff;
+
+	if ((device != PCI_DEVICE_ID_VIA_CLE266_GFX) &&
+		(device != PCI_DEVICE_ID_VIA_KM400_GFX)) {
+		for (pll_n = 2; pll_n < 6; pll_n++) {
+			for (pll_r = 0; pll_r < 6; pll_r++) {
+				for (pll_m = 2; pll_m < 512; pll_m++) {
+					pll_fvco = (VIA_CLK_REFERENCE / pll_n) *
+							pll_m;
+					if ((pll_fvco < CSR_VCO_DOWN) ||
+						(pll_fvco > CSR_VCO_UP)) {
+						continue;
+					}
+
+					pll_fout = pll_fvco >> pll_r;
+					clk_diff = via_pll_diff(pll_fout, freq);
+
+					if ((!last_valid) ||
+						(clk_diff <= last_clk_diff)) {
+						last_valid = true;
+						last_clk_diff = clk_diff;
+						last_pll_m = pll_m;
+						last_pll_n = pll_n;
+						last_pll_r = pll_r;
+					}
+
+					if (clk_diff < best_clk_diff) {
+						best_clk_diff = clk_diff;
+						best_pll_m = pll_m;
+						best_pll_n = pll_n;
+						best_pll_r = pll_r;
+					}
+				}
+			}
+		}
+
+		if (freq > 150000000) {
+			best_pll_m = last_pll_m;
+			best_pll_r = last_pll_r;
+			best_pll_n = last_pll_n;
+		}
+	} else {
+		for (pll_r = 0; pll_r < 4; ++pll_r) {
+			for (pll_n = (pll_r == 0) ? 2 : 1; pll_n <= 7; ++pll_n) {
+				for (pll_m = 1; pll_m <= 127; ++pll_m) {
+					pll_fout = VIA_CLK_REFERENCE * pll_m;
+					pll_fout /= (pll_n << pll_r);
+					clk_diff = via_pll_diff(pll_fout, freq);
+
+					if (clk_diff < best_clk_diff) {
+						best_clk_diff = clk_diff;
+						best_pll_m = pll_m;
+						best_pll_n = pll_n;
+						best_pll_r = pll_r;
+					}
+				}
+			}
+		}
+	}
+
+	return via_pll_mrn(device, best_pll_m, best_pll_n, best_pll_r);
+}
+
+static void via_pll_solve_test_golden(struct kunit *test)
+{
+	const struct via_pll_golden *golden;
+	unsigned int i, j;
+	u16 device;
+
+	for (i = 0; i < ARRAY_SIZE(via_pll_golden_table); i++) {
+		golden = &via_pll_golden_table[i];
+
+		for (j = 0; j < ARRAY_SIZE(via_pll_golden_devices); j++) {
+			device = via_pll_golden_devices[j];
+			KUNIT_EXPECT_EQ_MSG(test,
+				via_pll_solve(device, golden->clock * 1000),
+				via_pll_golden_value(golden, device),
+				"device 0x%04x, %u kHz", device,
+				golden->clock);
+		}
+	}
+}
+
+/* The search only differs between these three families of chipsets. */
+static const u16 via_pll_solve_test_families[] = {
+	PCI_DEVICE_ID_VIA_CLE266_GFX,
+	PCI_DEVICE_ID_VIA_CHROME9_HD,
+	PCI_DEVICE_ID_VIA_CHROME9,
+};
+
+static void via_pll_solve_test_sweep(struct kunit *test)
+{
+	unsigned int i;
+	u32 freq;
+	u16 device;
+
+	for (i = 0; i < ARRAY_SIZE(via_pll_solve_test_families); i++) {
+		device = via_pll_solve_test_families[i];
+
+		for (freq = VIA_CLOCK_TEST_SWEEP_MIN;
+			freq <= VIA_CLOCK_TEST_SWEEP_MAX;
+			freq += VIA_CLOCK_TEST_SWEEP_STEP) {
+			KUNIT_EXPECT_EQ_MSG(test,
+				via_pll_solve(device, freq),
+				via_pll_solve_exhaustive(device, freq),
+				"device 0x%04x, %u Hz", device, freq);
+		}
+	}
+}
+
+static struct kunit_case via_clock_test_cases[] = {
+	KUNIT_CASE(via_pll_solve_test_golden),
+	KUNIT_CASE(via_pll_solve_test_sweep),
+	{}
+};
+
+static struct kunit_suite via_clock_test_suite = {
+	.name = "via_clock",
+	.test_cases = via_clock_test_cases,
+};
+
+kunit_test_suite(via_clock_test_suite);
@@ -0,0 +1,395 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_connector.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * The DDC bus is a fake I2C adapter whose algorithm serves an EDID
+ * from memory, as a display at 0x50 would, and counts the bytes read
+ * from it, so the tests can tell a cache hit from a full read. It
+ * also checks the negative DDC probe result against the hotplug
+ * sense.
+ */
+
+#include <kunit/test.h>
+
+#include <drm/drm_kunit_helpers.h>
+#include <drm/drm_managed.h>
+#include <drm/drm_mode_config.h>
+
+#define VIA_CONNECTOR_TEST_EDID_SIZE	(2 * EDID_LENGTH)
+
+/* Bytes a cache hit reads: the probe bytes and one extension checksum. */
+#define VIA_CONNECTOR_TEST_HIT_BYTES	(10 + 2 + 1)
+
+struct via_connector_test_ddc {
+	struct i2c_adapter adapter;
+	u8 edid[VIA_CONNECTOR_TEST_EDID_SIZE];
+	bool present;
+	unsigned int xfers;
+	unsigned int bytes;
+};
+
+struct via_connector_test {
+	struct via_connector *con;
+	struct via_connector_test_ddc *ddc;
+};
+
+static int via_connector_test_xfer(struct i2c_adapter *adapter,
+					struct i2c_msg *msgs, int num)
+{
+	struct via_connector_test_ddc *ddc =
+		container_of(adapter, struct via_connector_test_ddc, adapter);
+	unsigned int offset = 0, segment = 0;
+	int i;
+
+	ddc->xfers++;
+	if (!ddc->present) {
+		return -ENXIO;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (msgs[i].addr == VIA_DDC_SEGMENT_ADDR) {
+			segment = msgs[i].buf[0];
+		} else if (!(msgs[i].flags & I2C_M_RD)) {
+			offset = segment * 256 + msgs[i].buf[0];
+		} else {
+			if (offset + msgs[i].len > sizeof(ddc->edid)) {
+				return -EIO;
+			}
+
+			memcpy(msgs[i].buf, ddc->edid + offset, msgs[i].len);
+			offset += msgs[i].len;
+			ddc->bytes += msgs[i].len;
+		}
+	}
+
+	return num;
+}
+
+static u32 via_connector_test_func(struct i2c_adapter *adapter)
+{
+	return I2C_FUNC_I2C;
+}
+
+static const struct i2c_algorithm via_connector_test_algo = {
+	.master_xfer	= via_connector_test_xfer,
+	.functionality	= via_connector_test_func,
+};
+
+/* The adapter is never registered, and the tests do not race. */
+static void via_connector_test_lock_bus(struct i2c_adapter *adapter,
+					unsigned int flags)
+{
+}
+
+static int via_connector_test_trylock_bus(struct i2c_adapter *adapter,
+						unsigned int flags)
+{
+	return 1;
+}
+
+static const struct i2c_lock_operations via_connector_test_lock_ops = {
+	.lock_bus	= via_connector_test_lock_bus,
+	.trylock_bus	= via_connector_test_trylock_bus,
+	.unlock_bus	= via_connector_test_lock_bus,
+};
+
+static void via_connector_test_checksum(u8 *block)
+{
+	u8 sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < EDID_LENGTH - 1; i++) {
+		sum += block[i];
+	}
+
+	block[EDID_LENGTH - 1] = 0x100 - sum;
+}
+
+/* An EDID 1.3 base block followed by an empty CTA-861 extension. */
+static void via_connector_test_edid(u8 *edid)
+{
+	static const u8 header[] = {
+		0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00,
+	};
+
+	memset(edid, 0, VIA_CONNECTOR_TEST_EDID_SIZE);
+	memcpy(edid, header, sizeof(header));
+	edid[0x08] = 0x59;	/* Vendor "VIA" */
+	edid[0x09] = 0x21;
+	edid[0x0a] = 0x22;	/* Product code */
+	edid[0x0b] = 0x51;
+	edid[0x0c] = 0x01;	/* Serial number */
+	edid[0x10] = 10;	/* Week 10 of 2020 */
+	edid[0x11] = 30;
+	edid[0x12] = 1;		/* Version 1.3 */
+	edid[0x13] = 3;
+	edid[0x7e] = 1;		/* One extension block */
+	via_connector_test_checksum(edid);
+
+	edid[EDID_LENGTH] = 0x02;	/* CTA-861 revision 3 */
+	edid[EDID_LENGTH + 1] = 0x03;
+	edid[EDID_LENGTH + 2] = 0x04;
+	via_connector_test_checksum(edid + EDID_LENGTH);
+}
+
+static const struct drm_connector_funcs via_connector_test_funcs = {
+};
+
+static void via_connector_test_cache_fini(void *con)
+{
+	via_connector_edid_invalidate(con);
+}
+
+static int via_connector_test_init(struct kunit *test)
+{
+	struct via_connector_test *priv;
+	struct via_connector_test_ddc *ddc;
+	struct via_drm_priv *dev_priv;
+	struct drm_device *dev;
+	struct device *parent;
+	int ret;
+
+	priv = kunit_kzalloc(test, sizeof(*priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv);
+
+	ddc = kunit_kzalloc(test, sizeof(*ddc), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, ddc);
+	ddc->adapter.algo = &via_connector_test_algo;
+	ddc->adapter.lock_ops = &via_connector_test_lock_ops;
+	ddc->adapter.timeout = HZ;
+	strscpy(ddc->adapter.name, "via_connector_test",
+		sizeof(ddc->adapter.name));
+	via_connector_test_edid(ddc->edid);
+	ddc->present = true;
+
+	parent = drm_kunit_helper_alloc_device(test);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, parent);
+
+	dev_priv = drm_kunit_helper_alloc_drm_device(test, parent,
+						struct via_drm_priv, dev,
+						DRIVER_MODESET);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, dev_priv);
+	dev = &dev_priv->dev;
+
+	ret = drmm_mode_config_init(dev);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	priv->con = drmm_kzalloc(dev, sizeof(*priv->con), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv->con);
+	ret = drmm_connector_init(dev, &priv->con->base,
+					&via_connector_test_funcs,
+					DRM_MODE_CONNECTOR_DVID,
+					&ddc->adapter);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	ret = kunit_add_action_or_reset(test, via_connector_test_cache_fini,
+					priv->con);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	priv->ddc = ddc;
+	test->priv = priv;
+	return 0;
+}
+
+/* Reads the EDID, which must be the one the display has now. */
+static void via_connector_test_get(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct edid *edid;
+
+	edid = via_connector_get_edid(priv->con, &priv->ddc->adapter);
+	KUNIT_ASSERT_NOT_NULL(test, edid);
+	KUNIT_EXPECT_MEMEQ(test, edid, priv->ddc->edid,
+				VIA_CONNECTOR_TEST_EDID_SIZE);
+	kfree(edid);
+}
+
+static void via_connector_test_hit(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_edid_cache *cache = &priv->con->edid_cache;
+
+	/* The first read probes the bus, then reads everything. */
+	via_connector_test_get(test);
+	KUNIT_EXPECT_EQ(test, priv->ddc->bytes,
+			1 + VIA_CONNECTOR_TEST_EDID_SIZE);
+	KUNIT_EXPECT_EQ(test, cache->misses, 1);
+
+	priv->ddc->bytes = 0;
+	via_connector_test_get(test);
+	KUNIT_EXPECT_EQ(test, priv->ddc->bytes, VIA_CONNECTOR_TEST_HIT_BYTES);
+	KUNIT_EXPECT_EQ(test, cache->hits, 1);
+	KUNIT_EXPECT_EQ(test, cache->misses, 1);
+}
+
+/* Another display of the same model differs in its serial number. */
+static void via_connector_test_miss_identity(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_edid_cache *cache = &priv->con->edid_cache;
+
+	via_connector_test_get(test);
+
+	priv->ddc->edid[0x0c] = 0x02;
+	via_connector_test_checksum(priv->ddc->edid);
+	priv->ddc->bytes = 0;
+	via_connector_test_get(test);
+	KUNIT_EXPECT_EQ(test, cache->hits, 0);
+	KUNIT_EXPECT_EQ(test, cache->misses, 2);
+}
+
+/* Only the extension block changes, i.e. a new audio capability. */
+static void via_connector_test_miss_extension(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_edid_cache *cache = &priv->con->edid_cache;
+
+	via_connector_test_get(test);
+
+	priv->ddc->edid[EDID_LENGTH + 3] = 0x40;
+	via_connector_test_checksum(priv->ddc->edid + EDID_LENGTH);
+	priv->ddc->bytes = 0;
+	via_connector_test_get(test);
+	KUNIT_EXPECT_EQ(test, priv->ddc->bytes, VIA_CONNECTOR_TEST_HIT_BYTES +
+				VIA_CONNECTOR_TEST_EDID_SIZE);
+	KUNIT_EXPECT_EQ(test, cache->hits, 0);
+	KUNIT_EXPECT_EQ(test, cache->misses, 2);
+}
+
+static void via_connector_test_invalidate(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_edid_cache *cache = &priv->con->edid_cache;
+
+	via_connector_test_get(test);
+	via_connector_edid_invalidate(priv->con);
+	KUNIT_EXPECT_NULL(test, cache->edid);
+
+	priv->ddc->bytes = 0;
+	via_connector_test_get(test);
+	KUNIT_EXPECT_EQ(test, priv->ddc->bytes,
+			1 + VIA_CONNECTOR_TEST_EDID_SIZE);
+	KUNIT_EXPECT_EQ(test, cache->misses, 2);
+}
+
+/* Unplugging the display drops the cached EDID. */
+static void via_connector_test_unplug(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_edid_cache *cache = &priv->con->edid_cache;
+
+	via_connector_test_get(test);
+
+	priv->ddc->present = false;
+	KUNIT_EXPECT_NULL(test, via_connector_get_edid(priv->con,
+						&priv->ddc->adapter));
+	KUNIT_EXPECT_NULL(test, cache->edid);
+}
+
+/* While the sense says disconnected, an empty bus is not probed again. */
+static void via_connector_test_probe_sense_off(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_connector *con = priv->con;
+	struct i2c_adapter *bus = &priv->ddc->adapter;
+
+	via_connector_hotplug_sense(con, false);
+	priv->ddc->present = false;
+	KUNIT_EXPECT_FALSE(test, via_connector_ddc_probe(con, bus));
+	KUNIT_EXPECT_PTR_EQ(test, con->edid_cache.absent_bus, bus);
+	KUNIT_EXPECT_EQ(test, priv->ddc->xfers, 1);
+
+	KUNIT_EXPECT_FALSE(test, via_connector_ddc_probe(con, bus));
+	KUNIT_EXPECT_EQ(test, priv->ddc->xfers, 1);
+}
+
+/*
+ * While the sense says connected, an empty bus is probed every time,
+ * and found once the display answers.
+ */
+static void via_connector_test_probe_sense_on(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_connector *con = priv->con;
+	struct i2c_adapter *bus = &priv->ddc->adapter;
+
+	via_connector_hotplug_sense(con, true);
+	priv->ddc->present = false;
+	KUNIT_EXPECT_FALSE(test, via_connector_ddc_probe(con, bus));
+	KUNIT_EXPECT_FALSE(test, via_connector_ddc_probe(con, bus));
+	KUNIT_EXPECT_EQ(test, priv->ddc->xfers, 2);
+
+	priv->ddc->present = true;
+	KUNIT_EXPECT_TRUE(test, via_connector_ddc_probe(con, bus));
+	KUNIT_EXPECT_NULL(test, con->edid_cache.absent_bus);
+	KUNIT_EXPECT_EQ(test, priv->ddc->xfers, 3);
+}
+
+/* A change of the sense forgets the empty bus and the cached EDID. */
+static void via_connector_test_probe_sense_change(struct kunit *test)
+{
+	struct via_connector_test *priv = test->priv;
+	struct via_connector *con = priv->con;
+	struct i2c_adapter *bus = &priv->ddc->adapter;
+
+	via_connector_hotplug_sense(con, true);
+	via_connector_test_get(test);
+	KUNIT_EXPECT_NOT_NULL(test, con->edid_cache.edid);
+
+	via_connector_hotplug_sense(con, false);
+	KUNIT_EXPECT_NULL(test, con->edid_cache.edid);
+	priv->ddc->present = false;
+	KUNIT_EXPECT_FALSE(test, via_connector_ddc_probe(con, bus));
+	KUNIT_EXPECT_PTR_EQ(test, con->edid_cache.absent_bus, bus);
+
+	/* The same sense again changes nothing. */
+	via_connector_hotplug_sense(con, false);
+	KUNIT_EXPECT_PTR_EQ(test, con->edid_cache.absent_bus, bus);
+
+	via_connector_hotplug_sense(con, true);
+	KUNIT_EXPECT_NULL(test, con->edid_cache.absent_bus);
+}
+
+static struct kunit_case via_connector_test_cases[] = {
+	KUNIT_CASE(via_connector_test_hit),
+	KUNIT_CASE(via_connector_test_miss_identity),
+	KUNIT_CASE(via_connector_test_miss_extension),
+	KUNIT_CASE(via_connector_test_invalidate),
+	KUNIT_CASE(via_connector_test_unplug),
+	KUNIT_CASE(via_connector_test_probe_sense_off),
+	KUNIT_CASE(via_connector_test_probe_sense_on),
+	KUNIT_CASE(via_connector_test_probe_sense_change),
+	{}
+};
+
+static struct kunit_suite via_connector_test_suite = {
+	.name = "via_connector",
+	.init = via_connector_test_init,
+	.test_cases = via_connector_test_cases,
+};
+
+kunit_test_suite(via_connector_test_suite);
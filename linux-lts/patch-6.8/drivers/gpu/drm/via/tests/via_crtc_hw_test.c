@@ -0,0 +1,219 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_crtc_hw.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * The register file is simulated with plain memory standing in for
+ * the VGA window. A port only holds the last byte written to it, so
+ * the tests put the value the "hardware" returns into the data port
+ * before an access, and look at the data port afterwards to see what
+ * went out.
+ */
+
+#include <kunit/test.h>
+
+#define VIA_TEST_VGA_WINDOW	0x400
+
+struct via_vga_shadow_test {
+	struct via_vga_shadow shadow;
+	u8 *window;
+};
+
+static int via_vga_shadow_test_init(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv;
+
+	priv = kunit_kzalloc(test, sizeof(*priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv);
+
+	priv->window = kunit_kzalloc(test, VIA_TEST_VGA_WINDOW, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv->window);
+
+	via_vga_shadow_init(&priv->shadow,
+				(void __iomem __force *)priv->window);
+	test->priv = priv;
+	return 0;
+}
+
+/* The first masked write reads the register, later ones do not. */
+static void via_vga_shadow_test_masked_write(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->shadow;
+
+	priv->window[VGA_CRT_DC] = 0xA5;
+	svga_wcrt_mask(shadow, 0x33, 0x0F, 0x0F);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_CRT_IC], 0x33);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_CRT_DC], 0xAF);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 1);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 1);
+
+	/* A read back would now see 0x00 and lose the upper nibble. */
+	priv->window[VGA_CRT_DC] = 0x00;
+	svga_wcrt_mask(shadow, 0x33, 0x10, 0xF0);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_CRT_DC], 0x1F);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 1);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads_avoided, 1);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 2);
+
+	KUNIT_EXPECT_EQ(test, via_vga_rcrt(shadow, 0x33), 0x1F);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 1);
+}
+
+/* Writing the value a register already holds is dropped. */
+static void via_vga_shadow_test_unchanged_write(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->shadow;
+
+	via_vga_wseq(shadow, 0x15, 0x22);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_SEQ_D], 0x22);
+
+	priv->window[VGA_SEQ_D] = 0xEE;
+	via_vga_wseq(shadow, 0x15, 0x22);
+	svga_wseq_mask(shadow, 0x15, 0x02, 0x02);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_SEQ_D], 0xEE);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 1);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes_avoided, 2);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 0);
+}
+
+/* Volatile registers always go to the hardware. */
+static void via_vga_shadow_test_volatile(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->shadow;
+
+	priv->window[VGA_SEQ_D] = 0x01;
+	KUNIT_EXPECT_EQ(test, via_vga_rseq(shadow, 0x3C), 0x01);
+	priv->window[VGA_SEQ_D] = 0x02;
+	KUNIT_EXPECT_EQ(test, via_vga_rseq(shadow, 0x3C), 0x02);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 2);
+
+	via_vga_wseq(shadow, 0x26, 0x31);
+	via_vga_wseq(shadow, 0x26, 0x31);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 2);
+
+	priv->window[VGA_SEQ_D] = 0x80;
+	svga_wseq_mask(shadow, 0x26, 0x01, 0x01);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_SEQ_D], 0x81);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 3);
+
+	/* The BIOS scratch pad registers are CRT ones. */
+	priv->window[VGA_CRT_DC] = 0x04;
+	KUNIT_EXPECT_EQ(test, via_vga_rcrt(shadow, 0x3b), 0x04);
+	priv->window[VGA_CRT_DC] = 0x05;
+	KUNIT_EXPECT_EQ(test, via_vga_rcrt(shadow, 0x3b), 0x05);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 5);
+}
+
+/* The banks are kept apart, and invalidation forces a read back. */
+static void via_vga_shadow_test_invalidate(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->shadow;
+
+	via_vga_wseq(shadow, 0x40, 0x11);
+	via_vga_wcrt(shadow, 0x40, 0x22);
+	KUNIT_EXPECT_EQ(test, via_vga_rseq(shadow, 0x40), 0x11);
+	KUNIT_EXPECT_EQ(test, via_vga_rcrt(shadow, 0x40), 0x22);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 0);
+
+	via_vga_shadow_invalidate(shadow);
+	priv->window[VGA_CRT_DC] = 0x33;
+	KUNIT_EXPECT_EQ(test, via_vga_rcrt(shadow, 0x40), 0x33);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 1);
+}
+
+/*
+ * CRFD switches which register the IGA2 timing indexes reach, so the
+ * same value written under each CRFD setting must reach both, and a
+ * masked write must not merge in bits from the other one.
+ */
+static void via_vga_shadow_test_crfd(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->shadow;
+
+	via_vga_wcrt(shadow, 0xfd, 0x00);
+	via_vga_wcrt(shadow, 0x50, 0x42);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 2);
+
+	via_vga_wcrt(shadow, 0xfd, BIT(0));
+	priv->window[VGA_CRT_DC] = 0x00;
+	via_vga_wcrt(shadow, 0x50, 0x42);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_CRT_IC], 0x50);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_CRT_DC], 0x42);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 4);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes_avoided, 0);
+
+	/* The other register is read back, not taken from the shadow. */
+	via_vga_wcrt(shadow, 0xfd, 0x00);
+	priv->window[VGA_CRT_DC] = 0x80;
+	svga_wcrt_mask(shadow, 0x50, 0x01, 0x0F);
+	KUNIT_EXPECT_EQ(test, priv->window[VGA_CRT_DC], 0x81);
+	KUNIT_EXPECT_EQ(test, shadow->total.reads, 1);
+
+	/* CRFD itself stays cached. */
+	via_vga_wcrt(shadow, 0xfd, 0x00);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes_avoided, 1);
+}
+
+/* The per commit counters restart after every report. */
+static void via_vga_shadow_test_report(struct kunit *test)
+{
+	struct via_vga_shadow_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->shadow;
+
+	via_vga_wcrt(shadow, 0x11, 0x00);
+	via_vga_wcrt(shadow, 0x11, 0x00);
+	KUNIT_EXPECT_EQ(test, shadow->commit.writes, 1);
+	KUNIT_EXPECT_EQ(test, shadow->commit.writes_avoided, 1);
+
+	via_vga_shadow_report(NULL, shadow);
+	KUNIT_EXPECT_EQ(test, shadow->commit.writes, 0);
+	KUNIT_EXPECT_EQ(test, shadow->commit.writes_avoided, 0);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 1);
+}
+
+static struct kunit_case via_vga_shadow_test_cases[] = {
+	KUNIT_CASE(via_vga_shadow_test_masked_write),
+	KUNIT_CASE(via_vga_shadow_test_unchanged_write),
+	KUNIT_CASE(via_vga_shadow_test_volatile),
+	KUNIT_CASE(via_vga_shadow_test_invalidate),
+	KUNIT_CASE(via_vga_shadow_test_crfd),
+	KUNIT_CASE(via_vga_shadow_test_report),
+	{}
+};
+
+static struct kunit_suite via_vga_shadow_test_suite = {
+	.name = "via_vga_shadow",
+	.init = via_vga_shadow_test_init,
+	.test_cases = via_vga_shadow_test_cases,
+};
+
+kunit_test_suite(via_vga_shadow_test_suite);
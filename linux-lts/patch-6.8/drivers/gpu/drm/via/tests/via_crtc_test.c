@@ -0,0 +1,423 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_crtc.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * Loads the CRTC timings of a few common modes into two memory backed
+ * VGA shadows, once a table at a time the way the driver used to, and
+ * once through the compiled register program. Both must leave the
+ * same register contents behind, and the access counts of the two are
+ * reported so the saving per mode set can be followed over time.
+ * The IGA2 load is also repeated under both CRFD settings.
+ *
+ * The register queue is run against memory backed MMIO, where a
+ * register only keeps the last value written to it. The VGA index
+ * port keeps the last index, which tells which entry went out last.
+ */
+
+#include <kunit/test.h>
+
+#define VIA_CRTC_TEST_VGA_WINDOW	0x400
+
+static const struct drm_display_mode via_crtc_test_modes[] = {
+	/* 640x480@60Hz, DMT */
+	{ DRM_MODE("640x480", DRM_MODE_TYPE_DRIVER, 25175, 640, 656,
+		   752, 800, 0, 480, 490, 492, 525, 0,
+		   DRM_MODE_FLAG_NHSYNC | DRM_MODE_FLAG_NVSYNC) },
+	/* 1024x768@60Hz, DMT */
+	{ DRM_MODE("1024x768", DRM_MODE_TYPE_DRIVER, 65000, 1024, 1048,
+		   1184, 1344, 0, 768, 771, 777, 806, 0,
+		   DRM_MODE_FLAG_NHSYNC | DRM_MODE_FLAG_NVSYNC) },
+	/* 1920x1080@60Hz, CEA VIC 16 */
+	{ DRM_MODE("1920x1080", DRM_MODE_TYPE_DRIVER, 148500, 1920, 2008,
+		   2052, 2200, 0, 1080, 1084, 1089, 1125, 0,
+		   DRM_MODE_FLAG_PHSYNC | DRM_MODE_FLAG_PVSYNC) },
+};
+
+#define VIA_CRTC_TEST_FIELD(timings, field, table)		\
+	do {							\
+		(timings)->field.count = ARRAY_SIZE(table);	\
+		(timings)->field.regs = table;			\
+	} while (0)
+
+/* Timing tables as set up for VX900, which uses every entry */
+static void via_crtc_test_timings(uint32_t index,
+					struct crtc_timings *timings)
+{
+	if (index) {
+		VIA_CRTC_TEST_FIELD(timings, htotal, iga2_hor_total);
+		VIA_CRTC_TEST_FIELD(timings, hdisplay, iga2_hor_addr);
+		VIA_CRTC_TEST_FIELD(timings, hblank_start,
+					iga2_hor_blank_start);
+		VIA_CRTC_TEST_FIELD(timings, hblank_end, iga2_hor_blank_end);
+		VIA_CRTC_TEST_FIELD(timings, hsync_start, iga2_hor_sync_start);
+		VIA_CRTC_TEST_FIELD(timings, hsync_end, iga2_hor_sync_end);
+		VIA_CRTC_TEST_FIELD(timings, vtotal, iga2_ver_total);
+		VIA_CRTC_TEST_FIELD(timings, vdisplay, iga2_ver_addr);
+		VIA_CRTC_TEST_FIELD(timings, vblank_start,
+					iga2_ver_blank_start);
+		VIA_CRTC_TEST_FIELD(timings, vblank_end, iga2_ver_blank_end);
+		VIA_CRTC_TEST_FIELD(timings, vsync_start, iga2_ver_sync_start);
+		VIA_CRTC_TEST_FIELD(timings, vsync_end, iga2_ver_sync_end);
+	} else {
+		VIA_CRTC_TEST_FIELD(timings, htotal, iga1_hor_total);
+		VIA_CRTC_TEST_FIELD(timings, hdisplay, iga1_hor_addr);
+		VIA_CRTC_TEST_FIELD(timings, hblank_start,
+					iga1_hor_blank_start);
+		VIA_CRTC_TEST_FIELD(timings, hblank_end, iga1_hor_blank_end);
+		VIA_CRTC_TEST_FIELD(timings, hsync_start, iga1_hor_sync_start);
+		VIA_CRTC_TEST_FIELD(timings, hsync_end, iga1_hor_sync_end);
+		VIA_CRTC_TEST_FIELD(timings, vtotal, iga1_ver_total);
+		VIA_CRTC_TEST_FIELD(timings, vdisplay, iga1_ver_addr);
+		VIA_CRTC_TEST_FIELD(timings, vblank_start,
+					iga1_ver_blank_start);
+		VIA_CRTC_TEST_FIELD(timings, vblank_end, iga1_ver_blank_end);
+		VIA_CRTC_TEST_FIELD(timings, vsync_start, iga1_ver_sync_start);
+		VIA_CRTC_TEST_FIELD(timings, vsync_end, iga1_ver_sync_end);
+	}
+}
+
+/*
+ * The CRT registers start out known and cleared, so neither load
+ * depends on what a cold read of the simulated window returns.
+ */
+static struct via_vga_shadow *via_crtc_test_shadow(struct kunit *test)
+{
+	struct via_vga_shadow *shadow;
+	u8 *window;
+
+	shadow = kunit_kzalloc(test, sizeof(*shadow), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, shadow);
+
+	window = kunit_kzalloc(test, VIA_CRTC_TEST_VGA_WINDOW, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, window);
+
+	via_vga_shadow_init(shadow, (void __iomem __force *)window);
+	bitmap_fill(shadow->valid[VIA_VGA_SHADOW_CRT], VIA_VGA_SHADOW_REGS);
+	return shadow;
+}
+
+static void via_crtc_test_timing_load(struct kunit *test, uint32_t index)
+{
+	struct vga_registers *fields[VIA_TIMING_NUM_FIELDS];
+	struct via_vga_shadow *per_table, *compiled;
+	struct via_vga_shadow_stats table_stats;
+	struct via_reg_program *prog;
+	struct crtc_timings timings;
+	struct drm_display_mode mode;
+	u32 values[VIA_TIMING_NUM_FIELDS];
+	unsigned int entries = 0, partial = 0;
+	unsigned int i, j;
+
+	prog = kunit_kzalloc(test, sizeof(*prog), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, prog);
+
+	via_crtc_test_timings(index, &timings);
+	via_crtc_timing_fields(&timings, fields);
+	KUNIT_ASSERT_EQ(test, via_reg_program_compile(prog, fields,
+						VIA_TIMING_NUM_FIELDS), 0);
+
+	for (i = 0; i < VIA_TIMING_NUM_FIELDS; i++) {
+		entries += fields[i]->count;
+	}
+
+	for (i = 0; i < prog->num_ops; i++) {
+		if (prog->ops[i].mask != 0xff) {
+			partial++;
+		}
+	}
+
+	/* Several fields share the overflow registers. */
+	KUNIT_EXPECT_LT(test, prog->num_ops, entries);
+
+	for (i = 0; i < ARRAY_SIZE(via_crtc_test_modes); i++) {
+		mode = via_crtc_test_modes[i];
+		drm_mode_set_crtcinfo(&mode, 0);
+		via_crtc_timing_values(index, &mode, values);
+
+		per_table = via_crtc_test_shadow(test);
+		compiled = via_crtc_test_shadow(test);
+
+		for (j = 0; j < VIA_TIMING_NUM_FIELDS; j++) {
+			load_value_to_registers(per_table, fields[j],
+						values[j]);
+		}
+
+		via_reg_program_load(compiled, prog, values);
+
+		KUNIT_EXPECT_MEMEQ(test,
+				per_table->regs[VIA_VGA_SHADOW_CRT],
+				compiled->regs[VIA_VGA_SHADOW_CRT],
+				VIA_VGA_SHADOW_REGS);
+
+		/* One masked write per table entry before. */
+		table_stats = per_table->total;
+		KUNIT_EXPECT_EQ(test, table_stats.writes +
+					table_stats.writes_avoided, entries);
+
+		/* One masked write per physical register now. */
+		KUNIT_EXPECT_EQ(test, compiled->total.writes +
+					compiled->total.writes_avoided,
+					prog->num_ops);
+		KUNIT_EXPECT_EQ(test, compiled->total.reads +
+					compiled->total.reads_avoided,
+					partial);
+
+		kunit_info(test, "IGA%u %s: per table %llu writes / %llu reads, "
+				"compiled %llu writes / %llu reads\n",
+				index + 1, mode.name,
+				table_stats.writes + table_stats.writes_avoided,
+				table_stats.reads + table_stats.reads_avoided,
+				compiled->total.writes +
+					compiled->total.writes_avoided,
+				compiled->total.reads +
+					compiled->total.reads_avoided);
+
+		/* Setting the same mode again must not reach the hardware. */
+		table_stats = compiled->total;
+		via_reg_program_load(compiled, prog, values);
+		KUNIT_EXPECT_EQ(test, compiled->total.writes,
+				table_stats.writes);
+		KUNIT_EXPECT_EQ(test, compiled->total.reads,
+				table_stats.reads);
+	}
+}
+
+static void via_crtc_test_iga1_timing_load(struct kunit *test)
+{
+	via_crtc_test_timing_load(test, 0);
+}
+
+static void via_crtc_test_iga2_timing_load(struct kunit *test)
+{
+	via_crtc_test_timing_load(test, 1);
+}
+
+/*
+ * The IGA2 downscaling path loads the source timing, switches CRFD
+ * to the downscaling registers, and loads the destination timing
+ * through the same indexes. Even when both timings are the same, the
+ * second load must reach every register again.
+ */
+static void via_crtc_test_iga2_two_bank_load(struct kunit *test)
+{
+	struct vga_registers *fields[VIA_TIMING_NUM_FIELDS];
+	struct via_vga_shadow_stats before;
+	struct via_vga_shadow *shadow;
+	struct via_reg_program *prog;
+	struct crtc_timings timings;
+	struct drm_display_mode mode;
+	u32 values[VIA_TIMING_NUM_FIELDS];
+	unsigned int partial = 0, i;
+
+	prog = kunit_kzalloc(test, sizeof(*prog), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, prog);
+
+	via_crtc_test_timings(1, &timings);
+	via_crtc_timing_fields(&timings, fields);
+	KUNIT_ASSERT_EQ(test, via_reg_program_compile(prog, fields,
+						VIA_TIMING_NUM_FIELDS), 0);
+
+	for (i = 0; i < prog->num_ops; i++) {
+		if (prog->ops[i].mask != 0xff) {
+			partial++;
+		}
+	}
+
+	mode = via_crtc_test_modes[1];
+	drm_mode_set_crtcinfo(&mode, 0);
+	via_crtc_timing_values(1, &mode, values);
+
+	shadow = via_crtc_test_shadow(test);
+	via_reg_program_load(shadow, prog, values);
+
+	for (i = 0; i < 2; i++) {
+		via_vga_wcrt(shadow, 0xfd, i ? 0x00 : BIT(0));
+
+		before = shadow->total;
+		via_reg_program_load(shadow, prog, values);
+		KUNIT_EXPECT_EQ(test, shadow->total.writes - before.writes,
+				prog->num_ops);
+		KUNIT_EXPECT_EQ(test, shadow->total.writes_avoided,
+				before.writes_avoided);
+
+		/* Masked writes read the other register back. */
+		KUNIT_EXPECT_EQ(test, shadow->total.reads - before.reads,
+				partial);
+	}
+}
+
+/* The VGA window sits at VIA_MMIO_VGABASE, past every MMIO register. */
+#define VIA_CRTC_TEST_MMIO_SIZE	(VIA_MMIO_VGABASE + \
+					VIA_CRTC_TEST_VGA_WINDOW)
+
+/* MMIO registers the queue tests write to */
+#define VIA_CRTC_TEST_MMIO_REG(i)	(0x100 + ((i) * 4))
+
+struct via_crtc_test_queue {
+	struct via_drm_priv *dev_priv;
+	struct via_crtc iga;
+	u8 *mmio;
+};
+
+static struct via_crtc_test_queue *via_crtc_test_queue_alloc(
+						struct kunit *test)
+{
+	struct via_crtc_test_queue *priv;
+	struct via_drm_priv *dev_priv;
+
+	priv = kunit_kzalloc(test, sizeof(*priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv);
+
+	dev_priv = kunit_kzalloc(test, sizeof(*dev_priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, dev_priv);
+
+	priv->mmio = kunit_kzalloc(test, VIA_CRTC_TEST_MMIO_SIZE,
+					GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv->mmio);
+
+	dev_priv->mmio = (void __iomem __force *)priv->mmio;
+	via_vga_shadow_init(VGASHADOW, VGABASE);
+	bitmap_fill(VGASHADOW->valid[VIA_VGA_SHADOW_CRT],
+			VIA_VGA_SHADOW_REGS);
+
+	priv->iga.base.dev = &dev_priv->dev;
+	priv->iga.queue.open = true;
+	priv->dev_priv = dev_priv;
+	return priv;
+}
+
+static u32 via_crtc_test_mmio(struct via_crtc_test_queue *priv,
+				unsigned int i)
+{
+	return *(u32 *)(priv->mmio + VIA_CRTC_TEST_MMIO_REG(i));
+}
+
+/* A second write to a queued register is merged into its entry. */
+static void via_crtc_test_queue_fold(struct kunit *test)
+{
+	struct via_crtc_test_queue *priv = via_crtc_test_queue_alloc(test);
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	struct via_reg_queue *queue = &priv->iga.queue;
+
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x50, 0x0F, 0x0F);
+	via_reg_queue_mmio(&priv->iga, VIA_CRTC_TEST_MMIO_REG(0),
+				0x12345678, 0xFFFFFFFF);
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x50, 0x30, 0xF0);
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x50, 0x00, 0x03);
+	KUNIT_EXPECT_EQ(test, queue->count, 2);
+	KUNIT_EXPECT_EQ(test, queue->entries[0].data, 0x3C);
+	KUNIT_EXPECT_EQ(test, queue->entries[0].mask, 0xFF);
+
+	/* Nothing reaches the hardware before the flush. */
+	KUNIT_EXPECT_EQ(test, VGASHADOW->total.writes, 0);
+	KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, 0), 0);
+
+	via_reg_queue_write_out(&priv->iga);
+	KUNIT_EXPECT_EQ(test, queue->count, 0);
+	KUNIT_EXPECT_EQ(test, VGASHADOW->regs[VIA_VGA_SHADOW_CRT][0x50],
+			0x3C);
+	KUNIT_EXPECT_EQ(test, VGASHADOW->total.writes, 1);
+	KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, 0), 0x12345678);
+}
+
+/* Entries go out in the order they were first queued. */
+static void via_crtc_test_queue_order(struct kunit *test)
+{
+	struct via_crtc_test_queue *priv = via_crtc_test_queue_alloc(test);
+
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x51, 0x01, 0xFF);
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x50, 0x02, 0xFF);
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x51, 0x03, 0xFF);
+	via_reg_queue_write_out(&priv->iga);
+	KUNIT_EXPECT_EQ(test, priv->mmio[VIA_MMIO_VGABASE + VGA_CRT_IC],
+			0x50);
+	KUNIT_EXPECT_EQ(test, priv->mmio[VIA_MMIO_VGABASE + VGA_CRT_DC],
+			0x02);
+
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x50, 0x04, 0xFF);
+	via_reg_queue_vga(&priv->iga, VGA_CRT_IC, 0x51, 0x05, 0xFF);
+	via_reg_queue_write_out(&priv->iga);
+	KUNIT_EXPECT_EQ(test, priv->mmio[VIA_MMIO_VGABASE + VGA_CRT_IC],
+			0x51);
+	KUNIT_EXPECT_EQ(test, priv->mmio[VIA_MMIO_VGABASE + VGA_CRT_DC],
+			0x05);
+}
+
+/*
+ * A full queue is written out before the next entry is taken, and
+ * a closed queue writes straight through.
+ */
+static void via_crtc_test_queue_overflow(struct kunit *test)
+{
+	struct via_crtc_test_queue *priv = via_crtc_test_queue_alloc(test);
+	struct via_reg_queue *queue = &priv->iga.queue;
+	unsigned int i;
+
+	for (i = 0; i < VIA_REG_QUEUE_SIZE; i++) {
+		via_reg_queue_mmio(&priv->iga, VIA_CRTC_TEST_MMIO_REG(i),
+					i + 1, 0xFFFFFFFF);
+	}
+
+	KUNIT_EXPECT_EQ(test, queue->count, VIA_REG_QUEUE_SIZE);
+	KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, 0), 0);
+
+	via_reg_queue_mmio(&priv->iga, VIA_CRTC_TEST_MMIO_REG(i),
+				i + 1, 0xFFFFFFFF);
+	KUNIT_EXPECT_EQ(test, queue->count, 1);
+	for (i = 0; i < VIA_REG_QUEUE_SIZE; i++) {
+		KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, i), i + 1);
+	}
+
+	KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, i), 0);
+
+	via_reg_queue_write_out(&priv->iga);
+	KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, i), i + 1);
+
+	queue->open = false;
+	via_reg_queue_mmio(&priv->iga, VIA_CRTC_TEST_MMIO_REG(0),
+				0xAA, 0xFFFFFFFF);
+	KUNIT_EXPECT_EQ(test, queue->count, 0);
+	KUNIT_EXPECT_EQ(test, via_crtc_test_mmio(priv, 0), 0xAA);
+}
+
+static struct kunit_case via_crtc_test_cases[] = {
+	KUNIT_CASE(via_crtc_test_iga1_timing_load),
+	KUNIT_CASE(via_crtc_test_iga2_timing_load),
+	KUNIT_CASE(via_crtc_test_iga2_two_bank_load),
+	KUNIT_CASE(via_crtc_test_queue_fold),
+	KUNIT_CASE(via_crtc_test_queue_order),
+	KUNIT_CASE(via_crtc_test_queue_overflow),
+	{}
+};
+
+static struct kunit_suite via_crtc_test_suite = {
+	.name = "via_crtc",
+	.test_cases = via_crtc_test_cases,
+};
+
+kunit_test_suite(via_crtc_test_suite);
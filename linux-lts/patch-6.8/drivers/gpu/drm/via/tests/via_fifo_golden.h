@@ -0,0 +1,819 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Golden display FIFO settings, shared by the via_fifo KUnit suite and
+ * the userspace harness in tools/testing/via.
+ *
+ * The chipsets whose settings depend on the mode are covered with
+ * every DMT and CEA-861 mode below on DDR200, DDR266 and DDR400, at
+ * 16 and 24 bit color depth, with no other load on the memory. The
+ * later chipsets use one setting for everything, and are listed once.
+ */
+
+#ifndef _VIA_FIFO_GOLDEN_H
+#define _VIA_FIFO_GOLDEN_H
+
+#define VIA_GOLDEN_CLE266_AX	PCI_DEVICE_ID_VIA_CLE266_GFX, CLE266_REVISION_AX
+#define VIA_GOLDEN_CLE266_CX	PCI_DEVICE_ID_VIA_CLE266_GFX, CLE266_REVISION_CX
+#define VIA_GOLDEN_KM400	PCI_DEVICE_ID_VIA_KM400_GFX, 0
+#define VIA_GOLDEN_K8M800	PCI_DEVICE_ID_VIA_K8M800_GFX, 0
+#define VIA_GOLDEN_PM800	PCI_DEVICE_ID_VIA_PM800_GFX, 0
+
+struct via_fifo_golden_mode {
+	const char	*name;
+	u32		hdisplay;
+	u32		vdisplay;
+	u32		clock;
+};
+
+static const struct via_fifo_golden_mode via_fifo_golden_modes[] = {
+	{ "640x480@60", 640, 480, 25175 },
+	{ "800x600@60", 800, 600, 40000 },
+	{ "1024x768@60", 1024, 768, 65000 },
+	{ "1280x720@60", 1280, 720, 74250 },
+	{ "1280x1024@60", 1280, 1024, 108000 },
+	{ "1366x768@60", 1366, 768, 85500 },
+	{ "1400x1050@60", 1400, 1050, 121750 },
+	{ "1440x900@60", 1440, 900, 106500 },
+	{ "1600x1200@60", 1600, 1200, 162000 },
+	{ "1680x1050@60", 1680, 1050, 119000 },
+	{ "1920x1080@60", 1920, 1080, 148500 },
+};
+
+struct via_fifo_golden_config {
+	u16	max_depth;
+	u16	threshold;
+	u16	high_threshold;
+	u16	display_queue_expire_num;
+	bool	extended;
+};
+
+/* mode is an index into via_fifo_golden_modes[]. */
+struct via_fifo_golden {
+	u16	device;
+	int	revision;
+	u8	vram_type;
+	u8	depth;
+	u8	mode;
+	struct via_fifo_golden_config iga1;
+	struct via_fifo_golden_config iga2;
+};
+
+static const struct via_fifo_golden via_fifo_golden_table[] = {
+	/* CLE266 AX */
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 0,
+	  { 64, 32, 56, 12, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 1,
+	  { 64, 32, 56, 12, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 2,
+	  { 64, 32, 56, 12, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 3,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 4,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 5,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 6,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 7,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 8,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 9,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 16, 10,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 1,
+	  { 64, 32, 56, 40, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 2,
+	  { 64, 32, 56, 40, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 3,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 4,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 5,
+	  { 96, 92, 92, 12, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 6,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 7,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 8,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 9,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_200, 24, 10,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 2,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 3,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 4,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 5,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 6,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 7,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 8,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 9,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 16, 10,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 2,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 3,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 4,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 5,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 6,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 7,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 8,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 9,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_266, 24, 10,
+	  { 96, 92, 92, 16, 1 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 2,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 3,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 4,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 5,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 6,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 7,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 8,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 9,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 16, 10,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 2,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 3,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 4,
+	  { 96, 92, 92, 12, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 5,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 6,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 7,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 8,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 9,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_AX, VIA_MEM_DDR_400, 24, 10,
+	  { 96, 92, 92, 16, 1 }, { 56, 28, 0, 0, 0 } },
+
+	/* CLE266 CX */
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 1,
+	  { 64, 32, 56, 40, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 2,
+	  { 128, 112, 92, 40, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 3,
+	  { 128, 112, 92, 12, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 4,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 5,
+	  { 128, 112, 92, 12, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 6,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 7,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 8,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 9,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 16, 10,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 1,
+	  { 64, 32, 56, 40, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 2,
+	  { 128, 112, 92, 40, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 3,
+	  { 128, 112, 92, 12, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 4,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 5,
+	  { 128, 112, 92, 12, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 6,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 7,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 8,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 9,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_200, 24, 10,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 2,
+	  { 128, 112, 92, 124, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 3,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 4,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 5,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 6,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 7,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 8,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 9,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 16, 10,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 2,
+	  { 128, 112, 92, 124, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 3,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 4,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 5,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 6,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 7,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 8,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 9,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_266, 24, 10,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 2,
+	  { 128, 112, 92, 124, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 3,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 4,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 5,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 6,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 7,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 8,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 9,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 16, 10,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 0,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 1,
+	  { 64, 32, 56, 124, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 2,
+	  { 128, 112, 92, 124, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 3,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 4,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 5,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 6,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 7,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 8,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 9,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+	{ VIA_GOLDEN_CLE266_CX, VIA_MEM_DDR_400, 24, 10,
+	  { 128, 112, 92, 16, 0 }, { 88, 44, 0, 0, 0 } },
+
+	/* KM400 */
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 0,
+	  { 128, 112, 92, 8, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 1,
+	  { 128, 112, 92, 8, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 2,
+	  { 128, 112, 92, 8, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 3,
+	  { 128, 112, 92, 8, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 4,
+	  { 128, 112, 92, 8, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 5,
+	  { 128, 112, 92, 8, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 6,
+	  { 128, 112, 92, 8, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 7,
+	  { 128, 112, 92, 8, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 8,
+	  { 58, 24, 92, 16, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 9,
+	  { 58, 24, 92, 16, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 16, 10,
+	  { 58, 24, 92, 16, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 0,
+	  { 128, 112, 92, 8, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 1,
+	  { 128, 112, 92, 8, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 2,
+	  { 128, 112, 92, 8, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 3,
+	  { 128, 112, 92, 8, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 4,
+	  { 128, 112, 92, 8, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 5,
+	  { 128, 112, 92, 8, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 6,
+	  { 128, 112, 92, 8, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 7,
+	  { 128, 112, 92, 8, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 8,
+	  { 58, 24, 92, 16, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 9,
+	  { 58, 24, 92, 16, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_200, 24, 10,
+	  { 58, 24, 92, 16, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 0,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 1,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 2,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 3,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 4,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 5,
+	  { 128, 112, 92, 36, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 6,
+	  { 128, 112, 92, 36, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 7,
+	  { 128, 112, 92, 36, 0 }, { 88, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 8,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 9,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 16, 10,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 0,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 1,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 2,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 3,
+	  { 128, 112, 92, 36, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 4,
+	  { 128, 112, 92, 36, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 5,
+	  { 128, 112, 92, 36, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 6,
+	  { 128, 112, 92, 36, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 7,
+	  { 128, 112, 92, 36, 0 }, { 104, 28, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 8,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 9,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_266, 24, 10,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 0,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 1,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 2,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 3,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 4,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 5,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 6,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 7,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 8,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 9,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 16, 10,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 0,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 1,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 2,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 3,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 4,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 5,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 6,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 7,
+	  { 128, 112, 92, 36, 0 }, { 56, 28, 0, 0, 0 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 8,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 9,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+	{ VIA_GOLDEN_KM400, VIA_MEM_DDR_400, 24, 10,
+	  { 128, 112, 92, 40, 0 }, { 120, 44, 0, 0, 1 } },
+
+	/* K8M800 */
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 0,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 1,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 2,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 3,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 4,
+	  { 384, 328, 296, 104, 0 }, { 376, 328, 296, 104, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 5,
+	  { 384, 328, 296, 124, 0 }, { 376, 328, 296, 124, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 6,
+	  { 384, 328, 296, 92, 0 }, { 376, 328, 296, 92, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 7,
+	  { 384, 328, 296, 104, 0 }, { 376, 328, 296, 104, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 8,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 9,
+	  { 384, 328, 296, 96, 0 }, { 376, 328, 296, 96, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 16, 10,
+	  { 384, 328, 296, 72, 0 }, { 376, 328, 296, 72, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 0,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 1,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 2,
+	  { 384, 328, 296, 84, 0 }, { 376, 328, 296, 84, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 3,
+	  { 384, 328, 296, 72, 0 }, { 376, 328, 296, 72, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 4,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 5,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 6,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 7,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 8,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 9,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_200, 24, 10,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 0,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 1,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 2,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 3,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 4,
+	  { 384, 328, 296, 124, 0 }, { 376, 328, 296, 124, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 5,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 6,
+	  { 384, 328, 296, 116, 0 }, { 376, 328, 296, 116, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 7,
+	  { 384, 328, 296, 124, 0 }, { 376, 328, 296, 124, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 8,
+	  { 384, 328, 296, 92, 0 }, { 376, 328, 296, 92, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 9,
+	  { 384, 328, 296, 116, 0 }, { 376, 328, 296, 116, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 16, 10,
+	  { 384, 328, 296, 104, 0 }, { 376, 328, 296, 104, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 0,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 1,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 2,
+	  { 384, 328, 296, 112, 0 }, { 376, 328, 296, 112, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 3,
+	  { 384, 328, 296, 104, 0 }, { 376, 328, 296, 104, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 4,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 5,
+	  { 384, 328, 296, 84, 0 }, { 376, 328, 296, 84, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 6,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 7,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 8,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 9,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_266, 24, 10,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 0,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 1,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 2,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 3,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 4,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 5,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 6,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 7,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 8,
+	  { 384, 328, 296, 124, 0 }, { 376, 328, 296, 124, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 9,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 16, 10,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 0,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 1,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 2,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 3,
+	  { 384, 328, 296, 128, 0 }, { 376, 328, 296, 128, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 4,
+	  { 384, 328, 296, 104, 0 }, { 376, 328, 296, 104, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 5,
+	  { 384, 328, 296, 124, 0 }, { 376, 328, 296, 124, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 6,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 7,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 8,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 9,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+	{ VIA_GOLDEN_K8M800, VIA_MEM_DDR_400, 24, 10,
+	  { 384, 328, 296, 64, 0 }, { 376, 328, 296, 64, 0 } },
+
+	/* PM800 */
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 0,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 1,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 2,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 3,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 4,
+	  { 192, 128, 64, 100, 0 }, { 96, 64, 32, 100, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 5,
+	  { 192, 128, 64, 120, 0 }, { 96, 64, 32, 120, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 6,
+	  { 192, 128, 64, 88, 0 }, { 96, 64, 32, 88, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 7,
+	  { 192, 128, 64, 100, 0 }, { 96, 64, 32, 100, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 8,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 9,
+	  { 192, 128, 64, 96, 0 }, { 96, 64, 32, 96, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 16, 10,
+	  { 192, 128, 64, 72, 0 }, { 96, 64, 32, 72, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 0,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 1,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 2,
+	  { 192, 128, 64, 84, 0 }, { 96, 64, 32, 84, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 3,
+	  { 192, 128, 64, 72, 0 }, { 96, 64, 32, 72, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 4,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 5,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 6,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 7,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 8,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 9,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_200, 24, 10,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 0,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 1,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 2,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 3,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 4,
+	  { 192, 128, 64, 120, 0 }, { 96, 64, 32, 120, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 5,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 6,
+	  { 192, 128, 64, 112, 0 }, { 96, 64, 32, 112, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 7,
+	  { 192, 128, 64, 120, 0 }, { 96, 64, 32, 120, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 8,
+	  { 192, 128, 64, 88, 0 }, { 96, 64, 32, 88, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 9,
+	  { 192, 128, 64, 112, 0 }, { 96, 64, 32, 112, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 16, 10,
+	  { 192, 128, 64, 100, 0 }, { 96, 64, 32, 100, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 0,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 1,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 2,
+	  { 192, 128, 64, 108, 0 }, { 96, 64, 32, 108, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 3,
+	  { 192, 128, 64, 100, 0 }, { 96, 64, 32, 100, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 4,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 5,
+	  { 192, 128, 64, 84, 0 }, { 96, 64, 32, 84, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 6,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 7,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 8,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 9,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_266, 24, 10,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 0,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 1,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 2,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 3,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 4,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 5,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 6,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 7,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 8,
+	  { 192, 128, 64, 120, 0 }, { 96, 64, 32, 120, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 9,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 16, 10,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 0,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 1,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 2,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 3,
+	  { 192, 128, 64, 124, 0 }, { 96, 64, 32, 124, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 4,
+	  { 192, 128, 64, 100, 0 }, { 96, 64, 32, 100, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 5,
+	  { 192, 128, 64, 120, 0 }, { 96, 64, 32, 120, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 6,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 7,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 8,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 9,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+	{ VIA_GOLDEN_PM800, VIA_MEM_DDR_400, 24, 10,
+	  { 192, 128, 64, 64, 0 }, { 96, 64, 32, 64, 0 } },
+};
+
+struct via_fifo_golden_fixed {
+	u16	device;
+	struct via_fifo_golden_config iga1;
+	struct via_fifo_golden_config iga2;
+};
+
+static const struct via_fifo_golden_fixed via_fifo_golden_fixed_table[] = {
+	{
+		PCI_DEVICE_ID_VIA_P4M800_PRO_GFX,
+		{ 96, 80, 64, 128, 0 },
+		{ 96, 80, 32, 128, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_UNICHROME_PRO_II,
+		{ 192, 128, 128, 124, 0 },
+		{ 96, 64, 32, 128, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_CHROME9,
+		{ 360, 328, 296, 124, 0 },
+		{ 360, 328, 296, 124, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_P4M890_GFX,
+		{ 96, 76, 64, 32, 0 },
+		{ 96, 76, 64, 32, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_CHROME9_HC,
+		{ 96, 76, 76, 32, 0 },
+		{ 96, 76, 76, 32, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_CHROME9_HC3,
+		{ 192, 152, 152, 64, 0 },
+		{ 96, 64, 32, 128, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_CHROME9_HCM,
+		{ 400, 320, 320, 160, 0 },
+		{ 200, 160, 160, 320, 0 },
+	},
+	{
+		PCI_DEVICE_ID_VIA_CHROME9_HD,
+		{ 400, 320, 320, 160, 0 },
+		{ 192, 160, 160, 320, 0 },
+	},
+};
+
+static inline bool
+via_fifo_golden_equal(const struct via_fifo_golden_config *golden,
+			const struct via_fifo_params *fifo)
+{
+	return (fifo->max_depth == golden->max_depth) &&
+		(fifo->threshold == golden->threshold) &&
+		(fifo->high_threshold == golden->high_threshold) &&
+		(fifo->display_queue_expire_num ==
+			golden->display_queue_expire_num) &&
+		(fifo->extended == golden->extended);
+}
+
+#endif /* _VIA_FIFO_GOLDEN_H */
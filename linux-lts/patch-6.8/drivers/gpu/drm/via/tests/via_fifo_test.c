@@ -0,0 +1,260 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_fifo.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * The display FIFO settings picked for the DMT and CEA-861 modes are
+ * checked against the golden tables, and the descriptor tables
+ * themselves are checked for rows that could never be reached or
+ * would interpolate the wrong way.
+ */
+
+#include <kunit/test.h>
+
+#include "via_fifo_golden.h"
+
+static const u8 via_fifo_test_vram_types[] = {
+	VIA_MEM_DDR_200,
+	VIA_MEM_DDR_400,
+	VIA_MEM_DDR2_800,
+	VIA_MEM_DDR3_1600,
+};
+
+static void via_fifo_test_load(struct via_fifo_load *load,
+				const struct via_fifo_golden_mode *mode,
+				u8 vram_type, u32 depth, u32 other_load)
+{
+	load->vram_type = vram_type;
+	load->hdisplay = mode->hdisplay;
+	load->vdisplay = mode->vdisplay;
+	load->depth = depth;
+	load->clock = mode->clock;
+	load->cpp = (depth > 16) ? 4 : 2;
+	load->other_load = other_load;
+}
+
+static void via_fifo_test_expect(struct kunit *test,
+				const struct via_fifo_golden_config *golden,
+				const struct via_fifo_params *fifo,
+				u16 device, unsigned int iga,
+				const struct via_fifo_load *load)
+{
+	KUNIT_EXPECT_TRUE_MSG(test, via_fifo_golden_equal(golden, fifo),
+		"device 0x%04x IGA%u, %ux%u depth %u vram %u: got %u/%u/%u/%u/%d, expected %u/%u/%u/%u/%d",
+		device, iga, load->hdisplay, load->vdisplay, load->depth,
+		load->vram_type, fifo->max_depth, fifo->threshold,
+		fifo->high_threshold, fifo->display_queue_expire_num,
+		fifo->extended, golden->max_depth, golden->threshold,
+		golden->high_threshold, golden->display_queue_expire_num,
+		golden->extended);
+}
+
+static void via_fifo_test_golden(struct kunit *test)
+{
+	const struct via_fifo_golden *golden;
+	struct via_fifo_params fifo;
+	struct via_fifo_load load;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(via_fifo_golden_table); i++) {
+		golden = &via_fifo_golden_table[i];
+		via_fifo_test_load(&load,
+				&via_fifo_golden_modes[golden->mode],
+				golden->vram_type, golden->depth, 0);
+
+		KUNIT_ASSERT_EQ(test, via_iga1_fifo_params(golden->device,
+					golden->revision, &load, &fifo), 0);
+		via_fifo_test_expect(test, &golden->iga1, &fifo,
+					golden->device, 1, &load);
+
+		KUNIT_ASSERT_EQ(test, via_iga2_fifo_params(golden->device,
+					golden->revision, &load, &fifo), 0);
+		via_fifo_test_expect(test, &golden->iga2, &fifo,
+					golden->device, 2, &load);
+	}
+}
+
+static void via_fifo_test_fixed_load(struct kunit *test,
+				const struct via_fifo_golden_fixed *golden,
+				const struct via_fifo_load *load)
+{
+	struct via_fifo_params fifo;
+
+	KUNIT_ASSERT_EQ(test, via_iga1_fifo_params(golden->device, 0,
+							load, &fifo), 0);
+	via_fifo_test_expect(test, &golden->iga1, &fifo,
+				golden->device, 1, load);
+
+	KUNIT_ASSERT_EQ(test, via_iga2_fifo_params(golden->device, 0,
+							load, &fifo), 0);
+	via_fifo_test_expect(test, &golden->iga2, &fifo,
+				golden->device, 2, load);
+}
+
+/* The later chipsets must not care about the mode or the load. */
+static void via_fifo_test_fixed(struct kunit *test)
+{
+	const struct via_fifo_golden_fixed *golden;
+	const struct via_fifo_golden_mode *mode;
+	struct via_fifo_load load;
+	unsigned int i, j, k;
+	u32 depth;
+
+	for (i = 0; i < ARRAY_SIZE(via_fifo_golden_fixed_table); i++) {
+		golden = &via_fifo_golden_fixed_table[i];
+
+		for (j = 0; j < ARRAY_SIZE(via_fifo_golden_modes); j++) {
+			mode = &via_fifo_golden_modes[j];
+
+			for (k = 0; k < ARRAY_SIZE(via_fifo_test_vram_types);
+					k++) {
+				for (depth = 16; depth <= 24; depth += 8) {
+					via_fifo_test_load(&load, mode,
+						via_fifo_test_vram_types[k],
+						depth, 1000);
+					via_fifo_test_fixed_load(test, golden,
+								&load);
+				}
+			}
+		}
+	}
+}
+
+static bool via_fifo_test_catch_all(const struct via_fifo_desc *desc)
+{
+	return (desc->revision == VIA_FIFO_ANY_REVISION) &&
+		(!desc->max_vram_type) &&
+		(!desc->min_hdisplay) &&
+		(!desc->max_hdisplay) &&
+		(!desc->min_vdisplay) &&
+		(!desc->depths);
+}
+
+static void via_fifo_test_table(struct kunit *test,
+				const struct via_fifo_desc *table,
+				unsigned int size, unsigned int iga)
+{
+	const struct via_fifo_desc *desc;
+	unsigned int i;
+
+	for (i = 0; i < size; i++) {
+		desc = &table[i];
+
+		/* The last row of each chipset must always match. */
+		if ((i + 1 == size) ||
+			(table[i + 1].device != desc->device)) {
+			KUNIT_EXPECT_TRUE_MSG(test,
+				via_fifo_test_catch_all(desc),
+				"IGA%u row %u is the last one of device 0x%04x",
+				iga, i, desc->device);
+		}
+
+		if (!desc->heavy_load) {
+			continue;
+		}
+
+		KUNIT_EXPECT_LT_MSG(test, desc->light_load, desc->heavy_load,
+				"IGA%u row %u", iga, i);
+		KUNIT_EXPECT_GE_MSG(test, desc->heavy.max_depth,
+				desc->light.max_depth, "IGA%u row %u", iga, i);
+		KUNIT_EXPECT_GE_MSG(test, desc->heavy.threshold,
+				desc->light.threshold, "IGA%u row %u", iga, i);
+		KUNIT_EXPECT_GE_MSG(test, desc->heavy.high_threshold,
+				desc->light.high_threshold,
+				"IGA%u row %u", iga, i);
+		KUNIT_EXPECT_LE_MSG(test,
+				desc->heavy.display_queue_expire_num,
+				desc->light.display_queue_expire_num,
+				"IGA%u row %u", iga, i);
+	}
+}
+
+static void via_fifo_test_tables(struct kunit *test)
+{
+	via_fifo_test_table(test, via_iga1_fifo_table,
+				ARRAY_SIZE(via_iga1_fifo_table), 1);
+	via_fifo_test_table(test, via_iga2_fifo_table,
+				ARRAY_SIZE(via_iga2_fifo_table), 2);
+}
+
+static void via_fifo_test_monotonic_iga(struct kunit *test, u16 device,
+		int (*fifo_params)(u16 device, int revision,
+					const struct via_fifo_load *load,
+					struct via_fifo_params *fifo))
+{
+	struct via_fifo_params fifo, last = {};
+	struct via_fifo_load load;
+	u32 bandwidth = via_mem_bandwidth(VIA_MEM_DDR_200);
+	u32 other_load;
+
+	/* 1024x768 at 16 bits stays clear of the fixed high depth row. */
+	for (other_load = 0; other_load <= bandwidth; other_load += 8) {
+		via_fifo_test_load(&load, &via_fifo_golden_modes[2],
+					VIA_MEM_DDR_200, 16, other_load);
+		KUNIT_ASSERT_EQ(test, fifo_params(device, 0, &load, &fifo), 0);
+
+		if (other_load) {
+			KUNIT_EXPECT_GE(test, fifo.load, last.load);
+			KUNIT_EXPECT_GE(test, fifo.max_depth, last.max_depth);
+			KUNIT_EXPECT_GE(test, fifo.threshold, last.threshold);
+			KUNIT_EXPECT_GE(test, fifo.high_threshold,
+					last.high_threshold);
+			KUNIT_EXPECT_LE(test, fifo.display_queue_expire_num,
+					last.display_queue_expire_num);
+		}
+
+		last = fifo;
+	}
+}
+
+/* More load must never get a shallower FIFO or a later expire. */
+static void via_fifo_test_monotonic(struct kunit *test)
+{
+	via_fifo_test_monotonic_iga(test, PCI_DEVICE_ID_VIA_K8M800_GFX,
+					via_iga1_fifo_params);
+	via_fifo_test_monotonic_iga(test, PCI_DEVICE_ID_VIA_K8M800_GFX,
+					via_iga2_fifo_params);
+	via_fifo_test_monotonic_iga(test, PCI_DEVICE_ID_VIA_PM800_GFX,
+					via_iga1_fifo_params);
+	via_fifo_test_monotonic_iga(test, PCI_DEVICE_ID_VIA_PM800_GFX,
+					via_iga2_fifo_params);
+}
+
+static struct kunit_case via_fifo_test_cases[] = {
+	KUNIT_CASE(via_fifo_test_golden),
+	KUNIT_CASE(via_fifo_test_fixed),
+	KUNIT_CASE(via_fifo_test_tables),
+	KUNIT_CASE(via_fifo_test_monotonic),
+	{}
+};
+
+static struct kunit_suite via_fifo_test_suite = {
+	.name = "via_fifo",
+	.test_cases = via_fifo_test_cases,
+};
+
+kunit_test_suite(via_fifo_test_suite);
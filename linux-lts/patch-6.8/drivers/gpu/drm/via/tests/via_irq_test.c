@@ -0,0 +1,346 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_irq.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * The MMIO space is simulated with plain memory, so VIA_REG_INTERRUPT
+ * simply keeps the last value written to it. Pending bits are cleared
+ * by writing 1 on the hardware, so a pending bit that reads back as 0
+ * is one that was left alone, and one that reads back as 1 was
+ * acknowledged.
+ *
+ * Hotplug events are injected by setting their bits in AUX_TIMER_REG
+ * before calling the handler. The handler acknowledges only the bits
+ * it saw, so an event bit that was not injected must still read 0.
+ */
+
+#include <kunit/test.h>
+
+/* AUX_TIMER_REG is the highest register used, past the VGA range. */
+#define VIA_IRQ_TEST_MMIO_SIZE	(AUX_TIMER_REG + 0x10)
+
+/* Arbitrary AUX timer settings, which must be left alone. */
+#define VIA_IRQ_TEST_AUX_TIMER	0x00001234
+
+static atomic_t via_irq_test_hotplug_count;
+
+static void via_irq_test_hotplug_work(struct work_struct *work)
+{
+	atomic_inc(&via_irq_test_hotplug_count);
+}
+
+struct via_irq_test {
+	struct via_drm_priv *dev_priv;
+	struct via_crtc iga[VIA_MAX_CRTC];
+	u8 *mmio;
+};
+
+static int via_irq_test_init(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv;
+	struct via_irq_test *priv;
+	unsigned int i;
+
+	priv = kunit_kzalloc(test, sizeof(*priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv);
+
+	dev_priv = kunit_kzalloc(test, sizeof(*dev_priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, dev_priv);
+
+	priv->mmio = kunit_kzalloc(test, VIA_IRQ_TEST_MMIO_SIZE, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv->mmio);
+
+	dev_priv->mmio = (void __iomem __force *)priv->mmio;
+	spin_lock_init(&dev_priv->irq_lock);
+	via_vga_shadow_init(&dev_priv->vga_shadow, VGABASE);
+	dev_priv->hpd_status = VIA_IRQ_DP_NO_INT;
+	INIT_WORK(&dev_priv->hotplug_work, via_irq_test_hotplug_work);
+	atomic_set(&via_irq_test_hotplug_count, 0);
+
+	for (i = 0; i < VIA_MAX_CRTC; i++) {
+		priv->iga[i].base.dev = &dev_priv->dev;
+		priv->iga[i].index = i;
+	}
+
+	priv->dev_priv = dev_priv;
+	test->priv = priv;
+	return 0;
+}
+
+static u32 *via_irq_test_reg(struct via_irq_test *priv)
+{
+	return (u32 *)(priv->mmio + VIA_REG_INTERRUPT);
+}
+
+static u32 *via_irq_test_aux(struct via_irq_test *priv)
+{
+	return (u32 *)(priv->mmio + AUX_TIMER_REG);
+}
+
+/* IGA2 only needs its bits in VIA_REG_INTERRUPT, not CR11. */
+static void via_irq_test_enable_iga2(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_vga_shadow *shadow = &priv->dev_priv->vga_shadow;
+	u32 *reg = via_irq_test_reg(priv);
+
+	KUNIT_EXPECT_EQ(test, via_enable_vblank(&priv->iga[1].base), 0);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL |
+				VIA_IRQ_IGA2_VBLANK_ENABLE |
+				VIA_IRQ_IGA2_VBLANK_PENDING);
+	KUNIT_EXPECT_EQ(test, shadow->total.writes, 0);
+}
+
+static void via_irq_test_enable_iga1(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	u32 *reg = via_irq_test_reg(priv);
+	u8 *vga = priv->mmio + VIA_MMIO_VGABASE;
+
+	KUNIT_EXPECT_EQ(test, via_enable_vblank(&priv->iga[0].base), 0);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL |
+				VIA_IRQ_VBLANK_ENABLE |
+				VIA_IRQ_VBLANK_PENDING);
+	KUNIT_EXPECT_EQ(test, vga[VGA_CRT_IC], 0x11);
+	KUNIT_EXPECT_EQ(test, vga[VGA_CRT_DC] & (BIT(5) | BIT(4)),
+				BIT(5) | BIT(4));
+}
+
+/* Turning one IGA on or off must not acknowledge the other's event. */
+static void via_irq_test_other_pending(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	u32 *reg = via_irq_test_reg(priv);
+
+	*reg = VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE | VIA_IRQ_VBLANK_PENDING;
+	via_enable_vblank(&priv->iga[1].base);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL |
+				VIA_IRQ_VBLANK_ENABLE |
+				VIA_IRQ_IGA2_VBLANK_ENABLE |
+				VIA_IRQ_IGA2_VBLANK_PENDING);
+
+	*reg = VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE |
+		VIA_IRQ_IGA2_VBLANK_ENABLE | VIA_IRQ_VBLANK_PENDING;
+	via_disable_vblank(&priv->iga[1].base);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE);
+}
+
+static void via_irq_test_disable_iga2(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	u32 *reg = via_irq_test_reg(priv);
+
+	via_enable_vblank(&priv->iga[0].base);
+	via_enable_vblank(&priv->iga[1].base);
+	via_disable_vblank(&priv->iga[1].base);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE);
+
+	via_disable_vblank(&priv->iga[0].base);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL);
+}
+
+static void via_irq_test_vblank_irq(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	u32 *reg = via_irq_test_reg(priv);
+	u32 both = VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE |
+			VIA_IRQ_IGA2_VBLANK_ENABLE;
+
+	*reg = both | VIA_IRQ_IGA2_VBLANK_PENDING;
+	KUNIT_EXPECT_EQ(test, via_vblank_irq(dev_priv), BIT(1));
+	KUNIT_EXPECT_EQ(test, *reg, both | VIA_IRQ_IGA2_VBLANK_PENDING);
+
+	*reg = both | VIA_IRQ_VBLANK_PENDING | VIA_IRQ_IGA2_VBLANK_PENDING;
+	KUNIT_EXPECT_EQ(test, via_vblank_irq(dev_priv), BIT(0) | BIT(1));
+
+	/* A disabled source is acknowledged, but not reported. */
+	*reg = VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE |
+		VIA_IRQ_IGA2_VBLANK_PENDING;
+	KUNIT_EXPECT_EQ(test, via_vblank_irq(dev_priv), 0);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE |
+				VIA_IRQ_IGA2_VBLANK_PENDING);
+
+	*reg = both;
+	KUNIT_EXPECT_EQ(test, via_vblank_irq(dev_priv), 0);
+}
+
+/* 1024x768@60Hz, DMT */
+static const struct drm_display_mode via_irq_test_mode = {
+	DRM_MODE("1024x768", DRM_MODE_TYPE_DRIVER, 65000, 1024, 1048,
+		 1184, 1344, 0, 768, 771, 777, 806, 0,
+		 DRM_MODE_FLAG_NHSYNC | DRM_MODE_FLAG_NVSYNC)
+};
+
+/*
+ * The interrupt time is moved from the start of vertical sync to the
+ * end of vertical blank, 806 - 771 lines later.
+ */
+static void via_irq_test_vblank_timestamp(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	struct drm_device *dev = &dev_priv->dev;
+	struct drm_crtc *crtc = &priv->iga[1].base;
+	struct drm_vblank_crtc *vblank;
+	ktime_t vblank_time = 0;
+	int max_error = 20000;
+	int linedur_ns;
+
+	dev->vblank = kunit_kcalloc(test, VIA_MAX_CRTC, sizeof(*vblank),
+					GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, dev->vblank);
+	crtc->index = 1;
+	vblank = &dev->vblank[1];
+
+	vblank->hwmode = via_irq_test_mode;
+	drm_mode_set_crtcinfo(&vblank->hwmode, 0);
+	linedur_ns = DIV_ROUND_CLOSEST(1344 * 1000000, 65000);
+	dev_priv->vblank_irq_time[1] = ns_to_ktime(1000000);
+
+	/* Not known yet */
+	KUNIT_EXPECT_FALSE(test, via_get_vblank_timestamp(crtc, &max_error,
+							&vblank_time, true));
+
+	vblank->linedur_ns = linedur_ns;
+
+	/* Only the interrupt handler has a time to start from. */
+	KUNIT_EXPECT_FALSE(test, via_get_vblank_timestamp(crtc, &max_error,
+							&vblank_time, false));
+
+	KUNIT_EXPECT_TRUE(test, via_get_vblank_timestamp(crtc, &max_error,
+							&vblank_time, true));
+	KUNIT_EXPECT_EQ(test, ktime_to_ns(vblank_time),
+			1000000 + (806 - 771) * linedur_ns);
+	KUNIT_EXPECT_EQ(test, max_error, linedur_ns);
+}
+
+/*
+ * Enabling hotplug sets the event enables and the master enable,
+ * acknowledges a stale event, and leaves the vertical blank bits and
+ * the AUX timer settings alone.
+ */
+static void via_irq_test_hotplug_enable(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	u32 *reg = via_irq_test_reg(priv);
+	u32 *aux = via_irq_test_aux(priv);
+
+	*reg = VIA_IRQ_VBLANK_ENABLE | VIA_IRQ_VBLANK_PENDING;
+	*aux = VIA_IRQ_TEST_AUX_TIMER | VIA_IRQ_DP_HOT_PLUG;
+	via_hotplug_irq_enable(dev_priv);
+
+	KUNIT_EXPECT_TRUE(test, dev_priv->hpd_enabled);
+	KUNIT_EXPECT_EQ(test, *reg, VIA_IRQ_GLOBAL | VIA_IRQ_VBLANK_ENABLE);
+	KUNIT_EXPECT_EQ(test, *aux, VIA_IRQ_TEST_AUX_TIMER |
+				VIA_IRQ_DP_HOT_ENABLE |
+				VIA_IRQ_DP_HOT_PLUG);
+}
+
+/* Events are not looked at before via_hdmi_init() enables them. */
+static void via_irq_test_hotplug_disabled(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	u32 *aux = via_irq_test_aux(priv);
+
+	*via_irq_test_reg(priv) = VIA_IRQ_GLOBAL;
+	*aux = VIA_IRQ_DP_HOT_PLUG;
+	KUNIT_EXPECT_EQ(test, via_irq_handler(0, &dev_priv->dev), IRQ_NONE);
+	KUNIT_EXPECT_EQ(test, *aux, VIA_IRQ_DP_HOT_PLUG);
+	KUNIT_EXPECT_EQ(test, dev_priv->hpd_status, VIA_IRQ_DP_NO_INT);
+
+	flush_work(&dev_priv->hotplug_work);
+	KUNIT_EXPECT_EQ(test, atomic_read(&via_irq_test_hotplug_count), 0);
+}
+
+static void via_irq_test_hotplug_irq(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	u32 *aux = via_irq_test_aux(priv);
+	u32 enabled = VIA_IRQ_TEST_AUX_TIMER | VIA_IRQ_DP_HOT_ENABLE;
+
+	via_hotplug_irq_enable(dev_priv);
+
+	/* No event latched: the interrupt belongs to someone else. */
+	KUNIT_EXPECT_EQ(test, via_irq_handler(0, &dev_priv->dev), IRQ_NONE);
+
+	*aux = enabled | VIA_IRQ_DP_HOT_UNPLUG;
+	KUNIT_EXPECT_EQ(test, via_irq_handler(0, &dev_priv->dev),
+				IRQ_HANDLED);
+	KUNIT_EXPECT_EQ(test, *aux, enabled | VIA_IRQ_DP_HOT_UNPLUG);
+	KUNIT_EXPECT_EQ(test, dev_priv->hpd_status, VIA_IRQ_DP_HOT_UNPLUG);
+	flush_work(&dev_priv->hotplug_work);
+	KUNIT_EXPECT_EQ(test, atomic_read(&via_irq_test_hotplug_count), 1);
+
+	*aux = enabled | VIA_IRQ_DP_HOT_PLUG;
+	KUNIT_EXPECT_EQ(test, via_irq_handler(0, &dev_priv->dev),
+				IRQ_HANDLED);
+	KUNIT_EXPECT_EQ(test, *aux, enabled | VIA_IRQ_DP_HOT_PLUG);
+	KUNIT_EXPECT_EQ(test, dev_priv->hpd_status, VIA_IRQ_DP_HOT_PLUG);
+	flush_work(&dev_priv->hotplug_work);
+	KUNIT_EXPECT_EQ(test, atomic_read(&via_irq_test_hotplug_count), 2);
+}
+
+/* Masking turns the event enables off, and nothing else. */
+static void via_irq_test_hotplug_mask(struct kunit *test)
+{
+	struct via_irq_test *priv = test->priv;
+	struct via_drm_priv *dev_priv = priv->dev_priv;
+	u32 *aux = via_irq_test_aux(priv);
+
+	*aux = VIA_IRQ_TEST_AUX_TIMER;
+	via_hotplug_irq_enable(dev_priv);
+	via_irq_mask(&dev_priv->dev);
+
+	KUNIT_EXPECT_FALSE(test, dev_priv->hpd_enabled);
+	KUNIT_EXPECT_EQ(test, *aux, VIA_IRQ_TEST_AUX_TIMER);
+}
+
+static struct kunit_case via_irq_test_cases[] = {
+	KUNIT_CASE(via_irq_test_enable_iga2),
+	KUNIT_CASE(via_irq_test_enable_iga1),
+	KUNIT_CASE(via_irq_test_other_pending),
+	KUNIT_CASE(via_irq_test_disable_iga2),
+	KUNIT_CASE(via_irq_test_vblank_irq),
+	KUNIT_CASE(via_irq_test_vblank_timestamp),
+	KUNIT_CASE(via_irq_test_hotplug_enable),
+	KUNIT_CASE(via_irq_test_hotplug_disabled),
+	KUNIT_CASE(via_irq_test_hotplug_irq),
+	KUNIT_CASE(via_irq_test_hotplug_mask),
+	{}
+};
+
+static struct kunit_suite via_irq_test_suite = {
+	.name = "via_irq",
+	.init = via_irq_test_init,
+	.test_cases = via_irq_test_cases,
+};
+
+kunit_test_suite(via_irq_test_suite);
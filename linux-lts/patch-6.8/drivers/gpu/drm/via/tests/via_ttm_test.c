@@ -0,0 +1,424 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_ttm.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * VRAM is simulated with vmalloc memory, which the suite's own
+ * io_mem_reserve hands to TTM as an existing kernel mapping, so
+ * buffers can be created, written and evicted without the hardware. The suite brings up only the memory
+ * managers, the same way via_mm_init() does.
+ *
+ * Closing the last handle of a buffer is simulated by offering it to
+ * the buffer object cache and dropping the creator's reference, which
+ * is what via_gem_close() and the handle release do.
+ */
+
+#include <kunit/test.h>
+
+#include <linux/shrinker.h>
+#include <linux/sizes.h>
+#include <linux/vmalloc.h>
+
+#include <drm/drm_kunit_helpers.h>
+
+#define VIA_TTM_TEST_VRAM_SIZE	SZ_4M
+#define VIA_TTM_TEST_TT_SIZE	SZ_16M
+#define VIA_TTM_TEST_BO_SIZE	SZ_256K
+#define VIA_TTM_TEST_BO_COUNT	(2 * VIA_TTM_TEST_VRAM_SIZE / \
+					VIA_TTM_TEST_BO_SIZE)
+
+/* Stand-in for VRAM of the running test */
+static void *via_ttm_test_vram;
+
+static struct ttm_device_funcs via_ttm_test_bo_driver;
+
+static int via_ttm_test_io_mem_reserve(struct ttm_device *bdev,
+					struct ttm_resource *mem)
+{
+	int ret;
+
+	ret = via_bo_io_mem_reserve(bdev, mem);
+	if ((!ret) && (mem->mem_type == TTM_PL_VRAM)) {
+		mem->bus.addr = via_ttm_test_vram +
+				(mem->start << PAGE_SHIFT);
+	}
+
+	return ret;
+}
+
+static void via_ttm_test_vram_free(void *vram)
+{
+	vfree(vram);
+}
+
+static void via_ttm_test_device_fini(void *data)
+{
+	struct via_drm_priv *dev_priv = data;
+
+	ttm_device_fini(&dev_priv->bdev);
+}
+
+static void via_ttm_test_vram_mgr_fini(void *data)
+{
+	via_vram_mgr_fini(data);
+}
+
+static void via_ttm_test_tt_fini(void *data)
+{
+	struct via_drm_priv *dev_priv = data;
+
+	ttm_range_man_fini(&dev_priv->bdev, TTM_PL_TT);
+}
+
+static void via_ttm_test_bo_cache_fini(void *data)
+{
+	struct via_drm_priv *dev_priv = data;
+
+	via_bo_cache_fini(&dev_priv->dev);
+}
+
+static int via_ttm_test_init(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv;
+	struct drm_device *dev;
+	struct device *parent;
+	int ret;
+
+	parent = drm_kunit_helper_alloc_device(test);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, parent);
+
+	dev_priv = drm_kunit_helper_alloc_drm_device(test, parent,
+						struct via_drm_priv, dev,
+						DRIVER_GEM);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, dev_priv);
+	dev = &dev_priv->dev;
+
+	via_ttm_test_vram = vzalloc(VIA_TTM_TEST_VRAM_SIZE);
+	KUNIT_ASSERT_NOT_NULL(test, via_ttm_test_vram);
+	ret = kunit_add_action_or_reset(test, via_ttm_test_vram_free,
+					via_ttm_test_vram);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	dev_priv->vram_size = VIA_TTM_TEST_VRAM_SIZE;
+
+	via_ttm_test_bo_driver = via_bo_driver;
+	via_ttm_test_bo_driver.io_mem_reserve = via_ttm_test_io_mem_reserve;
+	ret = ttm_device_init(&dev_priv->bdev, &via_ttm_test_bo_driver,
+				dev->dev, dev->anon_inode->i_mapping,
+				dev->vma_offset_manager, false, true);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	ret = kunit_add_action_or_reset(test, via_ttm_test_device_fini,
+					dev_priv);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	ret = via_vram_mgr_init(dev_priv);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	ret = kunit_add_action_or_reset(test, via_ttm_test_vram_mgr_fini,
+					dev_priv);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	ret = ttm_range_man_init(&dev_priv->bdev, TTM_PL_TT, true,
+					VIA_TTM_TEST_TT_SIZE >> PAGE_SHIFT);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	ret = kunit_add_action_or_reset(test, via_ttm_test_tt_fini,
+					dev_priv);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	ret = via_bo_cache_init(dev);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	ret = kunit_add_action_or_reset(test, via_ttm_test_bo_cache_fini,
+					dev_priv);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	test->priv = dev_priv;
+	return 0;
+}
+
+/* Fills the whole buffer with one byte, wherever it is placed. */
+static void via_ttm_test_fill(struct kunit *test, struct via_bo *bo,
+				u8 value)
+{
+	struct ttm_buffer_object *ttm_bo = &bo->ttm_bo;
+	struct ttm_bo_kmap_obj map;
+	bool is_iomem;
+	void *virtual;
+
+	KUNIT_ASSERT_EQ(test, ttm_bo_reserve(ttm_bo, false, false, NULL), 0);
+	KUNIT_ASSERT_EQ(test, ttm_bo_kmap(ttm_bo, 0, PFN_UP(ttm_bo->base.size),
+						&map), 0);
+
+	virtual = ttm_kmap_obj_virtual(&map, &is_iomem);
+	if (is_iomem) {
+		memset_io((void __iomem __force *)virtual, value,
+				ttm_bo->base.size);
+	} else {
+		memset(virtual, value, ttm_bo->base.size);
+	}
+
+	ttm_bo_kunmap(&map);
+	ttm_bo_unreserve(ttm_bo);
+}
+
+/* Checks the contents of a buffer that is in TT. */
+static void via_ttm_test_check(struct kunit *test, struct via_bo *bo,
+				u8 value)
+{
+	struct ttm_buffer_object *ttm_bo = &bo->ttm_bo;
+	struct ttm_bo_kmap_obj map;
+	bool is_iomem;
+	void *virtual;
+
+	KUNIT_ASSERT_EQ(test, ttm_bo_reserve(ttm_bo, false, false, NULL), 0);
+	KUNIT_ASSERT_EQ(test, ttm_bo_kmap(ttm_bo, 0, PFN_UP(ttm_bo->base.size),
+						&map), 0);
+
+	virtual = ttm_kmap_obj_virtual(&map, &is_iomem);
+	KUNIT_EXPECT_FALSE(test, is_iomem);
+	KUNIT_EXPECT_NULL(test, memchr_inv(virtual, value,
+						ttm_bo->base.size));
+
+	ttm_bo_kunmap(&map);
+	ttm_bo_unreserve(ttm_bo);
+}
+
+/*
+ * Allocates twice as much VRAM as there is, the way GEM_ALLOC does.
+ * Every allocation must succeed, the oldest buffers must have moved to
+ * TT with their contents, and a pinned buffer must stay in VRAM.
+ */
+static void via_ttm_test_evict_to_tt(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv = test->priv;
+	struct drm_device *dev = &dev_priv->dev;
+	struct via_bo *bo[VIA_TTM_TEST_BO_COUNT];
+	struct via_bo *pinned;
+	unsigned int i, in_vram = 0, in_tt = 0;
+	u32 mem_type;
+	int ret;
+
+	ret = via_bo_create(dev, &dev_priv->bdev, VIA_TTM_TEST_BO_SIZE,
+				ttm_bo_type_kernel, TTM_PL_VRAM, false, true,
+				&pinned);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	for (i = 0; i < VIA_TTM_TEST_BO_COUNT; i++) {
+		ret = via_bo_create(dev, &dev_priv->bdev,
+					VIA_TTM_TEST_BO_SIZE,
+					ttm_bo_type_device, TTM_PL_VRAM,
+					false, false, &bo[i]);
+		KUNIT_ASSERT_EQ_MSG(test, ret, 0, "buffer %u", i);
+		via_ttm_test_fill(test, bo[i], i + 1);
+	}
+
+	for (i = 0; i < VIA_TTM_TEST_BO_COUNT; i++) {
+		mem_type = bo[i]->ttm_bo.resource->mem_type;
+		if (mem_type == TTM_PL_VRAM) {
+			in_vram++;
+		} else if (mem_type == TTM_PL_TT) {
+			in_tt++;
+			via_ttm_test_check(test, bo[i], i + 1);
+		}
+	}
+
+	kunit_info(test, "%u buffers in VRAM, %u in TT\n", in_vram, in_tt);
+	KUNIT_EXPECT_EQ(test, in_vram + in_tt, VIA_TTM_TEST_BO_COUNT);
+	KUNIT_EXPECT_LT(test, in_vram,
+			VIA_TTM_TEST_VRAM_SIZE / VIA_TTM_TEST_BO_SIZE);
+	KUNIT_EXPECT_EQ(test, bo[0]->ttm_bo.resource->mem_type, TTM_PL_TT);
+	KUNIT_EXPECT_EQ(test,
+		bo[VIA_TTM_TEST_BO_COUNT - 1]->ttm_bo.resource->mem_type,
+		TTM_PL_VRAM);
+	KUNIT_EXPECT_EQ(test, pinned->ttm_bo.resource->mem_type,
+				TTM_PL_VRAM);
+
+	for (i = 0; i < VIA_TTM_TEST_BO_COUNT; i++) {
+		ttm_bo_put(&bo[i]->ttm_bo);
+	}
+
+	via_bo_destroy(pinned, true);
+}
+
+static struct via_bo *via_ttm_test_bo_create(struct kunit *test,
+						u64 size)
+{
+	struct via_drm_priv *dev_priv = test->priv;
+	struct via_bo *bo;
+	int ret;
+
+	ret = via_bo_create(&dev_priv->dev, &dev_priv->bdev, size,
+				ttm_bo_type_device, TTM_PL_TT, false, false,
+				&bo);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+	return bo;
+}
+
+static bool via_ttm_test_bo_close(struct via_bo *bo)
+{
+	bool parked = via_bo_cache_put(bo);
+
+	drm_gem_object_put(&bo->ttm_bo.base);
+	return parked;
+}
+
+/* A buffer of the same size comes back cleared, and alive. */
+static void via_ttm_test_cache_hit(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv = test->priv;
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct via_bo *bo, *reused;
+
+	bo = via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE);
+	via_ttm_test_fill(test, bo, 0xA5);
+	KUNIT_ASSERT_TRUE(test, via_ttm_test_bo_close(bo));
+	KUNIT_EXPECT_EQ(test, cache->count, 1);
+	KUNIT_EXPECT_EQ(test, kref_read(&bo->ttm_bo.base.refcount), 1);
+
+	reused = via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE);
+	KUNIT_EXPECT_PTR_EQ(test, reused, bo);
+	KUNIT_EXPECT_EQ(test, cache->hits, 1);
+	KUNIT_EXPECT_EQ(test, cache->count, 0);
+	KUNIT_EXPECT_EQ(test, kref_read(&reused->ttm_bo.base.refcount), 1);
+	via_ttm_test_check(test, reused, 0x00);
+
+	drm_gem_object_put(&reused->ttm_bo.base);
+}
+
+/*
+ * Another size is allocated anew, and a buffer held elsewhere is not
+ * taken in.
+ */
+static void via_ttm_test_cache_miss(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv = test->priv;
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct via_bo *bo, *other;
+
+	bo = via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE);
+	KUNIT_ASSERT_TRUE(test, via_ttm_test_bo_close(bo));
+
+	other = via_ttm_test_bo_create(test, 2 * VIA_TTM_TEST_BO_SIZE);
+	KUNIT_EXPECT_PTR_NE(test, other, bo);
+	KUNIT_EXPECT_EQ(test, cache->misses, 2);
+	KUNIT_EXPECT_EQ(test, cache->count, 1);
+
+	drm_gem_object_get(&other->ttm_bo.base);
+	KUNIT_EXPECT_FALSE(test, via_ttm_test_bo_close(other));
+	KUNIT_EXPECT_EQ(test, cache->count, 1);
+	drm_gem_object_put(&other->ttm_bo.base);
+}
+
+/* The oldest buffers make room, and a too large one is refused. */
+static void via_ttm_test_cache_max_size(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv = test->priv;
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct via_bo *bo[3];
+	unsigned int i;
+
+	cache->max_size = 2 * VIA_TTM_TEST_BO_SIZE;
+
+	bo[0] = via_ttm_test_bo_create(test, 3 * VIA_TTM_TEST_BO_SIZE);
+	KUNIT_EXPECT_FALSE(test, via_ttm_test_bo_close(bo[0]));
+	KUNIT_EXPECT_EQ(test, cache->count, 0);
+
+	for (i = 0; i < ARRAY_SIZE(bo); i++) {
+		bo[i] = via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bo); i++) {
+		KUNIT_EXPECT_TRUE(test, via_ttm_test_bo_close(bo[i]));
+	}
+
+	KUNIT_EXPECT_EQ(test, cache->count, 2);
+	KUNIT_EXPECT_EQ(test, cache->size, cache->max_size);
+	KUNIT_EXPECT_TRUE(test, READ_ONCE(bo[1]->cached));
+	KUNIT_EXPECT_TRUE(test, READ_ONCE(bo[2]->cached));
+	flush_work(&cache->reap_work);
+
+	/* Most recently parked first */
+	KUNIT_EXPECT_PTR_EQ(test,
+			via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE),
+			bo[2]);
+	drm_gem_object_put(&bo[2]->ttm_bo.base);
+}
+
+/* The shrinker releases the oldest buffers from the work item. */
+static void via_ttm_test_cache_reap(struct kunit *test)
+{
+	struct via_drm_priv *dev_priv = test->priv;
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct shrink_control sc = {
+		.gfp_mask = GFP_KERNEL,
+		.nr_to_scan = VIA_TTM_TEST_BO_SIZE >> PAGE_SHIFT,
+	};
+	struct shrinker *shrinker = cache->shrinker;
+	struct via_bo *bo[2];
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(bo); i++) {
+		bo[i] = via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bo); i++) {
+		KUNIT_ASSERT_TRUE(test, via_ttm_test_bo_close(bo[i]));
+	}
+
+	KUNIT_EXPECT_EQ(test, shrinker->count_objects(shrinker, &sc),
+			2 * (VIA_TTM_TEST_BO_SIZE >> PAGE_SHIFT));
+	KUNIT_EXPECT_EQ(test, shrinker->scan_objects(shrinker, &sc),
+			VIA_TTM_TEST_BO_SIZE >> PAGE_SHIFT);
+	KUNIT_EXPECT_EQ(test, cache->count, 1);
+	KUNIT_EXPECT_TRUE(test, READ_ONCE(bo[1]->cached));
+	flush_work(&cache->reap_work);
+
+	sc.nr_to_scan = ULONG_MAX;
+	KUNIT_EXPECT_EQ(test, shrinker->scan_objects(shrinker, &sc),
+			VIA_TTM_TEST_BO_SIZE >> PAGE_SHIFT);
+	KUNIT_EXPECT_EQ(test, shrinker->count_objects(shrinker, &sc),
+			SHRINK_EMPTY);
+	flush_work(&cache->reap_work);
+
+	bo[0] = via_ttm_test_bo_create(test, VIA_TTM_TEST_BO_SIZE);
+	KUNIT_EXPECT_EQ(test, cache->hits, 0);
+	drm_gem_object_put(&bo[0]->ttm_bo.base);
+}
+
+static struct kunit_case via_ttm_test_cases[] = {
+	KUNIT_CASE(via_ttm_test_evict_to_tt),
+	KUNIT_CASE(via_ttm_test_cache_hit),
+	KUNIT_CASE(via_ttm_test_cache_miss),
+	KUNIT_CASE(via_ttm_test_cache_max_size),
+	KUNIT_CASE(via_ttm_test_cache_reap),
+	{}
+};
+
+static struct kunit_suite via_ttm_test_suite = {
+	.name = "via_ttm",
+	.init = via_ttm_test_init,
+	.test_cases = via_ttm_test_cases,
+};
+
+kunit_test_suite(via_ttm_test_suite);
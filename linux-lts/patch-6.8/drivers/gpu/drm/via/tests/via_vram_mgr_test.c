@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+/*
+ * Included from via_vram_mgr.c when CONFIG_DRM_VIA_KUNIT_TEST is set.
+ *
+ * Runs via_vram_mgr_alloc_blocks() against a bare 4 MiB drm_buddy,
+ * with single pages allocated at 1 MiB and 3 MiB, so that neither
+ * 2 MiB half of it is free.
+ */
+
+#include <kunit/test.h>
+
+#define VIA_VRAM_MGR_TEST_SIZE	SZ_4M
+
+struct via_vram_mgr_test {
+	struct drm_buddy	mm;
+	struct list_head	pinned;
+	struct list_head	blocks;
+};
+
+static void via_vram_mgr_test_fini(void *data)
+{
+	struct via_vram_mgr_test *priv = data;
+
+	drm_buddy_free_list(&priv->mm, &priv->blocks);
+	drm_buddy_free_list(&priv->mm, &priv->pinned);
+	drm_buddy_fini(&priv->mm);
+}
+
+static int via_vram_mgr_test_init(struct kunit *test)
+{
+	struct via_vram_mgr_test *priv;
+	u64 offset;
+	int ret;
+
+	priv = kunit_kzalloc(test, sizeof(*priv), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, priv);
+
+	INIT_LIST_HEAD(&priv->pinned);
+	INIT_LIST_HEAD(&priv->blocks);
+	KUNIT_ASSERT_EQ(test, drm_buddy_init(&priv->mm,
+						VIA_VRAM_MGR_TEST_SIZE,
+						PAGE_SIZE), 0);
+	ret = kunit_add_action_or_reset(test, via_vram_mgr_test_fini, priv);
+	KUNIT_ASSERT_EQ(test, ret, 0);
+
+	for (offset = SZ_1M; offset < VIA_VRAM_MGR_TEST_SIZE;
+		offset += SZ_2M) {
+		ret = drm_buddy_alloc_blocks(&priv->mm, offset,
+						offset + PAGE_SIZE,
+						PAGE_SIZE, PAGE_SIZE,
+						&priv->pinned,
+						DRM_BUDDY_RANGE_ALLOCATION);
+		KUNIT_ASSERT_EQ(test, ret, 0);
+	}
+
+	test->priv = priv;
+	return 0;
+}
+
+/*
+ * Checks that the blocks allocated by the test cover size bytes
+ * without a gap, and returns where they start.
+ */
+static u64 via_vram_mgr_test_run(struct kunit *test, u64 size)
+{
+	struct via_vram_mgr_test *priv = test->priv;
+	struct drm_buddy_block *block;
+	u64 start = U64_MAX, end = 0, total = 0;
+
+	list_for_each_entry(block, &priv->blocks, link) {
+		start = min(start, drm_buddy_block_offset(block));
+		end = max(end, drm_buddy_block_offset(block) +
+				drm_buddy_block_size(&priv->mm, block));
+		total += drm_buddy_block_size(&priv->mm, block);
+	}
+
+	KUNIT_EXPECT_EQ(test, total, size);
+	KUNIT_EXPECT_EQ(test, end - start, size);
+
+	drm_buddy_free_list(&priv->mm, &priv->blocks);
+	return start;
+}
+
+static int via_vram_mgr_test_alloc(struct kunit *test, u64 start, u64 end,
+					u64 size, unsigned long flags)
+{
+	struct via_vram_mgr_test *priv = test->priv;
+
+	return via_vram_mgr_alloc_blocks(&priv->mm, start, end, size, flags,
+						&priv->blocks);
+}
+
+/* What fits in a free aligned block is still taken as one. */
+static void via_vram_mgr_test_aligned(struct kunit *test)
+{
+	u64 size = SZ_512K + SZ_256K;
+
+	KUNIT_ASSERT_EQ(test, via_vram_mgr_test_alloc(test, 0,
+					VIA_VRAM_MGR_TEST_SIZE, size, 0), 0);
+	KUNIT_EXPECT_TRUE(test, IS_ALIGNED(via_vram_mgr_test_run(test, size),
+						SZ_1M));
+}
+
+/*
+ * 1.5 MiB rounds up to a 2 MiB block, and none is free, but the
+ * run between the two allocated pages is long enough.
+ */
+static void via_vram_mgr_test_unaligned(struct kunit *test)
+{
+	u64 size = SZ_1M + SZ_512K;
+
+	KUNIT_ASSERT_EQ(test, via_vram_mgr_test_alloc(test, 0,
+					VIA_VRAM_MGR_TEST_SIZE, size, 0), 0);
+	KUNIT_EXPECT_EQ(test, via_vram_mgr_test_run(test, size),
+				SZ_1M + PAGE_SIZE);
+
+	KUNIT_ASSERT_EQ(test, via_vram_mgr_test_alloc(test, 0,
+					VIA_VRAM_MGR_TEST_SIZE, size,
+					DRM_BUDDY_TOPDOWN_ALLOCATION), 0);
+	KUNIT_EXPECT_EQ(test, via_vram_mgr_test_run(test, size),
+				SZ_2M + SZ_1M - size);
+}
+
+/*
+ * The run has to lie within the requested range, and has to be
+ * contiguous even when enough free pages are in it.
+ */
+static void via_vram_mgr_test_range(struct kunit *test)
+{
+	struct via_vram_mgr_test *priv = test->priv;
+	u64 size = SZ_512K + SZ_256K;
+
+	KUNIT_ASSERT_EQ(test, via_vram_mgr_test_alloc(test,
+					SZ_1M + SZ_512K, SZ_2M + SZ_512K,
+					size, DRM_BUDDY_RANGE_ALLOCATION), 0);
+	KUNIT_EXPECT_EQ(test, via_vram_mgr_test_run(test, size),
+				SZ_1M + SZ_512K);
+
+	KUNIT_EXPECT_EQ(test, via_vram_mgr_test_alloc(test,
+					SZ_512K, SZ_1M + SZ_512K,
+					size, DRM_BUDDY_RANGE_ALLOCATION),
+				-ENOSPC);
+	KUNIT_EXPECT_TRUE(test, list_empty(&priv->blocks));
+}
+
+/* No run of free pages is 2 MiB long. */
+static void via_vram_mgr_test_nospace(struct kunit *test)
+{
+	struct via_vram_mgr_test *priv = test->priv;
+
+	KUNIT_EXPECT_EQ(test, via_vram_mgr_test_alloc(test, 0,
+					VIA_VRAM_MGR_TEST_SIZE, SZ_2M, 0),
+				-ENOSPC);
+	KUNIT_EXPECT_TRUE(test, list_empty(&priv->blocks));
+}
+static struct kunit_case via_vram_mgr_test_cases[] = {
+	KUNIT_CASE(via_vram_mgr_test_aligned),
+	KUNIT_CASE(via_vram_mgr_test_unaligned),
+	KUNIT_CASE(via_vram_mgr_test_range),
+	KUNIT_CASE(via_vram_mgr_test_nospace),
+	{}
+};
+
+static struct kunit_suite via_vram_mgr_test_suite = {
+	.name = "via_vram_mgr",
+	.init = via_vram_mgr_test_init,
+	.test_cases = via_vram_mgr_test_cases,
+};
+
+kunit_test_suite(via_vram_mgr_test_suite);
@@ -0,0 +1,233 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+#include <linux/minmax.h>
+#include <linux/slab.h>
+
+#include <drm/drm_atomic.h>
+#include <drm/drm_atomic_state_helper.h>
+#include <drm/drm_framebuffer.h>
+#include <drm/drm_managed.h>
+#include <drm/drm_print.h>
+#include <drm/drm_rect.h>
+
+#include "via_drv.h"
+
+
+static struct drm_private_state *
+via_bandwidth_duplicate_state(struct drm_private_obj *obj)
+{
+	struct via_bandwidth_state *state;
+
+	state = kmemdup(obj->state, sizeof(*state), GFP_KERNEL);
+	if (!state) {
+		return NULL;
+	}
+
+	__drm_atomic_helper_private_obj_duplicate_state(obj, &state->base);
+	return &state->base;
+}
+
+static void via_bandwidth_destroy_state(struct drm_private_obj *obj,
+					struct drm_private_state *state)
+{
+	kfree(to_via_bandwidth_state(state));
+}
+
+static const struct drm_private_state_funcs via_bandwidth_state_funcs = {
+	.atomic_duplicate_state = via_bandwidth_duplicate_state,
+	.atomic_destroy_state = via_bandwidth_destroy_state,
+};
+
+static struct via_bandwidth_state *
+via_get_bandwidth_state(struct drm_atomic_state *state)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(state->dev);
+	struct drm_private_state *priv_state;
+
+	priv_state = drm_atomic_get_private_obj_state(state,
+						&dev_priv->bandwidth_obj);
+	if (IS_ERR(priv_state)) {
+		return ERR_CAST(priv_state);
+	}
+
+	return to_via_bandwidth_state(priv_state);
+}
+
+/*
+ * Memory bandwidth in MB/s taken by the scanout of one plane. A plane
+ * narrower than the mode only fetches during part of each line.
+ */
+static u32 via_plane_load(const struct drm_crtc_state *crtc_state,
+				const struct drm_plane_state *plane_state)
+{
+	const struct drm_display_mode *mode = &crtc_state->adjusted_mode;
+	u32 width;
+
+	if ((!plane_state->visible) || (!plane_state->fb) ||
+		(!mode->hdisplay)) {
+		return 0;
+	}
+
+	width = min_t(u32, drm_rect_width(&plane_state->src) >> 16,
+			mode->hdisplay);
+	return DIV_ROUND_UP(via_scanout_load(mode->clock,
+					plane_state->fb->format->cpp[0]) *
+				width, mode->hdisplay);
+}
+
+static u32 via_crtc_load(const struct drm_crtc_state *crtc_state)
+{
+	struct drm_plane *plane;
+	const struct drm_plane_state *plane_state;
+	u32 load = 0;
+
+	if (!crtc_state->active) {
+		return 0;
+	}
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, plane_state,
+							crtc_state) {
+		load += via_plane_load(crtc_state, plane_state);
+	}
+
+	return load;
+}
+
+/*
+ * Rejects configurations whose combined scanout needs more memory
+ * bandwidth than the UMA memory can give to the display engine.
+ * Configurations that fit still have their display FIFO settings
+ * picked for the combined load at mode set.
+ */
+int via_bandwidth_check(struct drm_atomic_state *state)
+{
+	struct drm_device *dev = state->dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_bandwidth_state *cur_bw_state =
+			to_via_bandwidth_state(dev_priv->bandwidth_obj.state);
+	struct via_bandwidth_state *bw_state = NULL;
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *crtc_state;
+	struct via_crtc *iga;
+	u32 bandwidth, budget, load, total = 0;
+	int i;
+
+	for_each_new_crtc_in_state(state, crtc, crtc_state, i) {
+		iga = container_of(crtc, struct via_crtc, base);
+		load = via_crtc_load(crtc_state);
+
+		/*
+		 * Adding the bandwidth state to the commit serializes it
+		 * against every other commit, so a page flip or cursor
+		 * move that leaves the load as it was does not take it.
+		 */
+		if ((!drm_atomic_crtc_needs_modeset(crtc_state)) &&
+			(load == cur_bw_state->load[iga->index])) {
+			continue;
+		}
+
+		if (!bw_state) {
+			bw_state = via_get_bandwidth_state(state);
+			if (IS_ERR(bw_state)) {
+				return PTR_ERR(bw_state);
+			}
+		}
+
+		bw_state->load[iga->index] = load;
+	}
+
+	if (!bw_state) {
+		return 0;
+	}
+
+	bandwidth = via_mem_bandwidth(dev_priv->vram_type);
+	if (!bandwidth) {
+		return 0;
+	}
+
+	for (i = 0; i < VIA_MAX_CRTC; i++) {
+		total += bw_state->load[i];
+	}
+
+	budget = bandwidth * VIA_SCANOUT_BANDWIDTH_BUDGET / 100;
+	if (total > budget) {
+		drm_dbg_atomic(dev, "Scanout needs %u MB/s of memory "
+				"bandwidth, but only %u MB/s are "
+				"available.\n", total, budget);
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+
+/*
+ * Memory bandwidth in MB/s taken by the scanout of the IGAs other than
+ * the one given, as of the last committed state.
+ */
+u32 via_bandwidth_other_load(struct drm_device *dev, unsigned int index)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_bandwidth_state *bw_state =
+			to_via_bandwidth_state(dev_priv->bandwidth_obj.state);
+	u32 load = 0;
+	unsigned int i;
+
+	for (i = 0; i < VIA_MAX_CRTC; i++) {
+		if (i != index) {
+			load += bw_state->load[i];
+		}
+	}
+
+	return load;
+}
+
+static void via_bandwidth_obj_fini(struct drm_device *dev, void *unused)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+
+	drm_atomic_private_obj_fini(&dev_priv->bandwidth_obj);
+}
+
+int via_bandwidth_init(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_bandwidth_state *bw_state;
+
+	bw_state = kzalloc(sizeof(*bw_state), GFP_KERNEL);
+	if (!bw_state) {
+		return -ENOMEM;
+	}
+
+	drm_atomic_private_obj_init(dev, &dev_priv->bandwidth_obj,
+					&bw_state->base,
+					&via_bandwidth_state_funcs);
+	return drmm_add_action_or_reset(dev, via_bandwidth_obj_fini, NULL);
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_bandwidth_test.c"
+#endif
@@ -0,0 +1,413 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+#include <linux/dma-fence.h>
+#include <linux/iopoll.h>
+#include <linux/pci.h>
+#include <linux/slab.h>
+
+#include <drm/drm_print.h>
+
+#include "via_drv.h"
+
+
+/*
+ * Buffers are copied as 32 bpp rectangles, one page per line.
+ * Pitch is a 14-bit count of 8-byte units, and both dimensions are
+ * 12 bits wide, so a single copy moves at most 16 MB.
+ */
+#define VIA_BLIT_PITCH		4096
+#define VIA_BLIT_MAX_LINES	4096
+#define VIA_BLIT_ROP_SRCCOPY	0xCC
+#define VIA_BLIT_ROP_PATCOPY	0xF0
+
+#define VIA_BLIT_TIMEOUT_US	500000
+
+static int via_blit_enable = 1;
+
+MODULE_PARM_DESC(blit, "Use the 2D engine for VRAM buffer moves "
+			"(1 = enable)");
+module_param_named(blit, via_blit_enable, int, 0444);
+
+struct via_blit_fence {
+	struct dma_fence	base;
+	struct list_head	head;
+};
+
+static void via_blit_cmd_add(struct via_blit_cmd *cmd, u32 reg, u32 val)
+{
+	cmd->reg[cmd->count] = reg;
+	cmd->val[cmd->count] = val;
+	cmd->count++;
+}
+
+/*
+ * Encode a copy of lines pages from VRAM offset src to VRAM
+ * offset dst. m1 selects the register layout of the VX800 and
+ * later 2D engine.
+ */
+int via_blit_encode(bool m1, u32 src, u32 dst, u32 lines,
+			struct via_blit_cmd *cmd)
+{
+	u32 dimension, pitch;
+
+	cmd->count = 0;
+
+	if ((!lines) || (lines > VIA_BLIT_MAX_LINES) ||
+		(src & 0xE0000007) || (dst & 0xE0000007)) {
+		return -EINVAL;
+	}
+
+	dimension = ((VIA_BLIT_PITCH / 4) - 1) | ((lines - 1) << 16);
+	pitch = (VIA_BLIT_PITCH >> 3) | ((VIA_BLIT_PITCH >> 3) << 16);
+
+	via_blit_cmd_add(cmd, VIA_REG_GEMODE, VIA_GEM_32bpp);
+	if (!m1) {
+		via_blit_cmd_add(cmd, VIA_REG_SRCPOS, 0);
+		via_blit_cmd_add(cmd, VIA_REG_DSTPOS, 0);
+		via_blit_cmd_add(cmd, VIA_REG_DIMENSION, dimension);
+		via_blit_cmd_add(cmd, VIA_REG_SRCBASE, src >> 3);
+		via_blit_cmd_add(cmd, VIA_REG_DSTBASE, dst >> 3);
+		via_blit_cmd_add(cmd, VIA_REG_PITCH,
+					VIA_PITCH_ENABLE | pitch);
+		via_blit_cmd_add(cmd, VIA_REG_KEYCONTROL, 0);
+	} else {
+		via_blit_cmd_add(cmd, VIA_REG_PITCH_M1, pitch);
+		via_blit_cmd_add(cmd, VIA_REG_DIMENSION_M1, dimension);
+		via_blit_cmd_add(cmd, VIA_REG_DSTPOS_M1, 0);
+		via_blit_cmd_add(cmd, VIA_REG_DSTBASE_M1, dst >> 3);
+		via_blit_cmd_add(cmd, VIA_REG_SRCPOS_M1, 0);
+		via_blit_cmd_add(cmd, VIA_REG_SRCBASE_M1, src >> 3);
+		via_blit_cmd_add(cmd, VIA_REG_KEYCONTROL_M1, 0);
+	}
+
+	via_blit_cmd_add(cmd, VIA_REG_GECMD,
+				VIA_GEC_BLT | VIA_GEC_SRC_FB | VIA_GEC_DST_FB |
+				VIA_GEC_INCX | VIA_GEC_INCY |
+				(VIA_BLIT_ROP_SRCCOPY << 24));
+	return 0;
+}
+
+/*
+ * Encode a fill of lines pages at VRAM offset dst with zeros, using
+ * the pattern color as the source.
+ */
+int via_blit_encode_clear(bool m1, u32 dst, u32 lines,
+				struct via_blit_cmd *cmd)
+{
+	u32 dimension, pitch;
+
+	cmd->count = 0;
+
+	if ((!lines) || (lines > VIA_BLIT_MAX_LINES) ||
+		(dst & 0xE0000007)) {
+		return -EINVAL;
+	}
+
+	dimension = ((VIA_BLIT_PITCH / 4) - 1) | ((lines - 1) << 16);
+	pitch = (VIA_BLIT_PITCH >> 3) << 16;
+
+	via_blit_cmd_add(cmd, VIA_REG_GEMODE, VIA_GEM_32bpp);
+	if (!m1) {
+		via_blit_cmd_add(cmd, VIA_REG_DSTPOS, 0);
+		via_blit_cmd_add(cmd, VIA_REG_DIMENSION, dimension);
+		via_blit_cmd_add(cmd, VIA_REG_FGCOLOR, 0);
+		via_blit_cmd_add(cmd, VIA_REG_DSTBASE, dst >> 3);
+		via_blit_cmd_add(cmd, VIA_REG_PITCH,
+					VIA_PITCH_ENABLE | pitch);
+		via_blit_cmd_add(cmd, VIA_REG_KEYCONTROL, 0);
+	} else {
+		via_blit_cmd_add(cmd, VIA_REG_PITCH_M1, pitch);
+		via_blit_cmd_add(cmd, VIA_REG_DIMENSION_M1, dimension);
+		via_blit_cmd_add(cmd, VIA_REG_DSTPOS_M1, 0);
+		via_blit_cmd_add(cmd, VIA_REG_DSTBASE_M1, dst >> 3);
+		via_blit_cmd_add(cmd, VIA_REG_MONOPATFGC_M1, 0);
+		via_blit_cmd_add(cmd, VIA_REG_KEYCONTROL_M1, 0);
+	}
+
+	via_blit_cmd_add(cmd, VIA_REG_GECMD,
+				VIA_GEC_BLT | VIA_GEC_DST_FB |
+				VIA_GEC_FIXCOLOR_PAT |
+				VIA_GEC_INCX | VIA_GEC_INCY |
+				(VIA_BLIT_ROP_PATCOPY << 24));
+	return 0;
+}
+
+static bool via_blit_busy(struct via_drm_priv *dev_priv)
+{
+	return VIA_READ(VIA_REG_STATUS) & VIA_2D_ENG_BUSY;
+}
+
+static int via_blit_wait_idle(struct via_drm_priv *dev_priv)
+{
+	u32 status;
+
+	return readl_poll_timeout(VIA_BASE + VIA_REG_STATUS, status,
+					!(status & VIA_2D_ENG_BUSY),
+					10, VIA_BLIT_TIMEOUT_US);
+}
+
+static const char *via_blit_fence_get_driver_name(struct dma_fence *fence)
+{
+	return DRIVER_NAME;
+}
+
+static const char *via_blit_fence_get_timeline_name(struct dma_fence *fence)
+{
+	return "2d";
+}
+
+static const struct dma_fence_ops via_blit_fence_ops = {
+	.get_driver_name = via_blit_fence_get_driver_name,
+	.get_timeline_name = via_blit_fence_get_timeline_name,
+};
+
+/*
+ * Signal every pending fence, with error set if the engine did not
+ * go idle. Called with fence_lock held.
+ */
+static void via_blit_signal_locked(struct via_blit *blit, int error)
+{
+	struct via_blit_fence *fence, *tmp;
+
+	list_for_each_entry_safe(fence, tmp, &blit->pending, head) {
+		list_del_init(&fence->head);
+		if (error) {
+			dma_fence_set_error(&fence->base, error);
+		}
+
+		dma_fence_signal_locked(&fence->base);
+		dma_fence_put(&fence->base);
+	}
+}
+
+static void via_blit_work(struct work_struct *work)
+{
+	struct via_blit *blit = container_of(to_delayed_work(work),
+						struct via_blit, work);
+	struct via_drm_priv *dev_priv = container_of(blit,
+						struct via_drm_priv, blit);
+	bool timeout;
+
+	spin_lock_irq(&blit->fence_lock);
+	if (!via_blit_busy(dev_priv)) {
+		via_blit_signal_locked(blit, 0);
+	} else {
+		timeout = time_after(jiffies, blit->submitted +
+				usecs_to_jiffies(VIA_BLIT_TIMEOUT_US));
+		if (!timeout) {
+			schedule_delayed_work(&blit->work, 1);
+		} else {
+			drm_err(&dev_priv->dev, "2D engine hang, "
+					"disabling accelerated moves!\n");
+			blit->enabled = false;
+			via_blit_signal_locked(blit, -ETIMEDOUT);
+		}
+	}
+
+	spin_unlock_irq(&blit->fence_lock);
+}
+
+static struct dma_fence *via_blit_fence_emit(struct via_blit *blit)
+{
+	struct via_blit_fence *fence;
+
+	fence = kzalloc(sizeof(*fence), GFP_KERNEL);
+	if (!fence) {
+		return NULL;
+	}
+
+	spin_lock_irq(&blit->fence_lock);
+	dma_fence_init(&fence->base, &via_blit_fence_ops, &blit->fence_lock,
+			blit->context, ++blit->seqno);
+
+	/* One reference for the pending list, one for the caller. */
+	dma_fence_get(&fence->base);
+	list_add_tail(&fence->head, &blit->pending);
+	blit->submitted = jiffies;
+	spin_unlock_irq(&blit->fence_lock);
+
+	schedule_delayed_work(&blit->work, 0);
+	return &fence->base;
+}
+
+static int via_blit_submit(struct drm_device *dev, bool clear,
+				u64 src, u64 dst, u64 size,
+				struct dma_fence **fence)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_blit *blit = &dev_priv->blit;
+	struct via_blit_cmd cmd;
+	u32 lines;
+	unsigned int i;
+	int ret = 0;
+
+	if ((!blit->enabled) || (!size) ||
+		(!IS_ALIGNED(size, VIA_BLIT_PITCH)) ||
+		(src + size > dev_priv->vram_size) ||
+		(dst + size > dev_priv->vram_size)) {
+		return -ENODEV;
+	}
+
+	mutex_lock(&blit->lock);
+	while (size) {
+		lines = min_t(u64, size / VIA_BLIT_PITCH, VIA_BLIT_MAX_LINES);
+		if (clear) {
+			ret = via_blit_encode_clear(blit->m1, dst, lines, &cmd);
+		} else {
+			ret = via_blit_encode(blit->m1, src, dst, lines, &cmd);
+		}
+
+		if (ret) {
+			ret = -ENODEV;
+			goto exit;
+		}
+
+		ret = via_blit_wait_idle(dev_priv);
+		if (ret) {
+			drm_err(dev, "2D engine hang, "
+					"disabling accelerated moves!\n");
+			blit->enabled = false;
+			ret = -ENODEV;
+			goto exit;
+		}
+
+		for (i = 0; i < cmd.count; i++) {
+			VIA_WRITE(cmd.reg[i], cmd.val[i]);
+		}
+
+		src += (u64)lines * VIA_BLIT_PITCH;
+		dst += (u64)lines * VIA_BLIT_PITCH;
+		size -= (u64)lines * VIA_BLIT_PITCH;
+	}
+
+	*fence = via_blit_fence_emit(blit);
+	if (!*fence) {
+		via_blit_wait_idle(dev_priv);
+		*fence = dma_fence_get_stub();
+	}
+exit:
+	mutex_unlock(&blit->lock);
+	return ret;
+}
+
+/*
+ * Copy size bytes from VRAM offset src to VRAM offset dst with the
+ * 2D engine. All but the last piece of a large copy are waited for
+ * here. The returned fence signals once the last one is done.
+ * Returns -ENODEV when the engine cannot be used, in which case the
+ * caller is expected to copy with the CPU instead.
+ */
+int via_blit_copy(struct drm_device *dev, u64 src, u64 dst, u64 size,
+			struct dma_fence **fence)
+{
+	return via_blit_submit(dev, false, src, dst, size, fence);
+}
+
+/*
+ * Zero size bytes at VRAM offset dst with the 2D engine. Same
+ * rules as via_blit_copy().
+ */
+int via_blit_clear(struct drm_device *dev, u64 dst, u64 size,
+			struct dma_fence **fence)
+{
+	return via_blit_submit(dev, true, 0, dst, size, fence);
+}
+
+void via_blit_init(struct drm_device *dev)
+{
+	struct pci_dev *pdev = to_pci_dev(dev->dev);
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_blit *blit = &dev_priv->blit;
+	u32 reg, last;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	mutex_init(&blit->lock);
+	spin_lock_init(&blit->fence_lock);
+	INIT_LIST_HEAD(&blit->pending);
+	INIT_DELAYED_WORK(&blit->work, via_blit_work);
+	blit->context = dma_fence_context_alloc(1);
+	blit->seqno = 0;
+	blit->enabled = false;
+
+	switch (pdev->device) {
+	case PCI_DEVICE_ID_VIA_CHROME9_HC3:
+	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
+	case PCI_DEVICE_ID_VIA_CHROME9_HD:
+		blit->m1 = true;
+		last = VIA_REG_MONOPATBGC_M1;
+		break;
+	default:
+		blit->m1 = false;
+		last = VIA_REG_MONOPAT1;
+		break;
+	}
+
+	if (!via_blit_enable) {
+		goto exit;
+	}
+
+	if (via_blit_wait_idle(dev_priv)) {
+		drm_err(dev, "2D engine is not idle, "
+				"using the CPU for buffer moves.\n");
+		goto exit;
+	}
+
+	/* Start from a known state of the 2D registers. */
+	for (reg = VIA_REG_GEMODE; reg <= last; reg += 4) {
+		VIA_WRITE(reg, 0x00);
+	}
+
+	blit->enabled = true;
+exit:
+	drm_dbg_driver(dev, "2D engine moves: %s\n",
+			blit->enabled ? "enabled" : "disabled");
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+}
+
+void via_blit_fini(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_blit *blit = &dev_priv->blit;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	cancel_delayed_work_sync(&blit->work);
+
+	spin_lock_irq(&blit->fence_lock);
+	via_blit_signal_locked(blit,
+			via_blit_busy(dev_priv) ? -ETIMEDOUT : 0);
+	spin_unlock_irq(&blit->fence_lock);
+
+	blit->enabled = false;
+
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_blit_test.c"
+#endif
@@ -0,0 +1,405 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+#include <linux/debugfs.h>
+#include <linux/dma-fence.h>
+#include <linux/dma-resv.h>
+#include <linux/log2.h>
+#include <linux/math64.h>
+#include <linux/seq_file.h>
+#include <linux/shrinker.h>
+
+#include <drm/drm_gem.h>
+#include <drm/drm_print.h>
+
+#include <drm/ttm/ttm_bo.h>
+#include <drm/ttm/ttm_tt.h>
+
+#include "via_drv.h"
+
+
+/*
+ * Clients that free and reallocate same sized buffers every frame
+ * would otherwise pay for a GEM object, its mmap offset, and a TTM
+ * validation each time. Idle buffers are parked here when their last
+ * handle is closed and handed out again for a matching size, domain,
+ * and placement. The cache holds a GEM reference on every parked
+ * buffer, which is handed to the new owner on reuse and dropped when
+ * the buffer is reaped. A reused buffer is cleared, with the 2D
+ * engine when it is in VRAM, since it may come from another client.
+ * Parked buffers stay on the TTM LRU lists; when they get evicted
+ * their contents are simply dropped (see via_bo_evict_flags()).
+ */
+
+static unsigned int via_bo_cache_bucket(u64 size)
+{
+	return min_t(unsigned int, ilog2(size >> PAGE_SHIFT),
+			VIA_BO_CACHE_BUCKETS - 1);
+}
+
+/* Called with the cache lock held. */
+static void via_bo_cache_unlink(struct via_bo_cache *cache,
+				struct via_bo *bo)
+{
+	list_del_init(&bo->cache_head);
+	list_del_init(&bo->cache_lru);
+	WRITE_ONCE(bo->cached, false);
+	cache->size -= bo->ttm_bo.base.size;
+	cache->count--;
+}
+
+/*
+ * Buffers leaving the cache are released from a work item, since
+ * the shrinker may run with VRAM manager or reservation locks held.
+ * Called with the cache lock held.
+ */
+static void via_bo_cache_reap_locked(struct via_bo_cache *cache,
+					struct via_bo *bo)
+{
+	via_bo_cache_unlink(cache, bo);
+	list_add_tail(&bo->cache_lru, &cache->reap);
+	schedule_work(&cache->reap_work);
+}
+
+static void via_bo_cache_reap_work(struct work_struct *work)
+{
+	struct via_bo_cache *cache = container_of(work, struct via_bo_cache,
+							reap_work);
+	struct via_bo *bo, *tmp;
+	LIST_HEAD(reap);
+
+	mutex_lock(&cache->lock);
+	list_splice_init(&cache->reap, &reap);
+	mutex_unlock(&cache->lock);
+
+	list_for_each_entry_safe(bo, tmp, &reap, cache_lru) {
+		list_del_init(&bo->cache_lru);
+		drm_gem_object_put(&bo->ttm_bo.base);
+	}
+}
+
+/*
+ * Zero a buffer taken from the cache. Called with the buffer
+ * reserved.
+ */
+static int via_bo_cache_clear(struct via_bo *bo)
+{
+	struct ttm_buffer_object *ttm_bo = &bo->ttm_bo;
+	struct ttm_resource *res = ttm_bo->resource;
+	struct ttm_bo_kmap_obj map;
+	struct dma_fence *fence;
+	bool is_iomem;
+	void *virtual;
+	int ret;
+
+	if (res->mem_type == TTM_PL_VRAM) {
+		ret = dma_resv_reserve_fences(ttm_bo->base.resv, 1);
+		if (ret) {
+			return ret;
+		}
+
+		ret = via_blit_clear(ttm_bo->base.dev,
+					(u64)res->start << PAGE_SHIFT,
+					ttm_bo->base.size, &fence);
+		if (!ret) {
+			dma_resv_add_fence(ttm_bo->base.resv, fence,
+						DMA_RESV_USAGE_KERNEL);
+			dma_fence_put(fence);
+			return 0;
+		}
+	} else if ((!ttm_bo->ttm) || (!ttm_tt_is_populated(ttm_bo->ttm))) {
+		/* Pages are zeroed when they get populated. */
+		return 0;
+	}
+
+	ret = ttm_bo_kmap(ttm_bo, 0, PFN_UP(ttm_bo->base.size), &map);
+	if (ret) {
+		return ret;
+	}
+
+	virtual = ttm_kmap_obj_virtual(&map, &is_iomem);
+	if (is_iomem) {
+		memset_io((void __iomem *)virtual, 0, ttm_bo->base.size);
+	} else {
+		memset(virtual, 0, ttm_bo->base.size);
+	}
+
+	ttm_bo_kunmap(&map);
+	return 0;
+}
+
+/*
+ * Take a cached buffer of the given page aligned size for the given
+ * domain and placement, or return NULL if there is none. The buffer
+ * is returned validated, cleared, and holding one GEM reference.
+ */
+struct via_bo *via_bo_cache_get(struct drm_device *dev, u64 size,
+				uint32_t ttm_domain, bool scanout)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct ttm_operation_ctx ctx = {true, false};
+	struct ttm_buffer_object *ttm_bo;
+	struct via_bo *bo = NULL, *iter;
+	struct list_head *bucket;
+	bool zeroed;
+	int ret;
+
+	if (ttm_domain > TTM_PL_VRAM) {
+		return NULL;
+	}
+
+	bucket = &cache->buckets[ttm_domain][via_bo_cache_bucket(size)];
+
+	mutex_lock(&cache->lock);
+	list_for_each_entry(iter, bucket, cache_head) {
+		if ((iter->ttm_bo.base.size == size) &&
+			(iter->scanout == scanout)) {
+			bo = iter;
+			via_bo_cache_unlink(cache, bo);
+			break;
+		}
+	}
+
+	if (bo) {
+		cache->hits++;
+	} else {
+		cache->misses++;
+	}
+
+	mutex_unlock(&cache->lock);
+
+	if (!bo) {
+		return NULL;
+	}
+
+	/* The cache's reference now belongs to the caller. */
+	ttm_bo = &bo->ttm_bo;
+	ret = ttm_bo_reserve(ttm_bo, true, false, NULL);
+	if (ret) {
+		goto error_put;
+	}
+
+	/*
+	 * A buffer whose contents were dropped on eviction comes back
+	 * zeroed by the move, so it does not need another clear.
+	 */
+	zeroed = (ttm_bo->resource->mem_type == TTM_PL_SYSTEM) &&
+			((!ttm_bo->ttm) || (!ttm_tt_is_populated(ttm_bo->ttm)));
+
+	via_ttm_domain_to_placement(bo, ttm_domain);
+	ret = ttm_bo_validate(ttm_bo, &bo->placement, &ctx);
+	if ((!ret) && (!zeroed)) {
+		ret = via_bo_cache_clear(bo);
+	}
+
+	ttm_bo_unreserve(ttm_bo);
+	if (ret) {
+		goto error_put;
+	}
+
+	return bo;
+error_put:
+	drm_gem_object_put(&ttm_bo->base);
+	return NULL;
+}
+
+/*
+ * Offer a buffer whose only reference is the caller's to the cache.
+ * If it can be reused, the cache takes a reference of its own and
+ * true is returned. The caller drops its reference either way.
+ */
+bool via_bo_cache_put(struct via_bo *bo)
+{
+	struct ttm_buffer_object *ttm_bo = &bo->ttm_bo;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(ttm_bo->base.dev);
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct via_bo *old, *tmp;
+	u64 size = ttm_bo->base.size;
+
+	if ((!cache->max_size) ||
+		(kref_read(&ttm_bo->base.refcount) != 1) ||
+		(ttm_bo->type != ttm_bo_type_device) ||
+		(ttm_bo->pin_count) ||
+		(ttm_bo->base.import_attach) ||
+		(bo->kmap.virtual) ||
+		(bo->domain > TTM_PL_VRAM) ||
+		(size > cache->max_size) ||
+		(!dma_resv_test_signaled(ttm_bo->base.resv,
+					DMA_RESV_USAGE_BOOKKEEP))) {
+		return false;
+	}
+
+	drm_gem_object_get(&ttm_bo->base);
+
+	mutex_lock(&cache->lock);
+	list_add(&bo->cache_head,
+		&cache->buckets[bo->domain][via_bo_cache_bucket(size)]);
+	list_add_tail(&bo->cache_lru, &cache->lru);
+	WRITE_ONCE(bo->cached, true);
+	cache->size += size;
+	cache->count++;
+
+	list_for_each_entry_safe(old, tmp, &cache->lru, cache_lru) {
+		if (cache->size <= cache->max_size) {
+			break;
+		}
+
+		via_bo_cache_reap_locked(cache, old);
+	}
+
+	mutex_unlock(&cache->lock);
+	return true;
+}
+
+static unsigned long via_bo_cache_count(struct shrinker *shrinker,
+					struct shrink_control *sc)
+{
+	struct via_bo_cache *cache = shrinker->private_data;
+	unsigned long pages = READ_ONCE(cache->size) >> PAGE_SHIFT;
+
+	return pages ? pages : SHRINK_EMPTY;
+}
+
+static unsigned long via_bo_cache_scan(struct shrinker *shrinker,
+					struct shrink_control *sc)
+{
+	struct via_bo_cache *cache = shrinker->private_data;
+	struct via_bo *bo, *tmp;
+	unsigned long freed = 0;
+
+	if (!mutex_trylock(&cache->lock)) {
+		return SHRINK_STOP;
+	}
+
+	list_for_each_entry_safe(bo, tmp, &cache->lru, cache_lru) {
+		if (freed >= sc->nr_to_scan) {
+			break;
+		}
+
+		freed += bo->ttm_bo.base.size >> PAGE_SHIFT;
+		via_bo_cache_reap_locked(cache, bo);
+	}
+
+	mutex_unlock(&cache->lock);
+
+	sc->nr_scanned = freed;
+	return freed ? freed : SHRINK_STOP;
+}
+
+#if defined(CONFIG_DEBUG_FS)
+static int via_bo_cache_stats_show(struct seq_file *m, void *unused)
+{
+	struct via_bo_cache *cache = m->private;
+	u64 lookups;
+
+	mutex_lock(&cache->lock);
+	lookups = cache->hits + cache->misses;
+	seq_printf(m, "hits: %llu\n", cache->hits);
+	seq_printf(m, "misses: %llu\n", cache->misses);
+	seq_printf(m, "hit rate: %llu%%\n",
+			lookups ? div64_u64(cache->hits * 100, lookups) : 0);
+	seq_printf(m, "buffers: %u\n", cache->count);
+	seq_printf(m, "size: %lluKiB of %lluKiB\n",
+			cache->size >> 10, cache->max_size >> 10);
+	mutex_unlock(&cache->lock);
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(via_bo_cache_stats);
+#endif
+
+void via_bo_cache_debugfs_init(struct via_drm_priv *dev_priv,
+				struct dentry *root)
+{
+#if defined(CONFIG_DEBUG_FS)
+	debugfs_create_file("via_bo_cache", 0444, root,
+				&dev_priv->bo_cache,
+				&via_bo_cache_stats_fops);
+#endif
+}
+
+int via_bo_cache_init(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	unsigned int i, j;
+
+	mutex_init(&cache->lock);
+	for (i = 0; i <= TTM_PL_VRAM; i++) {
+		for (j = 0; j < VIA_BO_CACHE_BUCKETS; j++) {
+			INIT_LIST_HEAD(&cache->buckets[i][j]);
+		}
+	}
+
+	INIT_LIST_HEAD(&cache->lru);
+	INIT_LIST_HEAD(&cache->reap);
+	INIT_WORK(&cache->reap_work, via_bo_cache_reap_work);
+	cache->size = 0;
+	cache->count = 0;
+	cache->hits = 0;
+	cache->misses = 0;
+
+	cache->shrinker = shrinker_alloc(0, "drm-via-bo-cache:%s",
+						dev->unique);
+	if (!cache->shrinker) {
+		return -ENOMEM;
+	}
+
+	cache->shrinker->count_objects = via_bo_cache_count;
+	cache->shrinker->scan_objects = via_bo_cache_scan;
+	cache->shrinker->private_data = cache;
+	shrinker_register(cache->shrinker);
+
+	/* A quarter of VRAM worth of buffers, across all domains. */
+	cache->max_size = dev_priv->vram_size / 4;
+	return 0;
+}
+
+void via_bo_cache_fini(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_bo_cache *cache = &dev_priv->bo_cache;
+	struct via_bo *bo, *tmp;
+
+	if (!cache->shrinker) {
+		return;
+	}
+
+	shrinker_free(cache->shrinker);
+	cache->shrinker = NULL;
+
+	mutex_lock(&cache->lock);
+	cache->max_size = 0;
+	list_for_each_entry_safe(bo, tmp, &cache->lru, cache_lru) {
+		via_bo_cache_reap_locked(cache, bo);
+	}
+
+	mutex_unlock(&cache->lock);
+
+	flush_work(&cache->reap_work);
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2012 James Simmons. All Rights Reserved.
+ * Copyright 1998-2009 VIA Technologies, Inc. All Rights Reserved.
+ * Copyright 2001-2009 S3 Graphics, Inc. All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation;
+ * either version 2, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTIES OR REPRESENTATIONS; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.See the GNU General Public License
+ * for more details.
+ *
+ * Author(s):
+ * James Simmons <jsimmons@infradead.org>
+ */
+
+#include <linux/bits.h>
+#include <linux/math.h>
+#include <linux/math64.h>
+#include <linux/minmax.h>
+#include <linux/pci_ids.h>
+
+#include "via_drv.h"
+
+
+#define CSR_VCO_UP	600000000
+#define CSR_VCO_DOWN	300000000
+
+#define PLL_DTZ_DEFAULT		(BIT(0) | BIT(1))
+
+#define VIA_CLK_REFERENCE	14318180
+
+/*
+ * Both PLL formulas compute the output frequency as
+ * fout(m) = (mul * m) / div, which grows strictly with M. The
+ * distance to the target frequency is therefore smallest next to
+ * m0 = freq * div / mul, with fout(m0) <= freq <= fout(m0 + 1).
+ * Clamped to the valid M range, these are the only two M values of a
+ * given (N, R) pair that can ever be picked by a full search over M.
+ */
+static unsigned int via_pll_m_candidates(u32 freq, u32 mul, u32 div,
+					u32 m_min, u32 m_max, u32 *m)
+{
+	u64 m0 = div64_u64((u64)freq * div, mul);
+	u32 lo, hi;
+
+	if (m_min > m_max) {
+		return 0;
+	}
+
+	lo = clamp_t(u64, m0, m_min, m_max);
+	hi = clamp_t(u64, m0 + 1, m_min, m_max);
+
+	m[0] = lo;
+	if (hi == lo) {
+		return 1;
+	}
+
+	m[1] = hi;
+	return 2;
+}
+
+static u32 via_pll_diff(u32 fout, u32 freq)
+{
+	return (fout < freq) ? freq - fout : fout - freq;
+}
+
+/*
+ * Packs the chosen M, N and R values into the clock synthesizer
+ * register layout of the chipset.
+ */
+static u32 via_pll_mrn(u16 device, u32 pll_m, u32 pll_n, u32 pll_r)
+{
+	u32 pll_mrn;
+
+	switch (device) {
+	case PCI_DEVICE_ID_VIA_CLE266_GFX:
+	case PCI_DEVICE_ID_VIA_KM400_GFX:
+		/* Clock Synthesizer Value 0[7:6]: DR[1:0]
+		 * Clock Synthesizer Value 0[5:0]: DN[5:0] */
+		pll_mrn = ((pll_r & 0x3) << 14 |
+				(pll_n & 0x1F) << 8);
+		/* Clock Synthesizer Value 1[6:0]: DM[6:0] */
+		pll_mrn |= (pll_m & 0x7F);
+		break;
+	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
+	case PCI_DEVICE_ID_VIA_CHROME9_HD:
+		/* Clock Synthesizer Value 0 : DM[7:0] */
+		pll_mrn = (pll_m & 0xFF) << 16;
+		/* Clock Synthesizer Value 1[1:0] : DM[9:8]
+		 * Clock Synthesizer Value 1[4:2] : DR[2:0]
+		 * Clock Synthesizer Value 1[7] : DTZ[0] */
+		pll_mrn |= (((PLL_DTZ_DEFAULT & 0x1) << 7) |
+				((pll_r & 0x7) << 2) |
+				(((pll_m) >> 8) & 0x3)) << 8;
+		/* Clock Synthesizer Value 2[6:0] : DN[6:0]
+		 * Clock Synthesizer Value 2[7] : DTZ[1] */
+		pll_mrn |= (((PLL_DTZ_DEFAULT >> 1) & 0x1) << 7) |
+				((pll_n) & 0x7F);
+		break;
+	default:
+		/* Clock Synthesizer Value 0 : DM[7:0] */
+		pll_mrn = ((pll_m - 2) & 0xFF) << 16;
+		/* Clock Synthesizer Value 1[1:0] : DM[9:8]
+		 * Clock Synthesizer Value 1[4:2] : DR[2:0]
+		 * Clock Synthesizer Value 1[7] : DTZ[0] */
+		pll_mrn |= (((PLL_DTZ_DEFAULT & 0x1) << 7) |
+				((pll_r & 0x7) << 2) |
+				(((pll_m - 2) >> 8) & 0x3)) << 8;
+		/* Clock Synthesizer Value 2[6:0] : DN[6:0]
+		 * Clock Synthesizer Value 2[7] : DTZ[1] */
+		pll_mrn |= (((PLL_DTZ_DEFAULT >> 1) & 0x1) << 7) |
+				((pll_n - 2) & 0x7F);
+		break;
+	}
+	return pll_mrn;
+}
+
+/*
+ * This function first gets the best frequency M, R, N value
+ * to program the PLL according to the supplied frequence
+ * passed in. Only the M values nearest to the target are evaluated
+ * for each (N, R) pair, in the same order as an exhaustive search
+ * would visit them, so ties are resolved the same way.
+ *
+ * The result only depends on the chipset's PCI device ID and the
+ * requested frequency, not on any hardware state.
+ */
+u32 via_pll_solve(u16 device, u32 freq)
+{
+	u32 best_pll_n = 2, best_pll_r = 0, best_pll_m = 2, best_clk_diff = freq;
+	u32 last_pll_n = 0, last_pll_r = 0, last_pll_m = 0;
+	u32 last_clk_diff = 0;
+	bool last_valid = false;
+	u32 pll_fout;
+	u32 pll_n, pll_r, clk_diff, div_ref;
+	u32 m[2];
+	unsigned int count, i;
+
+	if ((device != PCI_DEVICE_ID_VIA_CLE266_GFX) &&
+		(device != PCI_DEVICE_ID_VIA_KM400_GFX)) {
+		/* DN[6:0] */
+		for (pll_n = 2; pll_n < 6; pll_n++) {
+			/* first divide pll_n then multiply pll_m */
+			div_ref = VIA_CLK_REFERENCE / pll_n;
+
+			/* DR[2:0] */
+			for (pll_r = 0; pll_r < 6; pll_r++) {
+				/* DM[9:0], limited to keep the VCO in range */
+				count = via_pll_m_candidates(freq,
+					div_ref, 1 << pll_r,
+					max_t(u32, 2,
+					DIV_ROUND_UP(CSR_VCO_DOWN, div_ref)),
+					min_t(u32, 511,
+					CSR_VCO_UP / div_ref), m);
+
+				for (i = 0; i < count; i++) {
+					pll_fout = (div_ref * m[i]) >> pll_r;
+					clk_diff = via_pll_diff(pll_fout, freq);
+
+					/* if frequency (which is the PLL we want
+					 * to set) > 150MHz, the MRN value we
+					 * write in register must < frequency, and
+					 * get MRN value whose M is the largeset */
+					if ((!last_valid) ||
+						(clk_diff <= last_clk_diff)) {
+						last_valid = true;
+						last_clk_diff = clk_diff;
+						last_pll_m = m[i];
+						last_pll_n = pll_n;
+						last_pll_r = pll_r;
+					}
+
+					if (clk_diff < best_clk_diff) {
+						best_clk_diff = clk_diff;
+						best_pll_m = m[i];
+						best_pll_n = pll_n;
+						best_pll_r = pll_r;
+					}
+				}
+			} /* for PLL R */
+		} /* for PLL N */
+
+		/* if frequency(which is the PLL we want to set) > 150MHz,
+		 * the MRN value we write in register must < frequency,
+		 * and get MRN value whose M is the largeset */
+		if (freq > 150000000) {
+			best_pll_m = last_pll_m;
+			best_pll_r = last_pll_r;
+			best_pll_n = last_pll_n;
+		}
+	/* UniChrome IGP (CLE266, KM400(A), KN400, and P4M800 chipsets)
+	 * requires a different formula for calculating the PLL parameters.
+	 * The code was borrowed from OpenChrome DDX device driver UMS
+	 * (User Mode Setting) section, but was modified to not use float type
+	 * variables. */
+	} else {
+		for (pll_r = 0; pll_r < 4; ++pll_r) {
+			for (pll_n = (pll_r == 0) ? 2 : 1; pll_n <= 7; ++pll_n) {
+				count = via_pll_m_candidates(freq,
+						VIA_CLK_REFERENCE,
+						pll_n << pll_r, 1, 127, m);
+
+				for (i = 0; i < count; i++) {
+					pll_fout = VIA_CLK_REFERENCE * m[i];
+					pll_fout /= (pll_n << pll_r);
+					clk_diff = via_pll_diff(pll_fout, freq);
+
+					if (clk_diff < best_clk_diff) {
+						best_clk_diff = clk_diff;
+						best_pll_m = m[i] & 0x7F;
+						best_pll_n = pll_n & 0x1F;
+						best_pll_r = pll_r & 0x03;
+					}
+				}
+			}
+		}
+	}
+
+	return via_pll_mrn(device, best_pll_m, best_pll_n, best_pll_r);
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_clock_test.c"
+#endif
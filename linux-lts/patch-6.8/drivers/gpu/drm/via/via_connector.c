@@ -26,10 +26,336 @@
  * James Simmons <jsimmons@infradead.org>
  */
 
+#include <linux/i2c.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+
 #include <drm/drm_connector.h>
+#include <drm/drm_debugfs.h>
+#include <drm/drm_edid.h>
+#include <drm/drm_modeset_lock.h>
+#include <drm/drm_print.h>
 
 #include "via_drv.h"
 
+#define VIA_DDC_SEGMENT_ADDR	0x30
+#define VIA_DDC_ADDR		0x50
+
+#define VIA_EDID_PROBE_SIZE	10
+
+/*
+ * Bytes re-read to check a cached EDID: the vendor and product IDs,
+ * serial number and week and year of manufacture, which tell apart
+ * two displays of the same model, then the extension block count
+ * and the checksum. The checksum of each extension block is read
+ * after them.
+ */
+static const struct {
+	u8 offset;
+	u8 size;
+} via_edid_probe[] = {
+	{ 0x08, 10 },
+	{ 0x7E, 2 },
+};
+
+/*
+ * Read len bytes from offset of the EDID, setting the E-DDC
+ * segment pointer for offsets past the first 256 bytes.
+ */
+static int via_ddc_read(struct i2c_adapter *i2c_bus, unsigned int offset,
+			u8 *buf, size_t len)
+{
+	u8 segment = offset >> 8;
+	u8 start = offset & 0xFF;
+	struct i2c_msg msgs[] = {
+		{
+			.addr	= VIA_DDC_SEGMENT_ADDR,
+			.flags	= 0,
+			.len	= 1,
+			.buf	= &segment,
+		}, {
+			.addr	= VIA_DDC_ADDR,
+			.flags	= 0,
+			.len	= 1,
+			.buf	= &start,
+		}, {
+			.addr	= VIA_DDC_ADDR,
+			.flags	= I2C_M_RD,
+			.len	= len,
+			.buf	= buf,
+		}
+	};
+	int xfers = segment ? 3 : 2;
+	int retries, ret = -EIO;
+
+	for (retries = 5; retries; retries--) {
+		ret = i2c_transfer(i2c_bus, &msgs[3 - xfers], xfers);
+		if (ret == xfers) {
+			return 0;
+		}
+
+		/* Nothing acknowledged the address, so do not retry. */
+		if (ret == -ENXIO) {
+			break;
+		}
+	}
+
+	return (ret < 0) ? ret : -EIO;
+}
+
+/*
+ * Check for a display on a DDC bus by addressing it for a one byte
+ * read. An empty bus does not acknowledge the address, so it costs
+ * a single byte time instead of the retried transfers of a full
+ * EDID read. On connectors with a hotplug sense, an empty bus is not
+ * probed again while the sense says nothing is connected, see
+ * via_connector_hotplug_sense(). When it says a display is there,
+ * a bus that did not answer is probed again on every read, since
+ * the display may just have been slow to bring up its DDC.
+ */
+bool via_connector_ddc_probe(struct via_connector *con,
+				struct i2c_adapter *i2c_bus)
+{
+	struct via_edid_cache *cache = &con->edid_cache;
+	u8 buf;
+	struct i2c_msg msg = {
+		.addr	= VIA_DDC_ADDR,
+		.flags	= I2C_M_RD,
+		.len	= 1,
+		.buf	= &buf,
+	};
+
+	if ((cache->has_sense) && (!cache->sense) &&
+		(cache->absent_bus == i2c_bus)) {
+		return false;
+	}
+
+	if (i2c_transfer(i2c_bus, &msg, 1) != 1) {
+		cache->absent_bus = i2c_bus;
+		return false;
+	}
+
+	if (cache->absent_bus == i2c_bus) {
+		cache->absent_bus = NULL;
+	}
+
+	return true;
+}
+
+/*
+ * Record the state of a connector's hotplug sense. A change means a
+ * display was plugged or unplugged, so forget what is known about
+ * its DDC bus.
+ */
+void via_connector_hotplug_sense(struct via_connector *con, bool sense)
+{
+	struct via_edid_cache *cache = &con->edid_cache;
+
+	if ((cache->has_sense) && (cache->sense == sense)) {
+		return;
+	}
+
+	cache->has_sense = true;
+	cache->sense = sense;
+	via_connector_edid_invalidate(con);
+}
+
+struct via_edid_read {
+	struct via_edid_cache *cache;
+	struct i2c_adapter *i2c_bus;
+};
+
+static int via_edid_read_block(void *data, u8 *buf, unsigned int block,
+				size_t len)
+{
+	struct via_edid_read *read = data;
+	struct via_edid_cache *cache = read->cache;
+	size_t offset = block * EDID_LENGTH;
+
+	if (!read->i2c_bus) {
+		if (offset + len > cache->size) {
+			return -EINVAL;
+		}
+
+		memcpy(buf, cache->edid + offset, len);
+		return 0;
+	}
+
+	return via_ddc_read(read->i2c_bus, offset, buf, len);
+}
+
+static void via_edid_cache_invalidate(struct via_edid_cache *cache)
+{
+	kfree(cache->edid);
+	cache->edid = NULL;
+	cache->size = 0;
+	cache->i2c_bus = NULL;
+}
+
+/*
+ * Compare the identifying bytes of the EDID on the bus with the
+ * cached one, and the checksum of each cached extension block.
+ * Returns 1 if they match, 0 if not, or a negative error code if the
+ * display did not answer.
+ */
+static int via_edid_cache_check(struct via_edid_cache *cache,
+				struct i2c_adapter *i2c_bus)
+{
+	u8 probe[VIA_EDID_PROBE_SIZE];
+	unsigned int i, offset;
+	int ret;
+
+	for (i = 0; i < ARRAY_SIZE(via_edid_probe); i++) {
+		ret = via_ddc_read(i2c_bus, via_edid_probe[i].offset, probe,
+					via_edid_probe[i].size);
+		if (ret) {
+			return ret;
+		}
+
+		if (memcmp(probe, cache->edid + via_edid_probe[i].offset,
+				via_edid_probe[i].size)) {
+			return 0;
+		}
+	}
+
+	/* A display may change an extension block only. */
+	for (offset = 2 * EDID_LENGTH - 1; offset < cache->size;
+		offset += EDID_LENGTH) {
+		ret = via_ddc_read(i2c_bus, offset, probe, 1);
+		if (ret) {
+			return ret;
+		}
+
+		if (probe[0] != cache->edid[offset]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * drm_get_edid() replacement for connector detection and mode
+ * probing. Reading a whole EDID over the bit-banged DDC buses takes
+ * tens of milliseconds of busy waiting, and the outputs get polled
+ * every 10 seconds. The last EDID read from the bus is kept, and as
+ * long as the display still returns the same identity, extension
+ * count and checksums, it is handed out again instead of being
+ * re-read. The caller owns, and has to kfree(), the returned EDID.
+ */
+struct edid *via_connector_get_edid(struct via_connector *con,
+					struct i2c_adapter *i2c_bus)
+{
+	struct drm_connector *connector = &con->base;
+	struct via_edid_cache *cache = &con->edid_cache;
+	struct via_edid_read read = {
+		.cache		= cache,
+		.i2c_bus	= i2c_bus,
+	};
+	struct edid *edid;
+	ktime_t start;
+	s64 elapsed;
+	int ret;
+
+	/* Forced connectors keep the stock behavior. */
+	if (connector->force != DRM_FORCE_UNSPECIFIED) {
+		return drm_get_edid(connector, i2c_bus);
+	}
+
+	start = ktime_get();
+	if (cache->i2c_bus != i2c_bus) {
+		if (!via_connector_ddc_probe(con, i2c_bus)) {
+			return NULL;
+		}
+
+		goto read;
+	}
+
+	/* Reading the probe bytes also tells if the display is there. */
+	ret = via_edid_cache_check(cache, i2c_bus);
+	if (ret < 0) {
+		via_edid_cache_invalidate(cache);
+		return NULL;
+	}
+
+	if (ret) {
+		elapsed = ktime_to_ns(ktime_sub(ktime_get(), start));
+		cache->hits++;
+		if (cache->read_ns > elapsed) {
+			cache->saved_ns += cache->read_ns - elapsed;
+		}
+
+		read.i2c_bus = NULL;
+		return drm_do_get_edid(connector, via_edid_read_block, &read);
+	}
+
+read:
+	cache->misses++;
+	edid = drm_do_get_edid(connector, via_edid_read_block, &read);
+	via_edid_cache_invalidate(cache);
+	if (!edid) {
+		return NULL;
+	}
+
+	cache->size = (edid->extensions + 1) * EDID_LENGTH;
+	cache->edid = kmemdup(edid, cache->size, GFP_KERNEL);
+	if (cache->edid) {
+		cache->i2c_bus = i2c_bus;
+		cache->read_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	} else {
+		cache->size = 0;
+	}
+
+	return edid;
+}
+
+/*
+ * Drop the cached EDID, so the next read goes to the display. Called
+ * when a hotplug event says the display may have changed.
+ */
+void via_connector_edid_invalidate(struct via_connector *con)
+{
+	via_edid_cache_invalidate(&con->edid_cache);
+	con->edid_cache.absent_bus = NULL;
+}
+
+static int via_edid_cache_show(struct seq_file *m, void *unused)
+{
+	struct drm_debugfs_entry *entry = m->private;
+	struct drm_device *dev = entry->dev;
+	struct drm_connector_list_iter conn_iter;
+	struct drm_connector *connector;
+	struct via_edid_cache *cache;
+	u64 lookups;
+
+	drm_modeset_lock(&dev->mode_config.connection_mutex, NULL);
+	drm_connector_list_iter_begin(dev, &conn_iter);
+	drm_for_each_connector_iter(connector, &conn_iter) {
+		cache = &container_of(connector, struct via_connector,
+					base)->edid_cache;
+		lookups = cache->hits + cache->misses;
+		seq_printf(m, "%s: hits %llu, misses %llu, "
+				"hit rate %llu%%, bus time saved %llu ms\n",
+				connector->name, cache->hits, cache->misses,
+				lookups ? div64_u64(cache->hits * 100,
+							lookups) : 0,
+				div_u64(cache->saved_ns, NSEC_PER_MSEC));
+	}
+
+	drm_connector_list_iter_end(&conn_iter);
+	drm_modeset_unlock(&dev->mode_config.connection_mutex);
+
+	return 0;
+}
+
+void via_connector_debugfs_init(struct drm_device *dev)
+{
+	drm_debugfs_add_file(dev, "via_edid_cache", via_edid_cache_show,
+				NULL);
+}
+
 void via_connector_destroy(struct drm_connector *connector)
 {
 	struct via_connector *con = container_of(connector, struct via_connector, base);
@@ -39,8 +365,12 @@ void via_connector_destroy(struct drm_connector *connector)
 		drm_property_destroy(connector->dev, property);
 	list_del(&con->props);
 
+	via_edid_cache_invalidate(&con->edid_cache);
 	drm_connector_update_edid_property(connector, NULL);
 	drm_connector_unregister(connector);
 	drm_connector_cleanup(connector);
 }
 
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_connector_test.c"
+#endif
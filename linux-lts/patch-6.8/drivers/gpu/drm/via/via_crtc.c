@@ -28,14 +28,17 @@
  * James Simmons <jsimmons@infradead.org>
  */
 
+#include <linux/delay.h>
 #include <linux/pci.h>
 #include <linux/pci_ids.h>
+#include <linux/seq_file.h>
 
 #include <drm/drm_atomic.h>
 #include <drm/drm_atomic_helper.h>
 #include <drm/drm_atomic_state_helper.h>
 #include <drm/drm_crtc.h>
 #include <drm/drm_crtc_helper.h>
+#include <drm/drm_debugfs.h>
 #include <drm/drm_fourcc.h>
 #include <drm/drm_framebuffer.h>
 #include <drm/drm_gem.h>
@@ -43,6 +46,8 @@
 #include <drm/drm_modeset_helper_vtables.h>
 #include <drm/drm_plane.h>
 #include <drm/drm_print.h>
+#include <drm/drm_rect.h>
+#include <drm/drm_vblank.h>
 
 #include <drm/ttm/ttm_bo.h>
 
@@ -81,7 +86,7 @@ static void via_iga_common_init(struct drm_device *dev)
 	 * 3C5.15[1]   - Extended Display Mode Enable
 	 *               0: Disable
 	 *               1: Enable */
-	svga_wseq_mask(VGABASE, 0x15, BIT(5) | BIT(1), BIT(5) | BIT(1));
+	svga_wseq_mask(VGASHADOW, 0x15, BIT(5) | BIT(1), BIT(5) | BIT(1));
 
 	/*
 	 * It was observed on NeoWare CA10 thin client with DVI that not
@@ -89,7 +94,7 @@ static void via_iga_common_init(struct drm_device *dev)
 	 * distorted.
 	 */
 	if (pdev->device == PCI_DEVICE_ID_VIA_CLE266_GFX) {
-		svga_wcrt_mask(VGABASE, 0x55, 0x00, BIT(7));
+		svga_wcrt_mask(VGASHADOW, 0x55, 0x00, BIT(7));
 	}
 
 	/*
@@ -101,15 +106,153 @@ static void via_iga_common_init(struct drm_device *dev)
 	 *               0: Disable
 	 *               1: Enable
 	 */
-	svga_wcrt_mask(VGABASE, 0x6B, 0x00, BIT(3));
+	svga_wcrt_mask(VGASHADOW, 0x6B, 0x00, BIT(3));
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
-static void via_iga1_set_color_depth(struct drm_device *dev,
-					u8 cpp, u8 depth)
+/*
+ * Plane updates do not write the hardware directly. Their register
+ * writes are staged in the CRTC's queue between atomic_begin and
+ * atomic_flush, and go out in one burst with interrupts disabled.
+ * A write to a register that is already queued is folded into the
+ * earlier entry. Entries keep their order otherwise, since the start
+ * address registers have to be written in a specific order on some
+ * hardware.
+ */
+static void via_reg_queue_write(struct via_crtc *iga,
+				struct via_reg_queue_entry *entry)
 {
+	struct drm_device *dev = iga->base.dev;
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+
+	if (entry->vga) {
+		via_vga_shadow_write_mask(VGASHADOW, entry->reg >> 8,
+						entry->reg & 0xFF,
+						entry->data, entry->mask);
+	} else if (entry->mask == 0xFFFFFFFF) {
+		VIA_WRITE(entry->reg, entry->data);
+	} else {
+		VIA_WRITE_MASK(entry->reg, entry->data, entry->mask);
+	}
+}
+
+static void via_reg_queue_write_out(struct via_crtc *iga)
+{
+	struct via_reg_queue *queue = &iga->queue;
+	unsigned long flags;
+	unsigned int i;
+
+	local_irq_save(flags);
+	for (i = 0; i < queue->count; i++) {
+		via_reg_queue_write(iga, &queue->entries[i]);
+	}
+
+	local_irq_restore(flags);
+	queue->count = 0;
+}
+
+static void via_reg_queue_add(struct via_crtc *iga, bool vga, u32 reg,
+				u32 data, u32 mask)
+{
+	struct via_reg_queue *queue = &iga->queue;
+	struct via_reg_queue_entry *entry;
+	unsigned int i;
+
+	if (!queue->open) {
+		struct via_reg_queue_entry now = {
+			.reg = reg,
+			.data = data,
+			.mask = mask,
+			.vga = vga,
+		};
+
+		via_reg_queue_write(iga, &now);
+		return;
+	}
+
+	for (i = 0; i < queue->count; i++) {
+		entry = &queue->entries[i];
+		if ((entry->vga == vga) && (entry->reg == reg)) {
+			entry->data = (entry->data & ~mask) | (data & mask);
+			entry->mask |= mask;
+			return;
+		}
+	}
+
+	if (queue->count == VIA_REG_QUEUE_SIZE) {
+		via_reg_queue_write_out(iga);
+	}
+
+	entry = &queue->entries[queue->count++];
+	entry->reg = reg;
+	entry->data = data & mask;
+	entry->mask = mask;
+	entry->vga = vga;
+}
+
+void via_reg_queue_vga(struct via_crtc *iga, u16 ioport, u8 index,
+			u8 data, u8 mask)
+{
+	via_reg_queue_add(iga, true, (ioport << 8) | index, data, mask);
+}
+
+void via_reg_queue_mmio(struct via_crtc *iga, u32 reg, u32 data, u32 mask)
+{
+	via_reg_queue_add(iga, false, reg, data, mask);
+}
+
+/*
+ * Queued counterpart of load_value_to_registers.
+ */
+void via_reg_queue_value(struct via_crtc *iga, struct vga_registers *regs,
+				unsigned int value)
+{
+	unsigned int bit_num = 0, i;
+	struct vga_regset *regset;
+	u8 mask, width;
+
+	for (i = 0; i < regs->count; i++) {
+		regset = &regs->regs[i];
+		width = regset->end_bit - regset->start_bit + 1;
+		mask = GENMASK(regset->end_bit, regset->start_bit);
+
+		via_reg_queue_vga(iga, regset->ioport, regset->io_addr,
+				((value >> bit_num) << regset->start_bit) & mask,
+				mask);
+		bit_num += width;
+	}
+}
+
+/*
+ * There is no scanline counter to evade the vertical blank with, so
+ * make sure the burst does not start while IGA1 is in vertical
+ * retrace (3DA[3]), which is when the start address gets latched.
+ * IGA2 has no retrace status bit, and is written right away.
+ */
+static void via_crtc_evade_vblank(struct via_crtc *iga)
+{
+	struct drm_device *dev = iga->base.dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	unsigned int i;
+
+	if ((iga->index) || (!iga->base.state->active)) {
+		return;
+	}
+
+	for (i = 0; i < VIA_VBLANK_EVASION_TIMEOUT_US; i++) {
+		if (!(vga_r(VGABASE, VGA_IS1_RC) & BIT(3))) {
+			break;
+		}
+
+		udelay(1);
+	}
+}
+
+static void via_iga1_set_color_depth(struct via_crtc *iga,
+					u8 cpp, u8 depth)
+{
+	struct drm_device *dev = iga->base.dev;
 	u8 data;
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
@@ -142,15 +285,16 @@ static void via_iga1_set_color_depth(struct drm_device *dev,
 	 *               10: 30bpp
 	 *               11: 32bpp
 	 */
-	svga_wseq_mask(VGABASE, 0x15, data, BIT(4) | BIT(3) | BIT(2));
+	via_reg_queue_vga(iga, VGA_SEQ_I, 0x15,
+				data, BIT(4) | BIT(3) | BIT(2));
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
-static void via_iga2_set_color_depth(struct drm_device *dev,
+static void via_iga2_set_color_depth(struct via_crtc *iga,
 					u8 cpp, u8 depth)
 {
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct drm_device *dev = iga->base.dev;
 	u8 data;
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
@@ -178,7 +322,7 @@ static void via_iga2_set_color_depth(struct drm_device *dev,
 	 *               10: 30bpp
 	 *               11: 32bpp
 	 */
-	svga_wcrt_mask(VGABASE, 0x67, data, BIT(7) | BIT(6));
+	via_reg_queue_vga(iga, VGA_CRT_IC, 0x67, data, BIT(7) | BIT(6));
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
@@ -208,17 +352,17 @@ static int via_gamma_set(struct drm_crtc *crtc,
 		/*
 		 * Access IGA1's pallette LUT.
 		 */
-		svga_wseq_mask(VGABASE, 0x1A, 0x00, BIT(0));
+		svga_wseq_mask(VGASHADOW, 0x1A, 0x00, BIT(0));
 
 		/*
 		 * Is it an 8-bit color mode?
 		 */
 		if (crtc->primary->fb->format->cpp[0] == 1) {
 			/* Change to Primary Display's LUT */
-			val = vga_rseq(VGABASE, 0x1B);
-			vga_wseq(VGABASE, 0x1B, val);
-			val = vga_rcrt(VGABASE, 0x67);
-			vga_wcrt(VGABASE, 0x67, val);
+			val = via_vga_rseq(VGASHADOW, 0x1B);
+			via_vga_wseq(VGASHADOW, 0x1B, val);
+			val = via_vga_rcrt(VGASHADOW, 0x67);
+			via_vga_wcrt(VGASHADOW, 0x67, val);
 
 			/* Fill in IGA1's LUT */
 			for (i = 0; i < end; i++) {
@@ -230,15 +374,15 @@ static int via_gamma_set(struct drm_crtc *crtc,
 				vga_w(VGABASE, VGA_PEL_D, b[i] >> 8);
 			}
 			/* enable LUT */
-			svga_wseq_mask(VGABASE, 0x1B, 0x00, BIT(0));
+			svga_wseq_mask(VGASHADOW, 0x1B, 0x00, BIT(0));
 			/*
 			 * Disable gamma in case it was enabled
 			 * previously
 			 */
-			svga_wcrt_mask(VGABASE, 0x33, 0x00, BIT(7));
+			svga_wcrt_mask(VGASHADOW, 0x33, 0x00, BIT(7));
 		} else {
 			/* Enable Gamma */
-			svga_wcrt_mask(VGABASE, 0x33, BIT(7), BIT(7));
+			svga_wcrt_mask(VGASHADOW, 0x33, BIT(7), BIT(7));
 
 			/* Fill in IGA1's gamma */
 			for (i = 0; i < end; i++) {
@@ -254,22 +398,22 @@ static int via_gamma_set(struct drm_crtc *crtc,
 		/*
 		 * Access IGA2's pallette LUT.
 		 */
-		svga_wseq_mask(VGABASE, 0x1A, BIT(0), BIT(0));
+		svga_wseq_mask(VGASHADOW, 0x1A, BIT(0), BIT(0));
 
 		/*
 		 * Is it an 8-bit color mode?
 		 */
 		if (crtc->primary->fb->format->cpp[0] == 1) {
 			/* Enable Secondary Display Engine */
-			svga_wseq_mask(VGABASE, 0x1B, BIT(7), BIT(7));
+			svga_wseq_mask(VGASHADOW, 0x1B, BIT(7), BIT(7));
 			/* Second Display Color Depth, 8bpp */
-			svga_wcrt_mask(VGABASE, 0x67, 0x3F, 0x3F);
+			svga_wcrt_mask(VGASHADOW, 0x67, 0x3F, 0x3F);
 
 			/*
 			 * Enable second display channel just in case.
 			 */
-			if (!(vga_rcrt(VGABASE, 0x6A) & BIT(7)))
-				svga_wcrt_mask(VGABASE, 0x6A,
+			if (!(via_vga_rcrt(VGASHADOW, 0x6A) & BIT(7)))
+				svga_wcrt_mask(VGASHADOW, 0x6A,
 						BIT(7), BIT(7));
 
 			/* Fill in IGA2's LUT */
@@ -285,12 +429,12 @@ static int via_gamma_set(struct drm_crtc *crtc,
 			 * Disable gamma in case it was enabled
 			 * previously
 			 */
-			svga_wcrt_mask(VGABASE, 0x6A, 0x00, BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x6A, 0x00, BIT(1));
 		} else {
 			u8 reg_bits = BIT(1);
 
 			/* Bit 1 enables gamma */
-			svga_wcrt_mask(VGABASE, 0x6A, BIT(1), BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x6A, BIT(1), BIT(1));
 
 			/* Old platforms LUT are 6 bits in size.
 			 * Newer it is 8 bits. */
@@ -305,7 +449,7 @@ static int via_gamma_set(struct drm_crtc *crtc,
 				reg_bits |= BIT(5);
 				break;
 			}
-			svga_wcrt_mask(VGABASE, 0x6A, reg_bits,
+			svga_wcrt_mask(VGASHADOW, 0x6A, reg_bits,
 					reg_bits);
 
 			/*
@@ -316,8 +460,8 @@ static int via_gamma_set(struct drm_crtc *crtc,
 			 * for about 1 sec and then be turned on
 			 * again.
 			 */
-			if (!(vga_rcrt(VGABASE, 0x6A) & BIT(7)))
-				svga_wcrt_mask(VGABASE, 0x6A,
+			if (!(via_vga_rcrt(VGASHADOW, 0x6A) & BIT(7)))
+				svga_wcrt_mask(VGASHADOW, 0x6A,
 						BIT(7), BIT(7));
 
 			/* Fill in IGA2's gamma */
@@ -353,6 +497,9 @@ static const struct drm_crtc_funcs via_drm_crtc_funcs = {
 	.page_flip = drm_atomic_helper_page_flip,
 	.atomic_duplicate_state = drm_atomic_helper_crtc_duplicate_state,
 	.atomic_destroy_state = drm_atomic_helper_crtc_destroy_state,
+	.enable_vblank = via_enable_vblank,
+	.disable_vblank = via_disable_vblank,
+	.get_vblank_timestamp = via_get_vblank_timestamp,
 };
 
 static void via_load_vpit_regs(struct via_drm_priv *dev_priv)
@@ -378,7 +525,7 @@ static void via_load_vpit_regs(struct via_drm_priv *dev_priv)
 	/* Fill VPIT registers */
 	vpit_regs.count = ARRAY_SIZE(vpit_table);
 	vpit_regs.regs = vpit_table;
-	load_register_tables(VGABASE, &vpit_regs);
+	load_register_tables(VGASHADOW, &vpit_regs);
 
 	/* Write Attribute Controller */
 	for (i = 0; i < 0x14; i++) {
@@ -401,342 +548,32 @@ static int via_iga1_display_fifo_regs(struct drm_device *dev,
 {
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_fifo_load load;
+	struct via_fifo_params fifo;
 	u32 reg_value;
-	unsigned int fifo_max_depth = 0;
-	unsigned int fifo_threshold = 0;
-	unsigned int fifo_high_threshold = 0;
-	unsigned int display_queue_expire_num = 0;
-	bool enable_extended_display_fifo = false;
 	int ret = 0;
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
-	switch (pdev->device) {
-	case PCI_DEVICE_ID_VIA_CLE266_GFX:
-		if (dev_priv->revision == CLE266_REVISION_AX) {
-			if (mode->hdisplay > 1024) {
-				/* SR17[6:0] */
-				fifo_max_depth = 96;
-
-				/* SR16[5:0] */
-				fifo_threshold = 92;
-
-				/* SR18[5:0] */
-				fifo_high_threshold = 92;
-
-				enable_extended_display_fifo = true;
-			} else {
-				/* SR17[6:0] */
-				fifo_max_depth = 64;
-
-				/* SR16[5:0] */
-				fifo_threshold = 32;
-
-				/* SR18[5:0] */
-				fifo_high_threshold = 56;
-
-				enable_extended_display_fifo = false;
-			}
-
-			if (dev_priv->vram_type <= VIA_MEM_DDR_200) {
-				if (fb->format->depth == 24) {
-					if (mode->hdisplay > 1024) {
-						if (mode->vdisplay > 768) {
-							/* SR22[4:0] */
-							display_queue_expire_num = 16;
-						} else {
-							/* SR22[4:0] */
-							display_queue_expire_num = 12;
-						}
-					} else if (mode->hdisplay > 640) {
-						/* SR22[4:0] */
-						display_queue_expire_num = 40;
-					} else {
-						/* SR22[4:0] */
-						display_queue_expire_num = 124;
-					}
-				} else if (fb->format->depth == 16){
-					if (mode->hdisplay > 1400) {
-						/* SR22[4:0] */
-						display_queue_expire_num = 16;
-					} else {
-						/* SR22[4:0] */
-						display_queue_expire_num = 12;
-					}
-				} else {
-					/* SR22[4:0] */
-					display_queue_expire_num = 124;
-				}
-			} else {
-				if (mode->hdisplay > 1280) {
-					/* SR22[4:0] */
-					display_queue_expire_num = 16;
-				} else if (mode->hdisplay > 1024) {
-					/* SR22[4:0] */
-					display_queue_expire_num = 12;
-				} else {
-					/* SR22[4:0] */
-					display_queue_expire_num = 124;
-				}
-			}
-		/* dev_priv->revision == CLE266_REVISION_CX */
-		} else {
-			if (mode->hdisplay >= 1024) {
-				/* SR17[6:0] */
-				fifo_max_depth = 128;
-
-				/* SR16[5:0] */
-				fifo_threshold = 112;
-
-				/* SR18[5:0] */
-				fifo_high_threshold = 92;
-
-				enable_extended_display_fifo = false;
-			} else {
-				/* SR17[6:0] */
-				fifo_max_depth = 64;
-
-				/* SR16[5:0] */
-				fifo_threshold = 32;
-
-				/* SR18[5:0] */
-				fifo_high_threshold = 56;
-
-				enable_extended_display_fifo = false;
-			}
-
-			if (dev_priv->vram_type <= VIA_MEM_DDR_200) {
-				if (mode->hdisplay > 1024) {
-					if (mode->vdisplay > 768) {
-						/* SR22[4:0] */
-						display_queue_expire_num = 16;
-					} else {
-						/* SR22[4:0] */
-						display_queue_expire_num = 12;
-					}
-				} else if (mode->hdisplay > 640) {
-					/* SR22[4:0] */
-					display_queue_expire_num = 40;
-				} else {
-					/* SR22[4:0] */
-					display_queue_expire_num = 124;
-				}
-			} else {
-				if (mode->hdisplay >= 1280) {
-					/* SR22[4:0] */
-					display_queue_expire_num = 16;
-				} else {
-					/* SR22[4:0] */
-					display_queue_expire_num = 124;
-				}
-			}
-		}
-		break;
-
-	case PCI_DEVICE_ID_VIA_KM400_GFX:
-		if ((mode->hdisplay >= 1600) &&
-			(dev_priv->vram_type <= VIA_MEM_DDR_200)) {
-			/* SR17[6:0] */
-			fifo_max_depth = 58;
-
-			/* SR16[5:0] */
-			fifo_threshold = 24;
-
-			/* SR18[5:0] */
-			fifo_high_threshold = 92;
-		} else {
-			/* SR17[6:0] */
-			fifo_max_depth = 128;
-
-			/* SR16[5:0] */
-			fifo_threshold = 112;
-
-			/* SR18[5:0] */
-			fifo_high_threshold = 92;
-		}
-
-		enable_extended_display_fifo = false;
-
-		if (dev_priv->vram_type <= VIA_MEM_DDR_200) {
-			if (mode->hdisplay >= 1600) {
-				/* SR22[4:0] */
-				display_queue_expire_num = 16;
-			} else {
-				/* SR22[4:0] */
-				display_queue_expire_num = 8;
-			}
-		} else {
-			if (mode->hdisplay >= 1600) {
-				/* SR22[4:0] */
-				display_queue_expire_num = 40;
-			} else {
-				/* SR22[4:0] */
-				display_queue_expire_num = 36;
-			}
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_K8M800_GFX:
-		/* SR17[7:0] */
-		fifo_max_depth = 384;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = 328;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = 296;
-
-		if ((fb->format->depth == 24) &&
-			(mode->hdisplay >= 1400)) {
-			/* SR22[4:0] */
-			display_queue_expire_num = 64;
-		} else {
-			/* SR22[4:0] */
-			display_queue_expire_num = 128;
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_PM800_GFX:
-		/* SR17[7:0] */
-		fifo_max_depth = 192;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = 128;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = 64;
-
-		if ((fb->format->depth == 24) &&
-			(mode->hdisplay >= 1400)) {
-			/* SR22[4:0] */
-			display_queue_expire_num = 64;
-		} else {
-			/* SR22[4:0] */
-			display_queue_expire_num = 124;
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_P4M800_PRO_GFX:
-		/* SR17[7:0] */
-		fifo_max_depth = CN700_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = CN700_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = CN700_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = CN700_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* CX700 */
-	case PCI_DEVICE_ID_VIA_UNICHROME_PRO_II:
-		/* SR17[7:0] */
-		fifo_max_depth = CX700_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = CX700_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = CX700_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = CX700_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-
-		/* K8M890 */
-	case PCI_DEVICE_ID_VIA_CHROME9:
-		/* SR17[7:0] */
-		fifo_max_depth = K8M890_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = K8M890_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = K8M890_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = K8M890_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* P4M890 */
-	case PCI_DEVICE_ID_VIA_P4M890_GFX:
-		/* SR17[7:0] */
-		fifo_max_depth = P4M890_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = P4M890_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = P4M890_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = P4M890_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* P4M900 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HC:
-		/* SR17[7:0] */
-		fifo_max_depth = P4M900_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = P4M900_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = P4M900_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = P4M900_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* VX800 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HC3:
-		/* SR17[7:0] */
-		fifo_max_depth = VX800_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = VX800_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = VX800_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = VX800_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* VX855 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
-		/* SR17[7:0] */
-		fifo_max_depth = VX855_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = VX855_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = VX855_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = VX855_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* VX900 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HD:
-		/* SR17[7:0] */
-		fifo_max_depth = VX900_IGA1_FIFO_MAX_DEPTH;
-
-		/* SR16[7], SR16[5:0] */
-		fifo_threshold = VX900_IGA1_FIFO_THRESHOLD;
-
-		/* SR18[7], SR18[5:0] */
-		fifo_high_threshold = VX900_IGA1_FIFO_HIGH_THRESHOLD;
-
-		/* SR22[4:0] */
-		display_queue_expire_num = VX900_IGA1_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-	default:
-		ret = -EINVAL;
-		break;
-	}
+	load.vram_type = dev_priv->vram_type;
+	load.hdisplay = mode->hdisplay;
+	load.vdisplay = mode->vdisplay;
+	load.depth = fb->format->depth;
+	load.clock = mode->clock;
+	load.cpp = fb->format->cpp[0];
+	load.other_load = via_bandwidth_other_load(dev, iga->index);
 
+	ret = via_iga1_fifo_params(pdev->device, dev_priv->revision,
+					&load, &fifo);
 	if (ret) {
 		goto exit;
 	}
 
+	drm_dbg_kms(dev, "IGA1 FIFO: %u%% memory load, depth %u, "
+			"threshold %u, high threshold %u, expire %u.\n",
+			fifo.load, fifo.max_depth, fifo.threshold,
+			fifo.high_threshold, fifo.display_queue_expire_num);
+
 	if ((pdev->device == PCI_DEVICE_ID_VIA_CLE266_GFX) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_KM400_GFX) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_K8M800_GFX) ||
@@ -744,14 +581,14 @@ static int via_iga1_display_fifo_regs(struct drm_device *dev,
 		(pdev->device == PCI_DEVICE_ID_VIA_P4M800_PRO_GFX) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_UNICHROME_PRO_II)) {
 		/* Force PREQ to be always higher than TREQ. */
-		svga_wseq_mask(VGABASE, 0x18, BIT(6), BIT(6));
+		svga_wseq_mask(VGASHADOW, 0x18, BIT(6), BIT(6));
 	} else {
-		svga_wseq_mask(VGABASE, 0x18, 0x00, BIT(6));
+		svga_wseq_mask(VGASHADOW, 0x18, 0x00, BIT(6));
 	}
 
 	if ((pdev->device == PCI_DEVICE_ID_VIA_CLE266_GFX) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_KM400_GFX)) {
-		if (enable_extended_display_fifo) {
+		if (fifo.extended) {
 			u32 reg_value = VIA_READ(0x0298);
 			VIA_WRITE(0x0298, reg_value | 0x20000000);
 
@@ -776,20 +613,20 @@ static int via_iga1_display_fifo_regs(struct drm_device *dev,
 	}
 
 	/* Set IGA1 Display FIFO Depth Select */
-	reg_value = IGA1_FIFO_DEPTH_SELECT_FORMULA(fifo_max_depth);
-	load_value_to_registers(VGABASE, &iga->fifo_depth, reg_value);
+	reg_value = IGA1_FIFO_DEPTH_SELECT_FORMULA(fifo.max_depth);
+	load_value_to_registers(VGASHADOW, &iga->fifo_depth, reg_value);
 
 	/* Set Display FIFO Threshold Select */
-	reg_value = fifo_threshold / 4;
-	load_value_to_registers(VGABASE, &iga->threshold, reg_value);
+	reg_value = fifo.threshold / 4;
+	load_value_to_registers(VGASHADOW, &iga->threshold, reg_value);
 
 	/* Set FIFO High Threshold Select */
-	reg_value = fifo_high_threshold / 4;
-	load_value_to_registers(VGABASE, &iga->high_threshold, reg_value);
+	reg_value = fifo.high_threshold / 4;
+	load_value_to_registers(VGASHADOW, &iga->high_threshold, reg_value);
 
 	/* Set Display Queue Expire Num */
-	reg_value = display_queue_expire_num / 4;
-	load_value_to_registers(VGABASE, &iga->display_queue, reg_value);
+	reg_value = fifo.display_queue_expire_num / 4;
+	load_value_to_registers(VGASHADOW, &iga->display_queue, reg_value);
 
 exit:
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -803,306 +640,68 @@ static int via_iga2_display_fifo_regs(struct drm_device *dev,
 {
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_fifo_load load;
+	struct via_fifo_params fifo;
 	u32 reg_value;
-	unsigned int fifo_max_depth = 0;
-	unsigned int fifo_threshold = 0;
-	unsigned int fifo_high_threshold = 0;
-	unsigned int display_queue_expire_num = 0;
-	bool enable_extended_display_fifo = false;
 	int ret = 0;
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
-	switch (pdev->device) {
-	case PCI_DEVICE_ID_VIA_CLE266_GFX:
-		if (dev_priv->revision == CLE266_REVISION_AX) {
-			if (((dev_priv->vram_type <= VIA_MEM_DDR_200) &&
-				(fb->format->depth > 16) &&
-				(mode->vdisplay > 768)) ||
-				((dev_priv->vram_type <= VIA_MEM_DDR_266) &&
-				(fb->format->depth > 16) &&
-				(mode->hdisplay > 1280))) {
-				/* CR68[7:4] */
-				fifo_max_depth = 88;
-
-				/* CR68[3:0] */
-				fifo_threshold = 44;
-
-				enable_extended_display_fifo = true;
-			} else {
-				/* CR68[7:4] */
-				fifo_max_depth = 56;
-
-				/* CR68[3:0] */
-				fifo_threshold = 28;
-
-				enable_extended_display_fifo = false;
-			}
-		/* dev_priv->revision == CLE266_REVISION_CX */
-		} else {
-			if (mode->hdisplay >= 1024) {
-				/* CR68[7:4] */
-				fifo_max_depth = 88;
-
-				/* CR68[3:0] */
-				fifo_threshold = 44;
-
-				enable_extended_display_fifo = false;
-			} else {
-				/* CR68[7:4] */
-				fifo_max_depth = 56;
-
-				/* CR68[3:0] */
-				fifo_threshold = 28;
-
-				enable_extended_display_fifo = false;
-			}
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_KM400_GFX:
-		if (mode->hdisplay >= 1600) {
-			/* CR68[7:4] */
-			fifo_max_depth = 120;
-
-			/* CR68[3:0] */
-			fifo_threshold = 44;
-
-			enable_extended_display_fifo = true;
-		} else if (((mode->hdisplay > 1024) &&
-			(fb->format->depth == 24) &&
-			(dev_priv->vram_type <= VIA_MEM_DDR_333)) ||
-			((mode->hdisplay == 1024) &&
-			(fb->format->depth == 24) &&
-			(dev_priv->vram_type <= VIA_MEM_DDR_200))) {
-			/* CR68[7:4] */
-			fifo_max_depth = 104;
-
-			/* CR68[3:0] */
-			fifo_threshold = 28;
-
-			enable_extended_display_fifo = true;
-		} else if (((mode->hdisplay > 1280) &&
-			(fb->format->depth == 16) &&
-			(dev_priv->vram_type <= VIA_MEM_DDR_333)) ||
-			((mode->hdisplay == 1280) &&
-			(fb->format->depth == 16) &&
-			(dev_priv->vram_type <= VIA_MEM_DDR_200))) {
-			/* CR68[7:4] */
-			fifo_max_depth = 88;
-
-			/* CR68[3:0] */
-			fifo_threshold = 44;
-
-			enable_extended_display_fifo = true;
-		} else {
-			/* CR68[7:4] */
-			fifo_max_depth = 56;
-
-			/* CR68[3:0] */
-			fifo_threshold = 28;
-
-			enable_extended_display_fifo = false;
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_K8M800_GFX:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = 376;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = 328;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = 296;
-
-		if ((fb->format->depth == 24) &&
-			(mode->hdisplay >= 1400)) {
-			/* CR94[6:0] */
-			display_queue_expire_num = 64;
-		} else {
-			/* CR94[6:0] */
-			display_queue_expire_num = 128;
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_PM800_GFX:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = 96;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = 64;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = 32;
-
-		if ((fb->format->depth == 24) &&
-				(mode->hdisplay >= 1400)) {
-			/* CR94[6:0] */
-			display_queue_expire_num = 64;
-		} else {
-			/* CR94[6:0] */
-			display_queue_expire_num = 124;
-		}
-
-		break;
-	case PCI_DEVICE_ID_VIA_P4M800_PRO_GFX:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = CN700_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = CN700_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = CN700_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = CN700_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* CX700 */
-	case PCI_DEVICE_ID_VIA_UNICHROME_PRO_II:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = CX700_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = CX700_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = CX700_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = CX700_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-
-		/* K8M890 */
-	case PCI_DEVICE_ID_VIA_CHROME9:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = K8M890_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = K8M890_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = K8M890_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = K8M890_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* P4M890 */
-	case PCI_DEVICE_ID_VIA_P4M890_GFX:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = P4M890_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = P4M890_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = P4M890_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = P4M890_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* P4M900 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HC:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = P4M900_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_threshold = P4M900_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = P4M900_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = P4M900_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* VX800 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HC3:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = VX800_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = VX800_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = VX800_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = VX800_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* VX855 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = VX855_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = VX855_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = VX855_IGA2_FIFO_HIGH_THRESHOLD;
-
-		/* CR94[6:0] */
-		display_queue_expire_num = VX855_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-		/* VX900 */
-	case PCI_DEVICE_ID_VIA_CHROME9_HD:
-		/* CR95[7], CR94[7], CR68[7:4] */
-		fifo_max_depth = VX900_IGA2_FIFO_MAX_DEPTH;
-
-		/* CR95[6:4], CR68[3:0] */
-		fifo_threshold = VX900_IGA2_FIFO_THRESHOLD;
-
-		/* CR95[2:0], CR92[3:0] */
-		fifo_high_threshold = VX900_IGA2_FIFO_HIGH_THRESHOLD;
-
-        /* CR94[6:0] */
-		display_queue_expire_num = VX900_IGA2_DISPLAY_QUEUE_EXPIRE_NUM;
-		break;
-	default:
-		ret = -EINVAL;
-		break;
-	}
+	load.vram_type = dev_priv->vram_type;
+	load.hdisplay = mode->hdisplay;
+	load.vdisplay = mode->vdisplay;
+	load.depth = fb->format->depth;
+	load.clock = mode->clock;
+	load.cpp = fb->format->cpp[0];
+	load.other_load = via_bandwidth_other_load(dev, iga->index);
 
+	ret = via_iga2_fifo_params(pdev->device, dev_priv->revision,
+					&load, &fifo);
 	if (ret) {
 		goto exit;
 	}
 
+	drm_dbg_kms(dev, "IGA2 FIFO: %u%% memory load, depth %u, "
+			"threshold %u, high threshold %u, expire %u.\n",
+			fifo.load, fifo.max_depth, fifo.threshold,
+			fifo.high_threshold, fifo.display_queue_expire_num);
+
 	if ((pdev->device == PCI_DEVICE_ID_VIA_CLE266_GFX) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_KM400_GFX)) {
-		if (enable_extended_display_fifo) {
+		if (fifo.extended) {
 			/* Enable IGA2 extended display FIFO. */
-			svga_wcrt_mask(VGABASE, 0x6a, BIT(5), BIT(5));
+			svga_wcrt_mask(VGASHADOW, 0x6a, BIT(5), BIT(5));
 		} else {
 			/* Disable IGA2 extended display FIFO. */
-			svga_wcrt_mask(VGABASE, 0x6a, 0x00, BIT(5));
+			svga_wcrt_mask(VGASHADOW, 0x6a, 0x00, BIT(5));
 		}
 	}
 
 	if ((pdev->device == PCI_DEVICE_ID_VIA_CLE266_GFX) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_KM400_GFX)) {
 		/* Set IGA2 Display FIFO Depth Select */
-		reg_value = IGA2_FIFO_DEPTH_SELECT_FORMULA(fifo_max_depth);
-		load_value_to_registers(VGABASE, &iga->fifo_depth, reg_value);
+		reg_value = IGA2_FIFO_DEPTH_SELECT_FORMULA(fifo.max_depth);
+		load_value_to_registers(VGASHADOW, &iga->fifo_depth, reg_value);
 
 		/* Set Display FIFO Threshold Select */
-		reg_value = fifo_threshold / 4;
-		load_value_to_registers(VGABASE, &iga->threshold, reg_value);
+		reg_value = fifo.threshold / 4;
+		load_value_to_registers(VGASHADOW, &iga->threshold, reg_value);
 	} else {
 		/* Set IGA2 Display FIFO Depth Select */
-		reg_value = IGA2_FIFO_DEPTH_SELECT_FORMULA(fifo_max_depth);
-		load_value_to_registers(VGABASE, &iga->fifo_depth, reg_value);
+		reg_value = IGA2_FIFO_DEPTH_SELECT_FORMULA(fifo.max_depth);
+		load_value_to_registers(VGASHADOW, &iga->fifo_depth, reg_value);
 
 		/* Set Display FIFO Threshold Select */
-		reg_value = fifo_threshold / 4;
-		load_value_to_registers(VGABASE, &iga->threshold, reg_value);
+		reg_value = fifo.threshold / 4;
+		load_value_to_registers(VGASHADOW, &iga->threshold, reg_value);
 
 		/* Set FIFO High Threshold Select */
-		reg_value = fifo_high_threshold / 4;
-		load_value_to_registers(VGABASE, &iga->high_threshold, reg_value);
+		reg_value = fifo.high_threshold / 4;
+		load_value_to_registers(VGASHADOW, &iga->high_threshold, reg_value);
 
 		/* Set Display Queue Expire Num */
-		reg_value = display_queue_expire_num / 4;
-		load_value_to_registers(VGABASE, &iga->display_queue, reg_value);
+		reg_value = fifo.display_queue_expire_num / 4;
+		load_value_to_registers(VGASHADOW, &iga->display_queue, reg_value);
 	}
 
 exit:
@@ -1122,46 +721,46 @@ void via_load_crtc_pixel_timing(struct drm_crtc *crtc,
     drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	reg_value = IGA1_PIXELTIMING_HOR_TOTAL_FORMULA(mode->crtc_htotal);
-	load_value_to_registers(VGABASE, &iga->pixel_timings.htotal,
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.htotal,
 				reg_value);
 
 	reg_value = IGA1_PIXELTIMING_HOR_ADDR_FORMULA(mode->crtc_hdisplay) << 16;
-	load_value_to_registers(VGABASE, &iga->pixel_timings.hdisplay,
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.hdisplay,
 				reg_value);
 
 	reg_value = IGA1_PIXELTIMING_HOR_BLANK_START_FORMULA(
 					mode->crtc_hblank_start);
-	load_value_to_registers(VGABASE, &iga->pixel_timings.hblank_start,
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.hblank_start,
 				reg_value);
 
 	reg_value = IGA1_PIXELTIMING_HOR_BLANK_END_FORMULA(mode->crtc_hblank_end) << 16;
-	load_value_to_registers(VGABASE, &iga->pixel_timings.hblank_end, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.hblank_end, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_HOR_SYNC_START_FORMULA(mode->crtc_hsync_start);
-	load_value_to_registers(VGABASE, &iga->pixel_timings.hsync_start,
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.hsync_start,
 				reg_value);
 
 	reg_value = IGA1_PIXELTIMING_HOR_SYNC_END_FORMULA(mode->crtc_hsync_end) << 16;
-	load_value_to_registers(VGABASE, &iga->pixel_timings.hsync_end, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.hsync_end, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_VER_TOTAL_FORMULA(mode->crtc_vtotal);
-	load_value_to_registers(VGABASE, &iga->pixel_timings.vtotal, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.vtotal, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_VER_ADDR_FORMULA(mode->crtc_vdisplay) << 16;
-	load_value_to_registers(VGABASE, &iga->pixel_timings.vdisplay, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.vdisplay, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_VER_BLANK_START_FORMULA(
 					mode->crtc_vblank_start);
-	load_value_to_registers(VGABASE, &iga->pixel_timings.vblank_start, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.vblank_start, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_VER_BLANK_END_FORMULA(mode->crtc_vblank_end) << 16;
-	load_value_to_registers(VGABASE, &iga->pixel_timings.vblank_end, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.vblank_end, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_VER_SYNC_START_FORMULA(mode->crtc_vsync_start);
-	load_value_to_registers(VGABASE, &iga->pixel_timings.vsync_start, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.vsync_start, reg_value);
 
 	reg_value = IGA1_PIXELTIMING_VER_SYNC_END_FORMULA(mode->crtc_vsync_end) << 12;
-	load_value_to_registers(VGABASE, &iga->pixel_timings.vsync_end, reg_value);
+	load_value_to_registers(VGASHADOW, &iga->pixel_timings.vsync_end, reg_value);
 
 	if (mode->flags & DRM_MODE_FLAG_INTERLACE) {
 		reg_value = IGA1_PIXELTIMING_HVSYNC_OFFSET_END_FORMULA(
@@ -1169,7 +768,7 @@ void via_load_crtc_pixel_timing(struct drm_crtc *crtc,
 		VIA_WRITE_MASK(IGA1_PIX_HALF_LINE_REG, reg_value,
 					IGA1_PIX_HALF_LINE_MASK);
 
-		svga_wcrt_mask(VGABASE, 0x32, BIT(2), BIT(2));
+		svga_wcrt_mask(VGASHADOW, 0x32, BIT(2), BIT(2));
 		/**
 		 * According to information from HW team,
 		 * we need to set 0xC280[1] = 1 (HDMI function enable)
@@ -1182,104 +781,119 @@ void via_load_crtc_pixel_timing(struct drm_crtc *crtc,
 		VIA_WRITE_MASK(0xC280, BIT(1), BIT(1));
 	} else {
 		VIA_WRITE_MASK(IGA1_PIX_HALF_LINE_REG, 0x0, IGA1_PIX_HALF_LINE_MASK);
-		svga_wcrt_mask(VGABASE, 0x32, 0x00, BIT(2));
+		svga_wcrt_mask(VGASHADOW, 0x32, 0x00, BIT(2));
 
 	}
-	svga_wcrt_mask(VGABASE, 0xFD, BIT(5), BIT(5));
+	svga_wcrt_mask(VGASHADOW, 0xFD, BIT(5), BIT(5));
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
+static void via_crtc_timing_fields(struct crtc_timings *timings,
+					struct vga_registers **fields)
+{
+	fields[VIA_TIMING_HTOTAL] = &timings->htotal;
+	fields[VIA_TIMING_HDISPLAY] = &timings->hdisplay;
+	fields[VIA_TIMING_HBLANK_START] = &timings->hblank_start;
+	fields[VIA_TIMING_HBLANK_END] = &timings->hblank_end;
+	fields[VIA_TIMING_HSYNC_START] = &timings->hsync_start;
+	fields[VIA_TIMING_HSYNC_END] = &timings->hsync_end;
+	fields[VIA_TIMING_VTOTAL] = &timings->vtotal;
+	fields[VIA_TIMING_VDISPLAY] = &timings->vdisplay;
+	fields[VIA_TIMING_VBLANK_START] = &timings->vblank_start;
+	fields[VIA_TIMING_VBLANK_END] = &timings->vblank_end;
+	fields[VIA_TIMING_VSYNC_START] = &timings->vsync_start;
+	fields[VIA_TIMING_VSYNC_END] = &timings->vsync_end;
+}
+
+/* Convert a mode into the register values of the IGA's timing fields */
+static void via_crtc_timing_values(uint32_t index,
+					const struct drm_display_mode *mode,
+					u32 *values)
+{
+	if (!index) {
+		values[VIA_TIMING_HTOTAL] =
+			IGA1_HOR_TOTAL_FORMULA(mode->crtc_htotal);
+		values[VIA_TIMING_HDISPLAY] =
+			IGA1_HOR_ADDR_FORMULA(mode->crtc_hdisplay);
+		values[VIA_TIMING_HBLANK_START] =
+			IGA1_HOR_BLANK_START_FORMULA(mode->crtc_hblank_start);
+		values[VIA_TIMING_HBLANK_END] =
+			IGA1_HOR_BLANK_END_FORMULA(mode->crtc_hblank_end);
+		values[VIA_TIMING_HSYNC_START] =
+			IGA1_HOR_SYNC_START_FORMULA(mode->crtc_hsync_start);
+		values[VIA_TIMING_HSYNC_END] =
+			IGA1_HOR_SYNC_END_FORMULA(mode->crtc_hsync_end);
+		values[VIA_TIMING_VTOTAL] =
+			IGA1_VER_TOTAL_FORMULA(mode->crtc_vtotal);
+		values[VIA_TIMING_VDISPLAY] =
+			IGA1_VER_ADDR_FORMULA(mode->crtc_vdisplay);
+		values[VIA_TIMING_VBLANK_START] =
+			IGA1_VER_BLANK_START_FORMULA(mode->crtc_vblank_start);
+		values[VIA_TIMING_VBLANK_END] =
+			IGA1_VER_BLANK_END_FORMULA(mode->crtc_vblank_end);
+		values[VIA_TIMING_VSYNC_START] =
+			IGA1_VER_SYNC_START_FORMULA(mode->crtc_vsync_start);
+		values[VIA_TIMING_VSYNC_END] =
+			IGA1_VER_SYNC_END_FORMULA(mode->crtc_vsync_end);
+	} else {
+		values[VIA_TIMING_HTOTAL] =
+			IGA2_HOR_TOTAL_FORMULA(mode->crtc_htotal);
+		values[VIA_TIMING_HDISPLAY] =
+			IGA2_HOR_ADDR_FORMULA(mode->crtc_hdisplay);
+		values[VIA_TIMING_HBLANK_START] =
+			IGA2_HOR_BLANK_START_FORMULA(mode->crtc_hblank_start);
+		values[VIA_TIMING_HBLANK_END] =
+			IGA2_HOR_BLANK_END_FORMULA(mode->crtc_hblank_end);
+		values[VIA_TIMING_HSYNC_START] =
+			IGA2_HOR_SYNC_START_FORMULA(mode->crtc_hsync_start);
+		values[VIA_TIMING_HSYNC_END] =
+			IGA2_HOR_SYNC_END_FORMULA(mode->crtc_hsync_end);
+		values[VIA_TIMING_VTOTAL] =
+			IGA2_VER_TOTAL_FORMULA(mode->crtc_vtotal);
+		values[VIA_TIMING_VDISPLAY] =
+			IGA2_VER_ADDR_FORMULA(mode->crtc_vdisplay);
+		values[VIA_TIMING_VBLANK_START] =
+			IGA2_VER_BLANK_START_FORMULA(mode->crtc_vblank_start);
+		values[VIA_TIMING_VBLANK_END] =
+			IGA2_VER_BLANK_END_FORMULA(mode->crtc_vblank_end);
+		values[VIA_TIMING_VSYNC_START] =
+			IGA2_VER_SYNC_START_FORMULA(mode->crtc_vsync_start);
+		values[VIA_TIMING_VSYNC_END] =
+			IGA2_VER_SYNC_END_FORMULA(mode->crtc_vsync_end);
+	}
+}
+
 /* Load CRTC timing registers */
 static void via_load_crtc_timing(struct via_crtc *iga, struct drm_display_mode *mode)
 {
 	struct drm_device *dev = iga->base.dev;
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
-	u32 reg_value = 0;
+	u32 values[VIA_TIMING_NUM_FIELDS];
+	struct vga_registers *fields[VIA_TIMING_NUM_FIELDS];
+	unsigned int i;
 
     drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
-	if (!iga->index) {
-		if (pdev->device == PCI_DEVICE_ID_VIA_CHROME9_HD) {
-			/* Disable IGA1 shadow timing */
-			svga_wcrt_mask(VGABASE, 0x45, 0x00, BIT(0));
-
-			/* Disable IGA1 pixel timing */
-			svga_wcrt_mask(VGABASE, 0xFD, 0x00, BIT(5));
-		}
-
-		reg_value = IGA1_HOR_TOTAL_FORMULA(mode->crtc_htotal);
-		load_value_to_registers(VGABASE, &iga->timings.htotal, reg_value);
-
-		reg_value = IGA1_HOR_ADDR_FORMULA(mode->crtc_hdisplay);
-		load_value_to_registers(VGABASE, &iga->timings.hdisplay, reg_value);
-
-		reg_value = IGA1_HOR_BLANK_START_FORMULA(mode->crtc_hblank_start);
-		load_value_to_registers(VGABASE, &iga->timings.hblank_start, reg_value);
-
-		reg_value = IGA1_HOR_BLANK_END_FORMULA(mode->crtc_hblank_end);
-		load_value_to_registers(VGABASE, &iga->timings.hblank_end, reg_value);
-
-		reg_value = IGA1_HOR_SYNC_START_FORMULA(mode->crtc_hsync_start);
-		load_value_to_registers(VGABASE, &iga->timings.hsync_start, reg_value);
-
-		reg_value = IGA1_HOR_SYNC_END_FORMULA(mode->crtc_hsync_end);
-		load_value_to_registers(VGABASE, &iga->timings.hsync_end, reg_value);
-
-		reg_value = IGA1_VER_TOTAL_FORMULA(mode->crtc_vtotal);
-		load_value_to_registers(VGABASE, &iga->timings.vtotal, reg_value);
-
-		reg_value = IGA1_VER_ADDR_FORMULA(mode->crtc_vdisplay);
-		load_value_to_registers(VGABASE, &iga->timings.vdisplay, reg_value);
-
-		reg_value = IGA1_VER_BLANK_START_FORMULA(mode->crtc_vblank_start);
-		load_value_to_registers(VGABASE, &iga->timings.vblank_start, reg_value);
-
-		reg_value = IGA1_VER_BLANK_END_FORMULA(mode->crtc_vblank_end);
-		load_value_to_registers(VGABASE, &iga->timings.vblank_end, reg_value);
+	if ((!iga->index) &&
+		(pdev->device == PCI_DEVICE_ID_VIA_CHROME9_HD)) {
+		/* Disable IGA1 shadow timing */
+		svga_wcrt_mask(VGASHADOW, 0x45, 0x00, BIT(0));
 
-		reg_value = IGA1_VER_SYNC_START_FORMULA(mode->crtc_vsync_start);
-		load_value_to_registers(VGABASE, &iga->timings.vsync_start, reg_value);
+		/* Disable IGA1 pixel timing */
+		svga_wcrt_mask(VGASHADOW, 0xFD, 0x00, BIT(5));
+	}
 
-		reg_value = IGA1_VER_SYNC_END_FORMULA(mode->crtc_vsync_end);
-		load_value_to_registers(VGABASE, &iga->timings.vsync_end, reg_value);
+	via_crtc_timing_values(iga->index, mode, values);
+	if (iga->timing_program.num_ops) {
+		via_reg_program_load(VGASHADOW, &iga->timing_program, values);
 	} else {
-		reg_value = IGA2_HOR_TOTAL_FORMULA(mode->crtc_htotal);
-		load_value_to_registers(VGABASE, &iga->timings.htotal, reg_value);
-
-		reg_value = IGA2_HOR_ADDR_FORMULA(mode->crtc_hdisplay);
-		load_value_to_registers(VGABASE, &iga->timings.hdisplay, reg_value);
-
-		reg_value = IGA2_HOR_BLANK_START_FORMULA(mode->crtc_hblank_start);
-		load_value_to_registers(VGABASE, &iga->timings.hblank_start, reg_value);
-
-		reg_value = IGA2_HOR_BLANK_END_FORMULA(mode->crtc_hblank_end);
-		load_value_to_registers(VGABASE, &iga->timings.hblank_end, reg_value);
-
-		reg_value = IGA2_HOR_SYNC_START_FORMULA(mode->crtc_hsync_start);
-		load_value_to_registers(VGABASE, &iga->timings.hsync_start, reg_value);
-
-		reg_value = IGA2_HOR_SYNC_END_FORMULA(mode->crtc_hsync_end);
-		load_value_to_registers(VGABASE, &iga->timings.hsync_end, reg_value);
-
-		reg_value = IGA2_VER_TOTAL_FORMULA(mode->crtc_vtotal);
-		load_value_to_registers(VGABASE, &iga->timings.vtotal, reg_value);
-
-		reg_value = IGA2_VER_ADDR_FORMULA(mode->crtc_vdisplay);
-		load_value_to_registers(VGABASE, &iga->timings.vdisplay, reg_value);
-
-		reg_value = IGA2_VER_BLANK_START_FORMULA(mode->crtc_vblank_start);
-		load_value_to_registers(VGABASE, &iga->timings.vblank_start, reg_value);
-
-		reg_value = IGA2_VER_BLANK_END_FORMULA(mode->crtc_vblank_end);
-		load_value_to_registers(VGABASE, &iga->timings.vblank_end, reg_value);
-
-		reg_value = IGA2_VER_SYNC_START_FORMULA(mode->crtc_vsync_start);
-		load_value_to_registers(VGABASE, &iga->timings.vsync_start, reg_value);
-
-		reg_value = IGA2_VER_SYNC_END_FORMULA(mode->crtc_vsync_end);
-		load_value_to_registers(VGABASE, &iga->timings.vsync_end, reg_value);
+		via_crtc_timing_fields(&iga->timings, fields);
+		for (i = 0; i < VIA_TIMING_NUM_FIELDS; i++) {
+			load_value_to_registers(VGASHADOW, fields[i], values[i]);
+		}
 	}
+
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
@@ -1295,7 +909,7 @@ static void via_set_scale_path(struct drm_crtc *crtc, u32 scale_type)
 	struct drm_device *dev = crtc->dev;
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
-	u8 reg_cr_fd = vga_rcrt(VGABASE, 0xFD);
+	u8 reg_cr_fd = via_vga_rcrt(VGASHADOW, 0xFD);
 
     drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
@@ -1332,7 +946,7 @@ static void via_set_scale_path(struct drm_crtc *crtc, u32 scale_type)
 	default:
 		break;
 	}
-	vga_wcrt(VGABASE, 0xFD, reg_cr_fd);
+	via_vga_wcrt(VGASHADOW, 0xFD, reg_cr_fd);
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
@@ -1349,30 +963,30 @@ static void via_disable_iga_scaling(struct drm_crtc *crtc)
 		/* IGA2 scalings disable */
 		via_set_scale_path(crtc, VIA_SHRINK);
 		/* disable IGA down scaling and buffer sharing. */
-		svga_wcrt_mask(VGABASE, 0x89, 0x00, BIT(7) | BIT(0));
+		svga_wcrt_mask(VGASHADOW, 0x89, 0x00, BIT(7) | BIT(0));
 		/* Horizontal and Vertical scaling disable */
-		svga_wcrt_mask(VGABASE, 0xA2, 0x00, BIT(7) | BIT(3));
+		svga_wcrt_mask(VGASHADOW, 0xA2, 0x00, BIT(7) | BIT(3));
 
 		/* Disable scale up as well */
 		via_set_scale_path(crtc, VIA_EXPAND);
 		/* disable IGA up scaling */
-		svga_wcrt_mask(VGABASE, 0x79, 0, BIT(0));
+		svga_wcrt_mask(VGASHADOW, 0x79, 0, BIT(0));
 		/* Horizontal and Vertical scaling disable */
-		svga_wcrt_mask(VGABASE, 0xA2, 0x00, BIT(7) | BIT(3));
+		svga_wcrt_mask(VGASHADOW, 0xA2, 0x00, BIT(7) | BIT(3));
 	} else {
 		/* IGA1 scalings disable */
 		via_set_scale_path(crtc, VIA_SHRINK);
 		/* disable IGA down scaling and buffer sharing. */
-		svga_wcrt_mask(VGABASE, 0x89, 0x00, BIT(7) | BIT(0));
+		svga_wcrt_mask(VGASHADOW, 0x89, 0x00, BIT(7) | BIT(0));
 		/* Horizontal and Vertical scaling disable */
-		svga_wcrt_mask(VGABASE, 0xA2, 0x00, BIT(7) | BIT(3));
+		svga_wcrt_mask(VGASHADOW, 0xA2, 0x00, BIT(7) | BIT(3));
 
 		/* Disable scale up as well */
 		via_set_scale_path(crtc, VIA_EXPAND);
 		/* disable IGA up scaling */
-		svga_wcrt_mask(VGABASE, 0x79, 0, BIT(0));
+		svga_wcrt_mask(VGASHADOW, 0x79, 0, BIT(0));
 		/* Horizontal and Vertical scaling disable */
-		svga_wcrt_mask(VGABASE, 0xA2, 0x00, BIT(7) | BIT(3));
+		svga_wcrt_mask(VGASHADOW, 0xA2, 0x00, BIT(7) | BIT(3));
 	}
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
@@ -1402,34 +1016,34 @@ static bool via_set_iga_scale_function(struct drm_crtc *crtc, u32 scale_type)
 		if (VIA_SHRINK & scale_type) {
 			via_set_scale_path(crtc, VIA_SHRINK);
 			/* Horizontal and Vertical scaling enable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
 			/* enable IGA down scaling */
-			svga_wcrt_mask(VGABASE, 0x89, BIT(0), BIT(0));
+			svga_wcrt_mask(VGASHADOW, 0x89, BIT(0), BIT(0));
 			/* hor and ver scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
 		}
 
 		if (VIA_EXPAND & scale_type) {
 			via_set_scale_path(crtc, VIA_EXPAND);
 			/* enable IGA up scaling */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(0), BIT(0));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(0), BIT(0));
 		}
 
 		if ((VIA_EXPAND & scale_type) == VIA_EXPAND) {
 			/* Horizontal and Vertical scaling enable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
 			/* hor and ver scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
 		} else if (VIA_HOR_EXPAND & scale_type) {
 			/* Horizontal scaling disable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7), BIT(7));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7), BIT(7));
 			/* hor scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(1), BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(1), BIT(1));
 		} else if (VIA_VER_EXPAND & scale_type) {
 			/* Vertical scaling disable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(3), BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(3), BIT(3));
 			/* ver scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(2), BIT(2));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(2), BIT(2));
 		}
 	} else {
 		/* IGA1 scalings enable */
@@ -1437,34 +1051,34 @@ static bool via_set_iga_scale_function(struct drm_crtc *crtc, u32 scale_type)
 			via_set_scale_path(crtc, VIA_SHRINK);
 
 			/* Horizontal and Vertical scaling enable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
 			/* enable IGA down scaling */
-			svga_wcrt_mask(VGABASE, 0x89, BIT(0), BIT(0));
+			svga_wcrt_mask(VGASHADOW, 0x89, BIT(0), BIT(0));
 			/* hor and ver scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
 		}
 
 		if (VIA_EXPAND & scale_type) {
 			via_set_scale_path(crtc, VIA_EXPAND);
 			/* enable IGA up scaling */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(0), BIT(0));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(0), BIT(0));
 		}
 
 		if ((VIA_EXPAND & scale_type) == VIA_EXPAND) {
 			/* Horizontal and Vertical scaling enable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7) | BIT(3), BIT(7) | BIT(3));
 			/* hor and ver scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(2) | BIT(1), BIT(2) | BIT(1));
 		} else if (VIA_HOR_EXPAND & scale_type) {
 			/* Horizontal scaling disable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7), BIT(7));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7), BIT(7));
 			/* hor scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(1), BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(1), BIT(1));
 		} else if (VIA_VER_EXPAND & scale_type) {
 			/* Vertical scaling disable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(3), BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(3), BIT(3));
 			/* ver scaling : Interpolation */
-			svga_wcrt_mask(VGABASE, 0x79, BIT(2), BIT(2));
+			svga_wcrt_mask(VGASHADOW, 0x79, BIT(2), BIT(2));
 		}
 	}
 
@@ -1501,18 +1115,18 @@ static bool via_load_iga_scale_factor_regs(struct via_drm_priv *dev_priv,
 			hor_factor = ((src_hor_regs - 1) * 4096) / (dst_hor_regs - 1);
 			reg.count = ARRAY_SIZE(lcd_hor_scaling);
 			reg.regs = lcd_hor_scaling;
-			load_value_to_registers(VGABASE, &reg, hor_factor);
+			load_value_to_registers(VGASHADOW, &reg, hor_factor);
 			/* Horizontal scaling enable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7), BIT(7));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7), BIT(7));
 		}
 
 		if (VER_SCALE & is_hor_or_ver) {
 			ver_factor = ((src_ver_regs - 1) * 2048) / (dst_ver_regs - 1);
 			reg.count = ARRAY_SIZE(lcd_ver_scaling);
 			reg.regs = lcd_ver_scaling;
-			load_value_to_registers(VGABASE, &reg, ver_factor);
+			load_value_to_registers(VGASHADOW, &reg, ver_factor);
 			/* Vertical scaling enable */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(3), BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(3), BIT(3));
 		}
 
 	} else if (VIA_SHRINK == scale_type) {
@@ -1525,31 +1139,31 @@ static bool via_load_iga_scale_factor_regs(struct via_drm_priv *dev_priv,
 
 		reg.count = ARRAY_SIZE(lcd_hor_scaling);
 		reg.regs = lcd_hor_scaling;
-		load_value_to_registers(VGABASE, &reg, hor_factor);
+		load_value_to_registers(VGASHADOW, &reg, hor_factor);
 
 		reg.count = ARRAY_SIZE(lcd_ver_scaling);
 		reg.regs = lcd_ver_scaling;
-		load_value_to_registers(VGABASE, &reg, ver_factor);
+		load_value_to_registers(VGASHADOW, &reg, ver_factor);
 
 		/* set buffer sharing enable bit . */
 		if (hor_factor || ver_factor) {
 			if (dst_hor_regs > 1024)
-				svga_wcrt_mask(VGABASE, 0x89, BIT(7), BIT(7));
+				svga_wcrt_mask(VGASHADOW, 0x89, BIT(7), BIT(7));
 			else
-				svga_wcrt_mask(VGABASE, 0x89, 0x00, BIT(7));
+				svga_wcrt_mask(VGASHADOW, 0x89, 0x00, BIT(7));
 		}
 
 		if (hor_factor)
 			/* CRA2[7]:1 Enable Hor scaling
 			   CRA2[6]:1 Linear Mode */
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(7) | BIT(6), BIT(7) | BIT(6));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(7) | BIT(6), BIT(7) | BIT(6));
 		else
-			svga_wcrt_mask(VGABASE, 0xA2, 0, BIT(7));
+			svga_wcrt_mask(VGASHADOW, 0xA2, 0, BIT(7));
 
 		if (ver_factor)
-			svga_wcrt_mask(VGABASE, 0xA2, BIT(3), BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, BIT(3), BIT(3));
 		else
-			svga_wcrt_mask(VGABASE, 0xA2, 0, BIT(3));
+			svga_wcrt_mask(VGASHADOW, 0xA2, 0, BIT(3));
 	}
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 	return true;
@@ -1619,11 +1233,15 @@ static void via_mode_set_nofb(struct drm_crtc *crtc)
 	struct via_crtc *iga = container_of(crtc,
 						struct via_crtc, base);
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_vga_shadow_stats start, end;
+	unsigned long flags;
 	u8 reg_value = 0;
 	int ret;
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
+	via_vga_shadow_stats_get(VGASHADOW, &start);
+
 	/* Load standard registers */
 	via_load_vpit_regs(dev_priv);
 
@@ -1639,13 +1257,13 @@ static void via_mode_set_nofb(struct drm_crtc *crtc)
 	}
 
 	/* Unlock CRTC registers. */
-	svga_wcrt_mask(VGABASE, 0x11, 0x00, BIT(7));
-	svga_wcrt_mask(VGABASE, 0x47, 0x00, reg_value);
+	svga_wcrt_mask(VGASHADOW, 0x11, 0x00, BIT(7));
+	svga_wcrt_mask(VGASHADOW, 0x47, 0x00, reg_value);
 
 	if (!iga->index) {
 		/* IGA1 reset */
-		vga_wcrt(VGABASE, 0x09, 0x00); /* initial CR09=0 */
-		svga_wcrt_mask(VGABASE, 0x11, 0x00, BIT(6));
+		via_vga_wcrt(VGASHADOW, 0x09, 0x00); /* initial CR09=0 */
+		svga_wcrt_mask(VGASHADOW, 0x11, 0x00, BIT(6));
 
 		/* disable IGA scales first */
 		via_disable_iga_scaling(crtc);
@@ -1671,7 +1289,7 @@ static void via_mode_set_nofb(struct drm_crtc *crtc)
 			break;
 		}
 
-		svga_wcrt_mask(VGABASE, 0x47,
+		svga_wcrt_mask(VGASHADOW, 0x47,
 				reg_value, BIT(7) | BIT(6) | BIT(3));
 	} else {
 		/* disable IGA scales first */
@@ -1746,12 +1364,12 @@ static void via_mode_set_nofb(struct drm_crtc *crtc)
 
 	if (!iga->index) {
 		/* Set non-interlace / interlace mode. */
-		via_iga1_set_interlace_mode(VGABASE,
+		via_iga1_set_interlace_mode(VGASHADOW,
 					adjusted_mode->flags &
 					DRM_MODE_FLAG_INTERLACE);
 
 		/* No HSYNC shift. */
-		via_iga1_set_hsync_shift(VGABASE, 0x05);
+		via_iga1_set_hsync_shift(VGASHADOW, 0x05);
 
 		/* Load display FIFO. */
 		ret = via_iga1_display_fifo_regs(dev, iga, adjusted_mode,
@@ -1774,10 +1392,10 @@ static void via_mode_set_nofb(struct drm_crtc *crtc)
 		via_iga_common_init(dev);
 
 		/* Set palette LUT to 8-bit mode. */
-		via_iga1_set_palette_lut_resolution(VGABASE, true);
+		via_iga1_set_palette_lut_resolution(VGASHADOW, true);
 	} else {
 		/* Set non-interlace / interlace mode. */
-		via_iga2_set_interlace_mode(VGABASE,
+		via_iga2_set_interlace_mode(VGASHADOW,
 					adjusted_mode->flags &
 					DRM_MODE_FLAG_INTERLACE);
 
@@ -1802,11 +1420,32 @@ static void via_mode_set_nofb(struct drm_crtc *crtc)
 		via_iga_common_init(dev);
 
 		/* Set palette LUT to 8-bit mode. */
-		via_iga2_set_palette_lut_resolution(VGABASE, true);
+		via_iga2_set_palette_lut_resolution(VGASHADOW, true);
 
-		svga_wcrt_mask(VGABASE, 0x6A, BIT(7), BIT(7));
+		svga_wcrt_mask(VGASHADOW, 0x6A, BIT(7), BIT(7));
 	}
 exit:
+	/*
+	 * Nonblocking commits get here without the CRTC lock, so the
+	 * result is published under the shadow lock for debugfs.
+	 */
+	spin_lock_irqsave(&dev_priv->vga_shadow.lock, flags);
+	end = dev_priv->vga_shadow.total;
+	iga->mode_set_stats.reads = end.reads - start.reads;
+	iga->mode_set_stats.writes = end.writes - start.writes;
+	iga->mode_set_stats.reads_avoided =
+			end.reads_avoided - start.reads_avoided;
+	iga->mode_set_stats.writes_avoided =
+			end.writes_avoided - start.writes_avoided;
+	spin_unlock_irqrestore(&dev_priv->vga_shadow.lock, flags);
+
+	drm_dbg_kms(dev, "IGA%u mode set: %llu reads, %llu writes, "
+			"%llu reads avoided, %llu writes avoided.\n",
+			iga->index + 1,
+			end.reads - start.reads,
+			end.writes - start.writes,
+			end.reads_avoided - start.reads_avoided,
+			end.writes_avoided - start.writes_avoided);
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
@@ -1821,11 +1460,13 @@ static void via_crtc_helper_atomic_enable(struct drm_crtc *crtc,
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	if (!iga->index) {
-		svga_wseq_mask(VGABASE, 0x01, 0x00, BIT(5));
+		svga_wseq_mask(VGASHADOW, 0x01, 0x00, BIT(5));
 	} else {
-		svga_wcrt_mask(VGABASE, 0x6B, 0x00, BIT(2));
+		svga_wcrt_mask(VGASHADOW, 0x6B, 0x00, BIT(2));
 	}
 
+	drm_crtc_vblank_on(crtc);
+
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
@@ -1839,17 +1480,74 @@ static void via_crtc_helper_atomic_disable(struct drm_crtc *crtc,
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
+	drm_crtc_vblank_off(crtc);
+
 	if (!iga->index) {
-		svga_wseq_mask(VGABASE, 0x01, BIT(5), BIT(5));
+		svga_wseq_mask(VGASHADOW, 0x01, BIT(5), BIT(5));
 	} else {
-		svga_wcrt_mask(VGABASE, 0x6B, BIT(2), BIT(2));
+		svga_wcrt_mask(VGASHADOW, 0x6B, BIT(2), BIT(2));
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
+static void via_crtc_helper_atomic_begin(struct drm_crtc *crtc,
+					struct drm_atomic_state *state)
+{
+	struct via_crtc *iga = container_of(crtc,
+						struct via_crtc, base);
+
+	iga->queue.count = 0;
+	iga->queue.open = true;
+}
+
+static void via_crtc_helper_atomic_flush(struct drm_crtc *crtc,
+					struct drm_atomic_state *state)
+{
+	struct drm_device *dev = crtc->dev;
+	struct via_crtc *iga = container_of(crtc,
+						struct via_crtc, base);
+	struct drm_crtc_state *crtc_state =
+			drm_atomic_get_new_crtc_state(state, crtc);
+	struct drm_pending_vblank_event *event;
+
+	iga->queue.open = false;
+	if (iga->queue.count) {
+		drm_dbg_kms(dev, "IGA%u: Flushing %u register writes.\n",
+				iga->index + 1, iga->queue.count);
+
+		via_crtc_evade_vblank(iga);
+		via_reg_queue_write_out(iga);
+	}
+
+	if (crtc_state->no_vblank) {
+		return;
+	}
+
+	/*
+	 * The new start address is latched at the next vertical
+	 * blank, so that is when the flip is complete. Send the
+	 * event right away if the CRTC is off.
+	 */
+	event = crtc_state->event;
+	if (event) {
+		crtc_state->event = NULL;
+
+		spin_lock_irq(&dev->event_lock);
+		if (drm_crtc_vblank_get(crtc) == 0) {
+			drm_crtc_arm_vblank_event(crtc, event);
+		} else {
+			drm_crtc_send_vblank_event(crtc, event);
+		}
+
+		spin_unlock_irq(&dev->event_lock);
+	}
+}
+
 static const struct drm_crtc_helper_funcs via_drm_crtc_helper_funcs = {
 	.mode_set_nofb = via_mode_set_nofb,
+	.atomic_begin = via_crtc_helper_atomic_begin,
+	.atomic_flush = via_crtc_helper_atomic_flush,
 	.atomic_enable = via_crtc_helper_atomic_enable,
 	.atomic_disable = via_crtc_helper_atomic_disable,
 };
@@ -1909,80 +1607,220 @@ static void via_primary_atomic_disable(struct drm_plane *plane,
 	return;
 }
 
+#define VIA_START_ADDRESS_REGS	4
+
+static void via_reg_entry_vga(struct via_reg_queue_entry *entry,
+				u8 index, u8 data, u8 mask)
+{
+	entry->reg = (VGA_CRT_IC << 8) | index;
+	entry->data = data & mask;
+	entry->mask = mask;
+	entry->vga = true;
+}
+
+/*
+ * Computes the register writes for the scanout start address of the
+ * plane's framebuffer, in the order they have to be done.
+ */
+static void via_primary_start_address_regs(struct via_crtc *iga,
+				struct drm_plane_state *plane_state,
+				struct via_reg_queue_entry *regs)
+{
+	struct drm_framebuffer *fb = plane_state->fb;
+	uint32_t pitch = (plane_state->crtc_y * fb->pitches[0]) +
+			(plane_state->crtc_x * fb->format->cpp[0]);
+	struct ttm_buffer_object *ttm_bo;
+	uint32_t addr;
+
+	ttm_bo = container_of(fb->obj[0], struct ttm_buffer_object, base);
+
+	if (!iga->index) {
+		addr = round_up((ttm_bo->resource->start << PAGE_SHIFT) +
+				pitch, 16) >> 1;
+
+		via_reg_entry_vga(&regs[0], 0x0D, addr & 0xFF, 0xFF);
+		via_reg_entry_vga(&regs[1], 0x0C, (addr >> 8) & 0xFF, 0xFF);
+		/* Yes order of setting these registers matters on some hardware */
+		via_reg_entry_vga(&regs[2], 0x48, ((addr >> 24) & 0x1F), 0x1F);
+		via_reg_entry_vga(&regs[3], 0x34, (addr >> 16) & 0xFF, 0xFF);
+	} else {
+		addr = round_up((ttm_bo->resource->start << PAGE_SHIFT) +
+				pitch, 16);
+		/* Bits 9 to 3 of the frame buffer go into bits 7 to 1
+		 * of the register. Bit 0 is for setting tile mode or
+		 * linear mode. A value of zero sets it to linear mode */
+		via_reg_entry_vga(&regs[0], 0x62,
+					((addr >> 3) & 0x7F) << 1, 0xFF);
+		via_reg_entry_vga(&regs[1], 0x63, (addr >> 10) & 0xFF, 0xFF);
+		via_reg_entry_vga(&regs[2], 0x64, (addr >> 18) & 0xFF, 0xFF);
+		via_reg_entry_vga(&regs[3], 0xA3, ((addr >> 26) & 0x07), 0x07);
+	}
+}
+
+/*
+ * Queues the scanout start address of the plane's framebuffer.
+ */
+static void via_primary_set_start_address(struct via_crtc *iga,
+					struct drm_plane_state *plane_state)
+{
+	struct via_reg_queue_entry regs[VIA_START_ADDRESS_REGS];
+	unsigned int i;
+
+	via_primary_start_address_regs(iga, plane_state, regs);
+	for (i = 0; i < VIA_START_ADDRESS_REGS; i++) {
+		via_reg_queue_add(iga, regs[i].vga, regs[i].reg,
+					regs[i].data, regs[i].mask);
+	}
+}
+
+/*
+ * Writes the scanout start address of the plane's framebuffer right
+ * away. An async update can run while a nonblocking commit of the same
+ * CRTC has its queue open, so it must not go through the queue, which
+ * is only protected by the commit sequence.
+ */
+static void via_primary_write_start_address(struct via_crtc *iga,
+					struct drm_plane_state *plane_state)
+{
+	struct via_reg_queue_entry regs[VIA_START_ADDRESS_REGS];
+	unsigned long flags;
+	unsigned int i;
+
+	via_primary_start_address_regs(iga, plane_state, regs);
+
+	local_irq_save(flags);
+	for (i = 0; i < VIA_START_ADDRESS_REGS; i++) {
+		via_reg_queue_write(iga, &regs[i]);
+	}
+
+	local_irq_restore(flags);
+}
+
+/*
+ * Tells whether going from the old to the new plane state only changes
+ * the memory being scanned out. Color depth, fetch count and pitch
+ * registers then already hold the right values, and reprogramming the
+ * start address is all it takes.
+ */
+static bool via_primary_flip_only(const struct drm_plane_state *old_state,
+				const struct drm_plane_state *new_state)
+{
+	if ((!old_state->fb) || (!new_state->fb) ||
+		(!old_state->visible) || (!new_state->visible)) {
+		return false;
+	}
+
+	if ((old_state->crtc != new_state->crtc) ||
+		(old_state->crtc_x != new_state->crtc_x) ||
+		(old_state->crtc_y != new_state->crtc_y)) {
+		return false;
+	}
+
+	if ((old_state->fb->format != new_state->fb->format) ||
+		(old_state->fb->pitches[0] != new_state->fb->pitches[0])) {
+		return false;
+	}
+
+	return drm_rect_equals(&old_state->src, &new_state->src) &&
+		drm_rect_equals(&old_state->dst, &new_state->dst);
+}
+
 static void via_primary_atomic_update(struct drm_plane *plane,
 					struct drm_atomic_state *state)
 {
+	struct drm_plane_state *old_state =
+			drm_atomic_get_old_plane_state(state, plane);
 	struct drm_plane_state *new_state =
 			drm_atomic_get_new_plane_state(state, plane);
 	struct drm_crtc *crtc = new_state->crtc;
+	struct drm_crtc_state *crtc_state =
+			drm_atomic_get_new_crtc_state(state, crtc);
 	struct drm_framebuffer *fb = new_state->fb;
-	uint32_t pitch = (new_state->crtc_y * fb->pitches[0]) +
-			(new_state->crtc_x * fb->format->cpp[0]);
-	uint32_t addr;
 	struct via_crtc *iga = container_of(crtc, struct via_crtc, base);
 	struct drm_device *dev = crtc->dev;
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
-	struct drm_gem_object *gem;
-	struct ttm_buffer_object *ttm_bo;
-	struct via_bo *bo;
+	uint32_t pitch;
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
-	gem = fb->obj[0];
-	ttm_bo = container_of(gem, struct ttm_buffer_object, base);
-	bo = to_ttm_bo(ttm_bo);
+	if ((crtc_state) && (!drm_atomic_crtc_needs_modeset(crtc_state)) &&
+		(via_primary_flip_only(old_state, new_state))) {
+		via_primary_set_start_address(iga, new_state);
+		goto exit;
+	}
 
 	if (!iga->index) {
-		via_iga1_set_color_depth(dev,
+		via_iga1_set_color_depth(iga,
 						fb->format->cpp[0],
 						fb->format->depth);
-
-		/* Set the framebuffer offset */
-		addr = round_up((ttm_bo->resource->start << PAGE_SHIFT) +
-				pitch, 16) >> 1;
-
-		vga_wcrt(VGABASE, 0x0D, addr & 0xFF);
-		vga_wcrt(VGABASE, 0x0C, (addr >> 8) & 0xFF);
-		/* Yes order of setting these registers matters on some hardware */
-		svga_wcrt_mask(VGABASE, 0x48, ((addr >> 24) & 0x1F), 0x1F);
-		vga_wcrt(VGABASE, 0x34, (addr >> 16) & 0xFF);
-
-		/* Load fetch count registers */
-		pitch = ALIGN(crtc->mode.hdisplay * fb->format->cpp[0],	16);
-		load_value_to_registers(VGABASE, &iga->fetch, pitch >> 4);
-
-		/* Set the primary pitch */
-		pitch = ALIGN(fb->pitches[0], 16);
-		/* Spec does not say that first adapter skips 3 bits but old
-		 * code did it and seems to be reasonable in analogy to
-		 * second adapter */
-		load_value_to_registers(VGABASE, &iga->offset, pitch >> 3);
 	} else {
-		via_iga2_set_color_depth(dev,
+		via_iga2_set_color_depth(iga,
 						fb->format->cpp[0],
 						fb->format->depth);
+	}
 
-		/* Set the framebuffer offset */
-		addr = round_up((ttm_bo->resource->start << PAGE_SHIFT) +
-				pitch, 16);
-		/* Bits 9 to 3 of the frame buffer go into bits 7 to 1
-		 * of the register. Bit 0 is for setting tile mode or
-		 * linear mode. A value of zero sets it to linear mode */
-		vga_wcrt(VGABASE, 0x62, ((addr >> 3) & 0x7F) << 1);
-		vga_wcrt(VGABASE, 0x63, (addr >> 10) & 0xFF);
-		vga_wcrt(VGABASE, 0x64, (addr >> 18) & 0xFF);
-		svga_wcrt_mask(VGABASE, 0xA3, ((addr >> 26) & 0x07), 0x07);
+	/* Set the framebuffer offset */
+	via_primary_set_start_address(iga, new_state);
+
+	/* Load fetch count registers */
+	pitch = ALIGN(crtc->mode.hdisplay * fb->format->cpp[0], 16);
+	via_reg_queue_value(iga, &iga->fetch, pitch >> 4);
 
-		/* Load fetch count registers */
-		pitch = ALIGN(crtc->mode.hdisplay * fb->format->cpp[0], 16);
-		load_value_to_registers(VGABASE, &iga->fetch, pitch >> 4);
+	/* Set the primary / secondary pitch */
+	pitch = ALIGN(fb->pitches[0], 16);
+	/* Spec does not say that first adapter skips 3 bits but old
+	 * code did it and seems to be reasonable in analogy to
+	 * second adapter */
+	via_reg_queue_value(iga, &iga->offset, pitch >> 3);
+exit:
+	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
+}
 
-		/* Set secondary pitch */
-		pitch = ALIGN(fb->pitches[0], 16);
-		load_value_to_registers(VGABASE, &iga->offset, pitch >> 3);
+static int via_primary_atomic_async_check(struct drm_plane *plane,
+					struct drm_atomic_state *state)
+{
+	struct drm_plane_state *new_state =
+			drm_atomic_get_new_plane_state(state, plane);
+	struct drm_crtc_state *crtc_state;
+
+	if ((!plane->state) ||
+		(!via_primary_flip_only(plane->state, new_state))) {
+		return -EINVAL;
 	}
 
-	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
+	crtc_state = drm_atomic_get_new_crtc_state(state, new_state->crtc);
+	if ((!crtc_state) || (!crtc_state->active) ||
+		(drm_atomic_crtc_needs_modeset(crtc_state))) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Flips to the new framebuffer right away, without waiting for vertical
+ * blank. Only the start address registers get written.
+ */
+static void via_primary_atomic_async_update(struct drm_plane *plane,
+					struct drm_atomic_state *state)
+{
+	struct drm_plane_state *new_state =
+			drm_atomic_get_new_plane_state(state, plane);
+	struct drm_crtc *crtc = new_state->crtc;
+	struct drm_crtc_state *crtc_state =
+			drm_atomic_get_new_crtc_state(state, crtc);
+	struct via_crtc *iga = container_of(crtc, struct via_crtc, base);
+	struct drm_device *dev = plane->dev;
+	unsigned long flags;
+
+	swap(plane->state->fb, new_state->fb);
+	via_primary_write_start_address(iga, plane->state);
+
+	if ((crtc_state) && (crtc_state->event)) {
+		spin_lock_irqsave(&dev->event_lock, flags);
+		drm_crtc_send_vblank_event(crtc, crtc_state->event);
+		spin_unlock_irqrestore(&dev->event_lock, flags);
+		crtc_state->event = NULL;
+	}
 }
 
 static int via_primary_prepare_fb(struct drm_plane *plane,
@@ -2053,6 +1891,8 @@ via_primary_drm_plane_helper_funcs = {
 	.atomic_check = via_primary_atomic_check,
 	.atomic_update = via_primary_atomic_update,
 	.atomic_disable = via_primary_atomic_disable,
+	.atomic_async_check = via_primary_atomic_async_check,
+	.atomic_async_update = via_primary_atomic_async_update,
 };
 
 static const struct drm_plane_funcs via_primary_drm_plane_funcs = {
@@ -2074,6 +1914,7 @@ static void via_crtc_param_init(struct via_drm_priv *dev_priv,
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_crtc *iga = container_of(crtc,
 						struct via_crtc, base);
+	struct vga_registers *fields[VIA_TIMING_NUM_FIELDS];
 
     drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
@@ -2226,9 +2067,63 @@ static void via_crtc_param_init(struct via_drm_priv *dev_priv,
 		iga->offset.count = ARRAY_SIZE(iga1_offset);
 		iga->offset.regs = iga1_offset;
 	}
+
+	via_crtc_timing_fields(&iga->timings, fields);
+	if (via_reg_program_compile(&iga->timing_program, fields,
+					VIA_TIMING_NUM_FIELDS)) {
+		drm_err(dev, "Failed to compile IGA%u timing registers! "
+				"Falling back to per-field loads.\n",
+				iga->index + 1);
+	}
+
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
 
+static void via_vga_shadow_stats_print(struct seq_file *m,
+					const char *name,
+					const struct via_vga_shadow_stats *stats)
+{
+	seq_printf(m, "%s: %llu reads, %llu writes, "
+			"%llu reads avoided, %llu writes avoided\n",
+			name, stats->reads, stats->writes,
+			stats->reads_avoided, stats->writes_avoided);
+}
+
+static int via_vga_shadow_show(struct seq_file *m, void *unused)
+{
+	struct drm_debugfs_entry *entry = m->private;
+	struct drm_device *dev = entry->dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_vga_shadow_stats stats;
+	struct drm_crtc *crtc;
+	struct via_crtc *iga;
+	unsigned long flags;
+	char name[32];
+
+	via_vga_shadow_stats_get(VGASHADOW, &stats);
+	via_vga_shadow_stats_print(m, "total", &stats);
+
+	drm_for_each_crtc(crtc, dev) {
+		iga = container_of(crtc, struct via_crtc, base);
+		snprintf(name, sizeof(name), "IGA%u last mode set",
+				iga->index + 1);
+
+		spin_lock_irqsave(&dev_priv->vga_shadow.lock, flags);
+		stats = iga->mode_set_stats;
+		spin_unlock_irqrestore(&dev_priv->vga_shadow.lock, flags);
+
+		via_vga_shadow_stats_print(m, name, &stats);
+	}
+
+	return 0;
+}
+
+void via_crtc_debugfs_init(struct drm_device *dev)
+{
+	drm_debugfs_add_file(dev, "via_vga_shadow", via_vga_shadow_show,
+				NULL);
+}
+
 static int via_gamma_init(struct drm_crtc *crtc)
 {
 	struct drm_device *dev = crtc->dev;
@@ -2315,6 +2210,8 @@ int via_crtc_init(struct via_drm_priv *dev_priv, uint32_t index)
 		goto free_cursor;
 	}
 
+	drm_plane_enable_fb_damage_clips(cursor);
+
 	iga = kzalloc(sizeof(struct via_crtc), GFP_KERNEL);
 	if (!iga) {
 		ret = -ENOMEM;
@@ -2356,3 +2253,7 @@ exit:
     drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 	return ret;
 }
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_crtc_test.c"
+#endif
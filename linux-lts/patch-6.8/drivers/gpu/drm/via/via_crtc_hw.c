@@ -24,10 +24,236 @@
  * James Simmons <jsimmons@infradead.org>
  */
 
+#include <linux/errno.h>
+#include <linux/spinlock.h>
+
 #include <video/vga.h>
 
+#include <drm/drm_device.h>
+
 #include "via_crtc_hw.h"
 
+/*
+ * Registers the hardware updates on its own, or whose read back
+ * value depends on state outside of the register itself.
+ */
+static const u8 via_vga_shadow_volatile_seq[] = {
+	0x12,	/* Strapping (banked by SR5A[0]) */
+	0x13,	/* Strapping (banked by SR5A[0]) */
+	0x25,	/* GPIO port */
+	0x26,	/* I2C port */
+	0x2c,	/* GPIO port */
+	0x31,	/* I2C port */
+	0x3c,	/* PLL lock status */
+	0x3d,	/* GPIO port */
+};
+
+/*
+ * BIOS scratch pad registers. The video BIOS may update them behind
+ * the driver's back, so they are only read through the shadow to
+ * serialize the index / data pair access with the other CRT users.
+ */
+static const u8 via_vga_shadow_volatile_crt[] = {
+	0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+};
+
+/*
+ * Registers that switch which physical register some of the other
+ * indexes of the same bank reach. Every cached value of that bank is
+ * dropped when one of them is written.
+ */
+static const u8 via_vga_shadow_select_crt[] = {
+	0xfd,	/* IGA1 / IGA2 / downscaling register reuse */
+};
+
+static int via_vga_shadow_bank(u16 port)
+{
+	switch (port) {
+	case VGA_SEQ_I:
+		return VIA_VGA_SHADOW_SEQ;
+	case VGA_CRT_IC:
+		return VIA_VGA_SHADOW_CRT;
+	case VGA_GFX_I:
+		return VIA_VGA_SHADOW_GFX;
+	default:
+		return -1;
+	}
+}
+
+void via_vga_shadow_init(struct via_vga_shadow *shadow,
+				void __iomem *regbase)
+{
+	unsigned int i;
+
+	memset(shadow, 0, sizeof(*shadow));
+	spin_lock_init(&shadow->lock);
+	shadow->regbase = regbase;
+
+	for (i = 0; i < ARRAY_SIZE(via_vga_shadow_volatile_seq); i++) {
+		__set_bit(via_vga_shadow_volatile_seq[i],
+			shadow->volatile_regs[VIA_VGA_SHADOW_SEQ]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(via_vga_shadow_volatile_crt); i++) {
+		__set_bit(via_vga_shadow_volatile_crt[i],
+			shadow->volatile_regs[VIA_VGA_SHADOW_CRT]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(via_vga_shadow_select_crt); i++) {
+		__set_bit(via_vga_shadow_select_crt[i],
+			shadow->select_regs[VIA_VGA_SHADOW_CRT]);
+	}
+}
+
+/*
+ * Forget every cached value. To be called whenever the registers
+ * may have been changed behind the driver's back (i.e., standby
+ * resume).
+ */
+void via_vga_shadow_invalidate(struct via_vga_shadow *shadow)
+{
+	unsigned long flags;
+	unsigned int i;
+
+	spin_lock_irqsave(&shadow->lock, flags);
+	for (i = 0; i < VIA_VGA_SHADOW_BANKS; i++) {
+		bitmap_zero(shadow->valid[i], VIA_VGA_SHADOW_REGS);
+	}
+
+	spin_unlock_irqrestore(&shadow->lock, flags);
+}
+
+/*
+ * Report the register accesses performed and avoided since the
+ * previous report, and start a new accounting period.
+ */
+void via_vga_shadow_report(struct drm_device *dev,
+				struct via_vga_shadow *shadow)
+{
+	struct via_vga_shadow_stats commit;
+	unsigned long flags;
+
+	spin_lock_irqsave(&shadow->lock, flags);
+	commit = shadow->commit;
+	memset(&shadow->commit, 0, sizeof(shadow->commit));
+	spin_unlock_irqrestore(&shadow->lock, flags);
+
+	if (!commit.reads && !commit.writes &&
+		!commit.reads_avoided && !commit.writes_avoided) {
+		return;
+	}
+
+	drm_dbg_kms(dev, "VGA registers: %llu reads, %llu writes, "
+			"%llu reads avoided, %llu writes avoided.\n",
+			commit.reads, commit.writes,
+			commit.reads_avoided, commit.writes_avoided);
+}
+
+/*
+ * Copy the register accesses performed and avoided since the shadow
+ * was set up. Subtracting two copies gives the cost of whatever ran
+ * in between.
+ */
+void via_vga_shadow_stats_get(struct via_vga_shadow *shadow,
+				struct via_vga_shadow_stats *stats)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&shadow->lock, flags);
+	*stats = shadow->total;
+	spin_unlock_irqrestore(&shadow->lock, flags);
+}
+
+u8 via_vga_shadow_read(struct via_vga_shadow *shadow, u16 port, u8 index)
+{
+	void __iomem *regbase = shadow->regbase;
+	unsigned long flags;
+	int bank = via_vga_shadow_bank(port);
+	u8 value;
+
+	spin_lock_irqsave(&shadow->lock, flags);
+	if ((bank >= 0) &&
+		(!test_bit(index, shadow->volatile_regs[bank])) &&
+		(test_bit(index, shadow->valid[bank]))) {
+		value = shadow->regs[bank][index];
+		shadow->commit.reads_avoided++;
+		shadow->total.reads_avoided++;
+		goto exit;
+	}
+
+	vga_w(regbase, port, index);
+	value = vga_r(regbase, port + 1);
+	shadow->commit.reads++;
+	shadow->total.reads++;
+
+	if ((bank >= 0) &&
+		(!test_bit(index, shadow->volatile_regs[bank]))) {
+		shadow->regs[bank][index] = value;
+		__set_bit(index, shadow->valid[bank]);
+	}
+exit:
+	spin_unlock_irqrestore(&shadow->lock, flags);
+	return value;
+}
+
+void via_vga_shadow_write_mask(struct via_vga_shadow *shadow, u16 port,
+				u8 index, u8 data, u8 mask)
+{
+	void __iomem *regbase = shadow->regbase;
+	unsigned long flags;
+	int bank = via_vga_shadow_bank(port);
+	bool cacheable, cached = false;
+	u8 orig = 0x00, value;
+
+	cacheable = (bank >= 0) &&
+			(!test_bit(index, shadow->volatile_regs[bank]));
+
+	spin_lock_irqsave(&shadow->lock, flags);
+	if (cacheable) {
+		cached = test_bit(index, shadow->valid[bank]);
+	}
+
+	if (cached) {
+		orig = shadow->regs[bank][index];
+		if (mask != 0xff) {
+			shadow->commit.reads_avoided++;
+			shadow->total.reads_avoided++;
+		}
+	} else if (mask != 0xff) {
+		vga_w(regbase, port, index);
+		orig = vga_r(regbase, port + 1);
+		shadow->commit.reads++;
+		shadow->total.reads++;
+	}
+
+	value = (data & mask) | (orig & ~mask);
+	if ((cached) && (value == orig)) {
+		shadow->commit.writes_avoided++;
+		shadow->total.writes_avoided++;
+		goto exit;
+	}
+
+	vga_w(regbase, port, index);
+	vga_w(regbase, port + 1, value);
+	shadow->commit.writes++;
+	shadow->total.writes++;
+
+	if (cacheable) {
+		/*
+		 * The indexes now reach other registers, whose values
+		 * are not known.
+		 */
+		if (test_bit(index, shadow->select_regs[bank])) {
+			bitmap_zero(shadow->valid[bank], VIA_VGA_SHADOW_REGS);
+		}
+
+		shadow->regs[bank][index] = value;
+		__set_bit(index, shadow->valid[bank]);
+	}
+exit:
+	spin_unlock_irqrestore(&shadow->lock, flags);
+}
+
 /*
  * load_register_table enables the ability to set entire
  * tables of registers. For each register defined by the
@@ -35,9 +261,9 @@
  * with a masked value.
  */
 void
-load_register_tables(void __iomem *regbase, struct vga_registers *regs)
+load_register_tables(struct via_vga_shadow *shadow, struct vga_registers *regs)
 {
-	u8 cr_index, orig, reg_mask, data;
+	u8 cr_index, reg_mask, data;
 	unsigned int i;
 	u16 port;
 
@@ -47,9 +273,8 @@ load_register_tables(void __iomem *regbase, struct vga_registers *regs)
 		cr_index = regs->regs[i].io_addr;
 		port = regs->regs[i].ioport;
 
-		vga_w(regbase, port, cr_index);
-		orig = (vga_r(regbase, port + 1) & ~reg_mask);
-		vga_w(regbase, port + 1, ((data & reg_mask) | orig));
+		via_vga_shadow_write_mask(shadow, port, cr_index,
+						data, reg_mask);
 	}
 }
 
@@ -61,11 +286,11 @@ load_register_tables(void __iomem *regbase, struct vga_registers *regs)
  * registers.
  */
 void
-load_value_to_registers(void __iomem *regbase, struct vga_registers *regs,
+load_value_to_registers(struct via_vga_shadow *shadow, struct vga_registers *regs,
 			unsigned int value)
 {
 	unsigned int bit_num = 0, shift_next_reg, reg_mask;
-	u8 start_index, end_index, cr_index, orig;
+	u8 start_index, end_index, cr_index;
 	unsigned int data, i, j;
 	u16 get_bit, port;
 
@@ -84,8 +309,115 @@ load_value_to_registers(void __iomem *regbase, struct vga_registers *regs,
 			bit_num++;
 		}
 
-		vga_w(regbase, port, cr_index);
-		orig = (vga_r(regbase, port + 1) & ~reg_mask);
-		vga_w(regbase, port + 1, ((data & reg_mask) | orig));
+		via_vga_shadow_write_mask(shadow, port, cr_index,
+						data, reg_mask);
+	}
+}
+
+/*
+ * via_reg_program_compile merges the fragments of several
+ * vga_registers tables by (port, index), so that
+ * via_reg_program_load can load all of the tables with exactly one
+ * masked write per physical register. The tables are expected to use
+ * the same bit layout load_value_to_registers does.
+ */
+int
+via_reg_program_compile(struct via_reg_program *prog,
+			struct vga_registers **fields,
+			unsigned int num_fields)
+{
+	struct via_reg_fragment *frag;
+	struct vga_regset *regset;
+	unsigned int field, i, op;
+	u8 value_shift;
+	int ret = 0;
+
+	memset(prog, 0, sizeof(*prog));
+
+	for (field = 0; field < num_fields; field++) {
+		value_shift = 0;
+
+		for (i = 0; i < fields[field]->count; i++) {
+			regset = &fields[field]->regs[i];
+
+			for (op = 0; op < prog->num_ops; op++) {
+				if ((prog->ops[op].ioport == regset->ioport) &&
+					(prog->ops[op].io_addr ==
+							regset->io_addr)) {
+					break;
+				}
+			}
+
+			if (op == prog->num_ops) {
+				if (prog->num_ops >= VIA_REG_PROGRAM_MAX_OPS) {
+					ret = -E2BIG;
+					goto exit;
+				}
+
+				prog->ops[op].ioport = regset->ioport;
+				prog->ops[op].io_addr = regset->io_addr;
+				prog->num_ops++;
+			}
+
+			if (prog->num_frags >= VIA_REG_PROGRAM_MAX_FRAGS) {
+				ret = -E2BIG;
+				goto exit;
+			}
+
+			frag = &prog->frags[prog->num_frags++];
+			frag->op = op;
+			frag->field = field;
+			frag->value_shift = value_shift;
+			frag->reg_shift = regset->start_bit;
+			frag->mask = GENMASK(regset->end_bit,
+						regset->start_bit);
+			prog->ops[op].mask |= frag->mask;
+
+			value_shift += regset->end_bit -
+					regset->start_bit + 1;
+		}
+	}
+
+exit:
+	if (ret) {
+		prog->num_ops = 0;
+		prog->num_frags = 0;
 	}
+
+	return ret;
 }
+
+void
+via_reg_program_load(struct via_vga_shadow *shadow,
+			const struct via_reg_program *prog,
+			const u32 *values)
+{
+	const struct via_reg_fragment *frag;
+	u8 data[VIA_REG_PROGRAM_MAX_OPS];
+	unsigned int i;
+	u8 bits;
+
+	memset(data, 0, prog->num_ops);
+
+	/*
+	 * Fragments are applied in table order, so a later field still
+	 * wins when two fields overlap, as it did when every table was
+	 * loaded on its own.
+	 */
+	for (i = 0; i < prog->num_frags; i++) {
+		frag = &prog->frags[i];
+		bits = ((values[frag->field] >> frag->value_shift) <<
+				frag->reg_shift) & frag->mask;
+		data[frag->op] = (data[frag->op] & ~frag->mask) | bits;
+	}
+
+	for (i = 0; i < prog->num_ops; i++) {
+		via_vga_shadow_write_mask(shadow, prog->ops[i].ioport,
+						prog->ops[i].io_addr,
+						data[i], prog->ops[i].mask);
+	}
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_crtc_hw_test.c"
+#endif
@@ -27,6 +27,10 @@
 #ifndef __CRTC_HW_H__
 #define __CRTC_HW_H__
 
+#include <linux/bitmap.h>
+#include <linux/spinlock.h>
+#include <linux/types.h>
+
 #include <video/vga.h>
 
 #include <drm/drm_print.h>
@@ -70,6 +74,134 @@ struct crtc_timings {
 	struct vga_registers vsync_end;
 };
 
+/* Order of the values handed to via_reg_program_load() for timings. */
+enum via_crtc_timing_field {
+	VIA_TIMING_HTOTAL,
+	VIA_TIMING_HDISPLAY,
+	VIA_TIMING_HBLANK_START,
+	VIA_TIMING_HBLANK_END,
+	VIA_TIMING_HSYNC_START,
+	VIA_TIMING_HSYNC_END,
+	VIA_TIMING_VTOTAL,
+	VIA_TIMING_VDISPLAY,
+	VIA_TIMING_VBLANK_START,
+	VIA_TIMING_VBLANK_END,
+	VIA_TIMING_VSYNC_START,
+	VIA_TIMING_VSYNC_END,
+	VIA_TIMING_NUM_FIELDS
+};
+
+/*
+ * A set of vga_registers tables compiled into one masked write per
+ * physical register. Several fields often share one register (i.e.,
+ * the CR07, CR33, and CR35 overflow bits), and loading them one table
+ * at a time would touch that register once per field.
+ */
+#define VIA_REG_PROGRAM_MAX_OPS		32
+#define VIA_REG_PROGRAM_MAX_FRAGS	64
+
+struct via_reg_op {
+	u16	ioport;
+	u8	io_addr;
+	u8	mask;
+};
+
+struct via_reg_fragment {
+	u8	op;		/* Index into ops[] */
+	u8	field;		/* Index into the value array */
+	u8	value_shift;	/* First value bit held by this fragment */
+	u8	reg_shift;	/* First register bit */
+	u8	mask;		/* Register bits, already shifted */
+};
+
+struct via_reg_program {
+	unsigned int num_ops;
+	unsigned int num_frags;
+	struct via_reg_op ops[VIA_REG_PROGRAM_MAX_OPS];
+	struct via_reg_fragment frags[VIA_REG_PROGRAM_MAX_FRAGS];
+};
+
+/************************************************
+ *****     VGA Register Shadow       *****
+ ************************************************/
+
+/*
+ * Shadow copy of the VGA indexed register banks (3C5, 3D5, and 3CF).
+ * The last value written to or read from a register is kept so that
+ * masked writes do not have to read the register back first, and
+ * writes of an unchanged value can be dropped. Registers modified by
+ * the hardware itself (i.e., status, strapping, and I2C / GPIO pin
+ * registers) are marked volatile and always go to the hardware.
+ * Writing a register that switches which register other indexes
+ * reach (i.e., CRFD) drops every cached value of its bank.
+ */
+#define VIA_VGA_SHADOW_SEQ	0
+#define VIA_VGA_SHADOW_CRT	1
+#define VIA_VGA_SHADOW_GFX	2
+#define VIA_VGA_SHADOW_BANKS	3
+
+#define VIA_VGA_SHADOW_REGS	256
+
+struct via_vga_shadow_stats {
+	u64 reads;
+	u64 writes;
+	u64 reads_avoided;
+	u64 writes_avoided;
+};
+
+struct via_vga_shadow {
+	spinlock_t lock;
+	void __iomem *regbase;
+
+	u8 regs[VIA_VGA_SHADOW_BANKS][VIA_VGA_SHADOW_REGS];
+	DECLARE_BITMAP(valid[VIA_VGA_SHADOW_BANKS], VIA_VGA_SHADOW_REGS);
+	DECLARE_BITMAP(volatile_regs[VIA_VGA_SHADOW_BANKS],
+			VIA_VGA_SHADOW_REGS);
+	DECLARE_BITMAP(select_regs[VIA_VGA_SHADOW_BANKS],
+			VIA_VGA_SHADOW_REGS);
+
+	/* Accumulated since the last via_vga_shadow_report(). */
+	struct via_vga_shadow_stats commit;
+	struct via_vga_shadow_stats total;
+};
+
+struct drm_device;
+
+void via_vga_shadow_init(struct via_vga_shadow *shadow,
+				void __iomem *regbase);
+void via_vga_shadow_invalidate(struct via_vga_shadow *shadow);
+void via_vga_shadow_report(struct drm_device *dev,
+				struct via_vga_shadow *shadow);
+void via_vga_shadow_stats_get(struct via_vga_shadow *shadow,
+				struct via_vga_shadow_stats *stats);
+u8 via_vga_shadow_read(struct via_vga_shadow *shadow, u16 port, u8 index);
+void via_vga_shadow_write_mask(struct via_vga_shadow *shadow, u16 port,
+				u8 index, u8 data, u8 mask);
+
+/* Read a sequence register, possibly from the shadow */
+static inline u8 via_vga_rseq(struct via_vga_shadow *shadow, u8 index)
+{
+	return via_vga_shadow_read(shadow, VGA_SEQ_I, index);
+}
+
+/* Write a value to a sequence register through the shadow */
+static inline void via_vga_wseq(struct via_vga_shadow *shadow, u8 index, u8 data)
+{
+	via_vga_shadow_write_mask(shadow, VGA_SEQ_I, index, data, 0xff);
+}
+
+/* Read a CRT register, possibly from the shadow */
+static inline u8 via_vga_rcrt(struct via_vga_shadow *shadow, u8 index)
+{
+	return via_vga_shadow_read(shadow, VGA_CRT_IC, index);
+}
+
+/* Write a value to a CRT register through the shadow */
+static inline void via_vga_wcrt(struct via_vga_shadow *shadow, u8 index, u8 data)
+{
+	via_vga_shadow_write_mask(shadow, VGA_CRT_IC, index, data, 0xff);
+}
+
 /* Write a value to misc register with a mask */
 static inline void svga_wmisc_mask(void __iomem *regbase, u8 data, u8 mask)
 {
@@ -77,15 +209,15 @@ static inline void svga_wmisc_mask(void __iomem *regbase, u8 data, u8 mask)
 }
 
 /* Write a value to a sequence register with a mask */
-static inline void svga_wseq_mask(void __iomem *regbase, u8 index, u8 data, u8 mask)
+static inline void svga_wseq_mask(struct via_vga_shadow *shadow, u8 index, u8 data, u8 mask)
 {
-	vga_wseq(regbase, index, (data & mask) | (vga_rseq(regbase, index) & ~mask));
+	via_vga_shadow_write_mask(shadow, VGA_SEQ_I, index, data, mask);
 }
 
 /* Write a value to a CRT register with a mask */
-static inline void svga_wcrt_mask(void __iomem *regbase, u8 index, u8 data, u8 mask)
+static inline void svga_wcrt_mask(struct via_vga_shadow *shadow, u8 index, u8 data, u8 mask)
 {
-	vga_wcrt(regbase, index, (data & mask) | (vga_rcrt(regbase, index) & ~mask));
+	via_vga_shadow_write_mask(shadow, VGA_CRT_IC, index, data, mask);
 }
 
 
@@ -96,38 +228,38 @@ static inline void svga_wcrt_mask(void __iomem *regbase, u8 index, u8 data, u8 m
 ***********************************************************************/
 
 static inline void
-via_iga1_set_palette_lut_resolution(void __iomem *regs,
+via_iga1_set_palette_lut_resolution(struct via_vga_shadow *shadow,
 					bool palette_lut)
 {
 	/* Set the palette LUT resolution for IGA1. */
 	/* 3C5.15[7] - IGA1 6 / 8 Bit LUT
 	 *             0: 6-bit
 	 *             1: 8-bit */
-	svga_wseq_mask(regs, 0x15, palette_lut ? BIT(7) : 0x00, BIT(7));
+	svga_wseq_mask(shadow, 0x15, palette_lut ? BIT(7) : 0x00, BIT(7));
 }
 
 static inline void
-via_iga2_set_palette_lut_resolution(void __iomem *regs,
+via_iga2_set_palette_lut_resolution(struct via_vga_shadow *shadow,
 					bool palette_lut)
 {
 	/* Set the palette LUT resolution for IGA2. */
 	/* 3X5.6A[5] - IGA2 6 / 8 Bit LUT
 	 *             0: 6-bit
 	 *             1: 8-bit */
-	svga_wcrt_mask(regs, 0x6a, palette_lut ? BIT(5) : 0x00, BIT(5));
+	svga_wcrt_mask(shadow, 0x6a, palette_lut ? BIT(5) : 0x00, BIT(5));
 }
 
 static inline void
-via_iga1_set_interlace_mode(void __iomem *regs, bool interlace_mode)
+via_iga1_set_interlace_mode(struct via_vga_shadow *shadow, bool interlace_mode)
 {
-	svga_wcrt_mask(regs, 0x33,
+	svga_wcrt_mask(shadow, 0x33,
 			interlace_mode ? BIT(6) : 0x00, BIT(6));
 }
 
 static inline void
-via_iga2_set_interlace_mode(void __iomem *regs, bool interlace_mode)
+via_iga2_set_interlace_mode(struct via_vga_shadow *shadow, bool interlace_mode)
 {
-	svga_wcrt_mask(regs, 0x67,
+	svga_wcrt_mask(shadow, 0x67,
 			interlace_mode ? BIT(5) : 0x00, BIT(5));
 }
 
@@ -135,10 +267,10 @@ via_iga2_set_interlace_mode(void __iomem *regs, bool interlace_mode)
  * Sets IGA1's HSYNC Shift value.
  */
 static inline void
-via_iga1_set_hsync_shift(void __iomem *regs, u8 shift_value)
+via_iga1_set_hsync_shift(struct via_vga_shadow *shadow, u8 shift_value)
 {
 	/* 3X5.33[2:0] - IGA1 HSYNC Shift */
-	svga_wcrt_mask(regs, 0x33, shift_value, BIT(2) | BIT(1) | BIT(0));
+	svga_wcrt_mask(shadow, 0x33, shift_value, BIT(2) | BIT(1) | BIT(0));
 }
 
 /*
@@ -146,14 +278,14 @@ via_iga1_set_hsync_shift(void __iomem *regs, u8 shift_value)
  * CLE266 chipset only.
  */
 static inline void
-via_dip0_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
+via_dip0_set_io_pad_state(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.1E[7:6] - DIP0 Power Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x1E, io_pad_state << 6, BIT(7) | BIT(6));
+	svga_wseq_mask(shadow, 0x1E, io_pad_state << 6, BIT(7) | BIT(6));
 }
 
 /*
@@ -161,14 +293,14 @@ via_dip0_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
  * CLE266 chipset only.
  */
 static inline void
-via_dip0_set_output_enable(void __iomem *regs, bool output_enable)
+via_dip0_set_output_enable(struct via_vga_shadow *shadow, bool output_enable)
 {
 	/*
 	* 3X5.6C[0] - DIP0 Output Enable
 	*             0: Output Disable
 	*             1: Output Enable
 	*/
-	svga_wcrt_mask(regs, 0x6c, output_enable ? BIT(0) : 0x00, BIT(0));
+	svga_wcrt_mask(shadow, 0x6c, output_enable ? BIT(0) : 0x00, BIT(0));
 }
 
 /*
@@ -176,14 +308,14 @@ via_dip0_set_output_enable(void __iomem *regs, bool output_enable)
  * interface. CLE266 chipset only.
  */
 static inline void
-via_dip0_set_clock_source(void __iomem *regs, bool clock_source)
+via_dip0_set_clock_source(struct via_vga_shadow *shadow, bool clock_source)
 {
 	/*
 	 * 3X5.6C[5] - DIP0 Clock Source
 	 *             0: External
 	 *             1: Internal
 	 */
-	svga_wcrt_mask(regs, 0x6c, clock_source ? BIT(5) : 0x00, BIT(5));
+	svga_wcrt_mask(shadow, 0x6c, clock_source ? BIT(5) : 0x00, BIT(5));
 }
 
 /*
@@ -191,14 +323,14 @@ via_dip0_set_clock_source(void __iomem *regs, bool clock_source)
  * CLE266 chipset only.
  */
 static inline void
-via_dip0_set_display_source(void __iomem *regs, u8 display_source)
+via_dip0_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/*
 	 * 3X5.6C[7] - DIP0 Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display
 	 */
-	svga_wcrt_mask(regs, 0x6c, display_source << 7, BIT(7));
+	svga_wcrt_mask(shadow, 0x6c, display_source << 7, BIT(7));
 }
 
 /*
@@ -206,14 +338,14 @@ via_dip0_set_display_source(void __iomem *regs, u8 display_source)
  * CLE266 chipset only.
  */
 static inline void
-via_dip1_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
+via_dip1_set_io_pad_state(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/*
 	 * 3C5.1E[5:4] - DIP1 I/O Pad Control
 	 *               00: I/O pad off
 	 *               11: I/O pad on
 	 */
-	svga_wseq_mask(regs, 0x1e, io_pad_state << 4, BIT(5) | BIT(4));
+	svga_wseq_mask(shadow, 0x1e, io_pad_state << 4, BIT(5) | BIT(4));
 }
 
 /*
@@ -221,14 +353,14 @@ via_dip1_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
  * CLE266 chipset only.
  */
 static inline void
-via_dip1_set_output_enable(void __iomem *regs, bool output_enable)
+via_dip1_set_output_enable(struct via_vga_shadow *shadow, bool output_enable)
 {
 	/*
 	 * 3X5.93[0] - DIP1 Output Enable
 	 *             0: Output Disable
 	 *             1: Output Enable
 	 */
-	svga_wcrt_mask(regs, 0x93, output_enable ? BIT(0) : 0x00, BIT(0));
+	svga_wcrt_mask(shadow, 0x93, output_enable ? BIT(0) : 0x00, BIT(0));
 }
 
 /*
@@ -236,14 +368,14 @@ via_dip1_set_output_enable(void __iomem *regs, bool output_enable)
  * interface. CLE266 chipset only.
  */
 static inline void
-via_dip1_set_clock_source(void __iomem *regs, bool clock_source)
+via_dip1_set_clock_source(struct via_vga_shadow *shadow, bool clock_source)
 {
 	/*
 	 * 3X5.93[5] - DIP1 Clock Source
 	 *             0: External
 	 *             1: Internal
 	 */
-	svga_wcrt_mask(regs, 0x93, clock_source ? BIT(5) : 0x00, BIT(5));
+	svga_wcrt_mask(shadow, 0x93, clock_source ? BIT(5) : 0x00, BIT(5));
 }
 
 /*
@@ -251,43 +383,43 @@ via_dip1_set_clock_source(void __iomem *regs, bool clock_source)
  * interface. CLE266 chipset only.
  */
 static inline void
-via_dip1_set_display_source(void __iomem *regs, u8 display_source)
+via_dip1_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/*
 	 * 3X5.93[7] - DIP1 Data Source Selection
 	 *             0: IGA1
 	 *             1: IGA2
 	 */
-	svga_wcrt_mask(regs, 0x93, display_source << 7, BIT(7));
+	svga_wcrt_mask(shadow, 0x93, display_source << 7, BIT(7));
 }
 
 /*
  * Sets DVP0 (Digital Video Port 0) I/O pad state.
  */
 static inline void
-via_dvp0_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
+via_dvp0_set_io_pad_state(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.1E[7:6] - DVP0 Power Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x1E, io_pad_state << 6, BIT(7) | BIT(6));
+	svga_wseq_mask(shadow, 0x1E, io_pad_state << 6, BIT(7) | BIT(6));
 }
 
 /*
  * Sets DVP0 (Digital Video Port 0) clock I/O pad drive strength.
  */
 static inline void
-via_dvp0_set_clock_drive_strength(void __iomem *regs,
+via_dvp0_set_clock_drive_strength(struct via_vga_shadow *shadow,
 					u8 clock_drive_strength)
 {
 	/* 3C5.1E[2] - DVP0 Clock Drive Strength Bit [0] */
-	svga_wseq_mask(regs, 0x1E,
+	svga_wseq_mask(shadow, 0x1E,
 			clock_drive_strength << 2, BIT(2));
 
 	/* 3C5.2A[4] - DVP0 Clock Drive Strength Bit [1] */
-	svga_wseq_mask(regs, 0x2A,
+	svga_wseq_mask(shadow, 0x2A,
 			clock_drive_strength << 3, BIT(4));
 }
 
@@ -295,15 +427,15 @@ via_dvp0_set_clock_drive_strength(void __iomem *regs,
  * Sets DVP0 (Digital Video Port 0) data I/O pads drive strength.
  */
 static inline void
-via_dvp0_set_data_drive_strength(void __iomem *regs,
+via_dvp0_set_data_drive_strength(struct via_vga_shadow *shadow,
 					u8 data_drive_strength)
 {
 	/* 3C5.1B[1] - DVP0 Data Drive Strength Bit [0] */
-	svga_wseq_mask(regs, 0x1B,
+	svga_wseq_mask(shadow, 0x1B,
 			data_drive_strength << 1, BIT(1));
 
 	/* 3C5.2A[5] - DVP0 Data Drive Strength Bit [1] */
-	svga_wseq_mask(regs, 0x2A,
+	svga_wseq_mask(shadow, 0x2A,
 			data_drive_strength << 4, BIT(5));
 }
 
@@ -311,33 +443,33 @@ via_dvp0_set_data_drive_strength(void __iomem *regs,
  * Sets the display source of DVP0 (Digital Video Port 0) interface.
  */
 static inline void
-via_dvp0_set_display_source(void __iomem *regs, u8 display_source)
+via_dvp0_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/* 3X5.96[4] - DVP0 Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x96, display_source << 4, BIT(4));
+	svga_wcrt_mask(shadow, 0x96, display_source << 4, BIT(4));
 }
 
 /*
  * Sets DVP1 (Digital Video Port 1) I/O pad state.
  */
 static inline void
-via_dvp1_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
+via_dvp1_set_io_pad_state(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.1E[5:4] - DVP1 Power Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x1E, io_pad_state << 4, BIT(5) | BIT(4));
+	svga_wseq_mask(shadow, 0x1E, io_pad_state << 4, BIT(5) | BIT(4));
 }
 
 /*
  * Sets DVP1 (Digital Video Port 1) clock I/O pad drive strength.
  */
 static inline void
-via_dvp1_set_clock_drive_strength(void __iomem *regs,
+via_dvp1_set_clock_drive_strength(struct via_vga_shadow *shadow,
 					u8 clock_drive_strength)
 {
 	/* 3C5.65[3:2] - DVP1 Clock Pads Driving Select [1:0]
@@ -345,7 +477,7 @@ via_dvp1_set_clock_drive_strength(void __iomem *regs,
 	 *               01: low
 	 *               10: high
 	 *               11: highest */
-	svga_wseq_mask(regs, 0x65,
+	svga_wseq_mask(shadow, 0x65,
 			clock_drive_strength << 2, BIT(3) | BIT(2));
 }
 
@@ -353,7 +485,7 @@ via_dvp1_set_clock_drive_strength(void __iomem *regs,
  * Sets DVP1 (Digital Video Port 1) data I/O pads drive strength.
  */
 static inline void
-via_dvp1_set_data_drive_strength(void __iomem *regs,
+via_dvp1_set_data_drive_strength(struct via_vga_shadow *shadow,
 					u8 data_drive_strength)
 {
 	/* 3C5.65[1:0] - DVP1 Data Pads Driving Select [1:0}
@@ -361,7 +493,7 @@ via_dvp1_set_data_drive_strength(void __iomem *regs,
 	 *               01: low
 	 *               10: high
 	 *               11: highest */
-	svga_wseq_mask(regs, 0x65,
+	svga_wseq_mask(shadow, 0x65,
 			data_drive_strength, BIT(1) | BIT(0));
 }
 
@@ -369,30 +501,30 @@ via_dvp1_set_data_drive_strength(void __iomem *regs,
  * Sets the display source of DVP1 (Digital Video Port 1) interface.
  */
 static inline void
-via_dvp1_set_display_source(void __iomem *regs, u8 display_source)
+via_dvp1_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/* 3X5.9B[4] - DVP1 Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x9B, display_source << 4, BIT(4));
+	svga_wcrt_mask(shadow, 0x9B, display_source << 4, BIT(4));
 }
 
 /*
  * Sets analog (VGA) DAC power.
  */
-static inline void via_dac_set_power(void __iomem *regs, bool output_state)
+static inline void via_dac_set_power(struct via_vga_shadow *shadow, bool output_state)
 {
 	/* 3X5.47[2] - DACOFF Backdoor Register
 	 *             0: DAC on
 	 *             1: DAC off */
-	svga_wcrt_mask(regs, 0x47,
+	svga_wcrt_mask(shadow, 0x47,
 			output_state ? 0x00 : BIT(2), BIT(2));
 }
 
 /*
  * Sets analog (VGA) DPMS state.
  */
-static inline void via_dac_set_dpms_control(void __iomem *regs,
+static inline void via_dac_set_dpms_control(struct via_vga_shadow *shadow,
 						u8 dpms_control)
 {
 	/* 3X5.36[5:4] - DPMS Control
@@ -400,14 +532,14 @@ static inline void via_dac_set_dpms_control(void __iomem *regs,
 	 *               01: Stand-by
 	 *               10: Suspend
 	 *               11: Off */
-	svga_wcrt_mask(regs, 0x36,
+	svga_wcrt_mask(shadow, 0x36,
 			dpms_control << 4, BIT(5) | BIT(4));
 }
 
 /*
  * Sets analog (VGA) sync polarity.
  */
-static inline void via_dac_set_sync_polarity(void __iomem *regs,
+static inline void via_dac_set_sync_polarity(struct via_vga_shadow *shadow,
 						u8 sync_polarity)
 {
 	/* 3C2[7] - Analog Vertical Sync Polarity
@@ -416,20 +548,20 @@ static inline void via_dac_set_sync_polarity(void __iomem *regs,
 	 * 3C2[6] - Analog Horizontal Sync Polarity
 	 *          0: Positive
 	 *          1: Negative */
-	svga_wmisc_mask(regs,
+	svga_wmisc_mask(shadow->regbase,
 			sync_polarity << 6, (BIT(1) | BIT(0)) << 6);
 }
 
 /*
  * Sets analog (VGA) display source.
  */
-static inline void via_dac_set_display_source(void __iomem *regs,
+static inline void via_dac_set_display_source(struct via_vga_shadow *shadow,
 						u8 display_source)
 {
 	/* 3C5.16[6] - CRT Display Source
 	 *             0: Primary Display Stream (IGA1)
 	 *             1: Secondary Display Stream (IGA2) */
-	svga_wseq_mask(regs, 0x16,
+	svga_wseq_mask(shadow, 0x16,
 			display_source << 6, BIT(6));
 }
 
@@ -437,13 +569,13 @@ static inline void via_dac_set_display_source(void __iomem *regs,
  * Sets KM400 or later chipset's FP primary power sequence control
  * type.
  */
-static inline void via_lvds_set_primary_power_seq_type(void __iomem *regs,
+static inline void via_lvds_set_primary_power_seq_type(struct via_vga_shadow *shadow,
 							bool ctrl_type)
 {
 	/* 3X5.91[0] - FP Primary Power Sequence Control Type
 	 *             0: Hardware Control
 	 *             1: Software Control */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			ctrl_type ? 0x00 : BIT(0), BIT(0));
 }
 
@@ -451,13 +583,13 @@ static inline void via_lvds_set_primary_power_seq_type(void __iomem *regs,
  * Sets KM400 or later chipset's FP primary software controlled
  * back light.
  */
-static inline void via_lvds_set_primary_soft_back_light(void __iomem *regs,
+static inline void via_lvds_set_primary_soft_back_light(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.91[1] - FP Primary Software Back Light On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			soft_on ? BIT(1) : 0x00, BIT(1));
 }
 
@@ -465,13 +597,13 @@ static inline void via_lvds_set_primary_soft_back_light(void __iomem *regs,
  * Sets KM400 or later chipset's FP primary software controlled
  * VEE.
  */
-static inline void via_lvds_set_primary_soft_vee(void __iomem *regs,
+static inline void via_lvds_set_primary_soft_vee(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.91[2] - FP Primary Software VEE On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			soft_on ? BIT(2) : 0x00, BIT(2));
 }
 
@@ -479,13 +611,13 @@ static inline void via_lvds_set_primary_soft_vee(void __iomem *regs,
  * Sets KM400 or later chipset's FP primary software controlled
  * data.
  */
-static inline void via_lvds_set_primary_soft_data(void __iomem *regs,
+static inline void via_lvds_set_primary_soft_data(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.91[3] - FP Primary Software Data On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			soft_on ? BIT(3) : 0x00, BIT(3));
 }
 
@@ -493,13 +625,13 @@ static inline void via_lvds_set_primary_soft_data(void __iomem *regs,
  * Sets KM400 or later chipset's FP primary software controlled
  * VDD.
  */
-static inline void via_lvds_set_primary_soft_vdd(void __iomem *regs,
+static inline void via_lvds_set_primary_soft_vdd(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.91[4] - FP Primary Software VDD On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			soft_on ? BIT(4) : 0x00, BIT(4));
 }
 
@@ -508,12 +640,12 @@ static inline void via_lvds_set_primary_soft_vdd(void __iomem *regs,
  * light control.
  */
 static inline void via_lvds_set_primary_direct_back_light_ctrl(
-					void __iomem *regs, bool direct_on)
+					struct via_vga_shadow *shadow, bool direct_on)
 {
 	/* 3X5.91[6] - FP Primary Direct Back Light Control
 	 *             0: On
 	 *             1: Off */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			direct_on ? 0x00 : BIT(6), BIT(6));
 }
 
@@ -522,12 +654,12 @@ static inline void via_lvds_set_primary_direct_back_light_ctrl(
  * period control.
  */
 static inline void via_lvds_set_primary_direct_display_period(
-					void __iomem *regs, bool direct_on)
+					struct via_vga_shadow *shadow, bool direct_on)
 {
 	/* 3X5.91[7] - FP Primary Direct Display Period Control
 	 *             0: On
 	 *             1: Off */
-	svga_wcrt_mask(regs, 0x91,
+	svga_wcrt_mask(shadow, 0x91,
 			direct_on ? 0x00 : BIT(7), BIT(7));
 }
 
@@ -535,13 +667,13 @@ static inline void via_lvds_set_primary_direct_display_period(
  * Sets KM400 or later chipset's FP primary hardware controlled
  * power sequence.
  */
-static inline void via_lvds_set_primary_hard_power(void __iomem *regs,
+static inline void via_lvds_set_primary_hard_power(struct via_vga_shadow *shadow,
 							bool power_state)
 {
 	/* 3X5.6A[3] - FP Primary Hardware Controlled Power Sequence
 	 *             0: Hardware Controlled Power Off
 	 *             1: Hardware Controlled Power On */
-	svga_wcrt_mask(regs, 0x6A,
+	svga_wcrt_mask(shadow, 0x6A,
 			power_state ? BIT(3) : 0x00, BIT(3));
 }
 
@@ -549,13 +681,13 @@ static inline void via_lvds_set_primary_hard_power(void __iomem *regs,
  * Sets CX700 / VX700 or later chipset's FP secondary
  * power sequence control type.
  */
-static inline void via_lvds_set_secondary_power_seq_type(void __iomem *regs,
+static inline void via_lvds_set_secondary_power_seq_type(struct via_vga_shadow *shadow,
 							bool ctrl_type)
 {
 	/* 3X5.D3[0] - FP Secondary Power Sequence Control Type
 	 *             0: Hardware Control
 	 *             1: Software Control */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			ctrl_type ? 0x00 : BIT(0), BIT(0));
 }
 
@@ -563,13 +695,13 @@ static inline void via_lvds_set_secondary_power_seq_type(void __iomem *regs,
  * Sets CX700 / VX700 or later chipset's FP secondary
  * software controlled back light.
  */
-static inline void via_lvds_set_secondary_soft_back_light(void __iomem *regs,
+static inline void via_lvds_set_secondary_soft_back_light(struct via_vga_shadow *shadow,
 								bool soft_on)
 {
 	/* 3X5.D3[1] - FP Secondary Software Back Light On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			soft_on ? BIT(1) : 0x00, BIT(1));
 }
 
@@ -577,13 +709,13 @@ static inline void via_lvds_set_secondary_soft_back_light(void __iomem *regs,
  * Sets CX700 / VX700 or later chipset's FP secondary software
  * controlled VEE.
  */
-static inline void via_lvds_set_secondary_soft_vee(void __iomem *regs,
+static inline void via_lvds_set_secondary_soft_vee(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.D3[2] - FP Secondary Software VEE On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			soft_on ? BIT(2) : 0x00, BIT(2));
 }
 
@@ -591,13 +723,13 @@ static inline void via_lvds_set_secondary_soft_vee(void __iomem *regs,
  * Sets CX700 / VX700 or later chipset's FP secondary software
  * controlled data.
  */
-static inline void via_lvds_set_secondary_soft_data(void __iomem *regs,
+static inline void via_lvds_set_secondary_soft_data(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.D3[3] - FP Secondary Software Data On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			soft_on ? BIT(3) : 0x00, BIT(3));
 }
 
@@ -605,13 +737,13 @@ static inline void via_lvds_set_secondary_soft_data(void __iomem *regs,
  * Sets CX700 / VX700 or later chipset's FP secondary software
  * controlled VDD.
  */
-static inline void via_lvds_set_secondary_soft_vdd(void __iomem *regs,
+static inline void via_lvds_set_secondary_soft_vdd(struct via_vga_shadow *shadow,
 							bool soft_on)
 {
 	/* 3X5.D3[4] - FP Secondary Software VDD On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			soft_on ? BIT(4) : 0x00, BIT(4));
 }
 
@@ -620,12 +752,12 @@ static inline void via_lvds_set_secondary_soft_vdd(void __iomem *regs,
  * light control.
  */
 static inline void via_lvds_set_secondary_direct_back_light_ctrl(
-					void __iomem *regs, bool direct_on)
+					struct via_vga_shadow *shadow, bool direct_on)
 {
 	/* 3X5.D3[6] - FP Secondary Direct Back Light Control
 	 *             0: On
 	 *             1: Off */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			direct_on ? 0x00 : BIT(6), BIT(6));
 }
 
@@ -634,25 +766,25 @@ static inline void via_lvds_set_secondary_direct_back_light_ctrl(
  * display period control.
  */
 static inline void via_lvds_set_secondary_direct_display_period(
-					void __iomem *regs, bool direct_on)
+					struct via_vga_shadow *shadow, bool direct_on)
 {
 	/* 3X5.D3[7] - FP Secondary Direct Display Period Control
 	 *             0: On
 	 *             1: Off */
-	svga_wcrt_mask(regs, 0xD3,
+	svga_wcrt_mask(shadow, 0xD3,
 			direct_on ? 0x00 : BIT(7), BIT(7));
 }
 
 /*
  * Sets FP secondary hardware controlled power sequence enable.
  */
-static inline void via_lvds_set_secondary_hard_power(void __iomem *regs,
+static inline void via_lvds_set_secondary_hard_power(struct via_vga_shadow *shadow,
 							bool power_state)
 {
 	/* 3X5.D4[1] - Secondary Power Hardware Power Sequence Enable
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0xD4,
+	svga_wcrt_mask(shadow, 0xD4,
 			power_state ? BIT(1) : 0x00, BIT(1));
 }
 
@@ -660,14 +792,14 @@ static inline void via_lvds_set_secondary_hard_power(void __iomem *regs,
  * Sets FPDP (Flat Panel Display Port) Low I/O pad state.
  */
 static inline void
-via_fpdp_low_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
+via_fpdp_low_set_io_pad_state(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.2A[1:0] - FPDP Low I/O Pad Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x2A,
+	svga_wseq_mask(shadow, 0x2A,
 			io_pad_state, BIT(1) | BIT(0));
 }
 
@@ -675,10 +807,10 @@ via_fpdp_low_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
  * Sets FPDP (Flat Panel Display Port) Low adjustment register.
  */
 static inline void
-via_fpdp_low_set_adjustment(void __iomem *regs, u8 adjustment)
+via_fpdp_low_set_adjustment(struct via_vga_shadow *shadow, u8 adjustment)
 {
 	/* 3X5.99[3:0] - FPDP Low Adjustment */
-	svga_wcrt_mask(regs, 0x99,
+	svga_wcrt_mask(shadow, 0x99,
 			adjustment, BIT(3) | BIT(2) | BIT(1) | BIT(0));
 }
 
@@ -686,12 +818,12 @@ via_fpdp_low_set_adjustment(void __iomem *regs, u8 adjustment)
  * Sets FPDP (Flat Panel Display Port) Low interface display source.
  */
 static inline void
-via_fpdp_low_set_display_source(void __iomem *regs, u8 display_source)
+via_fpdp_low_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/* 3X5.99[4] - FPDP Low Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x99,
+	svga_wcrt_mask(shadow, 0x99,
 			display_source << 4, BIT(4));
 }
 
@@ -699,14 +831,14 @@ via_fpdp_low_set_display_source(void __iomem *regs, u8 display_source)
  * Sets FPDP (Flat Panel Display Port) High I/O pad state.
  */
 static inline void
-via_fpdp_high_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
+via_fpdp_high_set_io_pad_state(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.2A[3:2] - FPDP High I/O Pad Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x2A,
+	svga_wseq_mask(shadow, 0x2A,
 			io_pad_state << 2, BIT(3) | BIT(2));
 }
 
@@ -714,10 +846,10 @@ via_fpdp_high_set_io_pad_state(void __iomem *regs, u8 io_pad_state)
  * Sets FPDP (Flat Panel Display Port) High adjustment register.
  */
 static inline void
-via_fpdp_high_set_adjustment(void __iomem *regs, u8 adjustment)
+via_fpdp_high_set_adjustment(struct via_vga_shadow *shadow, u8 adjustment)
 {
 	/* 3X5.97[3:0] - FPDP High Adjustment */
-	svga_wcrt_mask(regs, 0x97,
+	svga_wcrt_mask(shadow, 0x97,
 			adjustment, BIT(3) | BIT(2) | BIT(1) | BIT(0));
 }
 
@@ -725,12 +857,12 @@ via_fpdp_high_set_adjustment(void __iomem *regs, u8 adjustment)
  * Sets FPDP (Flat Panel Display Port) High interface display source.
  */
 static inline void
-via_fpdp_high_set_display_source(void __iomem *regs, u8 display_source)
+via_fpdp_high_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/* 3X5.97[4] - FPDP High Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x97,
+	svga_wcrt_mask(shadow, 0x97,
 			display_source << 4, BIT(4));
 }
 
@@ -738,12 +870,12 @@ via_fpdp_high_set_display_source(void __iomem *regs, u8 display_source)
  * Sets CX700 / VX700 or later chipset's LVDS1 power state.
  */
 static inline void
-via_lvds1_set_power(void __iomem *regs, bool power_state)
+via_lvds1_set_power(struct via_vga_shadow *shadow, bool power_state)
 {
 	/* 3X5.D2[7] - Power Down (Active High) for Channel 1 LVDS
 	 *             0: Power on
 	 *             1: Power off */
-	svga_wcrt_mask(regs, 0xD2,
+	svga_wcrt_mask(shadow, 0xD2,
 			power_state ? 0x00 : BIT(7), BIT(7));
 }
 
@@ -751,13 +883,13 @@ via_lvds1_set_power(void __iomem *regs, bool power_state)
  * Sets CX700 or later single chipset's LVDS1 power sequence type.
  */
 static inline void
-via_lvds1_set_power_seq(void __iomem *regs, bool softCtrl)
+via_lvds1_set_power_seq(struct via_vga_shadow *shadow, bool softCtrl)
 {
 	/* Set LVDS1 power sequence type. */
 	/* 3X5.91[0] - LVDS1 Hardware or Software Control Power Sequence
 	 *             0: Hardware Control
 	 *             1: Software Control */
-	svga_wcrt_mask(regs, 0x91, softCtrl ? BIT(0) : 0, BIT(0));
+	svga_wcrt_mask(shadow, 0x91, softCtrl ? BIT(0) : 0, BIT(0));
 }
 
 /*
@@ -765,26 +897,26 @@ via_lvds1_set_power_seq(void __iomem *regs, bool softCtrl)
  * data path state.
  */
 static inline void
-via_lvds1_set_soft_data(void __iomem *regs, bool softOn)
+via_lvds1_set_soft_data(struct via_vga_shadow *shadow, bool softOn)
 {
 	/* Set LVDS1 software controlled data path state. */
 	/* 3X5.91[3] - Software Data On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0x91, softOn ? BIT(3) : 0, BIT(3));
+	svga_wcrt_mask(shadow, 0x91, softOn ? BIT(3) : 0, BIT(3));
 }
 
 /*
  * Sets CX700 or later single chipset's LVDS1 software controlled Vdd.
  */
 static inline void
-via_lvds1_set_soft_vdd(void __iomem *regs, bool softOn)
+via_lvds1_set_soft_vdd(struct via_vga_shadow *shadow, bool softOn)
 {
 	/* Set LVDS1 software controlled Vdd. */
 	/* 3X5.91[4] - Software VDD On
 	 *             0: Off
 	 *             1: On */
-	svga_wcrt_mask(regs, 0x91, softOn ? BIT(4) : 0, BIT(4));
+	svga_wcrt_mask(shadow, 0x91, softOn ? BIT(4) : 0, BIT(4));
 }
 
 /*
@@ -792,28 +924,28 @@ via_lvds1_set_soft_vdd(void __iomem *regs, bool softOn)
  * display period.
  */
 static inline void
-via_lvds1_set_soft_display_period(void __iomem *regs, bool softOn)
+via_lvds1_set_soft_display_period(struct via_vga_shadow *shadow, bool softOn)
 {
 	/* Set LVDS1 software controlled display period state. */
 	/* 3X5.91[7] - Software Direct On / Off Display Period
 	 *             in the Panel Path
 	 *             0: On
 	 *             1: Off */
-	svga_wcrt_mask(regs, 0x91, softOn ? 0 : BIT(7), BIT(7));
+	svga_wcrt_mask(shadow, 0x91, softOn ? 0 : BIT(7), BIT(7));
 }
 
 /*
  * Sets LVDS1 I/O pad state.
  */
 static inline void
-via_lvds1_set_io_pad_setting(void __iomem *regs, u8 io_pad_state)
+via_lvds1_set_io_pad_setting(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.2A[1:0] - LVDS1 I/O Pad Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x2A,
+	svga_wseq_mask(shadow, 0x2A,
 			io_pad_state, BIT(1) | BIT(0));
 }
 
@@ -821,12 +953,12 @@ via_lvds1_set_io_pad_setting(void __iomem *regs, u8 io_pad_state)
  * Sets LVDS1 format.
  */
 static inline void
-via_lvds1_set_format(void __iomem *regs, u8 format)
+via_lvds1_set_format(struct via_vga_shadow *shadow, u8 format)
 {
 	/* 3X5.D2[1] - LVDS Channel 1 Format Selection
 	 *             0: SPWG Mode
 	 *             1: OPENLDI Mode */
-	svga_wcrt_mask(regs, 0xd2,
+	svga_wcrt_mask(shadow, 0xd2,
 			format << 1, BIT(1));
 }
 
@@ -834,12 +966,12 @@ via_lvds1_set_format(void __iomem *regs, u8 format)
  * Sets LVDS1 output format (rotation or sequential mode).
  */
 static inline void
-via_lvds1_set_output_format(void __iomem *regs, u8 output_format)
+via_lvds1_set_output_format(struct via_vga_shadow *shadow, u8 output_format)
 {
 	/* 3X5.88[6] - LVDS Channel 1 Output Format
 	 *             0: Rotation
 	 *             1: Sequential */
-	svga_wcrt_mask(regs, 0x88,
+	svga_wcrt_mask(shadow, 0x88,
 			output_format << 6, BIT(6));
 }
 
@@ -848,12 +980,12 @@ via_lvds1_set_output_format(void __iomem *regs, u8 output_format)
  * 24-bit color display).
  */
 static inline void
-via_lvds1_set_dithering(void __iomem *regs, bool dithering)
+via_lvds1_set_dithering(struct via_vga_shadow *shadow, bool dithering)
 {
 	/* 3X5.88[0] - LVDS Channel 1 Output Bits
 	 *             0: 24 bits (dithering off)
 	 *             1: 18 bits (dithering on) */
-	svga_wcrt_mask(regs, 0x88,
+	svga_wcrt_mask(shadow, 0x88,
 			dithering ? BIT(0) : 0x00, BIT(0));
 }
 
@@ -861,12 +993,12 @@ via_lvds1_set_dithering(void __iomem *regs, bool dithering)
  * Sets LVDS1 display source.
  */
 static inline void
-via_lvds1_set_display_source(void __iomem *regs, u8 display_source)
+via_lvds1_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/* 3X5.99[4] - LVDS Channel 1 Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x99,
+	svga_wcrt_mask(shadow, 0x99,
 			display_source << 4, BIT(4));
 }
 
@@ -874,12 +1006,12 @@ via_lvds1_set_display_source(void __iomem *regs, u8 display_source)
  * Sets CX700 / VX700 and VX800 chipset's LVDS2 power state.
  */
 static inline void
-via_lvds2_set_power(void __iomem *regs, bool power_state)
+via_lvds2_set_power(struct via_vga_shadow *shadow, bool power_state)
 {
 	/* 3X5.D2[6] - Power Down (Active High) for Channel 2 LVDS
 	 *             0: Power on
 	 *             1: Power off */
-	svga_wcrt_mask(regs, 0xD2,
+	svga_wcrt_mask(shadow, 0xD2,
 			power_state ? 0x00 : BIT(6), BIT(6));
 }
 
@@ -887,14 +1019,14 @@ via_lvds2_set_power(void __iomem *regs, bool power_state)
  * Sets LVDS2 I/O pad state.
  */
 static inline void
-via_lvds2_set_io_pad_setting(void __iomem *regs, u8 io_pad_state)
+via_lvds2_set_io_pad_setting(struct via_vga_shadow *shadow, u8 io_pad_state)
 {
 	/* 3C5.2A[3:2] - LVDS2 I/O Pad Control
 	 *               0x: Pad always off
 	 *               10: Depend on the other control signal
 	 *               11: Pad on/off according to the
 	 *                   Power Management Status (PMS) */
-	svga_wseq_mask(regs, 0x2A,
+	svga_wseq_mask(shadow, 0x2A,
 			io_pad_state << 2, BIT(3) | BIT(2));
 }
 
@@ -902,24 +1034,24 @@ via_lvds2_set_io_pad_setting(void __iomem *regs, u8 io_pad_state)
  * Sets LVDS2 format.
  */
 static inline void
-via_lvds2_set_format(void __iomem *regs, u8 format)
+via_lvds2_set_format(struct via_vga_shadow *shadow, u8 format)
 {
 	/* 3X5.D2[0] - LVDS Channel 2 Format Selection
 	 *             0: SPWG Mode
 	 *             1: OPENLDI Mode */
-	svga_wcrt_mask(regs, 0xd2, format, BIT(0));
+	svga_wcrt_mask(shadow, 0xd2, format, BIT(0));
 }
 
 /*
  * Sets LVDS2 output format (rotation or sequential mode).
  */
 static inline void
-via_lvds2_set_output_format(void __iomem *regs, u8 output_format)
+via_lvds2_set_output_format(struct via_vga_shadow *shadow, u8 output_format)
 {
 	/* 3X5.D4[7] - LVDS Channel 2 Output Format
 	 *             0: Rotation
 	 *             1: Sequential */
-	svga_wcrt_mask(regs, 0xd4, output_format << 7, BIT(7));
+	svga_wcrt_mask(shadow, 0xd4, output_format << 7, BIT(7));
 }
 
 /*
@@ -927,12 +1059,12 @@ via_lvds2_set_output_format(void __iomem *regs, u8 output_format)
  * 24-bit color display).
  */
 static inline void
-via_lvds2_set_dithering(void __iomem *regs, bool dithering)
+via_lvds2_set_dithering(struct via_vga_shadow *shadow, bool dithering)
 {
 	/* 3X5.D4[6] - LVDS Channel 2 Output Bits
 	 *             0: 24 bits (dithering off)
 	 *             1: 18 bits (dithering on) */
-	svga_wcrt_mask(regs, 0xd4,
+	svga_wcrt_mask(shadow, 0xd4,
 			dithering ? BIT(6) : 0x00, BIT(6));
 }
 
@@ -940,12 +1072,12 @@ via_lvds2_set_dithering(void __iomem *regs, bool dithering)
  * Sets LVDS2 display source.
  */
 static inline void
-via_lvds2_set_display_source(void __iomem *regs, u8 display_source)
+via_lvds2_set_display_source(struct via_vga_shadow *shadow, u8 display_source)
 {
 	/* 3X5.97[4] - LVDS Channel 2 Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x97,
+	svga_wcrt_mask(shadow, 0x97,
 			display_source << 4, BIT(4));
 }
 
@@ -953,12 +1085,12 @@ via_lvds2_set_display_source(void __iomem *regs, u8 display_source)
  * Sets CX700 / VX700 and VX800 chipsets' TMDS (DVI) power state.
  */
 static inline void
-via_tmds_set_power(void __iomem *regs, bool powerState)
+via_tmds_set_power(struct via_vga_shadow *shadow, bool powerState)
 {
 	/* 3X5.D2[3] - Power Down (Active High) for DVI
 	 *             0: TMDS power on
 	 *             1: TMDS power down */
-	svga_wcrt_mask(regs, 0xD2,
+	svga_wcrt_mask(shadow, 0xD2,
 			powerState ? 0x00 : BIT(3), BIT(3));
 }
 
@@ -966,7 +1098,7 @@ via_tmds_set_power(void __iomem *regs, bool powerState)
  * Sets CX700 / VX700 and VX800 chipsets' TMDS (DVI) sync polarity.
  */
 static inline void
-via_tmds_set_sync_polarity(void __iomem *regs, u8 syncPolarity)
+via_tmds_set_sync_polarity(struct via_vga_shadow *shadow, u8 syncPolarity)
 {
 	/* Set TMDS (DVI) sync polarity. */
 	/* 3X5.97[6] - DVI (TMDS) VSYNC Polarity
@@ -975,7 +1107,7 @@ via_tmds_set_sync_polarity(void __iomem *regs, u8 syncPolarity)
 	 * 3X5.97[5] - DVI (TMDS) HSYNC Polarity
 	 *              0: Positive
 	 *              1: Negative */
-	svga_wcrt_mask(regs, 0x97,
+	svga_wcrt_mask(shadow, 0x97,
 			syncPolarity << 5, BIT(6) | BIT(5));
 }
 
@@ -983,20 +1115,28 @@ via_tmds_set_sync_polarity(void __iomem *regs, u8 syncPolarity)
  * Sets TMDS (DVI) display source.
  */
 static inline void
-via_tmds_set_display_source(void __iomem *regs, u8 displaySource)
+via_tmds_set_display_source(struct via_vga_shadow *shadow, u8 displaySource)
 {
 	/* The integrated TMDS transmitter appears to utilize LVDS1's
 	 * data source selection bit (3X5.99[4]). */
 	/* 3X5.99[4] - LVDS Channel1 Data Source Selection
 	 *             0: Primary Display
 	 *             1: Secondary Display */
-	svga_wcrt_mask(regs, 0x99,
+	svga_wcrt_mask(shadow, 0x99,
 			displaySource << 4, BIT(4));
 }
 
 
-void load_register_tables(void __iomem *regbase, struct vga_registers *regs);
-void load_value_to_registers(void __iomem *regbase, struct vga_registers *regs,
-					unsigned int value);
+void load_register_tables(struct via_vga_shadow *shadow,
+				struct vga_registers *regs);
+void load_value_to_registers(struct via_vga_shadow *shadow,
+				struct vga_registers *regs,
+				unsigned int value);
+int via_reg_program_compile(struct via_reg_program *prog,
+				struct vga_registers **fields,
+				unsigned int num_fields);
+void via_reg_program_load(struct via_vga_shadow *shadow,
+				const struct via_reg_program *prog,
+				const u32 *values);
 
 #endif /* __CRTC_HW_H__ */
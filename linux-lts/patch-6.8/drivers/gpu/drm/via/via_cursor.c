@@ -28,6 +28,8 @@
  * James Simmons <jsimmons@infradead.org>
  */
 
+#include <linux/dma-resv.h>
+#include <linux/iosys-map.h>
 #include <linux/pci.h>
 #include <linux/pci_ids.h>
 
@@ -35,6 +37,7 @@
 #include <drm/drm_atomic_helper.h>
 #include <drm/drm_atomic_state_helper.h>
 #include <drm/drm_crtc.h>
+#include <drm/drm_damage_helper.h>
 #include <drm/drm_fourcc.h>
 #include <drm/drm_framebuffer.h>
 #include <drm/drm_gem.h>
@@ -47,14 +50,37 @@
 #include "via_drv.h"
 
 
+/* Bytes of ARGB8888 image data the Hardware Icon (HI) fetches */
+#define VIA_CURSOR_IMAGE_SIZE	(VIA_CURSOR_SIZE * VIA_CURSOR_SIZE * 4)
+
+/*
+ * The cursor image is copied into the small object VRAM slab, so
+ * the client's buffer does not have to stay pinned in VRAM. sa is
+ * NULL when the slab was full and the buffer got pinned instead.
+ */
+struct via_cursor_state {
+	struct drm_plane_state base;
+	struct via_suballoc *sa;
+};
+
+#define to_via_cursor_state(x) \
+		container_of(x, struct via_cursor_state, base)
+
+/*
+ * Cursor registers are staged in the CRTC's register queue, and
+ * reach the hardware at atomic_flush time.
+ */
+static inline void via_cursor_write(struct via_crtc *iga, u32 reg, u32 data)
+{
+	via_reg_queue_mmio(iga, reg, data, 0xFFFFFFFF);
+}
+
 static void via_hide_cursor(struct drm_crtc *crtc)
 {
 	struct drm_device *dev = crtc->dev;
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_crtc *iga = container_of(crtc,
 					struct via_crtc, base);
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
-	uint32_t temp;
 
 	switch (pdev->device) {
 	case PCI_DEVICE_ID_VIA_UNICHROME_PRO_II:
@@ -64,17 +90,16 @@ static void via_hide_cursor(struct drm_crtc *crtc)
 	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
 	case PCI_DEVICE_ID_VIA_CHROME9_HD:
 		if (iga->index) {
-			temp = VIA_READ(HI_CONTROL);
-			VIA_WRITE(HI_CONTROL, temp & 0xFFFFFFFA);
+			via_reg_queue_mmio(iga, HI_CONTROL, 0x00000000,
+						0x00000005);
 		} else {
-			temp = VIA_READ(PRIM_HI_CTRL);
-			VIA_WRITE(PRIM_HI_CTRL, temp & 0xFFFFFFFA);
+			via_reg_queue_mmio(iga, PRIM_HI_CTRL, 0x00000000,
+						0x00000005);
 		}
 
 		break;
 	default:
-		temp = VIA_READ(HI_CONTROL);
-		VIA_WRITE(HI_CONTROL, temp & 0xFFFFFFFA);
+		via_reg_queue_mmio(iga, HI_CONTROL, 0x00000000, 0x00000005);
 		break;
 	}
 }
@@ -85,7 +110,6 @@ static void via_show_cursor(struct drm_crtc *crtc)
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_crtc *iga = container_of(crtc,
 					struct via_crtc, base);
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 
 	switch (pdev->device) {
 	case PCI_DEVICE_ID_VIA_UNICHROME_PRO_II:
@@ -99,16 +123,16 @@ static void via_show_cursor(struct drm_crtc *crtc)
 		 * and background color.
 		 */
 		if (iga->index) {
-			VIA_WRITE(HI_TRANSPARENT_COLOR, 0x00000000);
-			VIA_WRITE(HI_INVTCOLOR, 0x00FFFFFF);
-			VIA_WRITE(ALPHA_V3_PREFIFO_CONTROL,
+			via_cursor_write(iga, HI_TRANSPARENT_COLOR, 0x00000000);
+			via_cursor_write(iga, HI_INVTCOLOR, 0x00FFFFFF);
+			via_cursor_write(iga, ALPHA_V3_PREFIFO_CONTROL,
 							0x000E0000);
-			VIA_WRITE(ALPHA_V3_FIFO_CONTROL, 0x0E0F0000);
+			via_cursor_write(iga, ALPHA_V3_FIFO_CONTROL, 0x0E0F0000);
 		} else {
-			VIA_WRITE(PRIM_HI_TRANSCOLOR, 0x00000000);
-			VIA_WRITE(PRIM_HI_INVTCOLOR, 0x00FFFFFF);
-			VIA_WRITE(V327_HI_INVTCOLOR, 0x00FFFFFF);
-			VIA_WRITE(PRIM_HI_FIFO, 0x0D000D0F);
+			via_cursor_write(iga, PRIM_HI_TRANSCOLOR, 0x00000000);
+			via_cursor_write(iga, PRIM_HI_INVTCOLOR, 0x00FFFFFF);
+			via_cursor_write(iga, V327_HI_INVTCOLOR, 0x00FFFFFF);
+			via_cursor_write(iga, PRIM_HI_FIFO, 0x0D000D0F);
 		}
 
 		break;
@@ -117,10 +141,10 @@ static void via_show_cursor(struct drm_crtc *crtc)
 		 * Program Hardware Icon (HI) FIFO, foreground color,
 		 * and background color.
 		 */
-		VIA_WRITE(HI_TRANSPARENT_COLOR, 0x00000000);
-		VIA_WRITE(HI_INVTCOLOR, 0x00FFFFFF);
-		VIA_WRITE(ALPHA_V3_PREFIFO_CONTROL, 0x000E0000);
-		VIA_WRITE(ALPHA_V3_FIFO_CONTROL, 0xE0F0000);
+		via_cursor_write(iga, HI_TRANSPARENT_COLOR, 0x00000000);
+		via_cursor_write(iga, HI_INVTCOLOR, 0x00FFFFFF);
+		via_cursor_write(iga, ALPHA_V3_PREFIFO_CONTROL, 0x000E0000);
+		via_cursor_write(iga, ALPHA_V3_FIFO_CONTROL, 0xE0F0000);
 		break;
 	}
 
@@ -135,9 +159,9 @@ static void via_show_cursor(struct drm_crtc *crtc)
 		 * Turn on Hardware Icon (HI).
 		 */
 		if (iga->index) {
-			VIA_WRITE(HI_CONTROL, 0xB6000005);
+			via_cursor_write(iga, HI_CONTROL, 0xB6000005);
 		} else {
-			VIA_WRITE(PRIM_HI_CTRL, 0x36000005);
+			via_cursor_write(iga, PRIM_HI_CTRL, 0x36000005);
 		}
 
 		break;
@@ -146,23 +170,21 @@ static void via_show_cursor(struct drm_crtc *crtc)
 		 * Turn on Hardware Icon (HI).
 		 */
 		if (iga->index) {
-			VIA_WRITE(HI_CONTROL, 0xB6000005);
+			via_cursor_write(iga, HI_CONTROL, 0xB6000005);
 		} else {
-			VIA_WRITE(HI_CONTROL, 0x36000005);
+			via_cursor_write(iga, HI_CONTROL, 0x36000005);
 		}
 
 		break;
 	}
 }
 
-static void via_cursor_address(struct drm_crtc *crtc,
-				struct ttm_buffer_object *ttm_bo)
+static void via_cursor_address(struct drm_crtc *crtc, u32 offset)
 {
 	struct drm_device *dev = crtc->dev;
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_crtc *iga = container_of(crtc,
 					struct via_crtc, base);
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 
 	switch (pdev->device) {
 	case PCI_DEVICE_ID_VIA_UNICHROME_PRO_II:
@@ -175,18 +197,16 @@ static void via_cursor_address(struct drm_crtc *crtc,
 		 * Program Hardware Icon (HI) offset.
 		 */
 		if (iga->index) {
-			VIA_WRITE(HI_FBOFFSET,
-				ttm_bo->resource->start << PAGE_SHIFT);
+			via_cursor_write(iga, HI_FBOFFSET, offset);
 		} else {
-			VIA_WRITE(PRIM_HI_FBOFFSET,
-				ttm_bo->resource->start << PAGE_SHIFT);
+			via_cursor_write(iga, PRIM_HI_FBOFFSET, offset);
 		}
 		break;
 	default:
 		/*
 		 * Program Hardware Icon (HI) offset.
 		 */
-		VIA_WRITE(HI_FBOFFSET, ttm_bo->resource->start << PAGE_SHIFT);
+		via_cursor_write(iga, HI_FBOFFSET, offset);
 		break;
 	}
 
@@ -199,7 +219,6 @@ static void via_set_hi_location(struct drm_crtc *crtc, int crtc_x, int crtc_y)
 	struct pci_dev *pdev = to_pci_dev(dev->dev);
 	struct via_crtc *iga = container_of(crtc,
 					struct via_crtc, base);
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 	uint32_t location_x = 0, location_y = 0;
 	uint32_t offset_x = 0, offset_y = 0;
 
@@ -223,38 +242,126 @@ static void via_set_hi_location(struct drm_crtc *crtc, int crtc_x, int crtc_y)
 	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
 	case PCI_DEVICE_ID_VIA_CHROME9_HD:
 		if (iga->index) {
-			VIA_WRITE(HI_POSSTART,
+			via_cursor_write(iga, HI_POSSTART,
 				(((location_x & 0x07ff) << 16) |
 				(location_y & 0x07ff)));
-			VIA_WRITE(HI_CENTEROFFSET,
+			via_cursor_write(iga, HI_CENTEROFFSET,
 				(((offset_x & 0x07ff) << 16) |
 				(offset_y & 0x07ff)));
 		} else {
-			VIA_WRITE(PRIM_HI_POSSTART,
+			via_cursor_write(iga, PRIM_HI_POSSTART,
 				(((location_x & 0x07ff) << 16) |
 				(location_y & 0x07ff)));
-			VIA_WRITE(PRIM_HI_CENTEROFFSET,
+			via_cursor_write(iga, PRIM_HI_CENTEROFFSET,
 				(((offset_x & 0x07ff) << 16) |
 				(offset_y & 0x07ff)));
 		}
 
 		break;
 	default:
-		VIA_WRITE(HI_POSSTART,
+		via_cursor_write(iga, HI_POSSTART,
 				(((location_x & 0x07ff) << 16) |
 				(location_y & 0x07ff)));
-		VIA_WRITE(HI_CENTEROFFSET,
+		via_cursor_write(iga, HI_CENTEROFFSET,
 				(((offset_x & 0x07ff) << 16) |
 				(offset_y & 0x07ff)));
 		break;
 	}
 }
 
+/*
+ * VRAM offset the Hardware Icon (HI) fetches the cursor image of a
+ * prepared plane state from.
+ */
+static u32 via_cursor_state_offset(struct drm_plane_state *state)
+{
+	struct via_cursor_state *cursor_state = to_via_cursor_state(state);
+	struct ttm_buffer_object *ttm_bo;
+
+	if (cursor_state->sa) {
+		return via_suballoc_offset(cursor_state->sa);
+	}
+
+	ttm_bo = container_of(state->fb->obj[0],
+				struct ttm_buffer_object, base);
+	return ttm_bo->resource->start << PAGE_SHIFT;
+}
+
+/*
+ * Copy the cursor image of the framebuffer into a slab allocation.
+ * The source may be in VRAM or in system memory.
+ */
+static int via_cursor_copy(struct ttm_buffer_object *ttm_bo,
+				struct via_suballoc *sa)
+{
+	void __iomem *dst = via_suballoc_cpu_addr(sa);
+	struct iosys_map map;
+	size_t size, i;
+	int ret;
+
+	ret = ttm_bo_reserve(ttm_bo, true, false, NULL);
+	if (ret) {
+		return ret;
+	}
+
+	/* Let a pending clear or move of the buffer finish first. */
+	if (dma_resv_wait_timeout(ttm_bo->base.resv, DMA_RESV_USAGE_WRITE,
+					true, MAX_SCHEDULE_TIMEOUT) < 0) {
+		ret = -ERESTARTSYS;
+		goto exit;
+	}
+
+	ret = ttm_bo_vmap(ttm_bo, &map);
+	if (ret) {
+		goto exit;
+	}
+
+	size = min_t(size_t, ttm_bo->base.size, VIA_CURSOR_IMAGE_SIZE);
+	for (i = 0; i < size; i += 4) {
+		iowrite32(iosys_map_rd(&map, i, u32), dst + i);
+	}
+
+	memset_io(dst + size, 0, VIA_CURSOR_IMAGE_SIZE - size);
+	ttm_bo_vunmap(ttm_bo, &map);
+exit:
+	ttm_bo_unreserve(ttm_bo);
+	return ret;
+}
+
+/*
+ * Whether the image already copied for the old state can be kept.
+ * Legacy cursor moves resubmit the framebuffer in use, while a new
+ * image comes in a new framebuffer. Atomic commits may have drawn
+ * into the same framebuffer; they keep the copy only when their
+ * damage clips say nothing changed, as no clips means everything.
+ */
+static bool via_cursor_image_unchanged(struct drm_plane_state *old_state,
+					struct drm_plane_state *new_state)
+{
+	struct drm_rect damage;
+
+	if ((!old_state) || (old_state->fb != new_state->fb) ||
+		(!to_via_cursor_state(old_state)->sa)) {
+		return false;
+	}
+
+	if (new_state->state->legacy_cursor_update) {
+		return true;
+	}
+
+	return !drm_atomic_helper_damage_merged(old_state, new_state,
+						&damage);
+}
+
 static int via_cursor_prepare_fb(struct drm_plane *plane,
 					struct drm_plane_state *new_state)
 {
+	struct via_cursor_state *cursor_state =
+					to_via_cursor_state(new_state);
+	struct drm_plane_state *old_state = plane->state;
 	struct drm_gem_object *gem;
 	struct ttm_buffer_object *ttm_bo;
+	struct via_suballoc *sa;
 	struct via_bo *bo;
 	int ret = 0;
 
@@ -266,6 +373,27 @@ static int via_cursor_prepare_fb(struct drm_plane *plane,
 	ttm_bo = container_of(gem, struct ttm_buffer_object, base);
 	bo = to_ttm_bo(ttm_bo);
 
+	if (via_cursor_image_unchanged(old_state, new_state)) {
+		cursor_state->sa =
+			via_suballoc_get(to_via_cursor_state(old_state)->sa);
+		goto exit;
+	}
+
+	sa = via_suballoc_new(plane->dev, VIA_CURSOR_IMAGE_SIZE, PAGE_SIZE);
+	if (!IS_ERR(sa)) {
+		ret = via_cursor_copy(ttm_bo, sa);
+		if (!ret) {
+			cursor_state->sa = sa;
+			goto exit;
+		}
+
+		via_suballoc_put(sa);
+	}
+
+	/*
+	 * Slab is full. Have the hardware fetch the image from the
+	 * framebuffer itself.
+	 */
 	ret = ttm_bo_reserve(ttm_bo, true, false, NULL);
 	if (ret) {
 		goto exit;
@@ -273,6 +401,10 @@ static int via_cursor_prepare_fb(struct drm_plane *plane,
 
 	ret = via_bo_pin(bo, TTM_PL_VRAM);
 	ttm_bo_unreserve(ttm_bo);
+	if (ret) {
+		goto exit;
+	}
+
 	ret = ttm_bo_kmap(ttm_bo, 0, PFN_UP(ttm_bo->resource->size), &bo->kmap);
 	if (ret) {
 		goto exit;
@@ -285,6 +417,8 @@ exit:
 static void via_cursor_cleanup_fb(struct drm_plane *plane,
 					struct drm_plane_state *old_state)
 {
+	struct via_cursor_state *cursor_state =
+					to_via_cursor_state(old_state);
 	struct drm_gem_object *gem;
 	struct ttm_buffer_object *ttm_bo;
 	struct via_bo *bo;
@@ -294,6 +428,12 @@ static void via_cursor_cleanup_fb(struct drm_plane *plane,
 		goto exit;
 	}
 
+	if (cursor_state->sa) {
+		via_suballoc_put(cursor_state->sa);
+		cursor_state->sa = NULL;
+		goto exit;
+	}
+
 	gem = old_state->fb->obj[0];
 	ttm_bo = container_of(gem, struct ttm_buffer_object, base);
 	bo = to_ttm_bo(ttm_bo);
@@ -352,13 +492,11 @@ static void via_cursor_atomic_update(struct drm_plane *plane,
 	struct drm_plane_state *old_state =
 			drm_atomic_get_old_plane_state(state, plane);
 	struct drm_crtc *crtc = new_state->crtc;
-	struct drm_gem_object *gem;
-	struct ttm_buffer_object *ttm_bo;
+	u32 offset = via_cursor_state_offset(new_state);
 
-	if (new_state->fb != old_state->fb) {
-		gem = new_state->fb->obj[0];
-		ttm_bo = container_of(gem, struct ttm_buffer_object, base);
-		via_cursor_address(crtc, ttm_bo);
+	if ((!old_state->fb) ||
+		(offset != via_cursor_state_offset(old_state))) {
+		via_cursor_address(crtc, offset);
 	}
 
 	via_set_hi_location(crtc, new_state->crtc_x, new_state->crtc_y);
@@ -380,9 +518,9 @@ static void via_cursor_atomic_enable(struct drm_plane *plane,
 static void via_cursor_atomic_disable(struct drm_plane *plane,
 					struct drm_atomic_state *state)
 {
-	struct drm_plane_state *new_state =
-			drm_atomic_get_new_plane_state(state, plane);
-	struct drm_crtc *crtc = new_state->crtc;
+	struct drm_plane_state *old_state =
+			drm_atomic_get_old_plane_state(state, plane);
+	struct drm_crtc *crtc = old_state->crtc;
 
 	if (crtc) {
 		via_hide_cursor(crtc);
@@ -398,13 +536,68 @@ const struct drm_plane_helper_funcs via_cursor_drm_plane_helper_funcs = {
 	.atomic_disable	= via_cursor_atomic_disable,
 };
 
+static void via_cursor_atomic_destroy_state(struct drm_plane *plane,
+					struct drm_plane_state *state);
+
+static void via_cursor_reset(struct drm_plane *plane)
+{
+	struct via_cursor_state *cursor_state;
+
+	if (plane->state) {
+		via_cursor_atomic_destroy_state(plane, plane->state);
+		plane->state = NULL;
+	}
+
+	cursor_state = kzalloc(sizeof(*cursor_state), GFP_KERNEL);
+	if (cursor_state) {
+		__drm_atomic_helper_plane_reset(plane, &cursor_state->base);
+	}
+}
+
+static struct drm_plane_state *
+via_cursor_atomic_duplicate_state(struct drm_plane *plane)
+{
+	struct via_cursor_state *cursor_state;
+
+	if (!plane->state) {
+		return NULL;
+	}
+
+	cursor_state = kzalloc(sizeof(*cursor_state), GFP_KERNEL);
+	if (!cursor_state) {
+		return NULL;
+	}
+
+	__drm_atomic_helper_plane_duplicate_state(plane,
+						&cursor_state->base);
+	return &cursor_state->base;
+}
+
+/*
+ * cleanup_fb() normally hands the image back to the slab already,
+ * but a state can be destroyed without it, i.e. the current state on
+ * reset.
+ */
+static void via_cursor_atomic_destroy_state(struct drm_plane *plane,
+					struct drm_plane_state *state)
+{
+	struct via_cursor_state *cursor_state = to_via_cursor_state(state);
+
+	if (cursor_state->sa) {
+		via_suballoc_put(cursor_state->sa);
+	}
+
+	__drm_atomic_helper_plane_destroy_state(state);
+	kfree(cursor_state);
+}
+
 const struct drm_plane_funcs via_cursor_drm_plane_funcs = {
 	.update_plane = drm_atomic_helper_update_plane,
 	.disable_plane = drm_atomic_helper_disable_plane,
 	.destroy = drm_plane_cleanup,
-	.reset = drm_atomic_helper_plane_reset,
-	.atomic_duplicate_state = drm_atomic_helper_plane_duplicate_state,
-	.atomic_destroy_state = drm_atomic_helper_plane_destroy_state,
+	.reset = via_cursor_reset,
+	.atomic_duplicate_state = via_cursor_atomic_duplicate_state,
+	.atomic_destroy_state = via_cursor_atomic_destroy_state,
 };
 
 const uint32_t via_cursor_formats[] = {
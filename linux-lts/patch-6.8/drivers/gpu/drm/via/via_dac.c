@@ -58,7 +58,7 @@ static void via_dac_sync_polarity(struct via_drm_priv *dev_priv,
 		syncPolarity |= BIT(1);
 	}
 
-	via_dac_set_sync_polarity(VGABASE, syncPolarity);
+	via_dac_set_sync_polarity(VGASHADOW, syncPolarity);
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
@@ -82,20 +82,20 @@ static void via_dac_dpms(struct drm_encoder *encoder, int mode)
 
 	switch (mode) {
 	case DRM_MODE_DPMS_ON:
-		via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_ON);
-		via_dac_set_power(VGABASE, true);
+		via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_ON);
+		via_dac_set_power(VGASHADOW, true);
 		break;
 	case DRM_MODE_DPMS_STANDBY:
-		via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_STANDBY);
-		via_dac_set_power(VGABASE, true);
+		via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_STANDBY);
+		via_dac_set_power(VGASHADOW, true);
 		break;
 	case DRM_MODE_DPMS_SUSPEND:
-		via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_SUSPEND);
-		via_dac_set_power(VGABASE, true);
+		via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_SUSPEND);
+		via_dac_set_power(VGASHADOW, true);
 		break;
 	case DRM_MODE_DPMS_OFF:
-		via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_OFF);
-		via_dac_set_power(VGABASE, false);
+		via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_OFF);
+		via_dac_set_power(VGASHADOW, false);
 		break;
 	default:
 		drm_err(dev, "Bad DPMS mode.");
@@ -131,7 +131,7 @@ static void via_dac_mode_set(struct drm_encoder *encoder,
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	via_dac_sync_polarity(dev_priv, adjusted_mode->flags);
-	via_dac_set_display_source(VGABASE, iga->index);
+	via_dac_set_display_source(VGASHADOW, iga->index);
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
@@ -144,8 +144,8 @@ static void via_dac_prepare(struct drm_encoder *encoder)
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	if (encoder->crtc) {
-		via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_OFF);
-		via_dac_set_power(VGABASE, false);
+		via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_OFF);
+		via_dac_set_power(VGASHADOW, false);
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -159,8 +159,8 @@ static void via_dac_commit(struct drm_encoder *encoder)
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	if (encoder->crtc) {
-		via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_ON);
-		via_dac_set_power(VGABASE, true);
+		via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_ON);
+		via_dac_set_power(VGASHADOW, true);
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -173,8 +173,8 @@ static void via_dac_disable(struct drm_encoder *encoder)
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
-	via_dac_set_dpms_control(VGABASE, VIA_DAC_DPMS_OFF);
-	via_dac_set_power(VGABASE, false);
+	via_dac_set_dpms_control(VGASHADOW, VIA_DAC_DPMS_OFF);
+	via_dac_set_power(VGASHADOW, false);
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
@@ -207,7 +207,7 @@ via_dac_detect(struct drm_connector *connector, bool force)
 	}
 
 	if (i2c_bus) {
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (!(edid->input & DRM_EDID_INPUT_DIGITAL)) {
 				ret = connector_status_connected;
@@ -225,7 +225,7 @@ via_dac_detect(struct drm_connector *connector, bool force)
 	}
 
 	if (i2c_bus) {
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (!(edid->input & DRM_EDID_INPUT_DIGITAL)) {
 				ret = connector_status_connected;
@@ -341,7 +341,7 @@ static int via_dac_get_modes(struct drm_connector *connector)
 	}
 
 	if (i2c_bus) {
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (!(edid->input & DRM_EDID_INPUT_DIGITAL)) {
 				drm_connector_update_edid_property(connector,
@@ -361,7 +361,7 @@ static int via_dac_get_modes(struct drm_connector *connector)
 	}
 
 	if (i2c_bus) {
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (!(edid->input & DRM_EDID_INPUT_DIGITAL)) {
 				drm_connector_update_edid_property(connector,
@@ -404,7 +404,7 @@ void via_dac_probe(struct drm_device *dev)
 		/* Setting SR5A[0] to 1.
 		 * This allows the reading out the alternative
 		 * pin strapping information from SR12 and SR13. */
-		svga_wseq_mask(VGABASE, 0x5a, BIT(0), BIT(0));
+		svga_wseq_mask(VGASHADOW, 0x5a, BIT(0), BIT(0));
 		drm_dbg_kms(dev, "SR5A: 0x%02x\n", sr5a);
 
 		sr13 = vga_rseq(VGABASE, 0x13);
@@ -418,7 +418,7 @@ void via_dac_probe(struct drm_device *dev)
 		}
 
 		/* Restore SR5A. */
-		vga_wseq(VGABASE, 0x5a, sr5a);
+		via_vga_wseq(VGASHADOW, 0x5a, sr5a);
 		break;
 	default:
 		dev_priv->dac_presence = true;
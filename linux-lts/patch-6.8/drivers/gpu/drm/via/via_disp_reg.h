@@ -31,109 +31,6 @@
 #define IGA1_FIFO_DEPTH_SELECT_FORMULA(x)		((x >> 1) - 1)
 #define IGA2_FIFO_DEPTH_SELECT_FORMULA(x)		((x >> 3) - 1)
 
-/* Define Display OFFSET */
-/* VT3314 chipset */
-#define CN700_IGA1_FIFO_MAX_DEPTH		96	/* location: {SR17,0,7}*/
-#define CN700_IGA1_FIFO_THRESHOLD		80	/* location: {SR16,0,5},{SR16,7,7}*/
-#define CN700_IGA1_FIFO_HIGH_THRESHOLD		64	/* location: {SR18,0,5},{SR18,7,7}*/
-#define CN700_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {SR22,0,4}. (128/4) =64,
-							 * P800 must be set zero, because HW
-							 * only 5 bits */
-#define CN700_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
-#define CN700_IGA2_FIFO_THRESHOLD		80	/* location: {CR68,0,3},{CR95,4,6}*/
-#define CN700_IGA2_FIFO_HIGH_THRESHOLD		32	/* location: {CR92,0,3},{CR95,0,2}*/
-#define CN700_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {CR94,0,6}*/
-
-/* For VT3324, these values are suggested by HW */
-#define CX700_IGA1_FIFO_MAX_DEPTH		192	/* location: {SR17,0,7}*/
-#define CX700_IGA1_FIFO_THRESHOLD		128	/* location: {SR16,0,5},{SR16,7,7}*/
-#define CX700_IGA1_FIFO_HIGH_THRESHOLD		128	/* location: {SR18,0,5},{SR18,7,7} */
-#define CX700_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	124	/* location: {SR22,0,4} */
-
-#define CX700_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
-#define CX700_IGA2_FIFO_THRESHOLD		64	/* location: {CR68,0,3},{CR95,4,6}*/
-#define CX700_IGA2_FIFO_HIGH_THRESHOLD		32	/* location: {CR92,0,3},{CR95,0,2} */
-#define CX700_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {CR94,0,6}*/
-
-/* VT3336 chipset */
-#define K8M890_IGA1_FIFO_MAX_DEPTH		360	/* location: {SR17,0,7}*/
-#define K8M890_IGA1_FIFO_THRESHOLD		328	/* location: {SR16,0,5},{SR16,7,7}*/
-#define K8M890_IGA1_FIFO_HIGH_THRESHOLD		296	/* location: {SR18,0,5},{SR18,7,7}*/
-#define K8M890_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	124	/* location: {SR22,0,4}.*/
-
-#define K8M890_IGA2_FIFO_MAX_DEPTH		360	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
-#define K8M890_IGA2_FIFO_THRESHOLD		328	/* location: {CR68,0,3},{CR95,4,6}*/
-#define K8M890_IGA2_FIFO_HIGH_THRESHOLD		296	/* location: {CR92,0,3},{CR95,0,2}*/
-#define K8M890_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	124	/* location: {CR94,0,6}*/
-
-/* VT3327 chipset */
-#define P4M890_IGA1_FIFO_MAX_DEPTH		96	/* location: {SR17,0,7}*/
-#define P4M890_IGA1_FIFO_THRESHOLD		76	/* location: {SR16,0,5},{SR16,7,7}*/
-#define P4M890_IGA1_FIFO_HIGH_THRESHOLD		64	/* location: {SR18,0,5},{SR18,7,7}*/
-#define P4M890_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {SR22,0,4}. (32/4) =8*/
-
-#define P4M890_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
-#define P4M890_IGA2_FIFO_THRESHOLD		76	/* location: {CR68,0,3},{CR95,4,6}*/
-#define P4M890_IGA2_FIFO_HIGH_THRESHOLD		64	/* location: {CR92,0,3},{CR95,0,2}*/
-#define P4M890_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {CR94,0,6}*/
-
-/* VT3364 chipset */
-#define P4M900_IGA1_FIFO_MAX_DEPTH		96	/* location: {SR17,0,7}*/
-#define P4M900_IGA1_FIFO_THRESHOLD		76	/* location: {SR16,0,5},{SR16,7,7}*/
-#define P4M900_IGA1_FIFO_HIGH_THRESHOLD		76	/* location: {SR18,0,5},{SR18,7,7}*/
-#define P4M900_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {SR22,0,4}.*/
-
-#define P4M900_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
-#define P4M900_IGA2_FIFO_THRESHOLD		76	/* location: {CR68,0,3},{CR95,4,6}*/
-#define P4M900_IGA2_FIFO_HIGH_THRESHOLD		76	/* location: {CR92,0,3},{CR95,0,2}*/
-#define P4M900_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {CR94,0,6}*/
-
-/* For VT3353, these values are suggested by HW */
-#define VX800_IGA1_FIFO_MAX_DEPTH		192	/* location: {SR17,0,7}*/
-#define VX800_IGA1_FIFO_THRESHOLD		152	/* location: {SR16,0,5},{SR16,7,7}*/
-#define VX800_IGA1_FIFO_HIGH_THRESHOLD		152	/* location: {SR18,0,5},{SR18,7,7} */
-#define VX800_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	64	/* location: {SR22,0,4} */
-
-#define VX800_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
-#define VX800_IGA2_FIFO_THRESHOLD		64	/* location: {CR68,0,3},{CR95,4,6}*/
-#define VX800_IGA2_FIFO_HIGH_THRESHOLD		32	/* location: {CR92,0,3},{CR95,0,2} */
-#define VX800_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {CR94,0,6}*/
-
-/* For VT3409 */
-#define VX855_IGA1_FIFO_MAX_DEPTH		400
-#define VX855_IGA1_FIFO_THRESHOLD		320
-#define VX855_IGA1_FIFO_HIGH_THRESHOLD		320
-#define VX855_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	160
-
-#define VX855_IGA2_FIFO_MAX_DEPTH		200
-#define VX855_IGA2_FIFO_THRESHOLD		160
-#define VX855_IGA2_FIFO_HIGH_THRESHOLD		160
-#define VX855_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	320
-
-/* For VT3410 */
-#define VX900_IGA1_FIFO_MAX_DEPTH		400
-#define VX900_IGA1_FIFO_THRESHOLD		320
-#define VX900_IGA1_FIFO_HIGH_THRESHOLD		320
-#define VX900_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	160
-
-#define VX900_IGA2_FIFO_MAX_DEPTH		192
-#define VX900_IGA2_FIFO_THRESHOLD		160
-#define VX900_IGA2_FIFO_HIGH_THRESHOLD		160
-#define VX900_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	320
-
-#ifdef VIA_VT3293_SUPPORT
-/* For VT3293 */
-#define CN750_IGA1_FIFO_MAX_DEPTH		96
-#define CN750_IGA1_FIFO_THRESHOLD		76
-#define CN750_IGA1_FIFO_HIGH_THRESHOLD		76
-#define CN750_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	32
-
-#define CN750_IGA2_FIFO_MAX_DEPTH		96
-#define CN750_IGA2_FIFO_THRESHOLD		76
-#define CN750_IGA2_FIFO_HIGH_THRESHOLD		76
-#define CN750_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	32
-#endif
-
 /* CLE266 and KM400 IGA1 FIFO Depth Select */
 static struct vga_regset iga1_cle266_fifo_depth_select[] = {
 	{ VGA_SEQ_I, 0x17, 0, 6 }
@@ -26,6 +26,7 @@
  * James Simmons <jsimmons@infradead.org>
  */
 
+#include <linux/dma-resv.h>
 #include <linux/pci.h>
 
 #include <drm/drm_aperture.h>
@@ -36,8 +37,10 @@
 #include <drm/drm_gem.h>
 #include <drm/drm_ioctl.h>
 #include <drm/drm_prime.h>
+#include <drm/drm_print.h>
 
 #include <drm/ttm/ttm_bo.h>
+#include <drm/ttm/ttm_tt.h>
 
 #include <uapi/drm/via_drm.h>
 
@@ -104,7 +107,8 @@ static int via_driver_dumb_create(struct drm_file *file_priv,
 	size = pitch * args->height;
 
 	ret = via_bo_create(dev, &dev_priv->bdev, size,
-				ttm_bo_type_device, TTM_PL_VRAM, false, &bo);
+				ttm_bo_type_device, TTM_PL_VRAM, true, false,
+				&bo);
 	if (ret) {
 		goto exit;
 	}
@@ -114,7 +118,7 @@ static int via_driver_dumb_create(struct drm_file *file_priv,
 	ret = drm_gem_handle_create(file_priv, &ttm_bo->base, &handle);
 	drm_gem_object_put(&ttm_bo->base);
 	if (ret) {
-		via_bo_destroy(bo, false);
+		/* Dropping the last reference above freed the buffer. */
 		goto exit;
 	}
 
@@ -154,6 +158,74 @@ exit:
 	return ret;
 }
 
+/*
+ * Per-client memory usage for /proc/<pid>/fdinfo, split by the
+ * region each buffer currently sits in. The walk costs one step per
+ * GEM handle of the client. A buffer that is being moved right now
+ * is counted in the domain it was created for, without residency.
+ */
+static void via_driver_show_fdinfo(struct drm_printer *p,
+					struct drm_file *file_priv)
+{
+	static const char * const region_names[TTM_PL_VRAM + 1] = {
+		[TTM_PL_SYSTEM]	= "system",
+		[TTM_PL_TT]	= "tt",
+		[TTM_PL_VRAM]	= "vram",
+	};
+	struct drm_memory_stats stats[TTM_PL_VRAM + 1] = {};
+	struct ttm_buffer_object *ttm_bo;
+	struct drm_gem_object *gem;
+	struct via_bo *bo;
+	uint32_t mem_type;
+	bool resident;
+	int id;
+
+	spin_lock(&file_priv->table_lock);
+	idr_for_each_entry(&file_priv->object_idr, gem, id) {
+		ttm_bo = container_of(gem, struct ttm_buffer_object, base);
+		bo = to_ttm_bo(ttm_bo);
+
+		if (dma_resv_trylock(gem->resv)) {
+			mem_type = ttm_bo->resource->mem_type;
+			resident = (mem_type != TTM_PL_SYSTEM) ||
+					((ttm_bo->ttm) &&
+					(ttm_tt_is_populated(ttm_bo->ttm)));
+			dma_resv_unlock(gem->resv);
+		} else {
+			mem_type = bo->domain;
+			resident = false;
+		}
+
+		if (mem_type > TTM_PL_VRAM) {
+			continue;
+		}
+
+		if ((gem->handle_count > 1) || (gem->dma_buf) ||
+			(gem->import_attach)) {
+			stats[mem_type].shared += gem->size;
+		} else {
+			stats[mem_type].private += gem->size;
+		}
+
+		if (resident) {
+			stats[mem_type].resident += gem->size;
+		}
+
+		if (!dma_resv_test_signaled(gem->resv,
+					DMA_RESV_USAGE_BOOKKEEP)) {
+			stats[mem_type].active += gem->size;
+		}
+	}
+
+	spin_unlock(&file_priv->table_lock);
+
+	for (mem_type = 0; mem_type <= TTM_PL_VRAM; mem_type++) {
+		drm_print_memory_stats(p, &stats[mem_type],
+					DRM_GEM_OBJECT_RESIDENT,
+					region_names[mem_type]);
+	}
+}
+
 static const struct drm_ioctl_desc via_driver_ioctls[] = {
 	DRM_IOCTL_DEF_DRV(VIA_ALLOCMEM, drm_invalid_op, DRM_AUTH),
 	DRM_IOCTL_DEF_DRV(VIA_FREEMEM, drm_invalid_op, DRM_AUTH),
@@ -171,6 +243,11 @@ static const struct drm_ioctl_desc via_driver_ioctls[] = {
 	DRM_IOCTL_DEF_DRV(VIA_BLIT_SYNC, drm_invalid_op, DRM_AUTH),
 	DRM_IOCTL_DEF_DRV(VIA_GEM_ALLOC, via_gem_alloc_ioctl, DRM_AUTH),
 	DRM_IOCTL_DEF_DRV(VIA_GEM_MMAP, via_gem_mmap_ioctl, DRM_AUTH),
+	DRM_IOCTL_DEF_DRV(VIA_GEM_WAIT, via_gem_wait_ioctl, DRM_AUTH),
+	DRM_IOCTL_DEF_DRV(VIA_GEM_CPU_PREP, via_gem_cpu_prep_ioctl, DRM_AUTH),
+	DRM_IOCTL_DEF_DRV(VIA_GEM_CPU_FINI, via_gem_cpu_fini_ioctl, DRM_AUTH),
+	DRM_IOCTL_DEF_DRV(VIA_GEM_ALLOC_BATCH, via_gem_alloc_batch_ioctl,
+				DRM_AUTH),
 };
 
 static const struct file_operations via_driver_fops = {
@@ -181,6 +258,7 @@ static const struct file_operations via_driver_fops = {
 	.mmap		= drm_gem_mmap,
 	.poll		= drm_poll,
 	.llseek		= noop_llseek,
+	.show_fdinfo	= drm_show_fdinfo,
 };
 
 static struct drm_driver via_driver = {
@@ -191,6 +269,10 @@ static struct drm_driver via_driver = {
 	.dumb_create = via_driver_dumb_create,
 	.dumb_map_offset = via_driver_dumb_map_offset,
 
+	.gem_prime_import_sg_table = via_gem_prime_import_sg_table,
+
+	.show_fdinfo = via_driver_show_fdinfo,
+
 	.major = DRIVER_MAJOR,
 	.minor = DRIVER_MINOR,
 	.patchlevel = DRIVER_PATCHLEVEL,
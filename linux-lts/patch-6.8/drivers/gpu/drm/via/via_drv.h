@@ -30,9 +30,16 @@
 #define _VIA_DRV_H
 
 #include <linux/module.h> /* Often needed for module_init/module_exit macros */
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+#include <drm/drm_atomic.h>
+#include <drm/drm_buddy.h>
 #include <drm/drm_connector.h>
 #include <drm/drm_crtc.h>
 #include <drm/drm_encoder.h>
+#include <drm/drm_gem.h>
+#include <drm/drm_mm.h>
 #include <drm/drm_plane.h>
 
 #include <drm/ttm/ttm_bo.h>
@@ -43,11 +50,11 @@
 
 /* Version details */
 #define DRIVER_MAJOR            3
-#define DRIVER_MINOR            6
-#define DRIVER_PATCHLEVEL       14
+#define DRIVER_MINOR            8
+#define DRIVER_PATCHLEVEL       0
 #define DRIVER_NAME             "via"
 #define DRIVER_DESC             "OpenChrome DRM for VIA Technologies Chrome"
-#define DRIVER_DATE             "20240215"
+#define DRIVER_DATE             "20261017"
 #define DRIVER_AUTHOR           "OpenChrome Project"
 
 #define VIA_TTM_PL_NUM          2
@@ -55,6 +62,11 @@
 #define VIA_CURSOR_SIZE         64
 #define VIA_MM_ALIGN_SIZE       16
 
+#define VIA_VBLANK_EVASION_TIMEOUT_US	1000
+
+/* Share of the peak memory bandwidth scanout may use, in percent. */
+#define VIA_SCANOUT_BANDWIDTH_BUDGET	80
+
 #define CLE266_REVISION_AX      0x0A
 #define CLE266_REVISION_CX      0x0C
 
@@ -137,6 +149,176 @@ struct via_lvds_info {
 	u32 y;
 };
 
+/*
+ * Mode and memory bus load the display FIFO settings of one IGA are
+ * picked for. clock is the pixel clock in kHz, depth the color depth of
+ * the framebuffer, and other_load the bandwidth in MB/s taken by the
+ * other IGA.
+ */
+struct via_fifo_load {
+	u8		vram_type;
+	u32		hdisplay;
+	u32		vdisplay;
+	u32		depth;
+	u32		clock;
+	u32		cpp;
+	u32		other_load;
+};
+
+/*
+ * Display FIFO settings of one IGA. load is the memory bandwidth use
+ * in percent they were picked for.
+ */
+struct via_fifo_params {
+	unsigned int	max_depth;
+	unsigned int	threshold;
+	unsigned int	high_threshold;
+	unsigned int	display_queue_expire_num;
+	bool		extended;
+	unsigned int	load;
+};
+
+/*
+ * Global atomic state tracking the memory bandwidth, in MB/s, taken by
+ * the scanout of all planes of each IGA.
+ */
+struct via_bandwidth_state {
+	struct drm_private_state base;
+	u32	load[VIA_MAX_CRTC];
+};
+
+/*
+ * Register writes for one 2D engine copy, in the order they are
+ * issued. The command register always comes last since writing it
+ * starts the engine.
+ */
+#define VIA_BLIT_CMD_REGS	9
+
+struct via_blit_cmd {
+	unsigned int	count;
+	u32		reg[VIA_BLIT_CMD_REGS];
+	u32		val[VIA_BLIT_CMD_REGS];
+};
+
+/*
+ * 2D engine used to copy buffers within VRAM. Fences are signaled
+ * once the engine has been seen idle after they were emitted.
+ */
+struct via_blit {
+	struct mutex		lock;
+	spinlock_t		fence_lock;
+	struct list_head	pending;
+	struct delayed_work	work;
+	unsigned long		submitted;
+	u64			context;
+	u64			seqno;
+	bool			m1;
+	bool			enabled;
+};
+
+#define VIA_BO_CACHE_BUCKETS	16
+
+/*
+ * Recently freed, idle buffer objects kept for reuse. Buckets are
+ * indexed by TTM domain and by log2 of the size in pages, most
+ * recently freed first. lru is ordered oldest first for trimming
+ * and the shrinker, and reap holds the buffers on their way out.
+ */
+struct via_bo_cache {
+	struct mutex		lock;
+	struct list_head	buckets[TTM_PL_VRAM + 1][VIA_BO_CACHE_BUCKETS];
+	struct list_head	lru;
+	struct list_head	reap;
+	struct work_struct	reap_work;
+	struct shrinker		*shrinker;
+	u64			size;
+	u64			max_size;
+	unsigned int		count;
+	u64			hits;
+	u64			misses;
+};
+
+/* Size of the VRAM slab small objects are carved from */
+#define VIA_SUBALLOC_SIZE	(4 * VIA_CURSOR_SIZE * VIA_CURSOR_SIZE * 4)
+
+/*
+ * Pinned, kernel mapped VRAM slab shared by objects too small to
+ * be worth a TTM buffer of their own.
+ */
+struct via_suballoc_mgr {
+	struct mutex		lock;
+	struct drm_mm		mm;
+	struct via_bo		*bo;
+};
+
+struct via_suballoc {
+	struct kref		ref;
+	struct drm_mm_node	node;
+	struct drm_device	*dev;
+};
+
+/*
+ * VRAM resource manager backed by a buddy allocator. Every buffer
+ * is physically contiguous since scanout and the io mappings use a
+ * single start offset.
+ */
+struct via_vram_mgr {
+	struct ttm_resource_manager	manager;
+	struct drm_buddy		mm;
+	struct mutex			lock;
+};
+
+struct via_vram_resource {
+	struct ttm_resource	base;
+	struct list_head	blocks;
+};
+
+#define to_via_vram_mgr(x) \
+		container_of(x, struct via_vram_mgr, manager)
+#define to_via_vram_resource(x) \
+		container_of(x, struct via_vram_resource, base)
+
+#define VIA_PLL_CACHE_SIZE	16
+
+struct via_pll_cache_entry {
+	u32	freq;
+	u32	pll_mrn;
+};
+
+/*
+ * Recently solved PLL values, most recently used first.
+ */
+struct via_pll_cache {
+	spinlock_t		lock;
+	unsigned int		count;
+	struct via_pll_cache_entry entries[VIA_PLL_CACHE_SIZE];
+	u64			hits;
+	u64			misses;
+};
+
+#define VIA_REG_QUEUE_SIZE	64
+
+/*
+ * Register write staged during an atomic commit. reg is an MMIO
+ * offset, or (VGA index port << 8) | register index when vga is set.
+ */
+struct via_reg_queue_entry {
+	u32	reg;
+	u32	data;
+	u32	mask;
+	bool	vga;
+};
+
+/*
+ * Per-CRTC register writes recorded between atomic_begin and
+ * atomic_flush, so that they reach the hardware in one burst.
+ */
+struct via_reg_queue {
+	bool			open;
+	unsigned int		count;
+	struct via_reg_queue_entry entries[VIA_REG_QUEUE_SIZE];
+};
+
 /*
  * This structure tracks per-CRTC (IGA) resources:
  *  - Base DRM CRTC object
@@ -153,6 +335,9 @@ struct via_crtc {
 	/* Standard CRTC timing registers (horizontal, vertical, sync, blank, etc.) */
 	struct crtc_timings    timings;
 
+	/* timings compiled into one masked write per register */
+	struct via_reg_program timing_program;
+
 	/* FIFO / queue / threshold registers for controlling memory fetch */
 	struct vga_registers   display_queue;
 	struct vga_registers   high_threshold;
@@ -164,10 +349,35 @@ struct via_crtc {
 	/* Scaling mode flags (VIA_NO_SCALING, VIA_SHRINK, VIA_EXPAND, etc.) */
 	int                    scaling_mode;
 
+	/* Plane register writes staged until atomic_flush */
+	struct via_reg_queue   queue;
+
+	/* VGA register accesses of the last via_mode_set_nofb() */
+	struct via_vga_shadow_stats mode_set_stats;
+
 	/* CRTC index (0 = IGA1, 1 = IGA2) */
 	uint32_t               index;
 };
 
+/*
+ * Last EDID read over a connector's DDC bus, see
+ * via_connector_get_edid().
+ */
+struct via_edid_cache {
+	struct i2c_adapter *i2c_bus;	/* Bus the EDID came from */
+	u8 *edid;
+	size_t size;
+	s64 read_ns;			/* Time the full read took */
+	u64 saved_ns;			/* Bus time saved by hits */
+	u64 hits;
+	u64 misses;
+
+	/* Negative probe result, kept while the sense says disconnected */
+	struct i2c_adapter *absent_bus;
+	bool has_sense;
+	bool sense;
+};
+
 /*
  * VIA connector structure
  */
@@ -176,6 +386,7 @@ struct via_connector {
 	u32 i2c_bus;
 	struct list_head props;
 	uint32_t flags;
+	struct via_edid_cache edid_cache;
 };
 
 /*
@@ -196,6 +407,14 @@ struct via_bo {
 	struct ttm_bo_kmap_obj   kmap;
 	struct ttm_placement     placement;
 	struct ttm_place         placements[VIA_TTM_PL_NUM];
+	enum ttm_caching         caching;  /* CPU mapping caching mode */
+	bool                     scanout;  /* Placed top-down in VRAM */
+	uint32_t                 domain;   /* TTM domain requested */
+
+	/* Buffer object cache membership, see via_bo_cache.c */
+	bool                     cached;
+	struct list_head         cache_head;
+	struct list_head         cache_lru;
 };
 
 /*
@@ -218,8 +437,41 @@ struct via_drm_priv {
 	resource_size_t mmio_size;   /* Size of MMIO region */
 	void __iomem *mmio;          /* Virtual (ioremap) pointer */
 
+	/* Shadow copy of the VGA indexed registers */
+	struct via_vga_shadow vga_shadow;
+
 	bool spread_spectrum;        /* If spread spectrum is in use */
 
+	/* Pixel clock to PLL register value cache */
+	struct via_pll_cache pll_cache;
+
+	/* Scanout memory bandwidth admission */
+	struct drm_private_obj bandwidth_obj;
+
+	/* 2D engine accelerated buffer moves */
+	struct via_blit blit;
+
+	/* VRAM resource manager */
+	struct via_vram_mgr vram_mgr;
+
+	/* Freed buffer objects kept for reuse */
+	struct via_bo_cache bo_cache;
+
+	/* Small object VRAM slab */
+	struct via_suballoc_mgr suballoc;
+
+	/* Serializes read-modify-write of VIA_REG_INTERRUPT */
+	spinlock_t irq_lock;
+	bool irq_enabled;
+
+	/* Time each IGA's vertical sync interrupt was taken */
+	ktime_t vblank_irq_time[VIA_MAX_CRTC];
+
+	/* Integrated HDMI/DP transmitter hotplug events */
+	bool hpd_enabled;
+	u32 hpd_status;
+	struct work_struct hotplug_work;
+
 	/*
 	 * On certain chipsets (VX800, VX855, VX900),
 	 * we need to save/restore SR14 and SR66~SR6F on resume,
@@ -286,6 +538,8 @@ struct via_drm_priv {
  */
 #define to_via_drm_priv(x)  container_of(x, struct via_drm_priv, dev)
 #define to_ttm_bo(x)        container_of(x, struct via_bo, ttm_bo)
+#define to_via_bandwidth_state(x) \
+		container_of(x, struct via_bandwidth_state, base)
 
 /*
  * Macros for reading/writing MMIO registers
@@ -306,16 +560,59 @@ do { \
 } while (0)
 
 #define VGABASE (VIA_BASE + VIA_MMIO_VGABASE)
+#define VGASHADOW (&dev_priv->vga_shadow)
 
 /*
  * Functions exported from various via_* files
  */
 
 /* via_connector.c */
+bool via_connector_ddc_probe(struct via_connector *con,
+				struct i2c_adapter *i2c_bus);
+void via_connector_hotplug_sense(struct via_connector *con, bool sense);
+struct edid *via_connector_get_edid(struct via_connector *con,
+					struct i2c_adapter *i2c_bus);
+void via_connector_edid_invalidate(struct via_connector *con);
+void via_connector_debugfs_init(struct drm_device *dev);
 void via_connector_destroy(struct drm_connector *connector);
 
+/* via_bandwidth.c */
+int via_bandwidth_init(struct drm_device *dev);
+u32 via_bandwidth_other_load(struct drm_device *dev, unsigned int index);
+int via_bandwidth_check(struct drm_atomic_state *state);
+
+/* via_blit.c */
+int via_blit_encode(bool m1, u32 src, u32 dst, u32 lines,
+			struct via_blit_cmd *cmd);
+int via_blit_encode_clear(bool m1, u32 dst, u32 lines,
+				struct via_blit_cmd *cmd);
+int via_blit_copy(struct drm_device *dev, u64 src, u64 dst, u64 size,
+			struct dma_fence **fence);
+int via_blit_clear(struct drm_device *dev, u64 dst, u64 size,
+			struct dma_fence **fence);
+void via_blit_init(struct drm_device *dev);
+void via_blit_fini(struct drm_device *dev);
+
+/* via_bo_cache.c */
+struct via_bo *via_bo_cache_get(struct drm_device *dev, u64 size,
+				uint32_t ttm_domain, bool scanout);
+bool via_bo_cache_put(struct via_bo *bo);
+int via_bo_cache_init(struct drm_device *dev);
+void via_bo_cache_fini(struct drm_device *dev);
+void via_bo_cache_debugfs_init(struct via_drm_priv *dev_priv,
+				struct dentry *root);
+
+/* via_clock.c */
+u32 via_pll_solve(u16 device, u32 freq);
+
 /* via_crtc.c */
+void via_reg_queue_vga(struct via_crtc *iga, u16 ioport, u8 index,
+			u8 data, u8 mask);
+void via_reg_queue_mmio(struct via_crtc *iga, u32 reg, u32 data, u32 mask);
+void via_reg_queue_value(struct via_crtc *iga, struct vga_registers *regs,
+				unsigned int value);
 int via_crtc_init(struct via_drm_priv *dev_priv, uint32_t index);
+void via_crtc_debugfs_init(struct drm_device *dev);
 void via_load_crtc_pixel_timing(struct drm_crtc *crtc,
 								struct drm_display_mode *mode);
 
@@ -328,6 +625,17 @@ extern const unsigned int via_cursor_formats_size;
 /* via_encoder.c */
 void via_encoder_destroy(struct drm_encoder *encoder);
 
+/* via_fifo.c */
+u32 via_mem_bandwidth(u8 vram_type);
+u32 via_scanout_load(u32 clock, u32 cpp);
+unsigned int via_mem_load(u8 vram_type, u32 load);
+int via_iga1_fifo_params(u16 device, int revision,
+			const struct via_fifo_load *load,
+			struct via_fifo_params *fifo);
+int via_iga2_fifo_params(u16 device, int revision,
+			const struct via_fifo_load *load,
+			struct via_fifo_params *fifo);
+
 /* via_i2c.c */
 struct i2c_adapter *via_find_ddc_bus(int port);
 void via_i2c_readbytes(struct i2c_adapter *adapter,
@@ -339,6 +647,7 @@ void via_i2c_writebytes(struct i2c_adapter *adapter,
 void via_i2c_reg_init(struct via_drm_priv *dev_priv);
 int via_i2c_init(struct drm_device *dev);
 void via_i2c_exit(void);
+void via_i2c_debugfs_init(struct drm_device *dev);
 
 /* via_init.c */
 int via_drm_init(struct drm_device *dev);
@@ -347,8 +656,25 @@ void via_drm_fini(struct drm_device *dev);
 /* via_ioctl.c */
 int via_gem_alloc_ioctl(struct drm_device *dev, void *data,
 						struct drm_file *file_priv);
+int via_gem_alloc_batch_ioctl(struct drm_device *dev, void *data,
+				struct drm_file *file_priv);
 int via_gem_mmap_ioctl(struct drm_device *dev, void *data,
 					   struct drm_file *file_priv);
+int via_gem_wait_ioctl(struct drm_device *dev, void *data,
+			struct drm_file *file_priv);
+int via_gem_cpu_prep_ioctl(struct drm_device *dev, void *data,
+				struct drm_file *file_priv);
+int via_gem_cpu_fini_ioctl(struct drm_device *dev, void *data,
+				struct drm_file *file_priv);
+
+/* via_irq.c */
+int via_enable_vblank(struct drm_crtc *crtc);
+void via_disable_vblank(struct drm_crtc *crtc);
+bool via_get_vblank_timestamp(struct drm_crtc *crtc, int *max_error,
+				ktime_t *vblank_time, bool in_vblank_irq);
+void via_hotplug_irq_enable(struct via_drm_priv *dev_priv);
+int via_irq_init(struct drm_device *dev);
+void via_irq_fini(struct drm_device *dev);
 
 /* via_object.c */
 void via_ttm_domain_to_placement(struct via_bo *bo, uint32_t ttm_domain);
@@ -357,8 +683,11 @@ int via_bo_pin(struct via_bo *bo, uint32_t ttm_domain);
 void via_bo_unpin(struct via_bo *bo);
 int via_bo_create(struct drm_device *dev, struct ttm_device *bdev,
 				  uint64_t size, enum ttm_bo_type type,
-				  uint32_t ttm_domain, bool kmap,
+				  uint32_t ttm_domain, bool scanout, bool kmap,
 				  struct via_bo **bo_ptr);
+struct drm_gem_object *via_gem_prime_import_sg_table(struct drm_device *dev,
+					struct dma_buf_attachment *attach,
+					struct sg_table *sg);
 void via_bo_destroy(struct via_bo *bo, bool kmap);
 int via_mm_init(struct drm_device *dev);
 void via_mm_fini(struct drm_device *dev);
@@ -371,6 +700,18 @@ void via_set_vclock(struct drm_crtc *crtc, u32 clk);
 int via_dev_pm_ops_suspend(struct device *dev);
 int via_dev_pm_ops_resume(struct device *dev);
 
+/* via_suballoc.c */
+struct via_suballoc *via_suballoc_new(struct drm_device *dev, u64 size,
+					u64 align);
+struct via_suballoc *via_suballoc_get(struct via_suballoc *sa);
+void via_suballoc_put(struct via_suballoc *sa);
+u64 via_suballoc_offset(struct via_suballoc *sa);
+void __iomem *via_suballoc_cpu_addr(struct via_suballoc *sa);
+int via_suballoc_init(struct drm_device *dev);
+void via_suballoc_fini(struct drm_device *dev);
+void via_suballoc_debugfs_init(struct via_drm_priv *dev_priv,
+				struct dentry *root);
+
 /* via_ttm.c */
 extern struct ttm_device_funcs via_bo_driver;
 void via_ttm_debugfs_init(struct drm_device *dev);
@@ -392,6 +733,12 @@ void via_transmitter_data_drive_strength(struct drm_device *dev,
 void via_transmitter_display_source(struct drm_device *dev,
 									u32 di_port, int index);
 
+/* via_vram_mgr.c */
+int via_vram_mgr_init(struct via_drm_priv *dev_priv);
+void via_vram_mgr_fini(struct via_drm_priv *dev_priv);
+void via_vram_mgr_debugfs_init(struct via_drm_priv *dev_priv,
+				struct dentry *root);
+
 /* Additional display probes / inits */
 void via_dac_init(struct drm_device *dev);
 void via_dac_probe(struct drm_device *dev);
@@ -0,0 +1,756 @@
+/*
+ * Copyright © 2019-2020 Kevin Brace.
+ * Copyright 2012 James Simmons. All Rights Reserved.
+ * Copyright 1998-2009 VIA Technologies, Inc. All Rights Reserved.
+ * Copyright 2001-2009 S3 Graphics, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * Kevin Brace <kevinbrace@bracecomputerlab.com>
+ * James Simmons <jsimmons@infradead.org>
+ */
+
+#include <linux/bits.h>
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/minmax.h>
+#include <linux/pci_ids.h>
+#include <linux/string.h>
+
+#include "via_drv.h"
+
+
+/* Define Display OFFSET */
+/* VT3314 chipset */
+#define CN700_IGA1_FIFO_MAX_DEPTH		96	/* location: {SR17,0,7}*/
+#define CN700_IGA1_FIFO_THRESHOLD		80	/* location: {SR16,0,5},{SR16,7,7}*/
+#define CN700_IGA1_FIFO_HIGH_THRESHOLD		64	/* location: {SR18,0,5},{SR18,7,7}*/
+#define CN700_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {SR22,0,4}. (128/4) =64,
+							 * P800 must be set zero, because HW
+							 * only 5 bits */
+#define CN700_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
+#define CN700_IGA2_FIFO_THRESHOLD		80	/* location: {CR68,0,3},{CR95,4,6}*/
+#define CN700_IGA2_FIFO_HIGH_THRESHOLD		32	/* location: {CR92,0,3},{CR95,0,2}*/
+#define CN700_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {CR94,0,6}*/
+
+/* For VT3324, these values are suggested by HW */
+#define CX700_IGA1_FIFO_MAX_DEPTH		192	/* location: {SR17,0,7}*/
+#define CX700_IGA1_FIFO_THRESHOLD		128	/* location: {SR16,0,5},{SR16,7,7}*/
+#define CX700_IGA1_FIFO_HIGH_THRESHOLD		128	/* location: {SR18,0,5},{SR18,7,7} */
+#define CX700_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	124	/* location: {SR22,0,4} */
+
+#define CX700_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
+#define CX700_IGA2_FIFO_THRESHOLD		64	/* location: {CR68,0,3},{CR95,4,6}*/
+#define CX700_IGA2_FIFO_HIGH_THRESHOLD		32	/* location: {CR92,0,3},{CR95,0,2} */
+#define CX700_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {CR94,0,6}*/
+
+/* VT3336 chipset */
+#define K8M890_IGA1_FIFO_MAX_DEPTH		360	/* location: {SR17,0,7}*/
+#define K8M890_IGA1_FIFO_THRESHOLD		328	/* location: {SR16,0,5},{SR16,7,7}*/
+#define K8M890_IGA1_FIFO_HIGH_THRESHOLD		296	/* location: {SR18,0,5},{SR18,7,7}*/
+#define K8M890_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	124	/* location: {SR22,0,4}.*/
+
+#define K8M890_IGA2_FIFO_MAX_DEPTH		360	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
+#define K8M890_IGA2_FIFO_THRESHOLD		328	/* location: {CR68,0,3},{CR95,4,6}*/
+#define K8M890_IGA2_FIFO_HIGH_THRESHOLD		296	/* location: {CR92,0,3},{CR95,0,2}*/
+#define K8M890_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	124	/* location: {CR94,0,6}*/
+
+/* VT3327 chipset */
+#define P4M890_IGA1_FIFO_MAX_DEPTH		96	/* location: {SR17,0,7}*/
+#define P4M890_IGA1_FIFO_THRESHOLD		76	/* location: {SR16,0,5},{SR16,7,7}*/
+#define P4M890_IGA1_FIFO_HIGH_THRESHOLD		64	/* location: {SR18,0,5},{SR18,7,7}*/
+#define P4M890_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {SR22,0,4}. (32/4) =8*/
+
+#define P4M890_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
+#define P4M890_IGA2_FIFO_THRESHOLD		76	/* location: {CR68,0,3},{CR95,4,6}*/
+#define P4M890_IGA2_FIFO_HIGH_THRESHOLD		64	/* location: {CR92,0,3},{CR95,0,2}*/
+#define P4M890_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {CR94,0,6}*/
+
+/* VT3364 chipset */
+#define P4M900_IGA1_FIFO_MAX_DEPTH		96	/* location: {SR17,0,7}*/
+#define P4M900_IGA1_FIFO_THRESHOLD		76	/* location: {SR16,0,5},{SR16,7,7}*/
+#define P4M900_IGA1_FIFO_HIGH_THRESHOLD		76	/* location: {SR18,0,5},{SR18,7,7}*/
+#define P4M900_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {SR22,0,4}.*/
+
+#define P4M900_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
+#define P4M900_IGA2_FIFO_THRESHOLD		76	/* location: {CR68,0,3},{CR95,4,6}*/
+#define P4M900_IGA2_FIFO_HIGH_THRESHOLD		76	/* location: {CR92,0,3},{CR95,0,2}*/
+#define P4M900_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	32	/* location: {CR94,0,6}*/
+
+/* For VT3353, these values are suggested by HW */
+#define VX800_IGA1_FIFO_MAX_DEPTH		192	/* location: {SR17,0,7}*/
+#define VX800_IGA1_FIFO_THRESHOLD		152	/* location: {SR16,0,5},{SR16,7,7}*/
+#define VX800_IGA1_FIFO_HIGH_THRESHOLD		152	/* location: {SR18,0,5},{SR18,7,7} */
+#define VX800_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	64	/* location: {SR22,0,4} */
+
+#define VX800_IGA2_FIFO_MAX_DEPTH		96	/* location: {CR68,4,7},{CR94,7,7},{CR95,7,7}*/
+#define VX800_IGA2_FIFO_THRESHOLD		64	/* location: {CR68,0,3},{CR95,4,6}*/
+#define VX800_IGA2_FIFO_HIGH_THRESHOLD		32	/* location: {CR92,0,3},{CR95,0,2} */
+#define VX800_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	128	/* location: {CR94,0,6}*/
+
+/* For VT3409 */
+#define VX855_IGA1_FIFO_MAX_DEPTH		400
+#define VX855_IGA1_FIFO_THRESHOLD		320
+#define VX855_IGA1_FIFO_HIGH_THRESHOLD		320
+#define VX855_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	160
+
+#define VX855_IGA2_FIFO_MAX_DEPTH		200
+#define VX855_IGA2_FIFO_THRESHOLD		160
+#define VX855_IGA2_FIFO_HIGH_THRESHOLD		160
+#define VX855_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	320
+
+/* For VT3410 */
+#define VX900_IGA1_FIFO_MAX_DEPTH		400
+#define VX900_IGA1_FIFO_THRESHOLD		320
+#define VX900_IGA1_FIFO_HIGH_THRESHOLD		320
+#define VX900_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	160
+
+#define VX900_IGA2_FIFO_MAX_DEPTH		192
+#define VX900_IGA2_FIFO_THRESHOLD		160
+#define VX900_IGA2_FIFO_HIGH_THRESHOLD		160
+#define VX900_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	320
+
+#ifdef VIA_VT3293_SUPPORT
+/* For VT3293 */
+#define CN750_IGA1_FIFO_MAX_DEPTH		96
+#define CN750_IGA1_FIFO_THRESHOLD		76
+#define CN750_IGA1_FIFO_HIGH_THRESHOLD		76
+#define CN750_IGA1_DISPLAY_QUEUE_EXPIRE_NUM	32
+
+#define CN750_IGA2_FIFO_MAX_DEPTH		96
+#define CN750_IGA2_FIFO_THRESHOLD		76
+#define CN750_IGA2_FIFO_HIGH_THRESHOLD		76
+#define CN750_IGA2_DISPLAY_QUEUE_EXPIRE_NUM	32
+#endif
+
+#define VIA_FIFO_ANY_REVISION	-1
+#define VIA_FIFO_WEIGHT_MAX	256
+
+/*
+ * Peak UMA bandwidth in MB/s of each memory type, for a 64-bit wide
+ * memory bus.
+ */
+static const u16 via_mem_bandwidth_table[] = {
+	[VIA_MEM_NONE]		= 0,
+	[VIA_MEM_SDR66]		= 528,
+	[VIA_MEM_SDR100]	= 800,
+	[VIA_MEM_SDR133]	= 1064,
+	[VIA_MEM_DDR_200]	= 1600,
+	[VIA_MEM_DDR_266]	= 2128,
+	[VIA_MEM_DDR_333]	= 2664,
+	[VIA_MEM_DDR_400]	= 3200,
+	[VIA_MEM_DDR2_400]	= 3200,
+	[VIA_MEM_DDR2_533]	= 4264,
+	[VIA_MEM_DDR2_667]	= 5336,
+	[VIA_MEM_DDR2_800]	= 6400,
+	[VIA_MEM_DDR2_1066]	= 8528,
+	[VIA_MEM_DDR3_533]	= 4264,
+	[VIA_MEM_DDR3_667]	= 5336,
+	[VIA_MEM_DDR3_800]	= 6400,
+	[VIA_MEM_DDR3_1066]	= 8528,
+	[VIA_MEM_DDR3_1333]	= 10664,
+	[VIA_MEM_DDR3_1600]	= 12800,
+};
+
+struct via_fifo_config {
+	u16	max_depth;
+	u16	threshold;
+	u16	high_threshold;
+	u16	display_queue_expire_num;
+};
+
+/*
+ * Display FIFO descriptor of one chipset IGA.
+ *
+ * The rows of a chipset are tried in order, and the first one whose
+ * conditions all hold is used. A condition left at 0 always holds:
+ * max_vram_type limits the row to memory types up to and including
+ * it, min_hdisplay and max_hdisplay to that range of mode widths,
+ * min_vdisplay to modes at least that tall, and depths (a bitmask of
+ * VIA_FIFO_DEPTH()) to those color depths.
+ *
+ * light is the known good setting picked for those conditions. A row
+ * may also give a heavy setting, which must be at least as deep in
+ * every respect (deeper FIFO, higher thresholds, shorter expire), along
+ * with the memory bandwidth use (in percent) each of the two is meant
+ * for. Loads in between then get settings interpolated between the
+ * two. Rows without a heavy setting are used as they are.
+ */
+struct via_fifo_desc {
+	u16	device;
+	int	revision;
+	u8	max_vram_type;
+	u16	min_hdisplay;
+	u16	max_hdisplay;
+	u16	min_vdisplay;
+	u64	depths;
+	u8	light_load;
+	u8	heavy_load;
+	struct via_fifo_config light;
+	struct via_fifo_config heavy;
+
+	/* The extended display FIFO of CLE266 and KM400 is needed. */
+	bool	extended;
+};
+
+#define VIA_FIFO_DEPTH(_depth)		BIT_ULL(_depth)
+#define VIA_FIFO_DEPTHS_ABOVE(_depth)	GENMASK_ULL(32, (_depth) + 1)
+
+#define VIA_FIFO_FIXED(_device, _chip, _iga)				\
+{									\
+	.device = _device,						\
+	.revision = VIA_FIFO_ANY_REVISION,				\
+	.light = {							\
+		_chip##_##_iga##_FIFO_MAX_DEPTH,			\
+		_chip##_##_iga##_FIFO_THRESHOLD,			\
+		_chip##_##_iga##_FIFO_HIGH_THRESHOLD,			\
+		_chip##_##_iga##_DISPLAY_QUEUE_EXPIRE_NUM,		\
+	},								\
+}
+
+static const struct via_fifo_desc via_iga1_fifo_table[] = {
+	/* SR17[6:0], SR16[5:0], SR18[5:0], SR22[4:0] */
+
+	/* CLE266 AX, up to DDR200 */
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1025,
+		.min_vdisplay = 769,
+		.light = { 96, 92, 92, 16 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1025,
+		.light = { 96, 92, 92, 12 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 641,
+		.light = { 64, 32, 56, 40 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(24),
+		.light = { 64, 32, 56, 124 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(16),
+		.min_hdisplay = 1401,
+		.light = { 96, 92, 92, 16 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(16),
+		.min_hdisplay = 1025,
+		.light = { 96, 92, 92, 12 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(16),
+		.light = { 64, 32, 56, 12 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.min_hdisplay = 1025,
+		.light = { 96, 92, 92, 124 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.light = { 64, 32, 56, 124 },
+	},
+	/* CLE266 AX, faster memory */
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.min_hdisplay = 1281,
+		.light = { 96, 92, 92, 16 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.min_hdisplay = 1025,
+		.light = { 96, 92, 92, 12 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.light = { 64, 32, 56, 124 },
+	},
+	/* CLE266 CX, up to DDR200 */
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.min_hdisplay = 1025,
+		.min_vdisplay = 769,
+		.light = { 128, 112, 92, 16 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.min_hdisplay = 1025,
+		.light = { 128, 112, 92, 12 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.min_hdisplay = 1024,
+		.light = { 128, 112, 92, 40 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.min_hdisplay = 641,
+		.light = { 64, 32, 56, 40 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.light = { 64, 32, 56, 124 },
+	},
+	/* CLE266 CX, faster memory */
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.min_hdisplay = 1280,
+		.light = { 128, 112, 92, 16 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.min_hdisplay = 1024,
+		.light = { 128, 112, 92, 124 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light = { 64, 32, 56, 124 },
+	},
+	/* KM400, the 1600 wide DDR200 mode gets a shallower FIFO. */
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.min_hdisplay = 1600,
+		.light = { 58, 24, 92, 16 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.light = { 128, 112, 92, 8 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.min_hdisplay = 1600,
+		.light = { 128, 112, 92, 40 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light = { 128, 112, 92, 36 },
+	},
+	/* SR17[7:0], SR16[7] SR16[5:0], SR18[7] SR18[5:0], SR22[4:0] */
+	{
+		.device = PCI_DEVICE_ID_VIA_K8M800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1400,
+		.light = { 384, 328, 296, 64 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_K8M800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light_load = 10,
+		.heavy_load = 20,
+		.light = { 384, 328, 296, 128 },
+		.heavy = { 384, 328, 296, 64 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_PM800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1400,
+		.light = { 192, 128, 64, 64 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_PM800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light_load = 10,
+		.heavy_load = 20,
+		.light = { 192, 128, 64, 124 },
+		.heavy = { 192, 128, 64, 64 },
+	},
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_P4M800_PRO_GFX, CN700, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_UNICHROME_PRO_II, CX700, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9, K8M890, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_P4M890_GFX, P4M890, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HC, P4M900, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HC3, VX800, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HCM, VX855, IGA1),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HD, VX900, IGA1),
+};
+
+static const struct via_fifo_desc via_iga2_fifo_table[] = {
+	/* CR68[7:4], CR68[3:0] */
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTHS_ABOVE(16),
+		.min_vdisplay = 769,
+		.light = { 88, 44, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.max_vram_type = VIA_MEM_DDR_266,
+		.depths = VIA_FIFO_DEPTHS_ABOVE(16),
+		.min_hdisplay = 1281,
+		.light = { 88, 44, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = CLE266_REVISION_AX,
+		.light = { 56, 28, 0, 0 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.min_hdisplay = 1024,
+		.light = { 88, 44, 0, 0 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_CLE266_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light = { 56, 28, 0, 0 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.min_hdisplay = 1600,
+		.light = { 120, 44, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_333,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1025,
+		.light = { 104, 28, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1024,
+		.max_hdisplay = 1024,
+		.light = { 104, 28, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_333,
+		.depths = VIA_FIFO_DEPTH(16),
+		.min_hdisplay = 1281,
+		.light = { 88, 44, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.max_vram_type = VIA_MEM_DDR_200,
+		.depths = VIA_FIFO_DEPTH(16),
+		.min_hdisplay = 1280,
+		.max_hdisplay = 1280,
+		.light = { 88, 44, 0, 0 },
+		.extended = true,
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_KM400_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light = { 56, 28, 0, 0 },
+	},
+	/*
+	 * CR95[7] CR94[7] CR68[7:4], CR95[6:4] CR68[3:0],
+	 * CR95[2:0] CR92[3:0], CR94[6:0]
+	 */
+	{
+		.device = PCI_DEVICE_ID_VIA_K8M800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1400,
+		.light = { 376, 328, 296, 64 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_K8M800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light_load = 10,
+		.heavy_load = 20,
+		.light = { 376, 328, 296, 128 },
+		.heavy = { 376, 328, 296, 64 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_PM800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.depths = VIA_FIFO_DEPTH(24),
+		.min_hdisplay = 1400,
+		.light = { 96, 64, 32, 64 },
+	},
+	{
+		.device = PCI_DEVICE_ID_VIA_PM800_GFX,
+		.revision = VIA_FIFO_ANY_REVISION,
+		.light_load = 10,
+		.heavy_load = 20,
+		.light = { 96, 64, 32, 124 },
+		.heavy = { 96, 64, 32, 64 },
+	},
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_P4M800_PRO_GFX, CN700, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_UNICHROME_PRO_II, CX700, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9, K8M890, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_P4M890_GFX, P4M890, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HC, P4M900, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HC3, VX800, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HCM, VX855, IGA2),
+	VIA_FIFO_FIXED(PCI_DEVICE_ID_VIA_CHROME9_HD, VX900, IGA2),
+};
+
+/*
+ * Peak memory bandwidth in MB/s, or 0 if the memory type is unknown.
+ */
+u32 via_mem_bandwidth(u8 vram_type)
+{
+	if (vram_type >= ARRAY_SIZE(via_mem_bandwidth_table)) {
+		return 0;
+	}
+
+	return via_mem_bandwidth_table[vram_type];
+}
+
+/*
+ * Memory bandwidth in MB/s needed to scan out a mode with the given
+ * pixel clock (in kHz) and bytes per pixel.
+ */
+u32 via_scanout_load(u32 clock, u32 cpp)
+{
+	return DIV_ROUND_UP(clock * cpp, 1000);
+}
+
+/*
+ * Memory bandwidth use in percent. An unknown memory type is treated
+ * as fully loaded, so that the heaviest setting gets picked.
+ */
+unsigned int via_mem_load(u8 vram_type, u32 load)
+{
+	u32 bandwidth = via_mem_bandwidth(vram_type);
+
+	if (!bandwidth) {
+		return 100;
+	}
+
+	return DIV_ROUND_UP(load * 100, bandwidth);
+}
+
+static bool via_fifo_desc_match(const struct via_fifo_desc *desc,
+				u16 device, int revision,
+				const struct via_fifo_load *load)
+{
+	if (desc->device != device) {
+		return false;
+	}
+
+	if ((desc->revision != VIA_FIFO_ANY_REVISION) &&
+		(desc->revision != revision)) {
+		return false;
+	}
+
+	if ((desc->max_vram_type) &&
+		(load->vram_type > desc->max_vram_type)) {
+		return false;
+	}
+
+	if ((load->hdisplay < desc->min_hdisplay) ||
+		((desc->max_hdisplay) &&
+		(load->hdisplay > desc->max_hdisplay))) {
+		return false;
+	}
+
+	if (load->vdisplay < desc->min_vdisplay) {
+		return false;
+	}
+
+	if ((desc->depths) &&
+		((load->depth > 32) ||
+		(!(desc->depths & VIA_FIFO_DEPTH(load->depth))))) {
+		return false;
+	}
+
+	return true;
+}
+
+static const struct via_fifo_desc *
+via_fifo_desc_lookup(const struct via_fifo_desc *table, unsigned int size,
+			u16 device, int revision,
+			const struct via_fifo_load *load)
+{
+	unsigned int i;
+
+	for (i = 0; i < size; i++) {
+		if (via_fifo_desc_match(&table[i], device, revision, load)) {
+			return &table[i];
+		}
+	}
+
+	return NULL;
+}
+
+static u16 via_fifo_interpolate(u16 light, u16 heavy,
+				unsigned int weight, unsigned int align)
+{
+	int value = light + DIV_ROUND_CLOSEST(((int)heavy - light) *
+						(int)weight,
+						VIA_FIFO_WEIGHT_MAX);
+
+	return roundup(value, align);
+}
+
+static int via_fifo_params(const struct via_fifo_desc *desc,
+				unsigned int depth_align,
+				const struct via_fifo_load *load,
+				struct via_fifo_params *fifo)
+{
+	unsigned int weight;
+
+	memset(fifo, 0, sizeof(*fifo));
+
+	if (!desc) {
+		return -EINVAL;
+	}
+
+	fifo->load = via_mem_load(load->vram_type,
+				via_scanout_load(load->clock, load->cpp) +
+				load->other_load);
+	fifo->extended = desc->extended;
+
+	if ((!desc->heavy_load) ||
+		(fifo->load <= desc->light_load)) {
+		fifo->max_depth = desc->light.max_depth;
+		fifo->threshold = desc->light.threshold;
+		fifo->high_threshold = desc->light.high_threshold;
+		fifo->display_queue_expire_num =
+				desc->light.display_queue_expire_num;
+		return 0;
+	}
+
+	if (fifo->load >= desc->heavy_load) {
+		weight = VIA_FIFO_WEIGHT_MAX;
+	} else {
+		weight = (fifo->load - desc->light_load) *
+				VIA_FIFO_WEIGHT_MAX /
+				(desc->heavy_load - desc->light_load);
+	}
+
+	fifo->max_depth = via_fifo_interpolate(desc->light.max_depth,
+						desc->heavy.max_depth,
+						weight, depth_align);
+	fifo->threshold = via_fifo_interpolate(desc->light.threshold,
+						desc->heavy.threshold,
+						weight, 4);
+	fifo->high_threshold = via_fifo_interpolate(
+					desc->light.high_threshold,
+					desc->heavy.high_threshold,
+					weight, 4);
+	fifo->display_queue_expire_num = via_fifo_interpolate(
+				desc->light.display_queue_expire_num,
+				desc->heavy.display_queue_expire_num,
+				weight, 4);
+	return 0;
+}
+
+/*
+ * Display FIFO settings only depend on the chipset, its revision, the
+ * memory type, the mode, and the memory bandwidth used by both IGAs.
+ * They are kept free of any register access here so that the
+ * selection can be evaluated without the hardware being present.
+ */
+int via_iga1_fifo_params(u16 device, int revision,
+			const struct via_fifo_load *load,
+			struct via_fifo_params *fifo)
+{
+	return via_fifo_params(via_fifo_desc_lookup(via_iga1_fifo_table,
+					ARRAY_SIZE(via_iga1_fifo_table),
+					device, revision, load),
+				2, load, fifo);
+}
+
+int via_iga2_fifo_params(u16 device, int revision,
+			const struct via_fifo_load *load,
+			struct via_fifo_params *fifo)
+{
+	return via_fifo_params(via_fifo_desc_lookup(via_iga2_fifo_table,
+					ARRAY_SIZE(via_iga2_fifo_table),
+					device, revision, load),
+				8, load, fifo);
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_fifo_test.c"
+#endif
@@ -27,6 +27,7 @@
  */
 
 #include <linux/delay.h>
+#include <linux/iopoll.h>
 
 #include <drm/drm_atomic_state_helper.h>
 #include <drm/drm_connector.h>
@@ -242,7 +243,7 @@ static void via_hdmi_native_mode_set(struct via_crtc *iga,
 	/* Select HDTV0 source */
 	if (iga->index)
 		value |= BIT(1);
-	svga_wcrt_mask(VGABASE, 0xFF, value, BIT(1) | BIT(0));
+	svga_wcrt_mask(VGASHADOW, 0xFF, value, BIT(1) | BIT(0));
 }
 
 static void via_hdmi_enc_mode_set(struct drm_encoder *encoder,
@@ -278,24 +279,24 @@ static void via_hdmi_enc_mode_set(struct drm_encoder *encoder,
 			via_load_crtc_pixel_timing(encoder->crtc, adjusted_mode);
 
 		/* Set Hsync Offset, delay one clock (To meet 861-D spec.) */
-		svga_wcrt_mask(VGABASE, 0x8A, 0x01, 0x7);
+		svga_wcrt_mask(VGASHADOW, 0x8A, 0x01, 0x7);
 
 		/* If CR8A +1, HSyc must -1 */
-		vga_wcrt(VGABASE, 0x56, vga_rcrt(VGABASE, 0x56) - 1);
-		vga_wcrt(VGABASE, 0x57, vga_rcrt(VGABASE, 0x57) - 1);
+		via_vga_wcrt(VGASHADOW, 0x56, via_vga_rcrt(VGASHADOW, 0x56) - 1);
+		via_vga_wcrt(VGASHADOW, 0x57, via_vga_rcrt(VGASHADOW, 0x57) - 1);
 
 		if (adjusted_mode->flags & DRM_MODE_FLAG_INTERLACE) {
 			if (iga->index) {
 				/* FIXME VIA where do you get this value from ??? */
 				u32 v_sync_adjust = 0;
 
-				svga_wcrt_mask(VGABASE, 0xAB, v_sync_adjust & 0xFF, 0xFF);
-				svga_wcrt_mask(VGABASE, 0xAC, (v_sync_adjust & 0x700) >> 8, 0x07);
+				svga_wcrt_mask(VGASHADOW, 0xAB, v_sync_adjust & 0xFF, 0xFF);
+				svga_wcrt_mask(VGASHADOW, 0xAC, (v_sync_adjust & 0x700) >> 8, 0x07);
 			}
 		} else { /* non-interlace, clear interlace setting. */
 			if (iga->index) {
-				vga_wcrt(VGABASE, 0xFB, 0);
-				svga_wcrt_mask(VGABASE, 0xFC, 0, 0x07);
+				via_vga_wcrt(VGASHADOW, 0xFB, 0);
+				svga_wcrt_mask(VGASHADOW, 0xFC, 0, 0x07);
 			}
 		}
 	} else if (connector->connector_type == DRM_MODE_CONNECTOR_DVID) {
@@ -329,12 +330,12 @@ static void via_hdmi_enc_mode_set(struct drm_encoder *encoder,
 		/* EPHY Control Register */
 		VIA_WRITE_MASK(DP_EPHY_PLL_REG, 0x1EC46E6F, 0x3FFFFFFF);
 		/* Select PHY Function as HDMI */
-		svga_wcrt_mask(VGABASE, 0xFF, BIT(0), BIT(0));
+		svga_wcrt_mask(VGASHADOW, 0xFF, BIT(0), BIT(0));
 		/* Select HDTV0 source */
 		if (!iga->index)
-			svga_wcrt_mask(VGABASE, 0xFF, 0, BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0xFF, 0, BIT(1));
 		else
-			svga_wcrt_mask(VGABASE, 0xFF, BIT(1), BIT(1));
+			svga_wcrt_mask(VGASHADOW, 0xFF, BIT(1), BIT(1));
 
 		/* in 640x480 case, MPLL is different */
 		/* For VT3410 internal transmitter 640x480 issue */
@@ -351,191 +352,188 @@ static const struct drm_encoder_helper_funcs via_hdmi_enc_helper_funcs = {
 	.mode_set = via_hdmi_enc_mode_set,
 };
 
-static unsigned int via_check_hdmi_i2c_status(struct via_drm_priv *dev_priv,
-						unsigned int check_bits,
-						unsigned int condition)
+/*
+ * DDC engine of the integrated HDMI transmitter. Each START, byte or
+ * STOP is handed to the engine, which clocks it out on its own. The
+ * CPU sleeps while a step is in flight instead of spinning on the
+ * status, since a 256 byte EDID takes tens of milliseconds at DDC
+ * speed.
+ */
+#define VIA_HDMI_DDC_DATA	0xC0B4
+#define VIA_HDMI_DDC_CTRL	0xC0B8
+
+#define VIA_HDMI_DDC_ENABLE	BIT(0)
+#define VIA_HDMI_DDC_GO		BIT(3)
+#define VIA_HDMI_DDC_START	BIT(4)
+#define VIA_HDMI_DDC_STOP	BIT(5)
+#define VIA_HDMI_DDC_DATA_READY	BIT(7)
+#define VIA_HDMI_DDC_BUS_BUSY	BIT(11)
+
+#define VIA_HDMI_DDC_SEGMENT_ADDR	0x30
+
+#define VIA_HDMI_DDC_POLL_US	20
+#define VIA_HDMI_DDC_TIMEOUT_US	2200	/* from VESA */
+
+static int via_hdmi_ddc_wait(struct via_drm_priv *dev_priv,
+				u32 bits, bool set)
 {
-	unsigned int status = true, max = 50, loop = 0;
+	u32 status;
 
-	if (condition) {
-		while ((VIA_READ(0xC0B8) & check_bits) && loop < max) {
-			/* delay 20 us */
-			udelay(20);
+	return readl_poll_timeout(VIA_BASE + VIA_HDMI_DDC_CTRL, status,
+					set ? (status & bits) :
+						!(status & bits),
+					VIA_HDMI_DDC_POLL_US,
+					VIA_HDMI_DDC_TIMEOUT_US);
+}
 
-			if (++loop == max)
-				status = false;
-		}
-	} else {
-		while (!(VIA_READ(0xC0B8) & check_bits) && loop < max) {
-			/* delay 20 us */
-			udelay(20);
+static int via_hdmi_ddc_start(struct via_drm_priv *dev_priv)
+{
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE |
+					VIA_HDMI_DDC_START);
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE |
+					VIA_HDMI_DDC_START |
+					VIA_HDMI_DDC_GO);
+	return via_hdmi_ddc_wait(dev_priv, VIA_HDMI_DDC_START |
+						VIA_HDMI_DDC_GO, false);
+}
 
-			if (++loop == max)
-				status = false;
-		}
-	}
-	return status;
+static int via_hdmi_ddc_write(struct via_drm_priv *dev_priv, u8 data)
+{
+	VIA_WRITE_MASK(VIA_HDMI_DDC_DATA, data << 16, 0x00FF0000);
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE |
+					VIA_HDMI_DDC_GO);
+	return via_hdmi_ddc_wait(dev_priv, VIA_HDMI_DDC_GO, false);
 }
 
-static unsigned int via_ddc_read_bytes_by_hdmi(struct via_drm_priv *dev_priv,
-					unsigned int offset,
-					unsigned char *block)
+static int via_hdmi_ddc_read(struct via_drm_priv *dev_priv, u8 *data)
 {
-	unsigned int status = true, temp = 0, i;
+	int ret;
 
-	/* Enable DDC */
-	VIA_WRITE_MASK(0xC000, 0x00000001, 0x00000001);
-	VIA_WRITE(0xC0C4, (VIA_READ(0xC0C4) & 0xFC7FFFFF) | 0x00800000);
-	VIA_WRITE(0xC0B8, 0x00000001);
-
-	/* START */
-	VIA_WRITE(0xC0B8, 0x0011);
-	VIA_WRITE(0xC0B8, 0x0019);
-	if (status)
-		status = via_check_hdmi_i2c_status(dev_priv, 0x0018, true);
-
-	/* Slave Address */
-	temp = 0xA0;
-	temp <<= 16;
-	temp |= VIA_READ(0xC0B4) & 0xFF00FFFF;
-	VIA_WRITE(0xC0B4, temp);
-	VIA_WRITE(0xC0B8, 0x0009);
-	if (status)
-		status = via_check_hdmi_i2c_status(dev_priv, 0x0008, true);
-
-	/* Offset */
-	temp = offset;
-	temp <<= 16;
-	temp |= VIA_READ(0xC0B4) & 0xFF00FFFF;
-	VIA_WRITE(0xC0B4, temp);
-	VIA_WRITE(0xC0B8, 0x0009);
-	if (status)
-		status = via_check_hdmi_i2c_status(dev_priv, 0x0008, true);
-
-	/* START */
-	VIA_WRITE(0xC0B8, 0x0011);
-	VIA_WRITE(0xC0B8, 0x0019);
-	if (status)
-		status = via_check_hdmi_i2c_status(dev_priv, 0x0018, true);
-
-	/* Slave Address + 1 */
-	temp = 0xA1;
-	temp <<= 16;
-	temp |= VIA_READ(0xC0B4) & 0xFF00FFFF;
-	VIA_WRITE(0xC0B4, temp);
-	VIA_WRITE(0xC0B8, 0x0009);
-	if (status)
-		status = via_check_hdmi_i2c_status(dev_priv, 0x0008, true);
-
-	for (i = 0; i < EDID_LENGTH; i++) {
-		/* Read Data */
-		VIA_WRITE(0xC0B8, 0x0009);
-		via_check_hdmi_i2c_status(dev_priv, 0x0008, true);
-		via_check_hdmi_i2c_status(dev_priv, 0x0080, false);
-		*block++ = (unsigned char) ((VIA_READ(0xC0B4) & 0x0000FF00) >> 8);
-		VIA_WRITE(0xC0B8, (VIA_READ(0xC0B8) & ~0x80));
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE |
+					VIA_HDMI_DDC_GO);
+	ret = via_hdmi_ddc_wait(dev_priv, VIA_HDMI_DDC_GO, false);
+	if (ret) {
+		return ret;
 	}
 
-	/* STOP */
-	VIA_WRITE(0xC0B8, 0x0021);
-	VIA_WRITE(0xC0B8, 0x0029);
-
-	status = via_check_hdmi_i2c_status(dev_priv, 0x0828, true);
-	if (!status) {
-		/* Reset */
-		VIA_WRITE_MASK(0xC0C4, 0x00000080, 0x00000080);
-		VIA_WRITE_MASK(0xC0C4, 0x00000000, 0x00000080);
+	ret = via_hdmi_ddc_wait(dev_priv, VIA_HDMI_DDC_DATA_READY, true);
+	if (ret) {
+		return ret;
 	}
-	return status;
+
+	*data = (VIA_READ(VIA_HDMI_DDC_DATA) & 0x0000FF00) >> 8;
+	VIA_WRITE_MASK(VIA_HDMI_DDC_CTRL, 0x00000000,
+			VIA_HDMI_DDC_DATA_READY);
+	return 0;
 }
 
-static struct edid* via_hdmi_get_edid(struct drm_connector *connector)
+static int via_hdmi_ddc_stop(struct via_drm_priv *dev_priv)
 {
-	bool print_bad_edid = !connector->bad_edid_counter || (drm_debug_enabled(DRM_UT_KMS));
-	struct drm_device *dev = connector->dev;
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
-	struct edid *edid = NULL;
-	int i, j = 0;
-	u8 *block;
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE |
+					VIA_HDMI_DDC_STOP);
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE |
+					VIA_HDMI_DDC_STOP |
+					VIA_HDMI_DDC_GO);
+	return via_hdmi_ddc_wait(dev_priv, VIA_HDMI_DDC_BUS_BUSY |
+						VIA_HDMI_DDC_STOP |
+						VIA_HDMI_DDC_GO, false);
+}
 
-	/* Clear out old EDID block */
-	drm_connector_update_edid_property(connector, edid);
+/*
+ * drm_do_get_edid() block reader. Blocks past the first two are
+ * reached through the E-DDC segment pointer. drm_do_get_edid()
+ * retries a block only until it reads back valid, and keeps the
+ * blocks it already has.
+ */
+static int via_hdmi_ddc_read_block(void *data, u8 *buf, unsigned int block,
+					size_t len)
+{
+	struct via_drm_priv *dev_priv = data;
+	u8 segment = block >> 1;
+	u8 offset = (block & 1) * EDID_LENGTH;
+	size_t i;
+	int ret, stop_ret;
 
-	block = kmalloc(EDID_LENGTH, GFP_KERNEL);
-	if (!block)
-		return edid;
+	/* Enable DDC */
+	VIA_WRITE_MASK(0xC000, 0x00000001, 0x00000001);
+	VIA_WRITE(0xC0C4, (VIA_READ(0xC0C4) & 0xFC7FFFFF) | 0x00800000);
+	VIA_WRITE(VIA_HDMI_DDC_CTRL, VIA_HDMI_DDC_ENABLE);
 
-	/* base block fetch */
-	for (i = 0; i < 4; i++) {
-		if (!via_ddc_read_bytes_by_hdmi(dev_priv, 0, block))
-			goto out;
+	if (segment) {
+		ret = via_hdmi_ddc_start(dev_priv);
+		if (ret) {
+			goto exit;
+		}
 
-		if (drm_edid_block_valid(block, 0, print_bad_edid, NULL))
-			break;
+		ret = via_hdmi_ddc_write(dev_priv,
+					VIA_HDMI_DDC_SEGMENT_ADDR << 1);
+		if (ret) {
+			goto exit;
+		}
 
-		if (i == 0 && !memchr_inv(block, 0, EDID_LENGTH)) {
-			connector->null_edid_counter++;
-			goto carp;
+		ret = via_hdmi_ddc_write(dev_priv, segment);
+		if (ret) {
+			goto exit;
 		}
 	}
-	if (i == 4)
-		goto carp;
-
-	/* parse the extensions if present */
-	if (block[0x7e]) {
-		u8 *new = krealloc(block, (block[0x7e] + 1) * EDID_LENGTH, GFP_KERNEL);
-		int valid_extensions = 0, offset = 0;
-
-		if (!new)
-			goto out;
-		block = new;
-
-		for (j = 1; j <= block[0x7e]; j++) {
-			for (i = 0; i < 4; i++) {
-				offset = (valid_extensions + 1) * EDID_LENGTH;
-				new = block + offset;
-
-				if (!via_ddc_read_bytes_by_hdmi(dev_priv,
-								 offset, new))
-					goto out;
-
-				if (drm_edid_block_valid(new, j, print_bad_edid, NULL)) {
-					valid_extensions++;
-					break;
-				}
-			}
 
-			if (i == 4 && print_bad_edid) {
-				dev_warn(connector->dev->dev,
-					"%s: Ignoring invalid EDID block %d.\n",
-					connector->name, j);
+	ret = via_hdmi_ddc_start(dev_priv);
+	if (ret) {
+		goto exit;
+	}
 
-				connector->bad_edid_counter++;
-			}
-		}
+	ret = via_hdmi_ddc_write(dev_priv, DDC_ADDR << 1);
+	if (ret) {
+		goto exit;
+	}
+
+	ret = via_hdmi_ddc_write(dev_priv, offset);
+	if (ret) {
+		goto exit;
+	}
 
-		if (valid_extensions != block[0x7e]) {
-			block[EDID_LENGTH - 1] += block[0x7e] - valid_extensions;
-			block[0x7e] = valid_extensions;
+	ret = via_hdmi_ddc_start(dev_priv);
+	if (ret) {
+		goto exit;
+	}
 
-			new = krealloc(block, (valid_extensions + 1) * EDID_LENGTH, GFP_KERNEL);
-			if (!new)
-				goto out;
-			block = new;
+	ret = via_hdmi_ddc_write(dev_priv, (DDC_ADDR << 1) | 0x01);
+	if (ret) {
+		goto exit;
+	}
+
+	for (i = 0; i < len; i++) {
+		ret = via_hdmi_ddc_read(dev_priv, &buf[i]);
+		if (ret) {
+			goto exit;
 		}
 	}
-	edid = (struct edid *) block;
-	drm_connector_update_edid_property(connector, edid);
-	return edid;
 
-carp:
-	if (print_bad_edid) {
-		dev_warn(connector->dev->dev, "%s: EDID block %d invalid.\n",
-			 connector->name, j);
+exit:
+	stop_ret = via_hdmi_ddc_stop(dev_priv);
+	if (!ret) {
+		ret = stop_ret;
 	}
-	connector->bad_edid_counter++;
-out:
-	kfree(block);
+
+	if (ret) {
+		/* Reset */
+		VIA_WRITE_MASK(0xC0C4, 0x00000080, 0x00000080);
+		VIA_WRITE_MASK(0xC0C4, 0x00000000, 0x00000080);
+	}
+
+	return ret;
+}
+
+/*
+ * The caller owns, and has to kfree(), the returned EDID.
+ */
+static struct edid *via_hdmi_get_edid(struct drm_connector *connector)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(connector->dev);
+	struct edid *edid;
+
+	edid = drm_do_get_edid(connector, via_hdmi_ddc_read_block, dev_priv);
+	drm_connector_update_edid_property(connector, edid);
 	return edid;
 }
 
@@ -545,9 +543,20 @@ via_hdmi_detect(struct drm_connector *connector, bool force)
 	struct drm_device *dev = connector->dev;
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 	enum drm_connector_status ret = connector_status_disconnected;
-	u32 mm_c730 = VIA_READ(0xc730) & 0xC0000000;
+	u32 mm_c730 = VIA_READ(AUX_TIMER_REG) & VIA_IRQ_DP_HOT_IRQ;
+	u32 hpd_status = xchg(&dev_priv->hpd_status, VIA_IRQ_DP_NO_INT);
 	struct edid *edid = NULL;
 
+	/*
+	 * The interrupt handler acknowledges the event bits, so fall
+	 * back to the last event it saw. It is only used once, so a
+	 * stale unplug does not hide a display that was connected
+	 * while no interrupt was taken.
+	 */
+	if (!mm_c730) {
+		mm_c730 = hpd_status;
+	}
+
 	if (VIA_IRQ_DP_HOT_UNPLUG == mm_c730) {
 		drm_connector_update_edid_property(connector, NULL);
 		return ret;
@@ -558,6 +567,8 @@ via_hdmi_detect(struct drm_connector *connector, bool force)
 		if ((connector->connector_type != DRM_MODE_CONNECTOR_HDMIA) ^
 			(drm_detect_hdmi_monitor(edid)))
 			ret = connector_status_connected;
+
+		kfree(edid);
 	}
 	return ret;
 }
@@ -595,6 +606,7 @@ static int via_hdmi_mode_valid(struct drm_connector *connector,
 static int via_hdmi_get_modes(struct drm_connector *connector)
 {
 	struct edid *edid = via_hdmi_get_edid(connector);
+	int count;
 
 	if (edid) {
 		struct via_connector *con;
@@ -606,7 +618,9 @@ static int via_hdmi_get_modes(struct drm_connector *connector)
 				con->flags |= drm_detect_monitor_audio(edid);
 		}
 	}
-	return drm_add_edid_modes(connector, edid);
+	count = drm_add_edid_modes(connector, edid);
+	kfree(edid);
+	return count;
 }
 
 static const struct drm_connector_helper_funcs via_hdmi_connector_helper_funcs = {
@@ -616,6 +630,7 @@ static const struct drm_connector_helper_funcs via_hdmi_connector_helper_funcs =
 
 void via_hdmi_init(struct drm_device *dev, u32 di_port)
 {
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 	struct via_connector *dvi, *hdmi;
 	struct via_encoder *enc;
 
@@ -642,7 +657,6 @@ void via_hdmi_init(struct drm_device *dev, u32 di_port)
 	drm_connector_helper_add(&hdmi->base, &via_hdmi_connector_helper_funcs);
 	drm_connector_register(&hdmi->base);
 
-	hdmi->base.polled = DRM_CONNECTOR_POLL_HPD;
 	hdmi->base.doublescan_allowed = false;
 	hdmi->base.interlace_allowed = true;
 	INIT_LIST_HEAD(&hdmi->props);
@@ -655,10 +669,22 @@ void via_hdmi_init(struct drm_device *dev, u32 di_port)
 	drm_connector_helper_add(&dvi->base, &via_hdmi_connector_helper_funcs);
 	drm_connector_register(&dvi->base);
 
-	dvi->base.polled = DRM_CONNECTOR_POLL_HPD;
 	dvi->base.doublescan_allowed = false;
 	dvi->base.interlace_allowed = true;
 	INIT_LIST_HEAD(&dvi->props);
 
 	drm_connector_attach_encoder(&dvi->base, &enc->base);
+
+	/*
+	 * The hotplug interrupt enable bits are not confirmed from
+	 * documentation, so keep polling the connectors and only use the
+	 * interrupt to reprobe them sooner.
+	 */
+	hdmi->base.polled = DRM_CONNECTOR_POLL_CONNECT |
+				DRM_CONNECTOR_POLL_DISCONNECT;
+	dvi->base.polled = DRM_CONNECTOR_POLL_CONNECT |
+				DRM_CONNECTOR_POLL_DISCONNECT;
+	if (dev_priv->irq_enabled) {
+		via_hotplug_irq_enable(dev_priv);
+	}
 }
@@ -12,7 +12,14 @@
 #include <linux/delay.h>
 #include <linux/i2c.h>
 #include <linux/i2c-algo-bit.h>
+#include <linux/jiffies.h>
+#include <linux/ktime.h>
 #include <linux/module.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+
+#include <drm/drm_debugfs.h>
+#include <drm/drm_edid.h>
 
 #include <uapi/linux/i2c.h>
 
@@ -21,20 +28,41 @@
 #define SERIAL	0
 #define	GPIO	1
 
+/*
+ * Half of the clock period in microseconds. 5 gives the 100 kHz that
+ * DDC allows, the old 15 gave ~33 kHz.
+ */
+#define VIA_I2C_UDELAY		5
+#define VIA_I2C_UDELAY_OLD	15
+
 struct via_i2c_stuff {
 	u16 i2c_port;			/* GPIO or I2C port */
 	u16 is_active;			/* Being used as I2C? */
 	struct i2c_adapter adapter;
 	struct i2c_algo_bit_data algo;
+
+	/* Last value written to the port */
+	u8 shadow;
 };
 
 static struct via_i2c_stuff via_i2c_par[5];
 
-static void via_i2c_setsda(void *data, int state)
+/*
+ * Only the I2C code drives the port, so the line changes are made on
+ * the last value written instead of reading the port back each time.
+ */
+static void via_i2c_set(struct via_i2c_stuff *i2c, u8 value, u8 mask)
 {
-	struct via_i2c_stuff *i2c = data;
 	struct drm_device *dev = i2c_get_adapdata(&i2c->adapter);
 	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+
+	i2c->shadow = (i2c->shadow & ~mask) | (value & mask);
+	via_vga_wseq(VGASHADOW, i2c->i2c_port, i2c->shadow);
+}
+
+static void via_i2c_setsda(void *data, int state)
+{
+	struct via_i2c_stuff *i2c = data;
 	u8 value, mask;
 
 	if (i2c->is_active == GPIO) {
@@ -45,14 +73,12 @@ static void via_i2c_setsda(void *data, int state)
 		mask = BIT(4) | BIT(0);
 	}
 
-	svga_wseq_mask(VGABASE, i2c->i2c_port, value, mask);
+	via_i2c_set(i2c, value, mask);
 }
 
 static void via_i2c_setscl(void *data, int state)
 {
 	struct via_i2c_stuff *i2c = data;
-	struct drm_device *dev = i2c_get_adapdata(&i2c->adapter);
-	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 	u8 value, mask;
 
 	if (i2c->is_active == GPIO) {
@@ -63,7 +89,7 @@ static void via_i2c_setscl(void *data, int state)
 		mask = BIT(5) | BIT(0);
 	}
 
-	svga_wseq_mask(VGABASE, i2c->i2c_port, value, mask);
+	via_i2c_set(i2c, value, mask);
 }
 
 static int via_i2c_getsda(void *data)
@@ -110,21 +136,23 @@ static int create_i2c_bus(struct drm_device *dev,
 	algo->setscl = via_i2c_setscl;
 	algo->getsda = via_i2c_getsda;
 	algo->getscl = via_i2c_getscl;
-	algo->udelay = 15;
+	algo->udelay = VIA_I2C_UDELAY;
 	algo->timeout = usecs_to_jiffies(2200); /* from VESA */
 	algo->data = i2c_par;
 
-	snprintf(adapter->name, sizeof(adapter->name),
-		 "via i2c bit bus 0x%02x", i2c_par->i2c_port);
 	adapter->owner = THIS_MODULE;
-    adapter->algo_data = algo;
 	i2c_set_adapdata(adapter, dev);
 
+	i2c_par->shadow = via_vga_rseq(VGASHADOW, i2c_par->i2c_port);
+
 	/* Raise SCL and SDA */
 	via_i2c_setsda(i2c_par, 1);
 	via_i2c_setscl(i2c_par, 1);
 	udelay(20);
 
+	snprintf(adapter->name, sizeof(adapter->name),
+		 "via i2c bit bus 0x%02x", i2c_par->i2c_port);
+	adapter->algo_data = algo;
 	return i2c_bit_add_bus(adapter);
 }
 
@@ -205,12 +233,12 @@ exit:
  */
 void via_i2c_reg_init(struct via_drm_priv *dev_priv)
 {
-	svga_wseq_mask(VGABASE, 0x31, 0x30, 0x30);
-	svga_wseq_mask(VGABASE, 0x26, 0x30, 0x30);
-	vga_wseq(VGABASE, 0x2C, 0xc2);
-	vga_wseq(VGABASE, 0x3D, 0xc0);
-	svga_wseq_mask(VGABASE, 0x2C, 0x30, 0x30);
-	svga_wseq_mask(VGABASE, 0x3D, 0x30, 0x30);
+	svga_wseq_mask(VGASHADOW, 0x31, 0x30, 0x30);
+	svga_wseq_mask(VGASHADOW, 0x26, 0x30, 0x30);
+	via_vga_wseq(VGASHADOW, 0x2C, 0xc2);
+	via_vga_wseq(VGASHADOW, 0x3D, 0xc0);
+	svga_wseq_mask(VGASHADOW, 0x2C, 0x30, 0x30);
+	svga_wseq_mask(VGASHADOW, 0x3D, 0x30, 0x30);
 }
 
 int via_i2c_init(struct drm_device *dev)
@@ -238,5 +266,105 @@ void via_i2c_exit(void)
 	int i;
 
 	for (i = 0; i < ARRAY_SIZE(via_i2c_par); i++)
-		i2c_del_adapter(&via_i2c_par->adapter);
-}
\ No newline at end of file
+		i2c_del_adapter(&via_i2c_par[i].adapter);
+}
+
+/*
+ * Time a 128 byte EDID block read on a port with the given clock delay.
+ * The read goes through a private copy of the port's adapter, which
+ * is never registered, so the registered adapter keeps its own delay.
+ * The registered adapter stays locked meanwhile, so that nothing else
+ * drives the port.
+ */
+static s64 via_i2c_bench_edid(struct via_i2c_stuff *i2c, int udelay)
+{
+	struct i2c_adapter *adapter = &i2c->adapter;
+	struct via_i2c_stuff *bench;
+	u8 offset = 0x00;
+	u8 buf[EDID_LENGTH];
+	struct i2c_msg msgs[] = {
+		{
+			.addr = DDC_ADDR,
+			.flags = 0,
+			.len = 1,
+			.buf = &offset,
+		},
+		{
+			.addr = DDC_ADDR,
+			.flags = I2C_M_RD,
+			.len = sizeof(buf),
+			.buf = buf,
+		}
+	};
+	ktime_t start;
+	s64 elapsed;
+	int ret;
+
+	bench = kzalloc(sizeof(*bench), GFP_KERNEL);
+	if (!bench) {
+		return -ENOMEM;
+	}
+
+	bench->i2c_port = i2c->i2c_port;
+	bench->is_active = i2c->is_active;
+	bench->algo = i2c->algo;
+	bench->algo.data = bench;
+	bench->algo.udelay = udelay;
+	bench->adapter.algo = &i2c_bit_algo;
+	bench->adapter.algo_data = &bench->algo;
+	bench->adapter.timeout = i2c->algo.timeout;
+	bench->adapter.retries = adapter->retries;
+	i2c_set_adapdata(&bench->adapter, i2c_get_adapdata(adapter));
+
+	i2c_lock_bus(adapter, I2C_LOCK_ROOT_ADAPTER);
+	bench->shadow = i2c->shadow;
+	start = ktime_get();
+	ret = i2c_bit_algo.master_xfer(&bench->adapter, msgs,
+					ARRAY_SIZE(msgs));
+	elapsed = ktime_us_delta(ktime_get(), start);
+	i2c->shadow = bench->shadow;
+	i2c_unlock_bus(adapter, I2C_LOCK_ROOT_ADAPTER);
+
+	kfree(bench);
+	return (ret == ARRAY_SIZE(msgs)) ? elapsed :
+					((ret < 0) ? ret : -EIO);
+}
+
+static void via_i2c_bench_print(struct seq_file *m, s64 us)
+{
+	if (us < 0) {
+		seq_printf(m, "failed (%lld)", us);
+	} else {
+		seq_printf(m, "%lld us", us);
+	}
+}
+
+static int via_i2c_bench_show(struct seq_file *m, void *unused)
+{
+	struct via_i2c_stuff *i2c;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(via_i2c_par); i++) {
+		i2c = &via_i2c_par[i];
+		if (!i2c->adapter.algo) {
+			continue;
+		}
+
+		seq_printf(m, "port 0x%02x: EDID read with %d us delay ",
+				i2c->i2c_port, VIA_I2C_UDELAY_OLD);
+		via_i2c_bench_print(m,
+				via_i2c_bench_edid(i2c, VIA_I2C_UDELAY_OLD));
+		seq_printf(m, ", with %d us delay ", VIA_I2C_UDELAY);
+		via_i2c_bench_print(m,
+				via_i2c_bench_edid(i2c, VIA_I2C_UDELAY));
+		seq_puts(m, "\n");
+	}
+
+	return 0;
+}
+
+void via_i2c_debugfs_init(struct drm_device *dev)
+{
+	drm_debugfs_add_file(dev, "via_i2c_bench", via_i2c_bench_show,
+				NULL);
+}
@@ -32,6 +32,7 @@
 
 #include <linux/pci.h>
 
+#include <drm/drm_atomic.h>
 #include <drm/drm_atomic_helper.h>
 #include <drm/drm_crtc_helper.h>
 #include <drm/drm_gem_framebuffer_helper.h>
@@ -1227,13 +1228,13 @@ static void via_graphics_unlock(struct drm_device *dev)
 	 * Unlock VIA Technologies Chrome IGP extended
 	 * registers.
 	 */
-	svga_wseq_mask(VGABASE, 0x10, BIT(0), BIT(0));
+	svga_wseq_mask(VGASHADOW, 0x10, BIT(0), BIT(0));
 
 	/*
 	 * Unlock VIA Technologies Chrome IGP extended
 	 * graphics functionality.
 	 */
-	svga_wseq_mask(VGABASE, 0x1a, BIT(3), BIT(3));
+	svga_wseq_mask(VGASHADOW, 0x1a, BIT(3), BIT(3));
 
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
 }
@@ -1249,9 +1250,13 @@ static void via_chip_revision_info(struct drm_device *dev)
 	switch (pdev->device) {
 	/* CLE266 Chipset */
 	case PCI_DEVICE_ID_VIA_CLE266_GFX:
-		/* CR4F only defined in CLE266.CX chipset. */
+		/*
+		 * CR4F only defined in CLE266.CX chipset. The probe
+		 * has to read the hardware, but the writes go through
+		 * the shadow so that it does not go stale.
+		 */
 		tmp = vga_rcrt(VGABASE, 0x4f);
-		vga_wcrt(VGABASE, 0x4f, 0x55);
+		via_vga_wcrt(VGASHADOW, 0x4f, 0x55);
 		if (vga_rcrt(VGABASE, 0x4f) != 0x55) {
 			dev_priv->revision = CLE266_REVISION_AX;
 		} else {
@@ -1259,7 +1264,7 @@ static void via_chip_revision_info(struct drm_device *dev)
 		}
 
 		/* Restore original CR4F value. */
-		vga_wcrt(VGABASE, 0x4f, tmp);
+		via_vga_wcrt(VGASHADOW, 0x4f, tmp);
 		break;
 	/* CX700 / VX700 Chipset */
 	case PCI_DEVICE_ID_VIA_UNICHROME_PRO_II:
@@ -1291,6 +1296,7 @@ static void via_chip_revision_info(struct drm_device *dev)
 
 static int via_device_init(struct drm_device *dev)
 {
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
 	int ret;
 
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
@@ -1312,6 +1318,7 @@ static int via_device_init(struct drm_device *dev)
 		goto error_mmio_init;
 	}
 
+	via_vga_shadow_init(&dev_priv->vga_shadow, VGABASE);
 	via_graphics_unlock(dev);
 	goto exit;
 error_mmio_init:
@@ -1323,6 +1330,8 @@ exit:
 
 static void via_device_fini(struct drm_device *dev)
 {
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
 
 	via_mmio_fini(dev);
@@ -1331,9 +1340,58 @@ static void via_device_fini(struct drm_device *dev)
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
 }
 
+static void via_atomic_commit_tail(struct drm_atomic_state *state)
+{
+	struct drm_device *dev = state->dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+
+	drm_atomic_helper_commit_tail(state);
+
+	via_vga_shadow_report(dev, &dev_priv->vga_shadow);
+}
+
+static int via_atomic_check(struct drm_device *dev,
+				struct drm_atomic_state *state)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *crtc_state;
+	int i, ret;
+
+	ret = drm_atomic_helper_check(dev, state);
+	if (ret) {
+		return ret;
+	}
+
+	ret = via_bandwidth_check(state);
+	if (ret) {
+		return ret;
+	}
+
+	/*
+	 * Asynchronous page flips that only change the scanned out
+	 * framebuffer are done right away through the primary plane's
+	 * atomic_async_update hook. Anything else is flipped at
+	 * vertical blank.
+	 */
+	for_each_new_crtc_in_state(state, crtc, crtc_state, i) {
+		if (crtc_state->async_flip) {
+			state->async_update =
+				!drm_atomic_helper_async_check(dev, state);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static const struct drm_mode_config_helper_funcs
+via_drm_mode_config_helper_funcs = {
+	.atomic_commit_tail	= via_atomic_commit_tail,
+};
+
 static const struct drm_mode_config_funcs via_drm_mode_config_funcs = {
 	.fb_create		= drm_gem_fb_create,
-	.atomic_check		= drm_atomic_helper_check,
+	.atomic_check		= via_atomic_check,
 	.atomic_commit		= drm_atomic_helper_commit,
 };
 
@@ -1348,14 +1406,19 @@ static int via_modeset_init(struct drm_device *dev)
 	dev_priv->number_fp = 0;
 	dev_priv->number_dvi = 0;
 
+	spin_lock_init(&dev_priv->pll_cache.lock);
+	dev_priv->pll_cache.count = 0;
+
 	dev->mode_config.min_width = 0;
 	dev->mode_config.min_height = 0;
 	dev->mode_config.max_width = 2044;
 	dev->mode_config.max_height = 4096;
 
 	dev->mode_config.funcs = &via_drm_mode_config_funcs;
+	dev->mode_config.helper_private = &via_drm_mode_config_helper_funcs;
 
 	dev->mode_config.preferred_depth = 24;
+	dev->mode_config.async_page_flip = true;
 
 	dev->mode_config.cursor_width =
 	dev->mode_config.cursor_height = VIA_CURSOR_SIZE;
@@ -1367,6 +1430,13 @@ static int via_modeset_init(struct drm_device *dev)
 		goto exit;
 	}
 
+	ret = via_bandwidth_init(dev);
+	if (ret) {
+		drm_err(dev, "Failed to initialize memory bandwidth "
+				"state!\n");
+		goto exit;
+	}
+
 	via_i2c_reg_init(dev_priv);
 	ret = via_i2c_init(dev);
 	if (ret) {
@@ -1382,6 +1452,12 @@ static int via_modeset_init(struct drm_device *dev)
 		}
 	}
 
+	ret = via_irq_init(dev);
+	if (ret) {
+		drm_err(dev, "Failed to initialize interrupt handling!\n");
+		goto error_crtc_init;
+	}
+
 	via_ext_dvi_probe(dev);
 	via_tmds_probe(dev);
 
@@ -1405,6 +1481,10 @@ static int via_modeset_init(struct drm_device *dev)
 		break;
 	}
 
+	via_crtc_debugfs_init(dev);
+	via_connector_debugfs_init(dev);
+	via_i2c_debugfs_init(dev);
+
 	drm_mode_config_reset(dev);
 
 	drm_kms_helper_poll_init(dev);
@@ -1419,7 +1499,14 @@ static void via_modeset_fini(struct drm_device *dev)
 {
 	drm_kms_helper_poll_fini(dev);
 
-	drm_helper_force_disable_all(dev);
+	/*
+	 * Unlike drm_helper_force_disable_all(), this also disables the
+	 * cursor planes, so that their images go back to the slab before
+	 * via_mm_fini() takes it down.
+	 */
+	drm_atomic_helper_shutdown(dev);
+
+	via_irq_fini(dev);
 
 	via_i2c_exit();
 }
@@ -1436,6 +1523,8 @@ int via_drm_init(struct drm_device *dev)
 		goto exit;
 	}
 
+	via_blit_init(dev);
+
 	ret = via_mm_init(dev);
 	if (ret) {
 		drm_err(dev, "Failed to initialize TTM!\n");
@@ -1454,6 +1543,7 @@ int via_drm_init(struct drm_device *dev)
 error_modeset_init:
 	via_mm_fini(dev);
 error_mm_init:
+	via_blit_fini(dev);
 	via_device_fini(dev);
 exit:
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
@@ -1466,6 +1556,7 @@ void via_drm_fini(struct drm_device *dev)
 
 	via_modeset_fini(dev);
 	via_mm_fini(dev);
+	via_blit_fini(dev);
 	via_device_fini(dev);
 
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
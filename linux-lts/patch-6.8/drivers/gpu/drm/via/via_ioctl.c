@@ -24,6 +24,12 @@
  * Kevin Brace <kevinbrace@bracecomputerlab.com>
  */
 
+#include <linux/dma-resv.h>
+#include <linux/jiffies.h>
+#include <linux/overflow.h>
+#include <linux/slab.h>
+#include <linux/uaccess.h>
+
 #include <drm/drm_gem.h>
 
 #include <drm/ttm/ttm_bo.h>
@@ -46,7 +52,8 @@ int via_gem_alloc_ioctl(struct drm_device *dev, void *data,
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
 
 	ret = via_bo_create(dev, &dev_priv->bdev, args->size,
-				ttm_bo_type_device, args->domain, false, &bo);
+				ttm_bo_type_device, args->domain, false, false,
+				&bo);
 	if (ret) {
 		goto exit;
 	}
@@ -56,7 +63,7 @@ int via_gem_alloc_ioctl(struct drm_device *dev, void *data,
 	ret = drm_gem_handle_create(file_priv, &ttm_bo->base, &handle);
 	drm_gem_object_put(&ttm_bo->base);
 	if (ret) {
-		via_bo_destroy(bo, false);
+		/* Dropping the last reference above freed the buffer. */
 		goto exit;
 	}
 
@@ -69,6 +76,103 @@ exit:
 	return ret;
 }
 
+/*
+ * Allocate every BO first and only then create the handles, so a
+ * failure part way through only has to drop references. Handles
+ * already created are deleted again if the results cannot be copied
+ * back, so userspace never sees a partial batch.
+ */
+int via_gem_alloc_batch_ioctl(struct drm_device *dev, void *data,
+				struct drm_file *file_priv)
+{
+	struct drm_via_gem_alloc_batch *args = data;
+	struct drm_via_gem_alloc __user *uentries =
+				u64_to_user_ptr(args->entries);
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct drm_via_gem_alloc *entries;
+	struct ttm_buffer_object *ttm_bo;
+	struct via_bo **bos;
+	unsigned int created = 0, handles = 0;
+	unsigned int i;
+	int ret = 0;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	if ((!args->count) || (args->count > VIA_GEM_ALLOC_BATCH_MAX) ||
+		(args->pad)) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	entries = kvmalloc_array(args->count, sizeof(*entries), GFP_KERNEL);
+	bos = kvcalloc(args->count, sizeof(*bos), GFP_KERNEL);
+	if ((!entries) || (!bos)) {
+		ret = -ENOMEM;
+		goto free;
+	}
+
+	if (copy_from_user(entries, uentries,
+				array_size(args->count, sizeof(*entries)))) {
+		ret = -EFAULT;
+		goto free;
+	}
+
+	for (i = 0; i < args->count; i++) {
+		if ((!entries[i].size) || (entries[i].domain > TTM_PL_VRAM)) {
+			ret = -EINVAL;
+			goto free;
+		}
+	}
+
+	for (created = 0; created < args->count; created++) {
+		ret = via_bo_create(dev, &dev_priv->bdev,
+					entries[created].size,
+					ttm_bo_type_device,
+					entries[created].domain,
+					false, false, &bos[created]);
+		if (ret) {
+			goto put;
+		}
+	}
+
+	for (handles = 0; handles < args->count; handles++) {
+		ttm_bo = &bos[handles]->ttm_bo;
+		ret = drm_gem_handle_create(file_priv, &ttm_bo->base,
+						&entries[handles].handle);
+		if (ret) {
+			goto delete;
+		}
+
+		entries[handles].size = ttm_bo->base.size;
+		entries[handles].domain = ttm_bo->resource->placement;
+		entries[handles].offset =
+				ttm_bo->resource->start << PAGE_SHIFT;
+	}
+
+	if (copy_to_user(uentries, entries,
+				array_size(args->count, sizeof(*entries)))) {
+		ret = -EFAULT;
+		goto delete;
+	}
+
+	goto put;
+delete:
+	while (handles--) {
+		drm_gem_handle_delete(file_priv, entries[handles].handle);
+	}
+put:
+	/* The handles, if any, now hold the only references. */
+	while (created--) {
+		drm_gem_object_put(&bos[created]->ttm_bo.base);
+	}
+free:
+	kvfree(bos);
+	kvfree(entries);
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return ret;
+}
+
 int via_gem_mmap_ioctl(struct drm_device *dev, void *data,
 			struct drm_file *file_priv)
 {
@@ -92,3 +196,134 @@ exit:
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
 	return ret;
 }
+
+/*
+ * Wait for the fences of the given usage on a BO. A timeout of 0
+ * only polls.
+ */
+static int via_gem_wait_idle(struct drm_gem_object *gem,
+				enum dma_resv_usage usage, s64 timeout_ns)
+{
+	long timeout;
+	long ret;
+
+	if (!timeout_ns) {
+		return dma_resv_test_signaled(gem->resv, usage) ? 0 : -EBUSY;
+	}
+
+	if (timeout_ns < 0) {
+		timeout = MAX_SCHEDULE_TIMEOUT;
+	} else {
+		timeout = clamp_t(u64, nsecs_to_jiffies(timeout_ns),
+					1, MAX_SCHEDULE_TIMEOUT - 1);
+	}
+
+	ret = dma_resv_wait_timeout(gem->resv, usage, true, timeout);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret ? 0 : -ETIME;
+}
+
+int via_gem_wait_ioctl(struct drm_device *dev, void *data,
+			struct drm_file *file_priv)
+{
+	struct drm_via_gem_wait *args = data;
+	struct drm_gem_object *gem;
+	enum dma_resv_usage usage;
+	int ret;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	if (args->flags & ~VIA_GEM_WAIT_WRITE) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	gem = drm_gem_object_lookup(file_priv, args->handle);
+	if (!gem) {
+		ret = -ENOENT;
+		goto exit;
+	}
+
+	usage = (args->flags & VIA_GEM_WAIT_WRITE) ?
+			DMA_RESV_USAGE_WRITE : DMA_RESV_USAGE_BOOKKEEP;
+	ret = via_gem_wait_idle(gem, usage, args->timeout_ns);
+	drm_gem_object_put(gem);
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return ret;
+}
+
+int via_gem_cpu_prep_ioctl(struct drm_device *dev, void *data,
+				struct drm_file *file_priv)
+{
+	struct drm_via_gem_cpu_prep *args = data;
+	struct drm_gem_object *gem;
+	bool write;
+	int ret;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	if ((args->flags & ~(VIA_GEM_CPU_PREP_READ |
+				VIA_GEM_CPU_PREP_WRITE |
+				VIA_GEM_CPU_PREP_NOWAIT)) ||
+		(!(args->flags & (VIA_GEM_CPU_PREP_READ |
+					VIA_GEM_CPU_PREP_WRITE)))) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	gem = drm_gem_object_lookup(file_priv, args->handle);
+	if (!gem) {
+		ret = -ENOENT;
+		goto exit;
+	}
+
+	/*
+	 * Reading only has to wait for writers, writing has to wait
+	 * for readers too. Fences the kernel adds for moves and
+	 * clears are waited for either way.
+	 */
+	write = args->flags & VIA_GEM_CPU_PREP_WRITE;
+	ret = via_gem_wait_idle(gem, dma_resv_usage_rw(write),
+				(args->flags & VIA_GEM_CPU_PREP_NOWAIT) ?
+					0 : args->timeout_ns);
+	drm_gem_object_put(gem);
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return ret;
+}
+
+int via_gem_cpu_fini_ioctl(struct drm_device *dev, void *data,
+				struct drm_file *file_priv)
+{
+	struct drm_via_gem_cpu_fini *args = data;
+	struct drm_gem_object *gem;
+	int ret = 0;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	if (args->pad) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	gem = drm_gem_object_lookup(file_priv, args->handle);
+	if (!gem) {
+		ret = -ENOENT;
+		goto exit;
+	}
+
+	/*
+	 * The hardware never snoops the CPU caches, it only reads
+	 * VRAM, which is mapped write-combined. Drain the
+	 * write-combining buffers so the 2D engine sees the writes.
+	 */
+	wmb();
+	drm_gem_object_put(gem);
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return ret;
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+#include <linux/interrupt.h>
+#include <linux/ktime.h>
+#include <linux/pci.h>
+
+#include <drm/drm_crtc.h>
+#include <drm/drm_modes.h>
+#include <drm/drm_print.h>
+#include <drm/drm_probe_helper.h>
+#include <drm/drm_vblank.h>
+
+#include "via_drv.h"
+
+
+/*
+ * Each IGA has its own vertical blank source in VIA_REG_INTERRUPT:
+ * bits 19 and 3 for IGA1, which also needs CR11[5:4], and bits 17 and
+ * 15 for IGA2.
+ */
+static const u32 via_vblank_enable[VIA_MAX_CRTC] = {
+	VIA_IRQ_VBLANK_ENABLE,
+	VIA_IRQ_IGA2_VBLANK_ENABLE,
+};
+
+static const u32 via_vblank_pending[VIA_MAX_CRTC] = {
+	VIA_IRQ_VBLANK_PENDING,
+	VIA_IRQ_IGA2_VBLANK_PENDING,
+};
+
+#define VIA_IRQ_VBLANK_ALL_ENABLE	(VIA_IRQ_VBLANK_ENABLE | \
+					VIA_IRQ_IGA2_VBLANK_ENABLE)
+#define VIA_IRQ_VBLANK_ALL_PENDING	(VIA_IRQ_VBLANK_PENDING | \
+					VIA_IRQ_IGA2_VBLANK_PENDING)
+
+int via_enable_vblank(struct drm_crtc *crtc)
+{
+	struct drm_device *dev = crtc->dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_crtc *iga = container_of(crtc, struct via_crtc, base);
+	u32 bits = via_vblank_enable[iga->index] |
+			via_vblank_pending[iga->index];
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev_priv->irq_lock, flags);
+
+	/*
+	 * Writing the pending bit back clears it, so that a stale
+	 * event does not fire right away.
+	 */
+	VIA_WRITE(VIA_REG_INTERRUPT,
+			(VIA_READ(VIA_REG_INTERRUPT) &
+			~VIA_IRQ_VBLANK_ALL_PENDING) |
+			VIA_IRQ_GLOBAL | bits);
+	if (!iga->index) {
+		svga_wcrt_mask(VGASHADOW, 0x11, BIT(5) | BIT(4),
+				BIT(5) | BIT(4));
+	}
+
+	spin_unlock_irqrestore(&dev_priv->irq_lock, flags);
+
+	return 0;
+}
+
+void via_disable_vblank(struct drm_crtc *crtc)
+{
+	struct drm_device *dev = crtc->dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_crtc *iga = container_of(crtc, struct via_crtc, base);
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev_priv->irq_lock, flags);
+	if (!iga->index) {
+		svga_wcrt_mask(VGASHADOW, 0x11, 0x00, BIT(5) | BIT(4));
+	}
+
+	VIA_WRITE(VIA_REG_INTERRUPT,
+			VIA_READ(VIA_REG_INTERRUPT) &
+			~(VIA_IRQ_VBLANK_ALL_PENDING |
+			via_vblank_enable[iga->index]));
+	spin_unlock_irqrestore(&dev_priv->irq_lock, flags);
+}
+
+/*
+ * There is no readable scanline counter for either IGA, so the
+ * scanout position based timestamp helper cannot be used. The
+ * interrupt is raised at the start of vertical sync instead; take
+ * the time as early as possible in the handler and move it forward
+ * to the end of vertical blank with the line duration of the mode.
+ * The offset is only as good as a whole line, which is what gets
+ * reported as the error.
+ */
+bool via_get_vblank_timestamp(struct drm_crtc *crtc, int *max_error,
+				ktime_t *vblank_time, bool in_vblank_irq)
+{
+	struct drm_device *dev = crtc->dev;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct drm_vblank_crtc *vblank = &dev->vblank[drm_crtc_index(crtc)];
+	const struct drm_display_mode *mode = &vblank->hwmode;
+	int lines;
+
+	if ((!in_vblank_irq) || (!vblank->linedur_ns)) {
+		return false;
+	}
+
+	lines = mode->crtc_vtotal - mode->crtc_vsync_start;
+	*max_error = vblank->linedur_ns;
+	*vblank_time = ktime_add_ns(
+				dev_priv->vblank_irq_time[drm_crtc_index(crtc)],
+					(u64)lines * vblank->linedur_ns);
+	return true;
+}
+
+static void via_hotplug_work_func(struct work_struct *work)
+{
+	struct via_drm_priv *dev_priv = container_of(work,
+						struct via_drm_priv,
+						hotplug_work);
+
+	drm_helper_hpd_irq_event(&dev_priv->dev);
+}
+
+/*
+ * The integrated HDMI/DP transmitter latches plug and unplug events
+ * in AUX_TIMER_REG[31:30] and raises them on the device interrupt.
+ * The connectors are still polled, so this only reprobes them sooner.
+ * Detection sleeps, so it is left to a work item. Called with
+ * irq_lock held.
+ */
+static bool via_hotplug_irq(struct via_drm_priv *dev_priv)
+{
+	u32 status;
+
+	if (!dev_priv->hpd_enabled) {
+		return false;
+	}
+
+	status = VIA_READ(AUX_TIMER_REG) & VIA_IRQ_DP_HOT_IRQ;
+	if (!status) {
+		return false;
+	}
+
+	/* Event bits are cleared by writing them back. */
+	VIA_WRITE_MASK(AUX_TIMER_REG, status, VIA_IRQ_DP_HOT_IRQ);
+	WRITE_ONCE(dev_priv->hpd_status, status);
+	schedule_work(&dev_priv->hotplug_work);
+	return true;
+}
+
+/*
+ * Unmasks the plug and unplug events of the integrated HDMI/DP
+ * transmitter, and the device interrupt they are raised on, and
+ * starts checking for them in via_irq_handler(). The caller must
+ * have installed the interrupt handler.
+ */
+void via_hotplug_irq_enable(struct via_drm_priv *dev_priv)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev_priv->irq_lock, flags);
+
+	/*
+	 * Writing latched event bits back clears them, so that an
+	 * event from before the handler was ready does not fire.
+	 */
+	VIA_WRITE(AUX_TIMER_REG,
+			VIA_READ(AUX_TIMER_REG) | VIA_IRQ_DP_HOT_ENABLE);
+	VIA_WRITE(VIA_REG_INTERRUPT,
+			(VIA_READ(VIA_REG_INTERRUPT) &
+			~VIA_IRQ_VBLANK_ALL_PENDING) |
+			VIA_IRQ_GLOBAL);
+	dev_priv->hpd_enabled = true;
+
+	spin_unlock_irqrestore(&dev_priv->irq_lock, flags);
+}
+
+/*
+ * Acknowledges the pending vertical blank events of the enabled IGAs,
+ * and returns them as a mask of CRTC indices. Called with irq_lock
+ * held.
+ */
+static unsigned int via_vblank_irq(struct via_drm_priv *dev_priv)
+{
+	unsigned int crtcs = 0, i;
+	u32 status;
+
+	status = VIA_READ(VIA_REG_INTERRUPT);
+	for (i = 0; i < VIA_MAX_CRTC; i++) {
+		if ((status & via_vblank_enable[i]) &&
+			(status & via_vblank_pending[i])) {
+			crtcs |= BIT(i);
+		}
+	}
+
+	if (status & VIA_IRQ_VBLANK_ALL_PENDING) {
+		/* Pending bits are cleared by writing them back. */
+		VIA_WRITE(VIA_REG_INTERRUPT, status);
+	}
+
+	return crtcs;
+}
+
+static irqreturn_t via_irq_handler(int irq, void *arg)
+{
+	struct drm_device *dev = arg;
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	ktime_t now = ktime_get();
+	unsigned int crtcs, i;
+	bool hotplug;
+
+	spin_lock(&dev_priv->irq_lock);
+	hotplug = via_hotplug_irq(dev_priv);
+	crtcs = via_vblank_irq(dev_priv);
+	spin_unlock(&dev_priv->irq_lock);
+
+	if (!crtcs) {
+		return hotplug ? IRQ_HANDLED : IRQ_NONE;
+	}
+
+	for (i = 0; i < VIA_MAX_CRTC; i++) {
+		if (crtcs & BIT(i)) {
+			dev_priv->vblank_irq_time[i] = now;
+			drm_crtc_handle_vblank(drm_crtc_from_index(dev, i));
+		}
+	}
+
+	return IRQ_HANDLED;
+}
+
+static void via_irq_mask(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev_priv->irq_lock, flags);
+	VIA_WRITE_MASK(VIA_REG_INTERRUPT, VIA_IRQ_VBLANK_ALL_PENDING,
+			VIA_IRQ_VBLANK_ALL_ENABLE |
+			VIA_IRQ_VBLANK_ALL_PENDING);
+
+	/* Only chips with the integrated transmitter have AUX_TIMER_REG. */
+	if (dev_priv->hpd_enabled) {
+		VIA_WRITE_MASK(AUX_TIMER_REG, 0x00, VIA_IRQ_DP_HOT_ENABLE);
+		dev_priv->hpd_enabled = false;
+	}
+
+	spin_unlock_irqrestore(&dev_priv->irq_lock, flags);
+}
+
+int via_irq_init(struct drm_device *dev)
+{
+	struct pci_dev *pdev = to_pci_dev(dev->dev);
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	int ret;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	spin_lock_init(&dev_priv->irq_lock);
+	dev_priv->irq_enabled = false;
+	dev_priv->hpd_enabled = false;
+	dev_priv->hpd_status = VIA_IRQ_DP_NO_INT;
+	INIT_WORK(&dev_priv->hotplug_work, via_hotplug_work_func);
+
+	ret = drm_vblank_init(dev, VIA_MAX_CRTC);
+	if (ret) {
+		drm_err(dev, "Failed to initialize vertical blank!\n");
+		goto exit;
+	}
+
+	/*
+	 * Leave the source masked, and any stale pending status
+	 * cleared, until the first drm_crtc_vblank_get().
+	 */
+	via_irq_mask(dev);
+
+	ret = request_irq(pdev->irq, via_irq_handler, IRQF_SHARED,
+				dev->driver->name, dev);
+	if (ret) {
+		drm_err(dev, "Failed to request IRQ %d!\n", pdev->irq);
+		goto exit;
+	}
+
+	dev_priv->irq_enabled = true;
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return ret;
+}
+
+void via_irq_fini(struct drm_device *dev)
+{
+	struct pci_dev *pdev = to_pci_dev(dev->dev);
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	if (!dev_priv->irq_enabled) {
+		goto exit;
+	}
+
+	via_irq_mask(dev);
+	free_irq(pdev->irq, dev);
+	cancel_work_sync(&dev_priv->hotplug_work);
+	dev_priv->irq_enabled = false;
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_irq_test.c"
+#endif
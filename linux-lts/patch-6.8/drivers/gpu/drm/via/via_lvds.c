@@ -105,14 +105,14 @@ static void via_init_td_timing_regs(struct drm_device *dev)
 
 		timings.count = ARRAY_SIZE(td_timer_regs[i].tdRegs);
 		timings.regs = td_timer_regs[i].tdRegs;
-		load_value_to_registers(VGABASE, &timings, reg_value);
+		load_value_to_registers(VGASHADOW, &timings, reg_value);
 	}
 
 	/* Note: VT3353 have two hardware power sequences
 	 * other chips only have one hardware power sequence */
 	if (pdev->device == PCI_DEVICE_ID_VIA_CHROME9_HC3) {
 		/* set CRD4[0] to "1" to select 2nd LCD power sequence. */
-		svga_wcrt_mask(VGABASE, 0xD4, BIT(0), BIT(0));
+		svga_wcrt_mask(VGASHADOW, 0xD4, BIT(0), BIT(0));
 		/* Fill secondary power sequence */
 		for (i = 0; i < 4; i++) {
 			/* Calculate TD Timer, every step is 572.1uSec */
@@ -120,50 +120,11 @@ static void via_init_td_timing_regs(struct drm_device *dev)
 
 			timings.count = ARRAY_SIZE(td_timer_regs[i].tdRegs);
 			timings.regs = td_timer_regs[i].tdRegs;
-			load_value_to_registers(VGABASE, &timings, reg_value);
+			load_value_to_registers(VGASHADOW, &timings, reg_value);
 		}
 	}
 }
 
-static bool via_fp_probe_edid(struct drm_device *dev,
-				struct i2c_adapter *i2c_bus)
-{
-	u8 out = 0x0;
-	u8 buf[8];
-	struct i2c_msg msgs[] = {
-		{
-			.addr = DDC_ADDR,
-			.flags = 0,
-			.len = 1,
-			.buf = &out,
-		},
-		{
-			.addr = DDC_ADDR,
-			.flags = I2C_M_RD,
-			.len = 8,
-			.buf = buf,
-		}
-	};
-	int i2c_ret;
-	bool ret = false;
-
-	drm_dbg_kms(dev, "Entered %s.\n", __func__);
-
-	i2c_ret = i2c_transfer(i2c_bus, msgs, 2);
-	if (i2c_ret != 2) {
-		goto exit;
-	}
-
-	if (drm_edid_header_is_valid(buf) < 6) {
-		goto exit;
-	}
-
-	ret = true;
-exit:
-	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
-	return ret;
-}
-
 static void via_lvds_cle266_soft_power_seq(struct drm_device *dev,
 						bool power_state)
 {
@@ -176,43 +137,43 @@ static void via_lvds_cle266_soft_power_seq(struct drm_device *dev,
 		mdelay(25);
 
 		/* Turn on FP VDD rail. */
-		via_lvds_set_primary_soft_vdd(VGABASE, true);
+		via_lvds_set_primary_soft_vdd(VGASHADOW, true);
 
 		/* Wait for 510 ms. */
 		mdelay(510);
 
 		/* Turn on FP data transmission. */
-		via_lvds_set_primary_soft_data(VGABASE, true);
+		via_lvds_set_primary_soft_data(VGASHADOW, true);
 
 		/* Wait for 1 ms. */
 		mdelay(1);
 
 		/* Turn on FP VEE rail. */
-		via_lvds_set_primary_soft_vee(VGABASE, true);
+		via_lvds_set_primary_soft_vee(VGASHADOW, true);
 
 		/* Turn on FP back light. */
-		via_lvds_set_primary_soft_back_light(VGABASE, true);
+		via_lvds_set_primary_soft_back_light(VGASHADOW, true);
 	} else {
 		/* Wait for 1 ms. */
 		mdelay(1);
 
 		/* Turn off FP back light. */
-		via_lvds_set_primary_soft_back_light(VGABASE, false);
+		via_lvds_set_primary_soft_back_light(VGASHADOW, false);
 
 		/* Turn off FP VEE rail. */
-		via_lvds_set_primary_soft_vee(VGABASE, false);
+		via_lvds_set_primary_soft_vee(VGASHADOW, false);
 
 		/* Wait for 510 ms. */
 		mdelay(510);
 
 		/* Turn off FP data transmission. */
-		via_lvds_set_primary_soft_data(VGABASE, false);
+		via_lvds_set_primary_soft_data(VGASHADOW, false);
 
 		/* Wait for 25 ms. */
 		mdelay(25);
 
 		/* Turn off FP VDD rail. */
-		via_lvds_set_primary_soft_vdd(VGABASE, false);
+		via_lvds_set_primary_soft_vdd(VGASHADOW, false);
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -226,62 +187,62 @@ static void via_lvds_primary_soft_power_seq(struct drm_device *dev,
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	/* Turn off FP hardware power sequence. */
-	via_lvds_set_primary_hard_power(VGABASE, false);
+	via_lvds_set_primary_hard_power(VGASHADOW, false);
 
 	/* Use software FP power sequence control. */
-	via_lvds_set_primary_power_seq_type(VGABASE, false);
+	via_lvds_set_primary_power_seq_type(VGASHADOW, false);
 
 	if (power_state) {
 		/* Turn on FP display period. */
-		via_lvds_set_primary_direct_display_period(VGABASE, true);
+		via_lvds_set_primary_direct_display_period(VGASHADOW, true);
 
 		/* Wait for TD0 ms. */
 		mdelay(TD0);
 
 		/* Turn on FP VDD rail. */
-		via_lvds_set_primary_soft_vdd(VGABASE, true);
+		via_lvds_set_primary_soft_vdd(VGASHADOW, true);
 
 		/* Wait for TD1 ms. */
 		mdelay(TD1);
 
 		/* Turn on FP data transmission. */
-		via_lvds_set_primary_soft_data(VGABASE, true);
+		via_lvds_set_primary_soft_data(VGASHADOW, true);
 
 		/* Wait for TD2 ms. */
 		mdelay(TD2);
 
 		/* Turn on FP VEE rail. */
-		via_lvds_set_primary_soft_vee(VGABASE, true);
+		via_lvds_set_primary_soft_vee(VGASHADOW, true);
 
 		/* Wait for TD3 ms. */
 		mdelay(TD3);
 
 		/* Turn on FP back light. */
-		via_lvds_set_primary_soft_back_light(VGABASE, true);
+		via_lvds_set_primary_soft_back_light(VGASHADOW, true);
 	} else {
 		/* Turn off FP back light. */
-		via_lvds_set_primary_soft_back_light(VGABASE, false);
+		via_lvds_set_primary_soft_back_light(VGASHADOW, false);
 
 		/* Wait for TD3 ms. */
 		mdelay(TD3);
 
 		/* Turn off FP VEE rail. */
-		via_lvds_set_primary_soft_vee(VGABASE, false);
+		via_lvds_set_primary_soft_vee(VGASHADOW, false);
 
 		/* Wait for TD2 ms. */
 		mdelay(TD2);
 
 		/* Turn off FP data transmission. */
-		via_lvds_set_primary_soft_data(VGABASE, false);
+		via_lvds_set_primary_soft_data(VGASHADOW, false);
 
 		/* Wait for TD1 ms. */
 		mdelay(TD1);
 
 		/* Turn off FP VDD rail. */
-		via_lvds_set_primary_soft_vdd(VGABASE, false);
+		via_lvds_set_primary_soft_vdd(VGASHADOW, false);
 
 		/* Turn off FP display period. */
-		via_lvds_set_primary_direct_display_period(VGABASE, false);
+		via_lvds_set_primary_direct_display_period(VGASHADOW, false);
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -295,62 +256,62 @@ static void via_lvds_secondary_soft_power_seq(struct drm_device *dev,
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	/* Turn off FP hardware power sequence. */
-	via_lvds_set_secondary_hard_power(VGABASE, false);
+	via_lvds_set_secondary_hard_power(VGASHADOW, false);
 
 	/* Use software FP power sequence control. */
-	via_lvds_set_secondary_power_seq_type(VGABASE, false);
+	via_lvds_set_secondary_power_seq_type(VGASHADOW, false);
 
 	if (power_state) {
 		/* Turn on FP display period. */
-		via_lvds_set_secondary_direct_display_period(VGABASE, true);
+		via_lvds_set_secondary_direct_display_period(VGASHADOW, true);
 
 		/* Wait for TD0 ms. */
 		mdelay(TD0);
 
 		/* Turn on FP VDD rail. */
-		via_lvds_set_secondary_soft_vdd(VGABASE, true);
+		via_lvds_set_secondary_soft_vdd(VGASHADOW, true);
 
 		/* Wait for TD1 ms. */
 		mdelay(TD1);
 
 		/* Turn on FP data transmission. */
-		via_lvds_set_secondary_soft_data(VGABASE, true);
+		via_lvds_set_secondary_soft_data(VGASHADOW, true);
 
 		/* Wait for TD2 ms. */
 		mdelay(TD2);
 
 		/* Turn on FP VEE rail. */
-		via_lvds_set_secondary_soft_vee(VGABASE, true);
+		via_lvds_set_secondary_soft_vee(VGASHADOW, true);
 
 		/* Wait for TD3 ms. */
 		mdelay(TD3);
 
 		/* Turn on FP back light. */
-		via_lvds_set_secondary_soft_back_light(VGABASE, true);
+		via_lvds_set_secondary_soft_back_light(VGASHADOW, true);
 	} else {
 		/* Turn off FP back light. */
-		via_lvds_set_secondary_soft_back_light(VGABASE, false);
+		via_lvds_set_secondary_soft_back_light(VGASHADOW, false);
 
 		/* Wait for TD3 ms. */
 		mdelay(TD3);
 
 		/* Turn off FP VEE rail. */
-		via_lvds_set_secondary_soft_vee(VGABASE, false);
+		via_lvds_set_secondary_soft_vee(VGASHADOW, false);
 
 		/* Wait for TD2 ms. */
 		mdelay(TD2);
 
 		/* Turn off FP data transmission. */
-		via_lvds_set_secondary_soft_data(VGABASE, false);
+		via_lvds_set_secondary_soft_data(VGASHADOW, false);
 
 		/* Wait for TD1 ms. */
 		mdelay(TD1);
 
 		/* Turn off FP VDD rail. */
-		via_lvds_set_secondary_soft_vdd(VGABASE, false);
+		via_lvds_set_secondary_soft_vdd(VGASHADOW, false);
 
 		/* Turn off FP display period. */
-		via_lvds_set_secondary_direct_display_period(VGABASE, false);
+		via_lvds_set_secondary_direct_display_period(VGASHADOW, false);
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -364,26 +325,26 @@ static void via_lvds_primary_hard_power_seq(struct drm_device *dev,
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	/* Use hardware FP power sequence control. */
-	via_lvds_set_primary_power_seq_type(VGABASE, true);
+	via_lvds_set_primary_power_seq_type(VGASHADOW, true);
 
 	if (power_state) {
 		/* Turn on FP display period. */
-		via_lvds_set_primary_direct_display_period(VGABASE, true);
+		via_lvds_set_primary_direct_display_period(VGASHADOW, true);
 
 		/* Turn on FP hardware power sequence. */
-		via_lvds_set_primary_hard_power(VGABASE, true);
+		via_lvds_set_primary_hard_power(VGASHADOW, true);
 
 		/* Turn on FP back light. */
-		via_lvds_set_primary_direct_back_light_ctrl(VGABASE, true);
+		via_lvds_set_primary_direct_back_light_ctrl(VGASHADOW, true);
 	} else {
 		/* Turn off FP back light. */
-		via_lvds_set_primary_direct_back_light_ctrl(VGABASE, false);
+		via_lvds_set_primary_direct_back_light_ctrl(VGASHADOW, false);
 
 		/* Turn off FP hardware power sequence. */
-		via_lvds_set_primary_hard_power(VGABASE, false);
+		via_lvds_set_primary_hard_power(VGASHADOW, false);
 
 		/* Turn on FP display period. */
-		via_lvds_set_primary_direct_display_period(VGABASE, false);
+		via_lvds_set_primary_direct_display_period(VGASHADOW, false);
 	}
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
@@ -414,19 +375,19 @@ static void via_lvds_power(struct drm_device *dev,
 	case PCI_DEVICE_ID_VIA_CHROME9_HC3:
 		if (di_port & VIA_DI_PORT_LVDS1) {
 			via_lvds_primary_soft_power_seq(dev, power_state);
-			via_lvds1_set_power(VGABASE, power_state);
+			via_lvds1_set_power(VGASHADOW, power_state);
 		}
 
 		if (di_port & VIA_DI_PORT_LVDS2) {
 			via_lvds_secondary_soft_power_seq(dev, power_state);
-			via_lvds2_set_power(VGABASE, power_state);
+			via_lvds2_set_power(VGASHADOW, power_state);
 		}
 
 		break;
 	case PCI_DEVICE_ID_VIA_CHROME9_HCM:
 	case PCI_DEVICE_ID_VIA_CHROME9_HD:
 		via_lvds_primary_hard_power_seq(dev, power_state);
-		via_lvds1_set_power(VGABASE, power_state);
+		via_lvds1_set_power(VGASHADOW, power_state);
 		break;
 	default:
 		drm_dbg_kms(dev, "VIA Technologies Chrome IGP "
@@ -450,32 +411,32 @@ static void via_lvds_io_pad_setting(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DVP0:
-		via_dvp0_set_io_pad_state(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_dvp0_set_io_pad_state(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_DVP1:
-		via_dvp1_set_io_pad_state(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_dvp1_set_io_pad_state(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_FPDPLOW:
-		via_fpdp_low_set_io_pad_state(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_fpdp_low_set_io_pad_state(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_FPDPHIGH:
-		via_fpdp_high_set_io_pad_state(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_fpdp_high_set_io_pad_state(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case (VIA_DI_PORT_FPDPLOW |
 		VIA_DI_PORT_FPDPHIGH):
-		via_fpdp_low_set_io_pad_state(VGABASE, io_pad_on ? 0x03 : 0x00);
-		via_fpdp_high_set_io_pad_state(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_fpdp_low_set_io_pad_state(VGASHADOW, io_pad_on ? 0x03 : 0x00);
+		via_fpdp_high_set_io_pad_state(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_io_pad_setting(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_lvds1_set_io_pad_setting(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_io_pad_setting(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_lvds2_set_io_pad_setting(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_io_pad_setting(VGABASE, io_pad_on ? 0x03 : 0x00);
-		via_lvds2_set_io_pad_setting(VGABASE, io_pad_on ? 0x03 : 0x00);
+		via_lvds1_set_io_pad_setting(VGASHADOW, io_pad_on ? 0x03 : 0x00);
+		via_lvds2_set_io_pad_setting(VGASHADOW, io_pad_on ? 0x03 : 0x00);
 		break;
 	default:
 		break;
@@ -496,15 +457,15 @@ static void via_lvds_format(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_format(VGABASE, temp);
+		via_lvds1_set_format(VGASHADOW, temp);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_format(VGABASE, temp);
+		via_lvds2_set_format(VGASHADOW, temp);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_format(VGABASE, temp);
-		via_lvds2_set_format(VGABASE, temp);
+		via_lvds1_set_format(VGASHADOW, temp);
+		via_lvds2_set_format(VGASHADOW, temp);
 		break;
 	default:
 		break;
@@ -523,15 +484,15 @@ static void via_lvds_output_format(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_output_format(VGABASE, temp);
+		via_lvds1_set_output_format(VGASHADOW, temp);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_output_format(VGABASE, temp);
+		via_lvds2_set_output_format(VGASHADOW, temp);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_output_format(VGABASE, temp);
-		via_lvds2_set_output_format(VGABASE, temp);
+		via_lvds1_set_output_format(VGASHADOW, temp);
+		via_lvds2_set_output_format(VGASHADOW, temp);
 		break;
 	default:
 		break;
@@ -549,15 +510,15 @@ static void via_lvds_dithering(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_dithering(VGABASE, dithering);
+		via_lvds1_set_dithering(VGASHADOW, dithering);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_dithering(VGABASE, dithering);
+		via_lvds2_set_dithering(VGASHADOW, dithering);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_dithering(VGABASE, dithering);
-		via_lvds2_set_dithering(VGABASE, dithering);
+		via_lvds1_set_dithering(VGASHADOW, dithering);
+		via_lvds2_set_dithering(VGASHADOW, dithering);
 		break;
 	default:
 		break;
@@ -579,34 +540,34 @@ static void via_lvds_display_source(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DVP0:
-		via_dvp0_set_display_source(VGABASE, display_source);
+		via_dvp0_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_DVP1:
-		via_dvp1_set_display_source(VGABASE, display_source);
+		via_dvp1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_FPDPLOW:
-		via_fpdp_low_set_display_source(VGABASE, display_source);
-		via_dvp1_set_display_source(VGABASE, display_source);
+		via_fpdp_low_set_display_source(VGASHADOW, display_source);
+		via_dvp1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_FPDPHIGH:
-		via_fpdp_high_set_display_source(VGABASE, display_source);
-		via_dvp0_set_display_source(VGABASE, display_source);
+		via_fpdp_high_set_display_source(VGASHADOW, display_source);
+		via_dvp0_set_display_source(VGASHADOW, display_source);
 		break;
 	case (VIA_DI_PORT_FPDPLOW |
 		VIA_DI_PORT_FPDPHIGH):
-		via_fpdp_low_set_display_source(VGABASE, display_source);
-		via_fpdp_high_set_display_source(VGABASE, display_source);
+		via_fpdp_low_set_display_source(VGASHADOW, display_source);
+		via_fpdp_high_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_display_source(VGABASE, display_source);
+		via_lvds1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_display_source(VGABASE, display_source);
+		via_lvds2_set_display_source(VGASHADOW, display_source);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_display_source(VGABASE, display_source);
-		via_lvds2_set_display_source(VGABASE, display_source);
+		via_lvds1_set_display_source(VGASHADOW, display_source);
+		via_lvds2_set_display_source(VGASHADOW, display_source);
 		break;
 	default:
 		break;
@@ -687,7 +648,7 @@ via_lvds_mode_set(struct drm_encoder *encoder, struct drm_display_mode *mode,
 	/* Temporary implementation.*/
 	switch (pdev->device) {
 	case PCI_DEVICE_ID_VIA_CHROME9_HC:
-		via_fpdp_low_set_adjustment(VGABASE, 0x08);
+		via_fpdp_low_set_adjustment(VGASHADOW, 0x08);
 		break;
 	default:
 		break;
@@ -782,12 +743,7 @@ via_lvds_detect(struct drm_connector *connector, bool force)
 			continue;
 		}
 
-		if (!via_fp_probe_edid(dev, i2c_bus)) {
-			i2c_bus_bit = i2c_bus_bit << 1;
-			continue;
-		}
-
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (edid->input & DRM_EDID_INPUT_DIGITAL) {
 				ret = connector_status_connected;
@@ -809,7 +765,7 @@ via_lvds_detect(struct drm_connector *connector, bool force)
 		mask = BIT(1);
 	}
 
-	if (vga_rcrt(VGABASE, 0x3B) & mask) {
+	if (via_vga_rcrt(VGASHADOW, 0x3B) & mask) {
 		ret = connector_status_connected;
 	}
 
@@ -888,7 +844,7 @@ via_lvds_get_modes(struct drm_connector *connector)
 			continue;
 		}
 
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (edid->input & DRM_EDID_INPUT_DIGITAL) {
 				drm_connector_update_edid_property(connector, edid);
@@ -905,7 +861,7 @@ via_lvds_get_modes(struct drm_connector *connector)
 		i2c_bus_bit = i2c_bus_bit << 1;
 	}
 
-	reg_value = (vga_rcrt(VGABASE, 0x3f) & 0x0f);
+	reg_value = (via_vga_rcrt(VGASHADOW, 0x3f) & 0x0f);
 	hdisplay = vdisplay = 0;
 	hdisplay = via_lvds_info_table[reg_value].x;
 	vdisplay = via_lvds_info_table[reg_value].y;
@@ -949,7 +905,7 @@ void via_lvds_probe(struct drm_device *dev)
 
 	sr12 = vga_rseq(VGABASE, 0x12);
 	sr13 = vga_rseq(VGABASE, 0x13);
-	cr3b = vga_rcrt(VGABASE, 0x3b);
+	cr3b = via_vga_rcrt(VGASHADOW, 0x3b);
 
 	drm_dbg_kms(dev, "sr12: 0x%02x\n", sr12);
 	drm_dbg_kms(dev, "sr13: 0x%02x\n", sr13);
@@ -1032,7 +988,7 @@ void via_lvds_probe(struct drm_device *dev)
 		/* Set SR5A[0] to 1.
 		 * This allows the read out of the alternative
 		 * pin strapping settings from SR12 and SR13. */
-		svga_wseq_mask(VGABASE, 0x5a, BIT(0), BIT(0));
+		svga_wseq_mask(VGASHADOW, 0x5a, BIT(0), BIT(0));
 
 		sr13 = vga_rseq(VGABASE, 0x13);
 		if (cr3b & BIT(1)) {
@@ -1101,7 +1057,7 @@ void via_lvds_probe(struct drm_device *dev)
 		}
 
 		/* Restore SR5A. */
-		vga_wseq(VGABASE, 0x5a, sr5a);
+		via_vga_wseq(VGASHADOW, 0x5a, sr5a);
 		break;
 	default:
 		dev_priv->int_fp1_presence = false;
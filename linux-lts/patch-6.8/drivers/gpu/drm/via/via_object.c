@@ -31,12 +31,17 @@
  *
  */
 
+#include <linux/dma-buf.h>
+#include <linux/mm.h>
+
 #include <drm/drm_file.h>
 #include <drm/drm_gem.h>
 #include <drm/drm_gem_ttm_helper.h>
+#include <drm/drm_prime.h>
 
 #include <drm/ttm/ttm_bo.h>
 #include <drm/ttm/ttm_range_manager.h>
+#include <drm/ttm/ttm_tt.h>
 
 #include "via_drv.h"
 
@@ -54,6 +59,102 @@ static void via_gem_free(struct drm_gem_object *obj)
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
 }
 
+/*
+ * Offer a buffer to the cache when its last handle is closed. A
+ * buffer with a flink name or a dma-buf can still be reached without
+ * a handle, so it is left alone. object_name_lock keeps a handle from
+ * being opened on the buffer meanwhile.
+ */
+static void via_gem_close(struct drm_gem_object *obj,
+				struct drm_file *file)
+{
+	struct ttm_buffer_object *ttm_bo = container_of(obj,
+				struct ttm_buffer_object, base);
+	struct drm_device *dev = obj->dev;
+
+	mutex_lock(&dev->object_name_lock);
+	if ((obj->handle_count == 1) && (!obj->name) && (!obj->dma_buf)) {
+		via_bo_cache_put(to_ttm_bo(ttm_bo));
+	}
+
+	mutex_unlock(&dev->object_name_lock);
+}
+
+static int via_gem_mmap(struct drm_gem_object *obj,
+				struct vm_area_struct *vma)
+{
+	int ret;
+
+	if (!obj->import_attach) {
+		return drm_gem_ttm_mmap(obj, vma);
+	}
+
+	/*
+	 * TTM refuses to fault in imported pages, so the mapping is
+	 * handed to the exporter. Clear vm_ops and vm_private_data so
+	 * ours are not left behind if the exporter does not set them.
+	 */
+	vma->vm_private_data = NULL;
+	vma->vm_ops = NULL;
+	ret = dma_buf_mmap(obj->dma_buf, vma, 0);
+
+	/* Drop the reference drm_gem_mmap_obj() took for our vm_ops. */
+	if (!ret) {
+		drm_gem_object_put(obj);
+	}
+
+	return ret;
+}
+
+/*
+ * Exported buffers are pinned in TT while attached, since the
+ * importer gets the pages behind them. Without a GART nothing else
+ * can reach VRAM, so buffers held in VRAM for scanout cannot be
+ * exported.
+ */
+static int via_gem_prime_pin(struct drm_gem_object *obj)
+{
+	struct ttm_buffer_object *ttm_bo = container_of(obj,
+				struct ttm_buffer_object, base);
+	struct via_bo *bo = to_ttm_bo(ttm_bo);
+	int ret;
+
+	ret = ttm_bo_reserve(ttm_bo, true, false, NULL);
+	if (ret) {
+		return ret;
+	}
+
+	ret = via_bo_pin(bo, TTM_PL_TT);
+	ttm_bo_unreserve(ttm_bo);
+	return ret;
+}
+
+static void via_gem_prime_unpin(struct drm_gem_object *obj)
+{
+	struct ttm_buffer_object *ttm_bo = container_of(obj,
+				struct ttm_buffer_object, base);
+
+	if (ttm_bo_reserve(ttm_bo, false, false, NULL)) {
+		return;
+	}
+
+	via_bo_unpin(to_ttm_bo(ttm_bo));
+	ttm_bo_unreserve(ttm_bo);
+}
+
+static struct sg_table *via_gem_prime_get_sg_table(struct drm_gem_object *obj)
+{
+	struct ttm_buffer_object *ttm_bo = container_of(obj,
+				struct ttm_buffer_object, base);
+
+	if ((!ttm_bo->ttm) || (!ttm_tt_is_populated(ttm_bo->ttm))) {
+		return ERR_PTR(-EINVAL);
+	}
+
+	return drm_prime_pages_to_sg(obj->dev, ttm_bo->ttm->pages,
+					ttm_bo->ttm->num_pages);
+}
+
 static const struct vm_operations_struct via_ttm_bo_vm_ops = {
 	.fault = ttm_bo_vm_fault,
 	.open = ttm_bo_vm_open,
@@ -63,9 +164,13 @@ static const struct vm_operations_struct via_ttm_bo_vm_ops = {
 
 static const struct drm_gem_object_funcs via_gem_object_funcs = {
 	.free = via_gem_free,
+	.close = via_gem_close,
+	.pin = via_gem_prime_pin,
+	.unpin = via_gem_prime_unpin,
+	.get_sg_table = via_gem_prime_get_sg_table,
 	.vmap = drm_gem_ttm_vmap,
 	.vunmap = drm_gem_ttm_vunmap,
-	.mmap = drm_gem_ttm_mmap,
+	.mmap = via_gem_mmap,
 	.vm_ops = &via_ttm_bo_vm_ops,
 };
 
@@ -100,12 +205,20 @@ void via_ttm_domain_to_placement(struct via_bo *bo,
 		bo->placements[i].fpfn = 0;
 		bo->placements[i].lpfn = 0;
 		bo->placements[i].mem_type = TTM_PL_VRAM;
-		bo->placements[i].flags = 0;
+		bo->placements[i].flags = bo->scanout ?
+						TTM_PL_FLAG_TOPDOWN : 0;
 		i++;
 	}
 
 	bo->placement.num_placement = i;
 
+	/*
+	 * Let TTM evict other buffers to make room when none of
+	 * the placements have free space left.
+	 */
+	bo->placement.busy_placement = bo->placements;
+	bo->placement.num_busy_placement = i;
+
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
 }
 
@@ -118,6 +231,10 @@ void via_ttm_bo_destroy(struct ttm_buffer_object *tbo)
 
 	bo = to_ttm_bo(tbo);
 
+	if (tbo->base.import_attach) {
+		drm_prime_gem_destroy(&tbo->base, tbo->sg);
+	}
+
 	drm_gem_object_release(&tbo->base);
 	kfree(bo);
 
@@ -133,10 +250,34 @@ int via_bo_pin(struct via_bo *bo, uint32_t ttm_domain)
 
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
 
+	/*
+	 * An existing pin keeps the buffer where it is. A buffer pinned
+	 * in TT for a PRIME export cannot be scanned out of VRAM, and
+	 * a scanout buffer cannot be exported.
+	 */
 	if (ttm_bo->pin_count) {
+		if (ttm_bo->resource->mem_type != ttm_domain) {
+			ret = -EBUSY;
+			goto exit;
+		}
+
 		goto pin;
 	}
 
+	/*
+	 * Imported pages stay with the exporter. Copying them into
+	 * VRAM for scanout would cut the buffer off from its producer.
+	 */
+	if ((ttm_bo->type == ttm_bo_type_sg) && (ttm_domain == TTM_PL_VRAM)) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	/* Only scanout and cursor buffers get pinned in VRAM. */
+	if (ttm_domain == TTM_PL_VRAM) {
+		bo->scanout = true;
+	}
+
 	via_ttm_domain_to_placement(bo, ttm_domain);
 	ret = ttm_bo_validate(ttm_bo, &bo->placement, &ctx);
 	if (ret) {
@@ -168,6 +309,7 @@ int via_bo_create(struct drm_device *dev,
 			uint64_t size,
 			enum ttm_bo_type type,
 			uint32_t ttm_domain,
+			bool scanout,
 			bool kmap,
 			struct via_bo **bo_ptr)
 {
@@ -178,6 +320,27 @@ int via_bo_create(struct drm_device *dev,
 
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
 
+	/*
+	 * It is an imperative to page align the requested buffer size
+	 * prior to a memory allocation request, or various memory
+	 * allocation related system instabilities may occur.
+	 */
+	size = ALIGN(size, PAGE_SIZE);
+
+	/*
+	 * Reuse an idle buffer of the same size if one was recently
+	 * freed. Kernel mapped buffers are pinned for their lifetime,
+	 * so they are never cached.
+	 */
+	if ((type == ttm_bo_type_device) && (!kmap)) {
+		bo = via_bo_cache_get(dev, size, ttm_domain, scanout);
+		if (bo) {
+			*bo_ptr = bo;
+			ret = 0;
+			goto exit;
+		}
+	}
+
 	bo = kzalloc(sizeof(*bo), GFP_KERNEL);
 	if (!bo) {
 		drm_err(dev, "Cannot allocate a TTM buffer object!\n");
@@ -186,13 +349,8 @@ int via_bo_create(struct drm_device *dev,
 	}
 
 	ttm_bo = &bo->ttm_bo;
-
-	/*
-	 * It is an imperative to page align the requested buffer size
-	 * prior to a memory allocation request, or various memory
-	 * allocation related system instabilities may occur.
-	 */
-	size = ALIGN(size, PAGE_SIZE);
+	INIT_LIST_HEAD(&bo->cache_head);
+	INIT_LIST_HEAD(&bo->cache_lru);
 
 	ret = drm_gem_object_init(dev, &ttm_bo->base, size);
 	if (ret) {
@@ -202,6 +360,21 @@ int via_bo_create(struct drm_device *dev,
 
 	ttm_bo->base.funcs = &via_gem_object_funcs;
 
+	/*
+	 * CPU mappings of VRAM, most of all software rendered scanout
+	 * buffers, are written sequentially and rarely read back, so
+	 * they are write-combined. Without a GART the GPU never reads
+	 * TT or system pages, so buffers meant for those are cached.
+	 */
+	if (ttm_domain == TTM_PL_VRAM) {
+		bo->caching = ttm_write_combined;
+	} else {
+		bo->caching = ttm_cached;
+	}
+
+	bo->scanout = scanout || kmap;
+	bo->domain = ttm_domain;
+
 	via_ttm_domain_to_placement(bo, ttm_domain);
 	ret = ttm_bo_init_validate(&dev_priv->bdev, ttm_bo,
 				type, &bo->placement,
@@ -243,6 +416,60 @@ exit:
 	return ret;
 }
 
+/*
+ * Wrap the pages of a dma-buf from another device in a TT buffer.
+ * It shares the exporter's reservation object, so fences attached
+ * by either side are seen by both.
+ */
+struct drm_gem_object *via_gem_prime_import_sg_table(struct drm_device *dev,
+					struct dma_buf_attachment *attach,
+					struct sg_table *sg)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct dma_resv *resv = attach->dmabuf->resv;
+	struct drm_gem_object *gem;
+	struct ttm_buffer_object *ttm_bo;
+	struct via_bo *bo;
+	int ret;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	bo = kzalloc(sizeof(*bo), GFP_KERNEL);
+	if (!bo) {
+		gem = ERR_PTR(-ENOMEM);
+		goto exit;
+	}
+
+	ttm_bo = &bo->ttm_bo;
+	INIT_LIST_HEAD(&bo->cache_head);
+	INIT_LIST_HEAD(&bo->cache_lru);
+
+	drm_gem_private_object_init(dev, &ttm_bo->base, attach->dmabuf->size);
+	ttm_bo->base.funcs = &via_gem_object_funcs;
+
+	bo->caching = ttm_cached;
+	bo->domain = TTM_PL_TT;
+
+	via_ttm_domain_to_placement(bo, TTM_PL_TT);
+	dma_resv_lock(resv, NULL);
+	ret = ttm_bo_init_validate(&dev_priv->bdev, ttm_bo,
+				ttm_bo_type_sg, &bo->placement,
+				PAGE_SIZE >> PAGE_SHIFT, false,
+				sg, resv, via_ttm_bo_destroy);
+	dma_resv_unlock(resv);
+	if (ret) {
+		/* TTM already freed the buffer through its destroy hook. */
+		drm_err(dev, "Cannot initialize an imported TTM object!\n");
+		gem = ERR_PTR(ret);
+		goto exit;
+	}
+
+	gem = &ttm_bo->base;
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return gem;
+}
+
 void via_bo_destroy(struct via_bo *bo, bool kmap)
 {
 	struct ttm_buffer_object *ttm_bo = &bo->ttm_bo;
@@ -294,17 +521,48 @@ int via_mm_init(struct drm_device *dev)
 	}
 
 	/*
-	 * Initialize TTM range manager for VRAM management.
+	 * Initialize the buddy allocator based VRAM manager.
 	 */
-	ret = ttm_range_man_init(&dev_priv->bdev, TTM_PL_VRAM, false,
-					dev_priv->vram_size >> PAGE_SHIFT);
+	ret = via_vram_mgr_init(dev_priv);
 	if (ret) {
 		drm_err(dev, "Failed initializing TTM VRAM memory manager!\n");
 		goto error_ttm_range_man;
 	}
 
+	/*
+	 * Initialize TTM range manager for TT. There is no GART, so
+	 * TT buffers are just populated system pages the CPU can map.
+	 * It is where VRAM gets evicted to, and is limited to half of
+	 * the system memory, like the TTM page pool.
+	 */
+	ret = ttm_range_man_init(&dev_priv->bdev, TTM_PL_TT, true,
+					totalram_pages() / 2);
+	if (ret) {
+		drm_err(dev, "Failed initializing TTM TT memory manager!\n");
+		goto error_ttm_range_man_tt;
+	}
+
+	ret = via_bo_cache_init(dev);
+	if (ret) {
+		drm_err(dev, "Failed initializing buffer object cache!\n");
+		goto error_bo_cache;
+	}
+
+	ret = via_suballoc_init(dev);
+	if (ret) {
+		drm_err(dev, "Failed initializing small object VRAM "
+				"slab!\n");
+		goto error_suballoc;
+	}
+
 	via_ttm_debugfs_init(dev);
 	goto exit;
+error_suballoc:
+	via_bo_cache_fini(dev);
+error_bo_cache:
+	ttm_range_man_fini(&dev_priv->bdev, TTM_PL_TT);
+error_ttm_range_man_tt:
+	via_vram_mgr_fini(dev_priv);
 error_ttm_range_man:
 	ttm_device_fini(&dev_priv->bdev);
 exit:
@@ -318,7 +576,10 @@ void via_mm_fini(struct drm_device *dev)
 
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
 
-	ttm_range_man_fini(&dev_priv->bdev, TTM_PL_VRAM);
+	via_suballoc_fini(dev);
+	via_bo_cache_fini(dev);
+	ttm_range_man_fini(&dev_priv->bdev, TTM_PL_TT);
+	via_vram_mgr_fini(dev_priv);
 
 	ttm_device_fini(&dev_priv->bdev);
 
@@ -74,11 +74,11 @@ int via_dev_pm_ops_suspend(struct device *dev)
 	 * Their values need to be saved because they get lost
 	 * when resuming from standby.
 	 */
-	dev_priv->saved_cr3b = vga_rcrt(VGABASE, 0x3b);
-	dev_priv->saved_cr3c = vga_rcrt(VGABASE, 0x3c);
-	dev_priv->saved_cr3d = vga_rcrt(VGABASE, 0x3d);
-	dev_priv->saved_cr3e = vga_rcrt(VGABASE, 0x3e);
-	dev_priv->saved_cr3f = vga_rcrt(VGABASE, 0x3f);
+	dev_priv->saved_cr3b = via_vga_rcrt(VGASHADOW, 0x3b);
+	dev_priv->saved_cr3c = via_vga_rcrt(VGASHADOW, 0x3c);
+	dev_priv->saved_cr3d = via_vga_rcrt(VGASHADOW, 0x3d);
+	dev_priv->saved_cr3e = via_vga_rcrt(VGASHADOW, 0x3e);
+	dev_priv->saved_cr3f = via_vga_rcrt(VGASHADOW, 0x3f);
 
 	console_unlock();
 
@@ -115,6 +115,12 @@ int via_dev_pm_ops_resume(struct device *dev)
 
 	console_lock();
 
+	/*
+	 * Register contents are undefined after resuming from standby,
+	 * so the shadow copy can no longer be trusted.
+	 */
+	via_vga_shadow_invalidate(&dev_priv->vga_shadow);
+
 	val = ioread8(regs + 0x03);
 	iowrite8(val | 0x1, regs + 0x03);
 	val = ioread8(regs + 0x0C);
@@ -148,18 +154,18 @@ int via_dev_pm_ops_resume(struct device *dev)
 	if ((pdev->device == PCI_DEVICE_ID_VIA_CHROME9_HC3) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_CHROME9_HCM) ||
 		(pdev->device == PCI_DEVICE_ID_VIA_CHROME9_HD)) {
-		vga_wseq(VGABASE, 0x14, dev_priv->saved_sr14);
-
-		vga_wseq(VGABASE, 0x66, dev_priv->saved_sr66);
-		vga_wseq(VGABASE, 0x67, dev_priv->saved_sr67);
-		vga_wseq(VGABASE, 0x68, dev_priv->saved_sr68);
-		vga_wseq(VGABASE, 0x69, dev_priv->saved_sr69);
-		vga_wseq(VGABASE, 0x6a, dev_priv->saved_sr6a);
-		vga_wseq(VGABASE, 0x6b, dev_priv->saved_sr6b);
-		vga_wseq(VGABASE, 0x6c, dev_priv->saved_sr6c);
-		vga_wseq(VGABASE, 0x6d, dev_priv->saved_sr6d);
-		vga_wseq(VGABASE, 0x6e, dev_priv->saved_sr6e);
-		vga_wseq(VGABASE, 0x6f, dev_priv->saved_sr6f);
+		via_vga_wseq(VGASHADOW, 0x14, dev_priv->saved_sr14);
+
+		via_vga_wseq(VGASHADOW, 0x66, dev_priv->saved_sr66);
+		via_vga_wseq(VGASHADOW, 0x67, dev_priv->saved_sr67);
+		via_vga_wseq(VGASHADOW, 0x68, dev_priv->saved_sr68);
+		via_vga_wseq(VGASHADOW, 0x69, dev_priv->saved_sr69);
+		via_vga_wseq(VGASHADOW, 0x6a, dev_priv->saved_sr6a);
+		via_vga_wseq(VGASHADOW, 0x6b, dev_priv->saved_sr6b);
+		via_vga_wseq(VGASHADOW, 0x6c, dev_priv->saved_sr6c);
+		via_vga_wseq(VGASHADOW, 0x6d, dev_priv->saved_sr6d);
+		via_vga_wseq(VGASHADOW, 0x6e, dev_priv->saved_sr6e);
+		via_vga_wseq(VGASHADOW, 0x6f, dev_priv->saved_sr6f);
 	}
 
 	/*
@@ -168,11 +174,16 @@ int via_dev_pm_ops_resume(struct device *dev)
 	 * Their values need to be restored because they are undefined
 	 * after resuming from standby.
 	 */
-	vga_wcrt(VGABASE, 0x3b, dev_priv->saved_cr3b);
-	vga_wcrt(VGABASE, 0x3c, dev_priv->saved_cr3c);
-	vga_wcrt(VGABASE, 0x3d, dev_priv->saved_cr3d);
-	vga_wcrt(VGABASE, 0x3e, dev_priv->saved_cr3e);
-	vga_wcrt(VGABASE, 0x3f, dev_priv->saved_cr3f);
+	via_vga_wcrt(VGASHADOW, 0x3b, dev_priv->saved_cr3b);
+	via_vga_wcrt(VGASHADOW, 0x3c, dev_priv->saved_cr3c);
+	via_vga_wcrt(VGASHADOW, 0x3d, dev_priv->saved_cr3d);
+	via_vga_wcrt(VGASHADOW, 0x3e, dev_priv->saved_cr3e);
+	via_vga_wcrt(VGASHADOW, 0x3f, dev_priv->saved_cr3f);
+
+	/* The hotplug interrupt enables do not survive standby. */
+	if (dev_priv->hpd_enabled) {
+		via_hotplug_irq_enable(dev_priv);
+	}
 
 	console_unlock();
 
@@ -100,6 +100,13 @@
 #define VIA_REG_INTERRUPT	0x200
 #define VIA_REG_CRTCSTART	0x214
 
+/* VIA_REG_INTERRUPT */
+#define VIA_IRQ_GLOBAL		BIT(31)	/* master interrupt enable */
+#define VIA_IRQ_VBLANK_ENABLE	BIT(19)	/* IGA1 vertical blank */
+#define VIA_IRQ_VBLANK_PENDING	BIT(3)	/* write 1 to clear */
+#define VIA_IRQ_IGA2_VBLANK_PENDING	BIT(15)	/* write 1 to clear */
+#define VIA_IRQ_IGA2_VBLANK_ENABLE	BIT(17)	/* IGA2 vertical blank */
+
 /*CN400 and older Hardware Icon engine register*/
 #define HI_POSSTART		0x208
 #define HI_CENTEROFFSET		0x20C
@@ -240,6 +247,7 @@
 #define VIA_IRQ_DP_HOT_UNPLUG	0x80000000
 #define VIA_IRQ_DP_HOT_PLUG	0x40000000
 #define VIA_IRQ_DP_NO_INT	0x00000000
+#define VIA_IRQ_DP_HOT_ENABLE	0x30000000
 
 #define AUX_TIMER_REG		0xC730
 #define AUX_CMD_REG		0xC734
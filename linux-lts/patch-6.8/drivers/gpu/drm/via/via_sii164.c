@@ -383,6 +383,8 @@ static enum drm_connector_status via_sii164_detect(
 		drm_dbg_kms(dev, "DVI detected.\n");
 	}
 
+	via_connector_hotplug_sense(con, ret == connector_status_connected);
+
 exit:
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 	return ret;
@@ -479,7 +481,7 @@ static int via_sii164_get_modes(struct drm_connector *connector)
 		goto exit;
 	}
 
-	edid = drm_get_edid(&con->base, i2c_bus);
+	edid = via_connector_get_edid(con, i2c_bus);
 	if (edid) {
 		if (edid->input & DRM_EDID_INPUT_DIGITAL) {
 			drm_connector_update_edid_property(connector, edid);
@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+#include <linux/debugfs.h>
+#include <linux/kref.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+
+#include <drm/drm_mm.h>
+#include <drm/drm_print.h>
+
+#include <drm/ttm/ttm_bo.h>
+
+#include "via_drv.h"
+
+
+/*
+ * Every TTM buffer takes at least a page of VRAM, and being a buddy
+ * block, rounds up to a power of two number of pages. Objects only a
+ * few KiB in size, such as the hardware cursor images, are instead
+ * carved out of a single pinned slab. Unlike drm_suballoc, which
+ * waits for space to be freed, an allocation that does not fit
+ * fails right away, so callers can fall back to a buffer of their
+ * own.
+ */
+
+/*
+ * Allocate size bytes of VRAM aligned to align bytes from the slab.
+ * Returns an ERR_PTR() on failure.
+ */
+struct via_suballoc *via_suballoc_new(struct drm_device *dev, u64 size,
+					u64 align)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_suballoc_mgr *mgr = &dev_priv->suballoc;
+	struct via_suballoc *sa;
+	int ret;
+
+	if (!mgr->bo) {
+		return ERR_PTR(-ENODEV);
+	}
+
+	sa = kzalloc(sizeof(*sa), GFP_KERNEL);
+	if (!sa) {
+		return ERR_PTR(-ENOMEM);
+	}
+
+	mutex_lock(&mgr->lock);
+	ret = drm_mm_insert_node_generic(&mgr->mm, &sa->node, size, align,
+						0, DRM_MM_INSERT_BEST);
+	mutex_unlock(&mgr->lock);
+	if (ret) {
+		kfree(sa);
+		return ERR_PTR(ret);
+	}
+
+	kref_init(&sa->ref);
+	sa->dev = dev;
+	return sa;
+}
+
+struct via_suballoc *via_suballoc_get(struct via_suballoc *sa)
+{
+	kref_get(&sa->ref);
+	return sa;
+}
+
+static void via_suballoc_release(struct kref *ref)
+{
+	struct via_suballoc *sa = container_of(ref, struct via_suballoc,
+						ref);
+	struct via_drm_priv *dev_priv = to_via_drm_priv(sa->dev);
+	struct via_suballoc_mgr *mgr = &dev_priv->suballoc;
+
+	mutex_lock(&mgr->lock);
+	drm_mm_remove_node(&sa->node);
+	mutex_unlock(&mgr->lock);
+	kfree(sa);
+}
+
+void via_suballoc_put(struct via_suballoc *sa)
+{
+	kref_put(&sa->ref, via_suballoc_release);
+}
+
+/* VRAM offset of the allocation, as programmed into the hardware. */
+u64 via_suballoc_offset(struct via_suballoc *sa)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(sa->dev);
+	struct ttm_buffer_object *ttm_bo = &dev_priv->suballoc.bo->ttm_bo;
+
+	return ((u64)ttm_bo->resource->start << PAGE_SHIFT) + sa->node.start;
+}
+
+void __iomem *via_suballoc_cpu_addr(struct via_suballoc *sa)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(sa->dev);
+	bool is_iomem;
+
+	return (u8 __iomem *)ttm_kmap_obj_virtual(&dev_priv->suballoc.bo->kmap,
+							&is_iomem) +
+		sa->node.start;
+}
+
+#if defined(CONFIG_DEBUG_FS)
+static int via_suballoc_show(struct seq_file *m, void *unused)
+{
+	struct via_suballoc_mgr *mgr = m->private;
+	struct drm_printer p = drm_seq_file_printer(m);
+
+	mutex_lock(&mgr->lock);
+	drm_mm_print(&mgr->mm, &p);
+	mutex_unlock(&mgr->lock);
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(via_suballoc);
+#endif
+
+void via_suballoc_debugfs_init(struct via_drm_priv *dev_priv,
+				struct dentry *root)
+{
+#if defined(CONFIG_DEBUG_FS)
+	if (!dev_priv->suballoc.bo) {
+		return;
+	}
+
+	debugfs_create_file("via_suballoc", 0444, root,
+				&dev_priv->suballoc, &via_suballoc_fops);
+#endif
+}
+
+int via_suballoc_init(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_suballoc_mgr *mgr = &dev_priv->suballoc;
+	int ret;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	mutex_init(&mgr->lock);
+	ret = via_bo_create(dev, &dev_priv->bdev, VIA_SUBALLOC_SIZE,
+				ttm_bo_type_kernel, TTM_PL_VRAM, true, true,
+				&mgr->bo);
+	if (ret) {
+		mgr->bo = NULL;
+		goto exit;
+	}
+
+	drm_mm_init(&mgr->mm, 0, VIA_SUBALLOC_SIZE);
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+	return ret;
+}
+
+void via_suballoc_fini(struct drm_device *dev)
+{
+	struct via_drm_priv *dev_priv = to_via_drm_priv(dev);
+	struct via_suballoc_mgr *mgr = &dev_priv->suballoc;
+
+	drm_dbg_driver(dev, "Entered %s.\n", __func__);
+
+	if (!mgr->bo) {
+		goto exit;
+	}
+
+	drm_mm_takedown(&mgr->mm);
+	via_bo_destroy(mgr->bo, true);
+	mgr->bo = NULL;
+exit:
+	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
+}
@@ -43,13 +43,13 @@ static void via_tmds_power(struct drm_device *dev, bool power_state)
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	if (power_state) {
-		via_lvds1_set_soft_display_period(VGABASE, true);
-		via_lvds1_set_soft_data(VGABASE, true);
-		via_tmds_set_power(VGABASE, true);
+		via_lvds1_set_soft_display_period(VGASHADOW, true);
+		via_lvds1_set_soft_data(VGASHADOW, true);
+		via_tmds_set_power(VGASHADOW, true);
 	} else {
-		via_tmds_set_power(VGABASE, false);
-		via_lvds1_set_soft_data(VGABASE, false);
-		via_lvds1_set_soft_display_period(VGABASE, false);
+		via_tmds_set_power(VGASHADOW, false);
+		via_lvds1_set_soft_data(VGASHADOW, false);
+		via_lvds1_set_soft_display_period(VGASHADOW, false);
 	}
 
 	drm_dbg_driver(dev, "DVI Power: %s\n",
@@ -67,7 +67,7 @@ static void via_tmds_io_pad_setting(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_TMDS:
-		via_lvds1_set_io_pad_setting(VGABASE,
+		via_lvds1_set_io_pad_setting(VGASHADOW,
 				io_pad_on ? 0x03 : 0x00);
 		break;
 	default:
@@ -91,21 +91,21 @@ static void via_tmds_init_reg(struct drm_device *dev)
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
 	/* Turn off hardware controlled FP power on / off circuit. */
-	via_lvds_set_primary_hard_power(VGABASE, false);
+	via_lvds_set_primary_hard_power(VGASHADOW, false);
 
 	/* Use software FP power sequence control. */
-	via_lvds_set_primary_power_seq_type(VGABASE, false);
+	via_lvds_set_primary_power_seq_type(VGASHADOW, false);
 
 	/* Turn off software controlled primary FP power rails. */
-	via_lvds_set_primary_soft_vdd(VGABASE, false);
-	via_lvds_set_primary_soft_vee(VGABASE, false);
+	via_lvds_set_primary_soft_vdd(VGASHADOW, false);
+	via_lvds_set_primary_soft_vee(VGASHADOW, false);
 
 	/* Turn off software controlled primary FP back light
 	* control. */
-	via_lvds_set_primary_soft_back_light(VGABASE, false);
+	via_lvds_set_primary_soft_back_light(VGASHADOW, false);
 
 	/* Turn off direct control of FP back light. */
-	via_lvds_set_primary_direct_back_light_ctrl(VGABASE, false);
+	via_lvds_set_primary_direct_back_light_ctrl(VGASHADOW, false);
 
 	/* Activate DVI + LVDS2 mode. */
 	/* 3X5.D2[5:4] - Display Channel Select
@@ -113,7 +113,7 @@ static void via_tmds_init_reg(struct drm_device *dev)
 	 *               01: DVI + LVDS2
 	 *               10: One Dual LVDS Channel (High Resolution Pannel)
 	 *               11: Single Channel DVI */
-	svga_wcrt_mask(VGABASE, 0xd2, 0x10, 0x30);
+	svga_wcrt_mask(VGASHADOW, 0xd2, 0x10, 0x30);
 
 	/* Various DVI PLL settings should be set to default settings. */
 	/* 3X5.D1[7]   - PLL2 Reference Clock Edge Select Bit
@@ -126,7 +126,7 @@ static void via_tmds_init_reg(struct drm_device *dev)
 	 *               11: ICH = 50.0 uA
 	 * 3X5.D1[4:1] - Reserved
 	 * 3X5.D1[0]   - PLL2 Control Voltage Measurement Enable Bit */
-	svga_wcrt_mask(VGABASE, 0xd1, 0x00, 0xe1);
+	svga_wcrt_mask(VGASHADOW, 0xd1, 0x00, 0xe1);
 
 	/* Disable DVI test mode. */
 	/* 3X5.D5[7] - PD1 Enable Selection
@@ -136,18 +136,18 @@ static void via_tmds_init_reg(struct drm_device *dev)
 	 * 3X5.D5[4] - DVI Testing Format Selection
 	 *             0: Half cycle
 	 *             1: LFSR mode */
-	svga_wcrt_mask(VGABASE, 0xd5, 0x00, 0xb0);
+	svga_wcrt_mask(VGASHADOW, 0xd5, 0x00, 0xb0);
 
 	/* Disable DVI sense interrupt. */
 	/* 3C5.2B[7] - DVI Sense Interrupt Enable
 	 *             0: Disable
 	 *             1: Enable */
-	svga_wseq_mask(VGABASE, 0x2b, 0x00, 0x80);
+	svga_wseq_mask(VGASHADOW, 0x2b, 0x00, 0x80);
 
 	/* Clear DVI sense interrupt status. */
 	/* 3C5.2B[6] - DVI Sense Interrupt Status
 	 *             (This bit has a RW1C attribute.) */
-	svga_wseq_mask(VGABASE, 0x2b, 0x40, 0x40);
+	svga_wseq_mask(VGASHADOW, 0x2b, 0x40, 0x40);
 
 	drm_dbg_kms(dev, "Exiting %s.\n", __func__);
 }
@@ -172,7 +172,7 @@ static void via_tmds_sync_polarity(struct drm_device *dev,
 		syncPolarity |= BIT(1);
 	}
 
-	via_tmds_set_sync_polarity(VGABASE, syncPolarity);
+	via_tmds_set_sync_polarity(VGASHADOW, syncPolarity);
 	drm_dbg_driver(dev, "TMDS (DVI) Horizontal Sync Polarity: %s\n",
 		(syncPolarity & BIT(0)) ? "-" : "+");
 	drm_dbg_driver(dev, "TMDS (DVI) Vertical Sync Polarity: %s\n",
@@ -191,7 +191,7 @@ static void via_tmds_display_source(struct drm_device *dev, int index)
 
 	drm_dbg_kms(dev, "Entered %s.\n", __func__);
 
-	via_tmds_set_display_source(VGABASE, displaySource & 0x01);
+	via_tmds_set_display_source(VGASHADOW, displaySource & 0x01);
 	drm_dbg_driver(dev, "TMDS (DVI) Display Source: IGA%d\n",
 			(displaySource & 0x01) + 1);
 
@@ -338,7 +338,7 @@ static enum drm_connector_status via_tmds_detect(
 	}
 
 	if (i2c_bus) {
-		edid = drm_get_edid(&con->base, i2c_bus);
+		edid = via_connector_get_edid(con, i2c_bus);
 		if (edid) {
 			if (edid->input & DRM_EDID_INPUT_DIGITAL) {
 				drm_connector_update_edid_property(connector, edid);
@@ -435,8 +435,8 @@ static int via_tmds_get_modes(struct drm_connector *connector)
 	}
 
 	if (i2c_bus) {
-		edid = drm_get_edid(&con->base, i2c_bus);
-		if (edid->input & DRM_EDID_INPUT_DIGITAL) {
+		edid = via_connector_get_edid(con, i2c_bus);
+		if ((edid) && (edid->input & DRM_EDID_INPUT_DIGITAL)) {
 			drm_connector_update_edid_property(connector,
 								edid);
 			count = drm_add_edid_modes(connector, edid);
@@ -476,12 +476,12 @@ void via_tmds_probe(struct drm_device *dev)
 		/* Setting SR5A[0] to 1.
 		 * This allows the reading out the alternative
 		 * pin strapping information from SR12 and SR13. */
-		svga_wseq_mask(VGABASE, 0x5a, BIT(0), BIT(0));
+		svga_wseq_mask(VGASHADOW, 0x5a, BIT(0), BIT(0));
 
 		sr13 = vga_rseq(VGABASE, 0x13);
 		drm_dbg_kms(dev, "sr13: 0x%02x\n", sr13);
 
-		vga_wseq(VGABASE, 0x5a, sr5a);
+		via_vga_wseq(VGASHADOW, 0x5a, sr5a);
 
 		/* 3C5.13[7:6] - Integrated LVDS / DVI Mode Select
 		 *               (DVP1D15-14 pin strapping)
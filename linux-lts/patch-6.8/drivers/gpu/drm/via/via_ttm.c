@@ -32,13 +32,16 @@
  */
 
 #include <linux/dcache.h>
+#include <linux/dma-fence.h>
 #include <linux/pci.h>
 
 #include <drm/drm_debugfs.h>
 #include <drm/drm_file.h>
+#include <drm/drm_prime.h>
 #include <drm/drm_print.h>
 
 #include <drm/ttm/ttm_bo.h>
+#include <drm/ttm/ttm_pool.h>
 #include <drm/ttm/ttm_tt.h>
 
 #include "via_drv.h"
@@ -55,6 +58,21 @@ static void via_bo_move_notify(struct ttm_buffer_object *bo, bool evict,
 	return;
 }
 
+/*
+ * Caching mode chosen for the buffer when it was created, used for
+ * both its VRAM io mappings and its ttm_tt pages. Buffers not
+ * created by this driver get the fallback.
+ */
+static enum ttm_caching via_bo_caching(struct ttm_buffer_object *bo,
+					enum ttm_caching fallback)
+{
+	if ((!bo) || (bo->destroy != &via_ttm_bo_destroy)) {
+		return fallback;
+	}
+
+	return to_ttm_bo(bo)->caching;
+}
+
 static struct ttm_tt *via_ttm_tt_create(struct ttm_buffer_object *bo,
 					uint32_t page_flags)
 {
@@ -65,7 +83,8 @@ static struct ttm_tt *via_ttm_tt_create(struct ttm_buffer_object *bo,
 	if (!tt)
 		return NULL;
 
-	ret = ttm_tt_init(tt, bo, page_flags, ttm_cached, 0);
+	ret = ttm_tt_init(tt, bo, page_flags,
+				via_bo_caching(bo, ttm_cached), 0);
 	if (ret < 0)
 		goto err_ttm_tt_init;
 
@@ -76,6 +95,32 @@ err_ttm_tt_init:
 	return NULL;
 }
 
+/*
+ * Pages of an imported dma-buf belong to the exporter. They are
+ * looked up from its sg table, never allocated or freed here.
+ */
+static int via_ttm_tt_populate(struct ttm_device *bdev,
+				struct ttm_tt *tt,
+				struct ttm_operation_ctx *ctx)
+{
+	if (tt->page_flags & TTM_TT_FLAG_EXTERNAL) {
+		return drm_prime_sg_to_page_array(tt->sg, tt->pages,
+							tt->num_pages);
+	}
+
+	return ttm_pool_alloc(&bdev->pool, tt, ctx);
+}
+
+static void via_ttm_tt_unpopulate(struct ttm_device *bdev,
+					struct ttm_tt *tt)
+{
+	if (tt->page_flags & TTM_TT_FLAG_EXTERNAL) {
+		return;
+	}
+
+	ttm_pool_free(&bdev->pool, tt);
+}
+
 static void via_ttm_tt_destroy(struct ttm_device *bdev, struct ttm_tt *tt)
 {
 	ttm_tt_fini(tt);
@@ -87,35 +132,89 @@ static void via_bo_evict_flags(struct ttm_buffer_object *bo,
 {
 	struct drm_device *dev = bo->base.dev;
 	struct via_bo *driver_bo = to_ttm_bo(bo);
+	unsigned int i = 0;
 
 	drm_dbg_driver(dev, "Entered %s.\n", __func__);
 
-	if (bo->destroy == &via_ttm_bo_destroy) {
+	if (bo->destroy != &via_ttm_bo_destroy) {
 		goto exit;
 	}
 
-	switch (bo->resource->mem_type) {
-	case TTM_PL_VRAM:
-		via_ttm_domain_to_placement(driver_bo, TTM_PL_VRAM);
-		break;
-	default:
-		via_ttm_domain_to_placement(driver_bo, TTM_PL_SYSTEM);
-		break;
+	/*
+	 * Nobody owns the contents of a buffer parked in the buffer
+	 * object cache, so rather than being moved it is left with an
+	 * empty placement, and TTM just drops its backing store.
+	 */
+	if (READ_ONCE(driver_bo->cached)) {
+		placement->num_placement = 0;
+		placement->num_busy_placement = 0;
+		goto exit;
 	}
 
+	/*
+	 * VRAM is evicted to TT, or straight to SYSTEM once TT is
+	 * full. TT is evicted to SYSTEM. Pinned buffers (scanout and
+	 * cursor) are never on an LRU list, so TTM does not offer
+	 * them for eviction in the first place.
+	 */
+	if (bo->resource->mem_type == TTM_PL_VRAM) {
+		driver_bo->placements[i].fpfn = 0;
+		driver_bo->placements[i].lpfn = 0;
+		driver_bo->placements[i].mem_type = TTM_PL_TT;
+		driver_bo->placements[i].flags = 0;
+		i++;
+	}
+
+	driver_bo->placements[i].fpfn = 0;
+	driver_bo->placements[i].lpfn = 0;
+	driver_bo->placements[i].mem_type = TTM_PL_SYSTEM;
+	driver_bo->placements[i].flags = 0;
+	i++;
+
+	driver_bo->placement.placement = driver_bo->placements;
+	driver_bo->placement.num_placement = i;
+	driver_bo->placement.busy_placement = driver_bo->placements;
+	driver_bo->placement.num_busy_placement = i;
+
 	*placement = driver_bo->placement;
 exit:
 	drm_dbg_driver(dev, "Exiting %s.\n", __func__);
 }
 
+static int via_bo_move_blit(struct ttm_buffer_object *bo, bool evict,
+				struct ttm_operation_ctx *ctx,
+				struct ttm_resource *new_mem)
+{
+	struct dma_fence *fence;
+	int ret;
+
+	ret = ttm_bo_wait_ctx(bo, ctx);
+	if (ret) {
+		return ret;
+	}
+
+	ret = via_blit_copy(bo->base.dev,
+				(u64)bo->resource->start << PAGE_SHIFT,
+				(u64)new_mem->start << PAGE_SHIFT,
+				bo->base.size, &fence);
+	if (ret) {
+		return ret;
+	}
+
+	ret = ttm_bo_move_accel_cleanup(bo, fence, evict, false, new_mem);
+	dma_fence_put(fence);
+	return ret;
+}
+
 static int via_bo_move(struct ttm_buffer_object *bo, bool evict,
 			struct ttm_operation_ctx *ctx,
 			struct ttm_resource *new_mem,
 			struct ttm_place *hop)
 {
+	struct ttm_resource *old_mem = bo->resource;
 	int ret;
 
-	if (!bo->resource) {
+	if (!old_mem) {
 		if (new_mem->mem_type != TTM_PL_SYSTEM) {
 			hop->mem_type = TTM_PL_SYSTEM;
 			hop->flags = TTM_PL_FLAG_TEMPORARY;
@@ -126,8 +225,34 @@ static int via_bo_move(struct ttm_buffer_object *bo, bool evict,
 		return 0;
 	}
 
+	/*
+	 * Without a GART, SYSTEM and TT are both plain system pages,
+	 * so moving between them only changes the bookkeeping.
+	 */
+	if ((old_mem->mem_type != TTM_PL_VRAM) &&
+		(new_mem->mem_type != TTM_PL_VRAM)) {
+		via_bo_move_notify(bo, evict, new_mem);
+		ttm_bo_move_null(bo, new_mem);
+		return 0;
+	}
+
 	via_bo_move_notify(bo, evict, new_mem);
-	ret = ttm_bo_move_memcpy(bo, ctx, new_mem);
+
+	/*
+	 * Copies within VRAM go through the 2D engine, sparing the
+	 * CPU uncached reads of VRAM. Fall back to memcpy if the
+	 * engine cannot be used.
+	 */
+	ret = -ENODEV;
+	if ((old_mem->mem_type == TTM_PL_VRAM) &&
+		(new_mem->mem_type == TTM_PL_VRAM)) {
+		ret = via_bo_move_blit(bo, evict, ctx, new_mem);
+	}
+
+	if (ret == -ENODEV) {
+		ret = ttm_bo_move_memcpy(bo, ctx, new_mem);
+	}
+
 	if (ret) {
 		swap(*new_mem, *bo->resource);
 		via_bo_move_notify(bo, false, new_mem);
@@ -161,11 +286,14 @@ static int via_bo_io_mem_reserve(struct ttm_device *bdev,
 
 	switch (mem->mem_type) {
 	case TTM_PL_SYSTEM:
+	case TTM_PL_TT:
 		break;
 	case TTM_PL_VRAM:
 		mem->bus.offset = dev_priv->vram_start +
 					(mem->start << PAGE_SHIFT);
 		mem->bus.is_iomem = true;
+		mem->bus.caching = via_bo_caching(mem->bo,
+						ttm_write_combined);
 		break;
 	default:
 		ret = -EINVAL;
@@ -178,6 +306,8 @@ static int via_bo_io_mem_reserve(struct ttm_device *bdev,
 
 struct ttm_device_funcs via_bo_driver = {
 	.ttm_tt_create = via_ttm_tt_create,
+	.ttm_tt_populate = via_ttm_tt_populate,
+	.ttm_tt_unpopulate = via_ttm_tt_unpopulate,
 	.ttm_tt_destroy = via_ttm_tt_destroy,
 	.eviction_valuable = ttm_bo_eviction_valuable,
 	.evict_flags = via_bo_evict_flags,
@@ -197,5 +327,16 @@ void via_ttm_debugfs_init(struct drm_device *dev)
 								TTM_PL_VRAM),
 						debugfs_root,
 						"via_ttm_rman_vram");
+	ttm_resource_manager_create_debugfs(ttm_manager_type(&dev_priv->bdev,
+								TTM_PL_TT),
+						debugfs_root,
+						"via_ttm_rman_tt");
+	via_vram_mgr_debugfs_init(dev_priv, debugfs_root);
+	via_bo_cache_debugfs_init(dev_priv, debugfs_root);
+	via_suballoc_debugfs_init(dev_priv, debugfs_root);
 #endif
 }
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_ttm_test.c"
+#endif
@@ -37,49 +37,49 @@ void via_transmitter_io_pad_state(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DIP0:
-		via_dip0_set_io_pad_state(VGABASE,
+		via_dip0_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_DIP1:
-		via_dip1_set_io_pad_state(VGABASE,
+		via_dip1_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_DVP0:
-		via_dvp0_set_io_pad_state(VGABASE,
+		via_dvp0_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_DVP1:
-		via_dvp1_set_io_pad_state(VGABASE,
+		via_dvp1_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_FPDPLOW:
-		via_fpdp_low_set_io_pad_state(VGABASE,
+		via_fpdp_low_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_FPDPHIGH:
-		via_fpdp_high_set_io_pad_state(VGABASE,
+		via_fpdp_high_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case (VIA_DI_PORT_FPDPLOW |
 		VIA_DI_PORT_FPDPHIGH):
-		via_fpdp_low_set_io_pad_state(VGABASE,
+		via_fpdp_low_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
-		via_fpdp_high_set_io_pad_state(VGABASE,
+		via_fpdp_high_set_io_pad_state(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_io_pad_setting(VGABASE,
+		via_lvds1_set_io_pad_setting(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_io_pad_setting(VGABASE,
+		via_lvds2_set_io_pad_setting(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_io_pad_setting(VGABASE,
+		via_lvds1_set_io_pad_setting(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
-		via_lvds2_set_io_pad_setting(VGABASE,
+		via_lvds2_set_io_pad_setting(VGASHADOW,
 					io_pad_on ? 0x03 : 0x00);
 		break;
 	default:
@@ -98,10 +98,10 @@ void via_output_enable(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DIP0:
-		via_dip0_set_output_enable(VGABASE, output_enable);
+		via_dip0_set_output_enable(VGASHADOW, output_enable);
 		break;
 	case VIA_DI_PORT_DIP1:
-		via_dip1_set_output_enable(VGABASE, output_enable);
+		via_dip1_set_output_enable(VGASHADOW, output_enable);
 		break;
 	default:
 		break;
@@ -119,10 +119,10 @@ void via_clock_source(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DIP0:
-		via_dip0_set_clock_source(VGABASE, clock_source);
+		via_dip0_set_clock_source(VGASHADOW, clock_source);
 		break;
 	case VIA_DI_PORT_DIP1:
-		via_dip1_set_clock_source(VGABASE, clock_source);
+		via_dip1_set_clock_source(VGASHADOW, clock_source);
 		break;
 	default:
 		break;
@@ -141,11 +141,11 @@ void via_transmitter_clock_drive_strength(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DVP0:
-		via_dvp0_set_clock_drive_strength(VGABASE,
+		via_dvp0_set_clock_drive_strength(VGASHADOW,
 						drive_strength);
 		break;
 	case VIA_DI_PORT_DVP1:
-		via_dvp1_set_clock_drive_strength(VGABASE,
+		via_dvp1_set_clock_drive_strength(VGASHADOW,
 						drive_strength);
 		break;
 	default:
@@ -164,11 +164,11 @@ void via_transmitter_data_drive_strength(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DVP0:
-		via_dvp0_set_data_drive_strength(VGABASE,
+		via_dvp0_set_data_drive_strength(VGASHADOW,
 						drive_strength);
 		break;
 	case VIA_DI_PORT_DVP1:
-		via_dvp1_set_data_drive_strength(VGABASE,
+		via_dvp1_set_data_drive_strength(VGASHADOW,
 						drive_strength);
 		break;
 	default:
@@ -188,40 +188,40 @@ void via_transmitter_display_source(struct drm_device *dev,
 
 	switch(di_port) {
 	case VIA_DI_PORT_DIP0:
-		via_dip0_set_display_source(VGABASE, display_source);
+		via_dip0_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_DIP1:
-		via_dip1_set_display_source(VGABASE, display_source);
+		via_dip1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_DVP0:
-		via_dvp0_set_display_source(VGABASE, display_source);
+		via_dvp0_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_DVP1:
-		via_dvp1_set_display_source(VGABASE, display_source);
+		via_dvp1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_FPDPLOW:
-		via_fpdp_low_set_display_source(VGABASE, display_source);
-		via_dvp1_set_display_source(VGABASE, display_source);
+		via_fpdp_low_set_display_source(VGASHADOW, display_source);
+		via_dvp1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_FPDPHIGH:
-		via_fpdp_high_set_display_source(VGABASE, display_source);
-		via_dvp0_set_display_source(VGABASE, display_source);
+		via_fpdp_high_set_display_source(VGASHADOW, display_source);
+		via_dvp0_set_display_source(VGASHADOW, display_source);
 		break;
 	case (VIA_DI_PORT_FPDPLOW |
 		VIA_DI_PORT_FPDPHIGH):
-		via_fpdp_low_set_display_source(VGABASE, display_source);
-		via_fpdp_high_set_display_source(VGABASE, display_source);
+		via_fpdp_low_set_display_source(VGASHADOW, display_source);
+		via_fpdp_high_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_LVDS1:
-		via_lvds1_set_display_source(VGABASE, display_source);
+		via_lvds1_set_display_source(VGASHADOW, display_source);
 		break;
 	case VIA_DI_PORT_LVDS2:
-		via_lvds2_set_display_source(VGABASE, display_source);
+		via_lvds2_set_display_source(VGASHADOW, display_source);
 		break;
 	case (VIA_DI_PORT_LVDS1 |
 		VIA_DI_PORT_LVDS2):
-		via_lvds1_set_display_source(VGABASE, display_source);
-		via_lvds2_set_display_source(VGABASE, display_source);
+		via_lvds1_set_display_source(VGASHADOW, display_source);
+		via_lvds2_set_display_source(VGASHADOW, display_source);
 		break;
 	default:
 		break;
@@ -0,0 +1,393 @@
+/*
+ * Copyright © 2026 agent.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sub license,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) OR COPYRIGHT HOLDER(S) BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Author(s):
+ * agent <agent@local>
+ */
+
+#include <linux/debugfs.h>
+#include <linux/log2.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
+
+#include <drm/drm_buddy.h>
+#include <drm/drm_print.h>
+
+#include <drm/ttm/ttm_bo.h>
+#include <drm/ttm/ttm_resource.h>
+
+#include "via_drv.h"
+
+
+struct via_vram_mgr_hole {
+	u64	start;
+	u64	end;
+};
+
+static int via_vram_mgr_hole_cmp(const void *a, const void *b)
+{
+	const struct via_vram_mgr_hole *x = a, *y = b;
+
+	if (x->start == y->start) {
+		return 0;
+	}
+
+	return (x->start < y->start) ? -1 : 1;
+}
+
+/*
+ * Find the lowest, or with topdown the highest, offset in [start, end)
+ * where size bytes of free VRAM are contiguous. Adjacent free buddy
+ * blocks are merged, since a hole may span several of them.
+ */
+static int via_vram_mgr_find_hole(struct drm_buddy *mm, u64 start, u64 end,
+					u64 size, bool topdown, u64 *offset)
+{
+	struct via_vram_mgr_hole *holes;
+	struct drm_buddy_block *block;
+	unsigned int count = 0, i, n;
+	u64 hole_start, hole_end;
+	int order, ret = -ENOSPC;
+
+	for (order = mm->max_order; order >= 0; order--) {
+		list_for_each_entry(block, &mm->free_list[order], link) {
+			count++;
+		}
+	}
+
+	if (!count) {
+		return -ENOSPC;
+	}
+
+	holes = kvmalloc_array(count, sizeof(*holes), GFP_KERNEL);
+	if (!holes) {
+		return -ENOMEM;
+	}
+
+	i = 0;
+	for (order = mm->max_order; order >= 0; order--) {
+		list_for_each_entry(block, &mm->free_list[order], link) {
+			holes[i].start = drm_buddy_block_offset(block);
+			holes[i].end = holes[i].start +
+					drm_buddy_block_size(mm, block);
+			i++;
+		}
+	}
+
+	sort(holes, count, sizeof(*holes), via_vram_mgr_hole_cmp, NULL);
+
+	for (i = 0; i < count; i = n) {
+		hole_start = holes[i].start;
+		hole_end = holes[i].end;
+		for (n = i + 1; (n < count) && (holes[n].start == hole_end);
+			n++) {
+			hole_end = holes[n].end;
+		}
+
+		hole_start = max(hole_start, start);
+		hole_end = min(hole_end, end);
+		if ((hole_end <= hole_start) ||
+			(hole_end - hole_start < size)) {
+			continue;
+		}
+
+		*offset = topdown ? hole_end - size : hole_start;
+		ret = 0;
+		if (!topdown) {
+			break;
+		}
+	}
+
+	kvfree(holes);
+	return ret;
+}
+
+/*
+ * Allocate size bytes of contiguous VRAM in [start, end). The
+ * allocation is first tried as one naturally aligned power of two
+ * block, trimmed to size, which is cheap and keeps the free space in
+ * large blocks. When no such block is free, any contiguous run of
+ * free pages that is large enough is taken instead.
+ */
+static int via_vram_mgr_alloc_blocks(struct drm_buddy *mm, u64 start,
+					u64 end, u64 size,
+					unsigned long flags,
+					struct list_head *blocks)
+{
+	u64 alloc_size = roundup_pow_of_two(size);
+	u64 offset;
+	int ret = -ENOSPC;
+
+	if (size > end - start) {
+		return -ENOSPC;
+	}
+
+	if (alloc_size <= end - start) {
+		ret = drm_buddy_alloc_blocks(mm, start, end, alloc_size,
+						alloc_size, blocks, flags);
+		if ((!ret) && (alloc_size != size)) {
+			ret = drm_buddy_block_trim(mm, size, blocks);
+			if (ret) {
+				drm_buddy_free_list(mm, blocks);
+			}
+		}
+	}
+
+	if (!ret) {
+		return 0;
+	}
+
+	ret = via_vram_mgr_find_hole(mm, start, end, size,
+					flags & DRM_BUDDY_TOPDOWN_ALLOCATION,
+					&offset);
+	if (ret) {
+		return ret;
+	}
+
+	return drm_buddy_alloc_blocks(mm, offset, offset + size, size,
+					PAGE_SIZE, blocks,
+					DRM_BUDDY_RANGE_ALLOCATION);
+}
+
+/*
+ * Each buffer is kept contiguous (see via_vram_mgr_alloc_blocks()).
+ * Buffers that are going to be scanned out ask for
+ * TTM_PL_FLAG_TOPDOWN and are taken from the top of VRAM, so the
+ * churn of short lived buffers at the bottom does not break up the
+ * space a new full screen framebuffer needs.
+ */
+static int via_vram_mgr_new(struct ttm_resource_manager *man,
+				struct ttm_buffer_object *bo,
+				const struct ttm_place *place,
+				struct ttm_resource **res)
+{
+	struct via_vram_mgr *mgr = to_via_vram_mgr(man);
+	struct via_vram_resource *vres;
+	struct drm_buddy_block *block;
+	unsigned long flags = 0;
+	u64 start, end, offset;
+	int ret;
+
+	vres = kzalloc(sizeof(*vres), GFP_KERNEL);
+	if (!vres) {
+		return -ENOMEM;
+	}
+
+	ttm_resource_init(bo, place, &vres->base);
+	INIT_LIST_HEAD(&vres->blocks);
+
+	start = (u64)place->fpfn << PAGE_SHIFT;
+	end = place->lpfn ? (u64)place->lpfn << PAGE_SHIFT : man->size;
+
+	if ((place->fpfn) || (place->lpfn)) {
+		flags |= DRM_BUDDY_RANGE_ALLOCATION;
+	}
+
+	if (place->flags & TTM_PL_FLAG_TOPDOWN) {
+		flags |= DRM_BUDDY_TOPDOWN_ALLOCATION;
+	}
+
+	mutex_lock(&mgr->lock);
+	ret = via_vram_mgr_alloc_blocks(&mgr->mm, start, end,
+					vres->base.size, flags,
+					&vres->blocks);
+	mutex_unlock(&mgr->lock);
+	if (ret) {
+		ret = (ret == -ENOMEM) ? ret : -ENOSPC;
+		goto error_fini;
+	}
+
+	/* A contiguous run may be made of several blocks, in any order. */
+	offset = U64_MAX;
+	list_for_each_entry(block, &vres->blocks, link) {
+		offset = min(offset, drm_buddy_block_offset(block));
+	}
+
+	vres->base.start = offset >> PAGE_SHIFT;
+
+	*res = &vres->base;
+	return 0;
+error_fini:
+	ttm_resource_fini(man, &vres->base);
+	kfree(vres);
+	return ret;
+}
+
+static void via_vram_mgr_del(struct ttm_resource_manager *man,
+				struct ttm_resource *res)
+{
+	struct via_vram_mgr *mgr = to_via_vram_mgr(man);
+	struct via_vram_resource *vres = to_via_vram_resource(res);
+
+	mutex_lock(&mgr->lock);
+	drm_buddy_free_list(&mgr->mm, &vres->blocks);
+	mutex_unlock(&mgr->lock);
+
+	ttm_resource_fini(man, res);
+	kfree(vres);
+}
+
+static bool via_vram_mgr_intersects(struct ttm_resource_manager *man,
+					struct ttm_resource *res,
+					const struct ttm_place *place,
+					size_t size)
+{
+	u32 num_pages = PFN_UP(size);
+
+	/* Buffers are contiguous, so start and size describe them. */
+	return (place->fpfn < res->start + num_pages) &&
+		((!place->lpfn) || (place->lpfn > res->start));
+}
+
+static bool via_vram_mgr_compatible(struct ttm_resource_manager *man,
+					struct ttm_resource *res,
+					const struct ttm_place *place,
+					size_t size)
+{
+	u32 num_pages = PFN_UP(size);
+
+	return (res->start >= place->fpfn) &&
+		((!place->lpfn) || (res->start + num_pages <= place->lpfn));
+}
+
+/*
+ * Share of the free VRAM, in percent, that is not part of the
+ * largest free block. 0 means all free space is in one piece.
+ */
+static unsigned int via_vram_mgr_fragmentation(struct via_vram_mgr *mgr,
+						u64 *largest)
+{
+	struct drm_buddy *mm = &mgr->mm;
+	int order;
+
+	*largest = 0;
+	for (order = mm->max_order; order >= 0; order--) {
+		if (!list_empty(&mm->free_list[order])) {
+			*largest = mm->chunk_size << order;
+			break;
+		}
+	}
+
+	if (!mm->avail) {
+		return 0;
+	}
+
+	return 100 - div64_u64(*largest * 100, mm->avail);
+}
+
+static void via_vram_mgr_debug(struct ttm_resource_manager *man,
+				struct drm_printer *printer)
+{
+	struct via_vram_mgr *mgr = to_via_vram_mgr(man);
+	unsigned int fragmentation;
+	u64 largest;
+
+	mutex_lock(&mgr->lock);
+	fragmentation = via_vram_mgr_fragmentation(mgr, &largest);
+	drm_printf(printer, "fragmentation: %u%%, largest free block: "
+			"%lluKiB\n", fragmentation, largest >> 10);
+	drm_buddy_print(&mgr->mm, printer);
+	mutex_unlock(&mgr->lock);
+}
+
+static const struct ttm_resource_manager_func via_vram_mgr_func = {
+	.alloc = via_vram_mgr_new,
+	.free = via_vram_mgr_del,
+	.intersects = via_vram_mgr_intersects,
+	.compatible = via_vram_mgr_compatible,
+	.debug = via_vram_mgr_debug,
+};
+
+#if defined(CONFIG_DEBUG_FS)
+static int via_vram_mgr_fragmentation_show(struct seq_file *m, void *unused)
+{
+	struct via_vram_mgr *mgr = m->private;
+	unsigned int fragmentation;
+	u64 largest;
+
+	mutex_lock(&mgr->lock);
+	fragmentation = via_vram_mgr_fragmentation(mgr, &largest);
+	seq_printf(m, "%u\n", fragmentation);
+	mutex_unlock(&mgr->lock);
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(via_vram_mgr_fragmentation);
+#endif
+
+void via_vram_mgr_debugfs_init(struct via_drm_priv *dev_priv,
+				struct dentry *root)
+{
+#if defined(CONFIG_DEBUG_FS)
+	debugfs_create_file("via_vram_fragmentation", 0444, root,
+				&dev_priv->vram_mgr,
+				&via_vram_mgr_fragmentation_fops);
+#endif
+}
+
+int via_vram_mgr_init(struct via_drm_priv *dev_priv)
+{
+	struct via_vram_mgr *mgr = &dev_priv->vram_mgr;
+	struct ttm_resource_manager *man = &mgr->manager;
+	int ret;
+
+	ret = drm_buddy_init(&mgr->mm, dev_priv->vram_size, PAGE_SIZE);
+	if (ret) {
+		return ret;
+	}
+
+	mutex_init(&mgr->lock);
+
+	man->func = &via_vram_mgr_func;
+	ttm_resource_manager_init(man, &dev_priv->bdev,
+					dev_priv->vram_size);
+	ttm_set_driver_manager(&dev_priv->bdev, TTM_PL_VRAM, man);
+	ttm_resource_manager_set_used(man, true);
+	return 0;
+}
+
+void via_vram_mgr_fini(struct via_drm_priv *dev_priv)
+{
+	struct via_vram_mgr *mgr = &dev_priv->vram_mgr;
+	struct ttm_resource_manager *man = &mgr->manager;
+	int ret;
+
+	ttm_resource_manager_set_used(man, false);
+
+	ret = ttm_resource_manager_evict_all(&dev_priv->bdev, man);
+	if (ret) {
+		return;
+	}
+
+	mutex_lock(&mgr->lock);
+	drm_buddy_fini(&mgr->mm);
+	mutex_unlock(&mgr->lock);
+
+	ttm_resource_manager_cleanup(man);
+	ttm_set_driver_manager(&dev_priv->bdev, TTM_PL_VRAM, NULL);
+}
+
+#if IS_ENABLED(CONFIG_DRM_VIA_KUNIT_TEST)
+#include "tests/via_vram_mgr_test.c"
+#endif
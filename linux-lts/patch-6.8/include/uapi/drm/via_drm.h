@@ -87,6 +87,10 @@ extern "C" {
  */
 #define	DRM_VIA_GEM_ALLOC	0x20
 #define	DRM_VIA_GEM_MMAP	0x21
+#define	DRM_VIA_GEM_WAIT	0x22
+#define	DRM_VIA_GEM_CPU_PREP	0x23
+#define	DRM_VIA_GEM_CPU_FINI	0x24
+#define	DRM_VIA_GEM_ALLOC_BATCH	0x25
 
 
 #define DRM_IOCTL_VIA_ALLOCMEM	  DRM_IOWR(DRM_COMMAND_BASE + DRM_VIA_ALLOCMEM, drm_via_mem_t)
@@ -110,6 +114,10 @@ extern "C" {
  */
 #define	DRM_IOCTL_VIA_GEM_ALLOC   DRM_IOWR(DRM_COMMAND_BASE + DRM_VIA_GEM_ALLOC, struct drm_via_gem_alloc)
 #define	DRM_IOCTL_VIA_GEM_MMAP    DRM_IOWR(DRM_COMMAND_BASE + DRM_VIA_GEM_MMAP, struct drm_via_gem_mmap)
+#define	DRM_IOCTL_VIA_GEM_WAIT    DRM_IOW(DRM_COMMAND_BASE + DRM_VIA_GEM_WAIT, struct drm_via_gem_wait)
+#define	DRM_IOCTL_VIA_GEM_CPU_PREP DRM_IOW(DRM_COMMAND_BASE + DRM_VIA_GEM_CPU_PREP, struct drm_via_gem_cpu_prep)
+#define	DRM_IOCTL_VIA_GEM_CPU_FINI DRM_IOW(DRM_COMMAND_BASE + DRM_VIA_GEM_CPU_FINI, struct drm_via_gem_cpu_fini)
+#define	DRM_IOCTL_VIA_GEM_ALLOC_BATCH DRM_IOW(DRM_COMMAND_BASE + DRM_VIA_GEM_ALLOC_BATCH, struct drm_via_gem_alloc_batch)
 
 /* Indices into buf.Setup where various bits of state are mirrored per
  * context and per buffer.  These can be fired at the card as a unit,
@@ -330,6 +338,86 @@ struct drm_via_gem_mmap {
 	__u64 offset;
 };
 
+/* Only wait for pending writes, not reads, of the BO. */
+#define VIA_GEM_WAIT_WRITE	0x00000001
+
+/**
+ * struct drm_via_gem_wait - IOCTL argument for waiting for a GEM based
+ * BO to become idle.
+ *
+ * Fails with -ETIME if the BO is still busy once the timeout expires.
+ * A timeout of 0 only polls, and fails with -EBUSY if the BO is busy.
+ */
+struct drm_via_gem_wait {
+	/* GEM handle of the BO. */
+	__u32 handle;
+
+	/* VIA_GEM_WAIT_* flags. */
+	__u32 flags;
+
+	/* Relative timeout in nanoseconds. Negative waits forever. */
+	__s64 timeout_ns;
+};
+
+/* The CPU is going to read the BO. */
+#define VIA_GEM_CPU_PREP_READ	0x00000001
+/* The CPU is going to write the BO. */
+#define VIA_GEM_CPU_PREP_WRITE	0x00000002
+/* Fail with -EBUSY instead of waiting. */
+#define VIA_GEM_CPU_PREP_NOWAIT	0x00000004
+
+/**
+ * struct drm_via_gem_cpu_prep - IOCTL argument for preparing a GEM
+ * based BO for CPU access.
+ *
+ * Reading waits for pending writes of the BO, writing waits for all
+ * pending access. Fails with -ETIME if the BO is still busy once the
+ * timeout expires.
+ */
+struct drm_via_gem_cpu_prep {
+	/* GEM handle of the BO. */
+	__u32 handle;
+
+	/* VIA_GEM_CPU_PREP_* flags. */
+	__u32 flags;
+
+	/* Relative timeout in nanoseconds. Negative waits forever. */
+	__s64 timeout_ns;
+};
+
+/**
+ * struct drm_via_gem_cpu_fini - IOCTL argument for ending CPU access
+ * to a GEM based BO.
+ *
+ * Makes CPU writes made through a mapping visible to the hardware.
+ */
+struct drm_via_gem_cpu_fini {
+	/* GEM handle of the BO. */
+	__u32 handle;
+	/* Must be zero. */
+	__u32 pad;
+};
+
+/* Most BOs a single DRM_VIA_GEM_ALLOC_BATCH call can allocate. */
+#define VIA_GEM_ALLOC_BATCH_MAX	1024
+
+/**
+ * struct drm_via_gem_alloc_batch - IOCTL argument for allocating
+ * several GEM based BOs at once.
+ *
+ * entries points to an array of count struct drm_via_gem_alloc, which
+ * are filled in the same way as for DRM_VIA_GEM_ALLOC. Either all of
+ * the BOs are allocated, or none are.
+ */
+struct drm_via_gem_alloc_batch {
+	/* User pointer to the struct drm_via_gem_alloc array. */
+	__u64 entries;
+
+	/* Number of entries, at most VIA_GEM_ALLOC_BATCH_MAX. */
+	__u32 count;
+	__u32 pad;
+};
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,11 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _VIA_SHIM_LINUX_KERNEL_H
+#define _VIA_SHIM_LINUX_KERNEL_H
+
+#include <linux/bits.h>
+#include <linux/math.h>
+#include <linux/minmax.h>
+
+#define ARRAY_SIZE(arr)		(sizeof(arr) / sizeof((arr)[0]))
+
+#endif
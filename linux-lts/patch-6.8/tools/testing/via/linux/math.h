@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _VIA_SHIM_LINUX_MATH_H
+#define _VIA_SHIM_LINUX_MATH_H
+
+#define DIV_ROUND_UP(n, d)	(((n) + (d) - 1) / (d))
+
+#define DIV_ROUND_CLOSEST(x, divisor) ({			\
+	typeof(x) __x = x;					\
+	typeof(divisor) __d = divisor;				\
+	(((typeof(x))-1) > 0 ||					\
+	 ((typeof(divisor))-1) > 0 ||				\
+	 (((__x) > 0) == ((__d) > 0))) ?			\
+		(((__x) + ((__d) / 2)) / (__d)) :		\
+		(((__x) - ((__d) / 2)) / (__d));		\
+})
+
+#define roundup(x, y) ({					\
+	typeof(y) __y = y;					\
+	(((x) + (__y - 1)) / __y) * __y;			\
+})
+
+#endif
@@ -0,0 +1,11 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _VIA_SHIM_LINUX_MATH64_H
+#define _VIA_SHIM_LINUX_MATH64_H
+
+
+static inline u64 div64_u64(u64 dividend, u64 divisor)
+{
+	return dividend / divisor;
+}
+
+#endif
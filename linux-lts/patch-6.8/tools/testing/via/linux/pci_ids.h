@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _VIA_SHIM_LINUX_PCI_IDS_H
+#define _VIA_SHIM_LINUX_PCI_IDS_H
+
+/* The VIA integrated graphics IDs of include/linux/pci_ids.h */
+#define PCI_DEVICE_ID_VIA_CHROME9_HC3		0x1122
+#define PCI_DEVICE_ID_VIA_K8M800_GFX		0x3108
+#define PCI_DEVICE_ID_VIA_PM800_GFX		0x3118
+#define PCI_DEVICE_ID_VIA_CLE266_GFX		0x3122
+#define PCI_DEVICE_ID_VIA_UNICHROME_PRO_II	0x3157
+#define PCI_DEVICE_ID_VIA_CHROME9		0x3230
+#define PCI_DEVICE_ID_VIA_P4M890_GFX		0x3343
+#define PCI_DEVICE_ID_VIA_P4M800_PRO_GFX	0x3344
+#define PCI_DEVICE_ID_VIA_CHROME9_HC		0x3371
+#define PCI_DEVICE_ID_VIA_CHROME9_HCM		0x5122
+#define PCI_DEVICE_ID_VIA_KM400_GFX		0x7205
+#define PCI_DEVICE_ID_VIA_CHROME9_HD		0x7122
+
+#endif
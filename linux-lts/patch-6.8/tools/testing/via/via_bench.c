@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Userspace driver for the pure display computations of drm/via.
+ *
+ * via_clock.c and via_fifo.c are built unmodified against the headers
+ * in this directory. Every pixel clock and FIFO setting of the golden
+ * tables the KUnit suites use is checked and timed, so a change to the
+ * solver can be measured without a VIA board at hand.
+ */
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <linux/kernel.h>
+#include <linux/pci_ids.h>
+
+#include "../../../drivers/gpu/drm/via/tests/via_clock_golden.h"
+#include "../../../drivers/gpu/drm/via/tests/via_fifo_golden.h"
+
+static unsigned int loops = 1000;
+
+static u64 now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int bench_pll(void)
+{
+	const struct via_pll_golden *golden;
+	volatile u32 sink;
+	unsigned int i, j, k, solves = 0, errors = 0;
+	u64 start, elapsed = 0;
+	u16 device;
+	u32 value;
+
+	for (i = 0; i < ARRAY_SIZE(via_pll_golden_table); i++) {
+		golden = &via_pll_golden_table[i];
+
+		for (j = 0; j < ARRAY_SIZE(via_pll_golden_devices); j++) {
+			device = via_pll_golden_devices[j];
+			value = via_pll_solve(device, golden->clock * 1000);
+			if (value != via_pll_golden_value(golden, device)) {
+				printf("pll: device 0x%04x, %u kHz: got 0x%08x, expected 0x%08x\n",
+					device, golden->clock, value,
+					via_pll_golden_value(golden, device));
+				errors++;
+			}
+
+			start = now_ns();
+			for (k = 0; k < loops; k++)
+				sink = via_pll_solve(device,
+						golden->clock * 1000);
+			elapsed += now_ns() - start;
+			solves += loops;
+		}
+	}
+
+	(void)sink;
+	printf("pll: %u clocks x %zu devices, %.1f ns/solve, %u mismatches\n",
+		(unsigned int)ARRAY_SIZE(via_pll_golden_table),
+		ARRAY_SIZE(via_pll_golden_devices),
+		(double)elapsed / solves, errors);
+	return errors;
+}
+
+static bool fifo_check(const char *what, u16 device, unsigned int iga,
+			const struct via_fifo_golden_config *golden,
+			const struct via_fifo_params *fifo)
+{
+	if (via_fifo_golden_equal(golden, fifo))
+		return true;
+
+	printf("fifo: device 0x%04x IGA%u, %s: got %u/%u/%u/%u/%d, expected %u/%u/%u/%u/%d\n",
+		device, iga, what, fifo->max_depth, fifo->threshold,
+		fifo->high_threshold, fifo->display_queue_expire_num,
+		fifo->extended, golden->max_depth, golden->threshold,
+		golden->high_threshold, golden->display_queue_expire_num,
+		golden->extended);
+	return false;
+}
+
+static int bench_fifo(void)
+{
+	const struct via_fifo_golden_mode *mode;
+	const struct via_fifo_golden *golden;
+	struct via_fifo_params fifo;
+	struct via_fifo_load load = {};
+	unsigned int i, k, lookups = 0, errors = 0;
+	u64 start, elapsed = 0;
+
+	for (i = 0; i < ARRAY_SIZE(via_fifo_golden_table); i++) {
+		golden = &via_fifo_golden_table[i];
+		mode = &via_fifo_golden_modes[golden->mode];
+
+		load.vram_type = golden->vram_type;
+		load.hdisplay = mode->hdisplay;
+		load.vdisplay = mode->vdisplay;
+		load.depth = golden->depth;
+		load.clock = mode->clock;
+		load.cpp = (golden->depth > 16) ? 4 : 2;
+
+		if (via_iga1_fifo_params(golden->device, golden->revision,
+						&load, &fifo) ||
+			!fifo_check(mode->name, golden->device, 1,
+					&golden->iga1, &fifo))
+			errors++;
+
+		if (via_iga2_fifo_params(golden->device, golden->revision,
+						&load, &fifo) ||
+			!fifo_check(mode->name, golden->device, 2,
+					&golden->iga2, &fifo))
+			errors++;
+
+		start = now_ns();
+		for (k = 0; k < loops; k++) {
+			via_iga1_fifo_params(golden->device, golden->revision,
+						&load, &fifo);
+			via_iga2_fifo_params(golden->device, golden->revision,
+						&load, &fifo);
+		}
+		elapsed += now_ns() - start;
+		lookups += 2 * loops;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(via_fifo_golden_fixed_table); i++) {
+		const struct via_fifo_golden_fixed *fixed =
+					&via_fifo_golden_fixed_table[i];
+
+		if (via_iga1_fifo_params(fixed->device, 0, &load, &fifo) ||
+			!fifo_check("any mode", fixed->device, 1,
+					&fixed->iga1, &fifo))
+			errors++;
+
+		if (via_iga2_fifo_params(fixed->device, 0, &load, &fifo) ||
+			!fifo_check("any mode", fixed->device, 2,
+					&fixed->iga2, &fifo))
+			errors++;
+	}
+
+	printf("fifo: %zu settings, %.1f ns/lookup, %u mismatches\n",
+		ARRAY_SIZE(via_fifo_golden_table) +
+		ARRAY_SIZE(via_fifo_golden_fixed_table),
+		(double)elapsed / lookups, errors);
+	return errors;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-n loops]\n", name);
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	int errors = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			loops = strtoul(optarg, NULL, 0);
+			if (!loops)
+				usage(argv[0]);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	errors += bench_pll();
+	errors += bench_fifo();
+
+	return errors ? 1 : 0;
+}
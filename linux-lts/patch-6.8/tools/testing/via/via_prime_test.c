@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Checks that drm/via refuses to scan out PRIME buffers it cannot
+ * keep in VRAM, by page flipping an active CRTC to:
+ *
+ * - a dumb buffer (must work, and is flipped back right away),
+ * - a dumb buffer exported to vgem, which pins it in TT (-EBUSY),
+ * - a udmabuf imported from a memfd, backed by system pages (-EINVAL).
+ *
+ * Run it as root, with no other DRM master, and vgem and udmabuf
+ * loaded. A case whose module is missing is skipped.
+ */
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include <drm/drm.h>
+#include <drm/drm_mode.h>
+#include <linux/udmabuf.h>
+
+static const char *card = "/dev/dri/card0";
+static int fd;
+static uint32_t crtc_id, orig_fb, width, height;
+static int failures;
+
+static int flip_wait(void)
+{
+	char buf[1024];
+	ssize_t len;
+
+	len = read(fd, buf, sizeof(buf));
+	if (len < (ssize_t)sizeof(struct drm_event)) {
+		perror("read flip event");
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Returns 0 or the negative errno of the flip. */
+static int flip(uint32_t fb_id)
+{
+	struct drm_mode_crtc_page_flip flip = {
+		.crtc_id = crtc_id,
+		.fb_id = fb_id,
+		.flags = DRM_MODE_PAGE_FLIP_EVENT,
+	};
+
+	if (ioctl(fd, DRM_IOCTL_MODE_PAGE_FLIP, &flip))
+		return -errno;
+
+	return flip_wait();
+}
+
+static int find_crtc(void)
+{
+	struct drm_mode_card_res res = {};
+	struct drm_mode_crtc crtc;
+	uint32_t *crtcs;
+	unsigned int i;
+
+	if (ioctl(fd, DRM_IOCTL_MODE_GETRESOURCES, &res))
+		return -1;
+
+	crtcs = calloc(res.count_crtcs, sizeof(*crtcs));
+	if (!crtcs)
+		return -1;
+
+	res.crtc_id_ptr = (uintptr_t)crtcs;
+	res.count_fbs = 0;
+	res.count_connectors = 0;
+	res.count_encoders = 0;
+	if (ioctl(fd, DRM_IOCTL_MODE_GETRESOURCES, &res))
+		goto error;
+
+	for (i = 0; i < res.count_crtcs; i++) {
+		memset(&crtc, 0, sizeof(crtc));
+		crtc.crtc_id = crtcs[i];
+		if (ioctl(fd, DRM_IOCTL_MODE_GETCRTC, &crtc))
+			continue;
+
+		if (crtc.mode_valid && crtc.fb_id) {
+			crtc_id = crtc.crtc_id;
+			orig_fb = crtc.fb_id;
+			width = crtc.mode.hdisplay;
+			height = crtc.mode.vdisplay;
+			free(crtcs);
+			return 0;
+		}
+	}
+
+error:
+	free(crtcs);
+	return -1;
+}
+
+static int add_fb(uint32_t handle, uint32_t pitch, uint32_t *fb_id)
+{
+	struct drm_mode_fb_cmd cmd = {
+		.width = width,
+		.height = height,
+		.pitch = pitch,
+		.bpp = 32,
+		.depth = 24,
+		.handle = handle,
+	};
+
+	if (ioctl(fd, DRM_IOCTL_MODE_ADDFB, &cmd))
+		return -errno;
+
+	*fb_id = cmd.fb_id;
+	return 0;
+}
+
+static int create_dumb(struct drm_mode_create_dumb *create)
+{
+	memset(create, 0, sizeof(*create));
+	create->width = width;
+	create->height = height;
+	create->bpp = 32;
+
+	return ioctl(fd, DRM_IOCTL_MODE_CREATE_DUMB, create);
+}
+
+static void result(const char *name, int ret, int expected)
+{
+	if (ret == expected) {
+		printf("ok: %s\n", name);
+		return;
+	}
+
+	printf("FAIL: %s: got %s, expected %s\n", name, strerror(-ret),
+		strerror(-expected));
+	failures++;
+}
+
+static void test_dumb(void)
+{
+	struct drm_mode_create_dumb create;
+	uint32_t fb_id;
+	int ret;
+
+	if (create_dumb(&create) ||
+		add_fb(create.handle, create.pitch, &fb_id)) {
+		printf("FAIL: dumb: cannot create a framebuffer\n");
+		failures++;
+		return;
+	}
+
+	ret = flip(fb_id);
+	result("dumb buffer", ret, 0);
+	if (!ret)
+		flip(orig_fb);
+}
+
+static int open_vgem(void)
+{
+	char name[16];
+	struct drm_version version;
+	struct dirent *dent;
+	DIR *dir;
+	int vgem;
+
+	dir = opendir("/dev/dri");
+	if (!dir)
+		return -1;
+
+	while ((dent = readdir(dir))) {
+		if (strncmp(dent->d_name, "card", 4))
+			continue;
+
+		vgem = openat(dirfd(dir), dent->d_name, O_RDWR | O_CLOEXEC);
+		if (vgem < 0)
+			continue;
+
+		memset(&version, 0, sizeof(version));
+		memset(name, 0, sizeof(name));
+		version.name = name;
+		version.name_len = sizeof(name) - 1;
+		if (!ioctl(vgem, DRM_IOCTL_VERSION, &version) &&
+			!strcmp(name, "vgem")) {
+			closedir(dir);
+			return vgem;
+		}
+
+		close(vgem);
+	}
+
+	closedir(dir);
+	return -1;
+}
+
+static void test_export(void)
+{
+	struct drm_prime_handle prime = { .fd = -1 };
+	struct drm_mode_create_dumb create;
+	uint32_t fb_id;
+	int vgem;
+
+	vgem = open_vgem();
+	if (vgem < 0) {
+		printf("skip: export to vgem, no vgem device\n");
+		return;
+	}
+
+	if (create_dumb(&create) ||
+		add_fb(create.handle, create.pitch, &fb_id)) {
+		printf("FAIL: export: cannot create a framebuffer\n");
+		failures++;
+		goto exit;
+	}
+
+	prime.handle = create.handle;
+	prime.flags = DRM_CLOEXEC | DRM_RDWR;
+	if (ioctl(fd, DRM_IOCTL_PRIME_HANDLE_TO_FD, &prime)) {
+		perror("DRM_IOCTL_PRIME_HANDLE_TO_FD");
+		failures++;
+		goto exit;
+	}
+
+	/* Importing attaches vgem, which pins the buffer in TT. */
+	if (ioctl(vgem, DRM_IOCTL_PRIME_FD_TO_HANDLE, &prime)) {
+		perror("vgem DRM_IOCTL_PRIME_FD_TO_HANDLE");
+		failures++;
+		goto exit;
+	}
+
+	result("dumb buffer exported to vgem", flip(fb_id), -EBUSY);
+exit:
+	if (prime.fd >= 0)
+		close(prime.fd);
+	close(vgem);
+}
+
+static void test_import(void)
+{
+	struct udmabuf_create create = {};
+	struct drm_prime_handle prime = {};
+	size_t pitch = width * 4;
+	size_t size = (pitch * height + 4095) & ~(size_t)4095;
+	uint32_t fb_id;
+	int dev, memfd, dmabuf = -1;
+
+	dev = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+	if (dev < 0) {
+		printf("skip: udmabuf import, no /dev/udmabuf\n");
+		return;
+	}
+
+	memfd = memfd_create("via_prime_test", MFD_ALLOW_SEALING);
+	if ((memfd < 0) || ftruncate(memfd, size) ||
+		fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK)) {
+		perror("memfd");
+		failures++;
+		goto exit;
+	}
+
+	create.memfd = memfd;
+	create.size = size;
+	create.flags = UDMABUF_FLAGS_CLOEXEC;
+	dmabuf = ioctl(dev, UDMABUF_CREATE, &create);
+	if (dmabuf < 0) {
+		perror("UDMABUF_CREATE");
+		failures++;
+		goto exit;
+	}
+
+	prime.fd = dmabuf;
+	if (ioctl(fd, DRM_IOCTL_PRIME_FD_TO_HANDLE, &prime)) {
+		perror("DRM_IOCTL_PRIME_FD_TO_HANDLE");
+		failures++;
+		goto exit;
+	}
+
+	if (add_fb(prime.handle, pitch, &fb_id)) {
+		printf("FAIL: import: cannot create a framebuffer\n");
+		failures++;
+		goto exit;
+	}
+
+	result("udmabuf import", flip(fb_id), -EINVAL);
+exit:
+	if (dmabuf >= 0)
+		close(dmabuf);
+	if (memfd >= 0)
+		close(memfd);
+	close(dev);
+}
+
+int main(int argc, char **argv)
+{
+	int opt;
+
+	while ((opt = getopt(argc, argv, "d:")) != -1) {
+		switch (opt) {
+		case 'd':
+			card = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-d card]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	fd = open(card, O_RDWR | O_CLOEXEC);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", card, strerror(errno));
+		return 1;
+	}
+
+	if (find_crtc()) {
+		fprintf(stderr, "%s: no active CRTC\n", card);
+		return 1;
+	}
+
+	test_dumb();
+	test_export();
+	test_import();
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Stand-in for via_drv.h, forced in ahead of every driver file so that
+ * the real header, and with it DRM and TTM, never gets pulled in. Only
+ * what via_clock.c and via_fifo.c use is provided, and it has to be
+ * kept in sync with via_drv.h.
+ */
+#ifndef _VIA_SHIM_H
+#define _VIA_SHIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+/* Keep the driver's own header out. */
+#define _VIA_DRV_H
+
+/* There is no Kconfig here, and so no KUnit either. */
+#define IS_ENABLED(option)	0
+
+#define CLE266_REVISION_AX      0x0A
+#define CLE266_REVISION_CX      0x0C
+
+#define VIA_MEM_NONE            0x00
+#define VIA_MEM_SDR66           0x01
+#define VIA_MEM_SDR100          0x02
+#define VIA_MEM_SDR133          0x03
+#define VIA_MEM_DDR_200         0x04
+#define VIA_MEM_DDR_266         0x05
+#define VIA_MEM_DDR_333         0x06
+#define VIA_MEM_DDR_400         0x07
+#define VIA_MEM_DDR2_400        0x08
+#define VIA_MEM_DDR2_533        0x09
+#define VIA_MEM_DDR2_667        0x0A
+#define VIA_MEM_DDR2_800        0x0B
+#define VIA_MEM_DDR2_1066       0x0C
+#define VIA_MEM_DDR3_533        0x0D
+#define VIA_MEM_DDR3_667        0x0E
+#define VIA_MEM_DDR3_800        0x0F
+#define VIA_MEM_DDR3_1066       0x10
+#define VIA_MEM_DDR3_1333       0x11
+#define VIA_MEM_DDR3_1600       0x12
+
+struct via_fifo_load {
+	u8		vram_type;
+	u32		hdisplay;
+	u32		vdisplay;
+	u32		depth;
+	u32		clock;
+	u32		cpp;
+	u32		other_load;
+};
+
+struct via_fifo_params {
+	unsigned int	max_depth;
+	unsigned int	threshold;
+	unsigned int	high_threshold;
+	unsigned int	display_queue_expire_num;
+	bool		extended;
+	unsigned int	load;
+};
+
+/* via_clock.c */
+u32 via_pll_solve(u16 device, u32 freq);
+
+/* via_fifo.c */
+u32 via_mem_bandwidth(u8 vram_type);
+u32 via_scanout_load(u32 clock, u32 cpp);
+unsigned int via_mem_load(u8 vram_type, u32 load);
+int via_iga1_fifo_params(u16 device, int revision,
+			const struct via_fifo_load *load,
+			struct via_fifo_params *fifo);
+int via_iga2_fifo_params(u16 device, int revision,
+			const struct via_fifo_load *load,
+			struct via_fifo_params *fifo);
+
+#endif /* _VIA_SHIM_H */
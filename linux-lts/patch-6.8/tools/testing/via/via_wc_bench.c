@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * CPU write bandwidth into the buffers drm/via hands to userspace.
+ *
+ * A software rendered frame is written, the way pixman and llvmpipe
+ * do, into a VRAM dumb buffer (write-combined), a TT buffer (cached)
+ * and plain malloc memory, and read back once. With -u the same is
+ * done through an uncached and, where available, a write-combined
+ * mapping of the VRAM BAR from sysfs, which shows what dumb buffers
+ * ran at before they were write-combined.
+ *
+ * -u writes to the start of VRAM, which is usually the visible
+ * console. Its contents are saved and restored, but run it as root
+ * with no other DRM client active.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include <drm/drm_mode.h>
+#include <drm/via_drm.h>
+
+#define PCI_DEVICE_ID_VIA_CHROME9_HD	0x5122
+
+/* TTM_PL_TT, as taken by DRM_IOCTL_VIA_GEM_ALLOC. */
+#define VIA_DOMAIN_TT	1
+
+static const char *card = "/dev/dri/card0";
+static unsigned int width = 1024, height = 768;
+static unsigned int loops = 100;
+static bool bar;
+
+struct target {
+	const char *name;
+	void *map;
+	size_t size;
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Solid fills, one 32-bit store per pixel, as pixman does. */
+static void frame_fill(uint32_t *dst, unsigned int frame)
+{
+	uint32_t color = 0xff000000 | (frame * 0x010203);
+	unsigned int x, y;
+
+	for (y = 0; y < height; y++)
+		for (x = 0; x < width; x++)
+			*dst++ = color;
+}
+
+/* Row uploads of a finished frame, as llvmpipe's display target does. */
+static void frame_copy(uint32_t *dst, unsigned int frame)
+{
+	static uint32_t *src;
+	unsigned int y;
+
+	if (!src) {
+		src = malloc((size_t)width * height * 4);
+		if (!src)
+			exit(1);
+		memset(src, 0x5a, (size_t)width * height * 4);
+	}
+
+	src[frame % width] = frame;
+	for (y = 0; y < height; y++)
+		memcpy(dst + y * width, src + y * width, width * 4);
+}
+
+static void frame_read(uint32_t *dst, unsigned int frame)
+{
+	static uint32_t *copy;
+
+	if (!copy) {
+		copy = malloc((size_t)width * height * 4);
+		if (!copy)
+			exit(1);
+	}
+
+	memcpy(copy, dst, (size_t)width * height * 4);
+	if (copy[frame % width] == 0x12345678)
+		printf("\n");
+}
+
+/*
+ * MB/s of loops frames, stopping early after a second so that
+ * uncached mappings do not take minutes.
+ */
+static double bench(const struct target *target,
+			void (*fn)(uint32_t *, unsigned int))
+{
+	uint64_t start = now_ns(), elapsed;
+	unsigned int frame = 0;
+
+	do {
+		fn(target->map, frame++);
+		elapsed = now_ns() - start;
+	} while ((frame < loops) && (elapsed < 1000000000));
+
+	return (double)frame * width * height * 4 * 1000 / elapsed;
+}
+
+static void bench_target(const struct target *target, double *base)
+{
+	double fill, copy, read;
+
+	fill = bench(target, frame_fill);
+	copy = bench(target, frame_copy);
+	read = bench(target, frame_read);
+
+	if (!base[0]) {
+		base[0] = fill;
+		base[1] = copy;
+	}
+
+	printf("%-12s %9.1f %9.1f %9.1f   %5.2fx %5.2fx\n", target->name,
+		fill, copy, read, fill / base[0], copy / base[1]);
+}
+
+static int gem_target(int fd, struct target *target)
+{
+	struct drm_mode_create_dumb create = {
+		.width = width,
+		.height = height,
+		.bpp = 32,
+	};
+	struct drm_mode_map_dumb map = {};
+
+	if (ioctl(fd, DRM_IOCTL_MODE_CREATE_DUMB, &create)) {
+		perror("DRM_IOCTL_MODE_CREATE_DUMB");
+		return -1;
+	}
+
+	map.handle = create.handle;
+	if (ioctl(fd, DRM_IOCTL_MODE_MAP_DUMB, &map)) {
+		perror("DRM_IOCTL_MODE_MAP_DUMB");
+		return -1;
+	}
+
+	target->name = "vram dumb";
+	target->size = create.size;
+	target->map = mmap(NULL, create.size, PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, map.offset);
+	if (target->map == MAP_FAILED) {
+		perror("dumb mmap");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int tt_target(int fd, struct target *target)
+{
+	struct drm_via_gem_alloc alloc = {
+		.size = (uint64_t)width * height * 4,
+		.domain = VIA_DOMAIN_TT,
+	};
+	struct drm_via_gem_mmap map = {};
+
+	if (ioctl(fd, DRM_IOCTL_VIA_GEM_ALLOC, &alloc)) {
+		perror("DRM_IOCTL_VIA_GEM_ALLOC");
+		return -1;
+	}
+
+	map.handle = alloc.handle;
+	if (ioctl(fd, DRM_IOCTL_VIA_GEM_MMAP, &map)) {
+		perror("DRM_IOCTL_VIA_GEM_MMAP");
+		return -1;
+	}
+
+	target->name = "tt gem";
+	target->size = alloc.size;
+	target->map = mmap(NULL, alloc.size, PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, map.offset);
+	if (target->map == MAP_FAILED) {
+		perror("tt mmap");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Map the start of the VRAM BAR through sysfs. resourceN is mapped
+ * uncached and resourceN_wc write-combined.
+ */
+static int bar_target(const char *suffix, const char *name,
+			struct target *target)
+{
+	char path[128];
+	unsigned int device = 0;
+	FILE *f;
+	int fd;
+
+	snprintf(path, sizeof(path), "/sys/class/drm/%s/device/device",
+		strrchr(card, '/') + 1);
+	f = fopen(path, "r");
+	if (!f || fscanf(f, "%x", &device) != 1) {
+		fprintf(stderr, "%s: cannot read the PCI device ID\n", path);
+		if (f)
+			fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	snprintf(path, sizeof(path), "/sys/class/drm/%s/device/resource%d%s",
+		strrchr(card, '/') + 1,
+		(device == PCI_DEVICE_ID_VIA_CHROME9_HD) ? 2 : 0, suffix);
+	fd = open(path, O_RDWR);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	target->name = name;
+	target->size = (size_t)width * height * 4;
+	target->map = mmap(NULL, target->size, PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, 0);
+	close(fd);
+	if (target->map == MAP_FAILED) {
+		fprintf(stderr, "%s: mmap: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static void bench_bar(const char *suffix, const char *name, double *base)
+{
+	struct target target;
+	void *saved;
+
+	if (bar_target(suffix, name, &target))
+		return;
+
+	saved = malloc(target.size);
+	if (!saved)
+		exit(1);
+
+	memcpy(saved, target.map, target.size);
+	bench_target(&target, base);
+	memcpy(target.map, saved, target.size);
+
+	munmap(target.map, target.size);
+	free(saved);
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-d card] [-s WxH] [-n loops] [-u]\n",
+		name);
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	struct target target;
+	double base[2] = {};
+	int opt, fd;
+
+	while ((opt = getopt(argc, argv, "d:s:n:u")) != -1) {
+		switch (opt) {
+		case 'd':
+			card = optarg;
+			break;
+		case 's':
+			if (sscanf(optarg, "%ux%u", &width, &height) != 2 ||
+				!width || !height)
+				usage(argv[0]);
+			break;
+		case 'n':
+			loops = strtoul(optarg, NULL, 0);
+			if (!loops)
+				usage(argv[0]);
+			break;
+		case 'u':
+			bar = true;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	fd = open(card, O_RDWR | O_CLOEXEC);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", card, strerror(errno));
+		return 1;
+	}
+
+	printf("%ux%u 32 bpp, MB/s, speedup of fill and copy over the first row\n",
+		width, height);
+	printf("%-12s %9s %9s %9s\n", "", "fill", "copy", "read");
+
+	if (bar)
+		bench_bar("", "vram uc", base);
+
+	if (gem_target(fd, &target))
+		return 1;
+	bench_target(&target, base);
+
+	if (bar)
+		bench_bar("_wc", "vram wc", base);
+
+	if (!tt_target(fd, &target))
+		bench_target(&target, base);
+
+	target.name = "system";
+	target.size = (size_t)width * height * 4;
+	target.map = malloc(target.size);
+	if (!target.map)
+		return 1;
+	bench_target(&target, base);
+
+	close(fd);
+	return 0;
+}